@@ -4,12 +4,14 @@
 //! Underruns are zero-padded; overflow drops tail to avoid stalling UE audio.
 
 use std::borrow::Cow;
-use std::collections::HashMap;
+use std::cell::Cell;
+use std::collections::{BTreeMap, HashMap, HashSet};
 use std::ffi::{CStr, CString};
 use std::os::raw::{c_char, c_int, c_void, c_float};
 use std::ptr;
-use std::sync::atomic::{AtomicI32, AtomicI64, Ordering};
-use std::sync::{Arc, Mutex};
+use std::sync::atomic::{AtomicBool, AtomicI32, AtomicI64, Ordering};
+use std::sync::{Arc, Condvar, Mutex, Weak};
+use std::time::Instant;
 
 use anyhow::Result;
 use once_cell::sync::OnceCell;
@@ -27,30 +29,52 @@ use livekit::RoomOptions;
 use livekit::{ByteStreamWriter, StreamByteOptions, StreamWriter};
 use livekit::RoomEvent;
 // use livekit::data_stream::ByteStreamReader; // not currently used
-use livekit::StreamReader;
+use livekit::{ByteStreamReader, StreamReader};
 use livekit::webrtc::audio_source::{native::NativeAudioSource, AudioSourceOptions, RtcAudioSource};
 use livekit::webrtc::prelude::AudioFrame;
 use livekit::webrtc::audio_stream::native::NativeAudioStream;
 
+use crate::clock_sync::{self, ClockEstimator};
+use crate::compress::{self, LabelCodec};
+use crate::delta::{self, DeltaDecoder, DeltaEncoder};
+use crate::fec::{self, FecDecoder, FecEncoder};
+use crate::framing::{self, FrameKind};
+use crate::latency::{Histogram, Latencies, Summary};
+use crate::logging::{LogCallback, Logger};
+use crate::rate_control::{LinkEstimate, RateController};
+use crate::scheduler::{self, Payload, QueuedSend, Scheduler};
+
 // --------- Internal logging helpers (gated by LkLogLevel) ---------
 // A message is emitted if msg_level <= current level. Default level is Error (quiet).
+// The check is one atomic load; enabled lines go through the client's log queue (see logging.rs).
 macro_rules! lk_log {
-    ($state:expr, $level:expr, $($arg:tt)*) => {{
-        if ($level as i32) <= ($state.log_level as i32) {
-            println!("[livekit_ffi] {}", format_args!($($arg)*));
-        }
-    }};
+    ($state:expr, $level:expr, $($arg:tt)*) => {
+        lk_log_to!($state.log, $level, $($arg)*)
+    };
 }
-macro_rules! lk_log_arc {
-    ($arc:expr, $level:expr, $($arg:tt)*) => {{
-        if let Ok(__g) = $arc.lock() {
-            if ($level as i32) <= (__g.log_level as i32) {
-                println!("[livekit_ffi] {}", format_args!($($arg)*));
-            }
+macro_rules! lk_log_to {
+    ($log:expr, $level:expr, $($arg:tt)*) => {{
+        let __level = $level;
+        if $log.enabled(__level) {
+            static SITE: crate::logging::CallSite = crate::logging::CallSite::new();
+            $log.emit(__level, module_path!(), &SITE, format_args!($($arg)*));
         }
     }};
 }
 
+// --------- Tracing spans (feature `trace_spans`) ---------
+// `trace_span!("name")` times the rest of the enclosing block; compiled out without the feature.
+#[cfg(feature = "trace_spans")]
+macro_rules! trace_span {
+    ($name:expr) => {
+        let _span = crate::trace::Span::enter($name);
+    };
+}
+#[cfg(not(feature = "trace_spans"))]
+macro_rules! trace_span {
+    ($name:expr) => {};
+}
+
 // --------- C ABI surface ---------
 
 #[repr(C)]
@@ -119,6 +143,31 @@ pub enum LkLogLevel {
     Trace = 4,
 }
 
+#[repr(C)]
+#[derive(Copy, Clone, Debug, PartialEq, Eq)]
+pub enum LkReceiveFilter {
+    Dedup = 0,
+    Sequenced = 1,
+}
+
+#[repr(C)]
+#[derive(Copy, Clone, Debug, PartialEq, Eq)]
+pub enum LkTransferState {
+    InProgress = 0,
+    Completed = 1,
+    Failed = 2,
+    Cancelled = 3,
+}
+
+#[repr(C)]
+#[derive(Copy, Clone, Debug)]
+pub enum LkRegistryEvent {
+    ParticipantJoined = 0,
+    ParticipantLeft = 1,
+    TrackSubscribed = 2,
+    TrackUnsubscribed = 3,
+}
+
 #[repr(C)]
 pub struct LkAudioStats {
     pub sample_rate: c_int,
@@ -135,6 +184,74 @@ pub struct LkDataStats {
     pub reliable_dropped: i64,
     pub lossy_sent_bytes: i64,
     pub lossy_dropped: i64,
+    pub batched_messages: i64,
+    pub batch_packets: i64,
+    pub unordered_retransmits: i64,
+    pub duplicates_dropped: i64,
+    pub stale_dropped: i64,
+    pub expired_dropped: i64,
+    /// Messages sent compressed (`lk_set_data_compression`), their size before and on the wire.
+    pub compressed_messages: i64,
+    pub compressed_raw_bytes: i64,
+    pub compressed_wire_bytes: i64,
+    /// `compressed_raw_bytes / compressed_wire_bytes`; 0 before any compressed send.
+    pub compression_ratio: f64,
+    /// Compressed messages dropped on receive: missing dictionary or malformed.
+    pub decompress_failed: i64,
+    /// Lossy messages sent in FEC groups (`lk_set_data_fec`) and the parity packets added.
+    pub fec_messages: i64,
+    pub fec_parity_packets: i64,
+    /// Bytes FEC added (headers and parity) / message bytes it protected; 0 before any.
+    pub fec_overhead_ratio: f64,
+    /// Received messages rebuilt from parity, and those lost beyond repair.
+    pub fec_recovered: i64,
+    pub fec_unrecovered: i64,
+}
+
+/// One latency histogram summarized, in microseconds (`lk_get_latency_stats`).
+#[repr(C)]
+#[derive(Default)]
+pub struct LkLatencySummary {
+    pub count: i64,
+    pub min_us: f64,
+    pub max_us: f64,
+    pub mean_us: f64,
+    pub p50_us: f64,
+    pub p90_us: f64,
+    pub p99_us: f64,
+    pub p999_us: f64,
+}
+
+impl From<Summary> for LkLatencySummary {
+    fn from(s: Summary) -> Self {
+        Self {
+            count: s.count as i64,
+            min_us: s.min_us,
+            max_us: s.max_us,
+            mean_us: s.mean_us,
+            p50_us: s.p50_us,
+            p90_us: s.p90_us,
+            p99_us: s.p99_us,
+            p999_us: s.p999_us,
+        }
+    }
+}
+
+#[repr(C)]
+#[derive(Default)]
+pub struct LkLatencyStats {
+    pub audio_ring: LkLatencySummary,
+    pub send: LkLatencySummary,
+    pub dispatch: LkLatencySummary,
+    pub callback: LkLatencySummary,
+}
+
+#[repr(C)]
+pub struct LkSendOptions {
+    pub reliability: LkReliability,
+    pub ordered: c_int,
+    pub label: *const c_char,
+    pub max_age_ms: c_int,
 }
 
 #[repr(C)]
@@ -153,18 +270,63 @@ struct AudioTrackHandleRef {
 #[repr(C)]
 pub struct LkAudioTrackHandle(AudioTrackHandleRef);
 
+#[repr(C)]
+pub struct LkStateChannelConfig {
+    pub label: *const c_char,
+    pub reliability: LkReliability,
+    pub tick_hz: c_int,
+    pub max_packet_bytes: c_int,
+}
+
+#[repr(C)]
+pub struct LkStateChannelStats {
+    pub updates_written: i64,
+    pub updates_superseded: i64,
+    pub updates_sent: i64,
+    pub packets_sent: i64,
+    pub bytes_sent: i64,
+    pub packets_dropped: i64,
+}
+
+struct StateChannelHandleRef {
+    client: Arc<Mutex<ClientState>>,
+    channel_id: u64,
+    channel: Arc<StateChannel>,
+}
+
+#[repr(C)]
+pub struct LkStateChannelHandle(StateChannelHandleRef);
+
 #[repr(C)]
 pub struct LkClientHandle {
     _private: [u8; 0],
 }
 
+/// A reference to a received packet, handed to the buffered data callback and held until
+/// `lk_data_release`. Batched messages share their packet's allocation.
+pub struct LkDataBuffer {
+    _packet: Arc<Vec<u8>>,
+}
+
+type DataCallbackBuffered = extern "C" fn(*mut c_void, u32, *const c_char, LkReliability, *const u8, usize, *mut LkDataBuffer);
+
 // --------- Internal state ---------
 
+/// Pushes the audio worker can be behind on before ring latency samples are dropped.
+const AUDIO_MARKS: usize = 1024;
+
 struct AudioRing {
     prod: Producer<i16>,
     capacity_frames: usize,
     underruns: Arc<AtomicI32>,
     overruns: Arc<AtomicI32>,
+    /// Most frames queued right after a push; the ring only grows on push.
+    high_water_frames: usize,
+    /// Local clock at the last push, 0 before the first.
+    last_push_us: i64,
+    /// (samples pushed so far, push time) per push, for the worker to time ring residency.
+    marks: Producer<(u64, Instant)>,
+    pushed_samples: u64,
 }
 
 impl AudioRing {
@@ -179,6 +341,26 @@ impl AudioRing {
     }
 }
 
+/// Receive-side counters of one subscribed audio track, updated by its stream task.
+#[derive(Default)]
+struct RemoteAudioCounters {
+    frames: AtomicI64,
+    last_frame_us: AtomicI64,
+    sample_rate: AtomicI32,
+    channels: AtomicI32,
+}
+
+struct RemoteAudio {
+    participant_id: u32,
+    counters: Arc<RemoteAudioCounters>,
+    /// From the track's inbound RTP stats at the last stats poll.
+    samples_received: i64,
+    concealed_samples: i64,
+    jitter_buffer_ms: f64,
+    /// Jitter buffer totals of the previous poll: (delay in seconds, samples emitted).
+    prev_jitter_buffer: (f64, u64),
+}
+
 #[allow(dead_code)]
 struct AudioPipeline {
     label: String,
@@ -198,6 +380,7 @@ impl Drop for AudioPipeline {
 
 impl AudioPipeline {
     fn push(&mut self, data: &[i16]) -> Result<()> {
+        trace_span!("audio.push");
         if data.len() % self.channels as usize != 0 {
             anyhow::bail!(
                 "pcm payload len {} is not divisible by channel count {}",
@@ -219,6 +402,13 @@ impl AudioPipeline {
         if dropped {
             self.ring.overruns.fetch_add(1, Ordering::Relaxed);
         }
+        if pushed > 0 {
+            self.ring.pushed_samples += pushed as u64;
+            // A full mark ring only loses latency samples, never audio
+            let _ = self.ring.marks.push((self.ring.pushed_samples, Instant::now()));
+        }
+        self.ring.high_water_frames = self.ring.high_water_frames.max(self.ring.queued_frames(self.channels));
+        self.ring.last_push_us = clock_sync::now_us();
         Ok(())
     }
 }
@@ -279,6 +469,24 @@ struct DataStatsCounters {
     reliable_dropped: AtomicI64,
     lossy_sent_bytes: AtomicI64,
     lossy_dropped: AtomicI64,
+    batched_messages: AtomicI64,
+    batch_packets: AtomicI64,
+    unordered_retransmits: AtomicI64,
+    duplicates_dropped: AtomicI64,
+    stale_dropped: AtomicI64,
+    expired_dropped: AtomicI64,
+    compressed_messages: AtomicI64,
+    compressed_raw_bytes: AtomicI64,
+    compressed_wire_bytes: AtomicI64,
+    decompress_failed: AtomicI64,
+    fec_messages: AtomicI64,
+    fec_parity_packets: AtomicI64,
+    fec_message_bytes: AtomicI64,
+    fec_overhead_bytes: AtomicI64,
+    fec_recovered: AtomicI64,
+    fec_unrecovered: AtomicI64,
+    /// From the send call (or enqueue, or batch open) until the publish completes.
+    send_latency: Histogram,
 }
 
 impl Default for DataStatsCounters {
@@ -288,15 +496,554 @@ impl Default for DataStatsCounters {
             reliable_dropped: AtomicI64::new(0),
             lossy_sent_bytes: AtomicI64::new(0),
             lossy_dropped: AtomicI64::new(0),
+            batched_messages: AtomicI64::new(0),
+            batch_packets: AtomicI64::new(0),
+            unordered_retransmits: AtomicI64::new(0),
+            duplicates_dropped: AtomicI64::new(0),
+            stale_dropped: AtomicI64::new(0),
+            expired_dropped: AtomicI64::new(0),
+            compressed_messages: AtomicI64::new(0),
+            compressed_raw_bytes: AtomicI64::new(0),
+            compressed_wire_bytes: AtomicI64::new(0),
+            decompress_failed: AtomicI64::new(0),
+            fec_messages: AtomicI64::new(0),
+            fec_parity_packets: AtomicI64::new(0),
+            fec_message_bytes: AtomicI64::new(0),
+            fec_overhead_bytes: AtomicI64::new(0),
+            fec_recovered: AtomicI64::new(0),
+            fec_unrecovered: AtomicI64::new(0),
+            send_latency: Histogram::default(),
+        }
+    }
+}
+
+impl DataStatsCounters {
+    fn record_sent(&self, reliable: bool, bytes: i64) {
+        if reliable {
+            self.reliable_sent_bytes.fetch_add(bytes, Ordering::Relaxed);
+        } else {
+            self.lossy_sent_bytes.fetch_add(bytes, Ordering::Relaxed);
+        }
+    }
+
+    fn record_compressed(&self, raw: usize, wire: usize) {
+        self.compressed_messages.fetch_add(1, Ordering::Relaxed);
+        self.compressed_raw_bytes.fetch_add(raw as i64, Ordering::Relaxed);
+        self.compressed_wire_bytes.fetch_add(wire as i64, Ordering::Relaxed);
+    }
+
+    fn record_fec(&self, message: usize, wire: usize, parity: Option<usize>) {
+        self.fec_messages.fetch_add(1, Ordering::Relaxed);
+        self.fec_message_bytes.fetch_add(message as i64, Ordering::Relaxed);
+        self.fec_overhead_bytes.fetch_add((wire - message + parity.unwrap_or(0)) as i64, Ordering::Relaxed);
+        if parity.is_some() {
+            self.fec_parity_packets.fetch_add(1, Ordering::Relaxed);
+        }
+    }
+
+    fn record_dropped(&self, reliable: bool, messages: i64) {
+        if reliable {
+            self.reliable_dropped.fetch_add(messages, Ordering::Relaxed);
+        } else {
+            self.lossy_dropped.fetch_add(messages, Ordering::Relaxed);
+        }
+    }
+}
+
+/// An open batch for one (label, reliability) pair.
+struct PendingBatch {
+    buf: Vec<u8>,
+    messages: i64,
+    opened: Instant,
+}
+
+/// A sealed batch ready to publish, or a single message too large to batch that is sent
+/// through the batch worker so it cannot overtake its label's earlier batches.
+struct BatchPacket {
+    topic: String,
+    reliable: bool,
+    payload: Vec<u8>,
+    messages: i64,
+    opened: Instant,
+    batched: bool,
+    destinations: Vec<String>,
+}
+
+type BatchSender = tokio::sync::mpsc::UnboundedSender<BatchPacket>;
+
+/// Opt-in send coalescing (`lk_set_data_batching`). Small messages on the same label are
+/// length-prefixed into one framed packet that is flushed when full or when its window expires.
+struct DataBatcher {
+    flush_window: Duration,
+    max_packet: usize,
+    // label -> [reliable, lossy]; looked up by &str so the hot path never allocates a key
+    pending: Mutex<HashMap<String, [Option<PendingBatch>; 2]>>,
+}
+
+impl DataBatcher {
+    fn limit(&self, reliable: bool) -> usize {
+        if reliable { self.max_packet } else { self.max_packet.min(framing::LOSSY_MTU) }
+    }
+
+    fn fits(&self, reliable: bool, len: usize) -> bool {
+        framing::FRAME_HEADER_LEN + framing::batch_entry_len(len) <= self.limit(reliable)
+    }
+
+    fn seal(label: &str, reliable: bool, batch: PendingBatch) -> BatchPacket {
+        BatchPacket {
+            topic: framing::framed_topic(label),
+            reliable,
+            payload: batch.buf,
+            messages: batch.messages,
+            opened: batch.opened,
+            batched: true,
+            destinations: Vec::new(),
+        }
+    }
+
+    // Sealed packets go to the worker while `pending` is still locked, so `take_due`, which
+    // takes the same lock, never seals a newer batch ahead of one not yet in the channel.
+
+    /// Append one message, first sealing the open batch and sending it to `tx` if the
+    /// message does not fit.
+    fn push(&self, label: &str, reliable: bool, bytes: &[u8], tx: &BatchSender) {
+        let limit = self.limit(reliable);
+        let mut pending = self.pending.lock().unwrap();
+        if !pending.contains_key(label) {
+            pending.insert(label.to_string(), [None, None]);
+        }
+        let slot = &mut pending.get_mut(label).unwrap()[if reliable { 0 } else { 1 }];
+        if let Some(open) = slot.as_ref() {
+            if open.buf.len() + framing::batch_entry_len(bytes.len()) > limit {
+                if let Some(b) = slot.take() {
+                    let _ = tx.send(Self::seal(label, reliable, b));
+                }
+            }
+        }
+        let open = slot.get_or_insert_with(|| {
+            let mut buf = Vec::with_capacity(limit);
+            framing::begin_batch_packet(&mut buf);
+            PendingBatch { buf, messages: 0, opened: Instant::now() }
+        });
+        framing::put_batch_entry(&mut open.buf, bytes);
+        open.messages += 1;
+    }
+
+    /// Queue a message that is not batched (too large, or targeted) behind `label`'s open
+    /// batches, which are sealed and sent first.
+    fn pass_through(&self, label: &str, message: BatchPacket, tx: &BatchSender) {
+        let mut pending = self.pending.lock().unwrap();
+        Self::seal_label(&mut pending, label, tx);
+        let _ = tx.send(message);
+    }
+
+    /// Seal `label`'s open batches and send them to `tx` now, ahead of their window.
+    fn flush_label(&self, label: &str, tx: &BatchSender) {
+        Self::seal_label(&mut self.pending.lock().unwrap(), label, tx);
+    }
+
+    fn seal_label(pending: &mut HashMap<String, [Option<PendingBatch>; 2]>, label: &str, tx: &BatchSender) {
+        if let Some(slots) = pending.get_mut(label) {
+            for (i, slot) in slots.iter_mut().enumerate() {
+                if let Some(b) = slot.take() {
+                    let _ = tx.send(Self::seal(label, i == 0, b));
+                }
+            }
+        }
+    }
+
+    /// Seal every batch whose window has expired (or all of them when `force`).
+    fn take_due(&self, now: Instant, force: bool) -> Vec<BatchPacket> {
+        let mut out = Vec::new();
+        let mut pending = self.pending.lock().unwrap();
+        for (label, slots) in pending.iter_mut() {
+            for (i, slot) in slots.iter_mut().enumerate() {
+                let due = slot.as_ref().map_or(false, |b| force || now.duration_since(b.opened) >= self.flush_window);
+                if due {
+                    out.push(Self::seal(label, i == 0, slot.take().unwrap()));
+                }
+            }
+        }
+        out
+    }
+}
+
+/// Per-chunk metadata for progressive stream handlers (`lk_register_stream_handler`).
+#[repr(C)]
+pub struct LkStreamChunkInfo {
+    pub label: *const c_char,
+    pub participant_id: u32,
+    pub transfer_id: u64,
+    pub offset: u64,
+    pub total_length: u64,
+    pub state: LkTransferState,
+}
+
+type StreamHandlerFn = extern "C" fn(*mut c_void, *const LkStreamChunkInfo, *const u8, usize);
+
+struct StreamHandler {
+    label: CString,
+    cb: StreamHandlerFn,
+    user: UserPtr,
+}
+
+/// Cancellation flag plus a completion latch for one large transfer. Send transfers read
+/// caller memory until `done`, so disconnect/destroy waits on the latch before returning.
+#[derive(Default)]
+struct TransferCtl {
+    outbound: bool,
+    cancel: AtomicBool,
+    cancelled: tokio::sync::Notify,
+    done: Mutex<bool>,
+    done_cv: Condvar,
+}
+
+impl TransferCtl {
+    fn cancel(&self) {
+        self.cancel.store(true, Ordering::Release);
+        self.cancelled.notify_waiters();
+    }
+
+    /// Resolves once the transfer is cancelled; lets a pending chunk write be abandoned.
+    async fn until_cancelled(&self) {
+        let notified = self.cancelled.notified();
+        tokio::pin!(notified);
+        notified.as_mut().enable();
+        if !self.cancel.load(Ordering::Acquire) {
+            notified.await;
+        }
+    }
+
+    fn finish(&self) {
+        *self.done.lock().unwrap() = true;
+        self.done_cv.notify_all();
+    }
+
+    fn wait(&self) {
+        let guard = self.done.lock().unwrap();
+        let _done = self.done_cv.wait_while(guard, |done| !*done).unwrap();
+    }
+}
+
+/// Caller-owned payload for `lk_send_large`; valid until the terminal progress callback.
+struct BorrowedPayload(*const u8, usize);
+unsafe impl Send for BorrowedPayload {}
+unsafe impl Sync for BorrowedPayload {}
+
+impl BorrowedPayload {
+    unsafe fn as_slice(&self) -> &[u8] {
+        std::slice::from_raw_parts(self.0, self.1)
+    }
+}
+
+/// Queued sends (deadlines, per-label classes) drained by one worker in scheduler order.
+#[derive(Default)]
+struct SendQueue {
+    scheduler: Mutex<Option<Scheduler>>,
+    ready: tokio::sync::Notify,
+}
+
+impl SendQueue {
+    fn push(&self, label: &str, msg: QueuedSend) {
+        if let Some(s) = self.scheduler.lock().unwrap().as_mut() {
+            s.push(label, msg);
+        }
+        self.ready.notify_one();
+    }
+
+    fn with<R>(&self, f: impl FnOnce(&mut Scheduler) -> R) -> Option<R> {
+        self.scheduler.lock().unwrap().as_mut().map(f)
+    }
+}
+
+struct SendQueueWorker {
+    queue: Arc<SendQueue>,
+    worker: JoinHandle<()>,
+}
+
+/// Periodic clock sync pings; the worker outlives reconnects, like the batch worker.
+struct ClockSyncWorker(JoinHandle<()>);
+
+impl Drop for ClockSyncWorker {
+    fn drop(&mut self) {
+        self.0.abort();
+    }
+}
+
+/// Periodic peer connection stats polls feeding the link estimate and the transport stats
+/// cache; outlives reconnects.
+struct LinkMonitor(JoinHandle<()>);
+
+impl Drop for LinkMonitor {
+    fn drop(&mut self) {
+        self.0.abort();
+    }
+}
+
+impl Drop for SendQueueWorker {
+    fn drop(&mut self) {
+        // Unsent messages are discarded with the queue
+        self.worker.abort();
+    }
+}
+
+/// First retransmit delay for reliable-unordered messages; doubles per attempt up to the cap.
+const UNORDERED_RTO: Duration = Duration::from_millis(60);
+const UNORDERED_RTO_MAX: Duration = Duration::from_millis(1000);
+/// Attempts before a message is given up on (about 5 s with the delays above).
+const UNORDERED_MAX_ATTEMPTS: u32 = 10;
+/// Unacknowledged messages kept for retransmission; the oldest is dropped beyond this, and so
+/// is any message that falls out of the receivers' duplicate window.
+const UNORDERED_MAX_IN_FLIGHT: usize = 1024;
+const UNORDERED_TICK: Duration = Duration::from_millis(10);
+
+/// A reliable-unordered message still waiting for acks from `pending` peers.
+struct Unacked {
+    topic: String,
+    packet: Vec<u8>,
+    pending: Vec<String>,
+    attempts: u32,
+    next_retx: Instant,
+    /// The sender's max age; retransmission stops once it passes.
+    deadline: Option<Instant>,
+}
+
+#[derive(Default)]
+struct UnorderedQueues {
+    next_seq: u32,
+    unacked: BTreeMap<u32, Unacked>,
+    /// Sequence numbers to acknowledge, keyed by the sending peer's identity.
+    acks_out: HashMap<String, Vec<u32>>,
+}
+
+/// A sequenced packet on its way to the transport.
+struct SeqPacket {
+    topic: String,
+    packet: Vec<u8>,
+    destinations: Vec<String>,
+    /// Dropped unsent past this; retransmissions carry the original message's deadline.
+    deadline: Option<Instant>,
+    /// When the first transmission was queued; None for retransmissions and acks.
+    enqueued: Option<Instant>,
+}
+
+/// Reliable-unordered delivery (`ordered = 0`): every message is an independent lossy packet
+/// with a sequence number, retransmitted to each peer until that peer acks it. One lost
+/// packet delays only itself, never the messages behind it.
+struct UnorderedState {
+    queues: Arc<Mutex<UnorderedQueues>>,
+    tx: tokio::sync::mpsc::UnboundedSender<SeqPacket>,
+}
+
+/// A caller buffer handed over by `lk_send_data_owned`; the release callback runs on drop.
+struct OwnedBuffer {
+    bytes: *const u8,
+    len: usize,
+    release: extern "C" fn(*mut c_void, *const u8, usize),
+    user: UserPtr,
+}
+unsafe impl Send for OwnedBuffer {}
+
+impl AsRef<[u8]> for OwnedBuffer {
+    fn as_ref(&self) -> &[u8] {
+        unsafe { std::slice::from_raw_parts(self.bytes, self.len) }
+    }
+}
+
+impl Drop for OwnedBuffer {
+    fn drop(&mut self) {
+        (self.release)(self.user.0, self.bytes, self.len);
+    }
+}
+
+/// Reassembly buffers reused across inbound byte streams.
+const STREAM_POOL_MAX_BUFFERS: usize = 4;
+const STREAM_POOL_MAX_RETAINED: usize = 8 * 1024 * 1024;
+/// Largest byte stream reassembled into one buffer; longer transfers end as `Failed`.
+const STREAM_REASSEMBLY_MAX: usize = 64 * 1024 * 1024;
+
+struct BatchingState {
+    batcher: Arc<DataBatcher>,
+    tx: BatchSender,
+    worker: JoinHandle<()>,
+}
+
+/// Per-message metadata handed to topic handlers registered via `lk_register_data_handler`.
+#[repr(C)]
+pub struct LkDataMessageInfo {
+    pub label: *const c_char,
+    pub participant_id: u32,
+    pub reliability: LkReliability,
+    /// Send time mapped into the local clock (see `lk_data_sender_time_us`); 0 if unknown.
+    pub sender_time_us: i64,
+}
+
+type DataHandlerFn = extern "C" fn(*mut c_void, *const LkDataMessageInfo, *const u8, usize);
+
+/// A handler bound to one topic. The label CString is built once at registration
+/// so dispatch never allocates.
+struct DataHandler {
+    label: CString,
+    cb: DataHandlerFn,
+    user: UserPtr,
+}
+
+type StateHandlerFn = extern "C" fn(*mut c_void, *const LkDataMessageInfo, u32, *const u8, usize);
+
+/// Receive side of a keyed state channel. Remembers the newest tick seen per
+/// (sender, key) so late lossy packets never roll a value back. A sender whose channel epoch
+/// changes has recreated the channel, so its ticks start over.
+struct StateHandler {
+    label: CString,
+    cb: StateHandlerFn,
+    user: UserPtr,
+    last_tick: HashMap<(u32, u32), u32>,
+    epochs: HashMap<u32, u32>,
+}
+
+impl StateHandler {
+    fn forget_participant(&mut self, participant_id: u32) {
+        self.last_tick.retain(|(p, _), _| *p != participant_id);
+        self.epochs.remove(&participant_id);
+    }
+}
+
+#[derive(Default)]
+struct StateSlot {
+    data: Vec<u8>,
+    dirty: bool,
+}
+
+/// Send side of a keyed state channel: one latest-value slot per key.
+/// Writers overwrite slots; the scheduler task drains dirty slots once per tick,
+/// so updates superseded between ticks never reach the network.
+struct StateChannel {
+    label: String,
+    topic: String,
+    /// Sent with every packet; differs between channels, including a recreated one.
+    epoch: u32,
+    reliable: bool,
+    max_packet: usize,
+    closed: AtomicBool,
+    slots: Mutex<BTreeMap<u32, StateSlot>>,
+    updates_written: AtomicI64,
+    updates_superseded: AtomicI64,
+    updates_sent: AtomicI64,
+    packets_sent: AtomicI64,
+    bytes_sent: AtomicI64,
+    packets_dropped: AtomicI64,
+}
+
+impl StateChannel {
+    fn write(&self, key: u32, bytes: &[u8]) {
+        let mut slots = self.slots.lock().unwrap();
+        let slot = slots.entry(key).or_default();
+        if slot.dirty {
+            self.updates_superseded.fetch_add(1, Ordering::Relaxed);
+        }
+        slot.data.clear();
+        slot.data.extend_from_slice(bytes);
+        slot.dirty = true;
+        self.updates_written.fetch_add(1, Ordering::Relaxed);
+    }
+
+    /// Pack every dirty slot into as few packets as fit `max_packet`, clearing the dirty flags.
+    fn collect(&self, tick: u32) -> (Vec<Vec<u8>>, i64) {
+        let mut packets = Vec::new();
+        let mut sent = 0i64;
+        let mut cur: Vec<u8> = Vec::new();
+        let mut slots = self.slots.lock().unwrap();
+        for (key, slot) in slots.iter_mut().filter(|(_, s)| s.dirty) {
+            slot.dirty = false;
+            let need = framing::state_entry_len(*key, slot.data.len());
+            if !cur.is_empty() && cur.len() + need > self.max_packet {
+                packets.push(std::mem::take(&mut cur));
+            }
+            if cur.is_empty() {
+                cur.reserve(self.max_packet);
+                framing::begin_state_packet(&mut cur, self.epoch, tick);
+            }
+            framing::put_state_entry(&mut cur, *key, &slot.data);
+            sent += 1;
+        }
+        if !cur.is_empty() {
+            packets.push(cur);
+        }
+        (packets, sent)
+    }
+
+    fn stats(&self) -> LkStateChannelStats {
+        LkStateChannelStats {
+            updates_written: self.updates_written.load(Ordering::Relaxed),
+            updates_superseded: self.updates_superseded.load(Ordering::Relaxed),
+            updates_sent: self.updates_sent.load(Ordering::Relaxed),
+            packets_sent: self.packets_sent.load(Ordering::Relaxed),
+            bytes_sent: self.bytes_sent.load(Ordering::Relaxed),
+            packets_dropped: self.packets_dropped.load(Ordering::Relaxed),
+        }
+    }
+}
+
+struct StateChannelWorker {
+    channel: Arc<StateChannel>,
+    worker: JoinHandle<()>,
+}
+
+impl Drop for StateChannelWorker {
+    fn drop(&mut self) {
+        self.channel.closed.store(true, Ordering::Release);
+        self.worker.abort();
+    }
+}
+
+/// Interns participant identities and track SIDs into small stable IDs.
+/// IDs start at 1 (0 means unknown) and are never reused for the client's lifetime,
+/// so a participant that leaves and rejoins keeps its ID.
+#[derive(Default)]
+struct IdRegistry {
+    participant_ids: HashMap<String, u32>,
+    participant_names: HashMap<u32, CString>,
+    track_ids: HashMap<String, u32>,
+    track_info: HashMap<u32, (u32, CString)>,
+    next_id: u32,
+}
+
+impl IdRegistry {
+    fn alloc(&mut self) -> u32 {
+        self.next_id = self.next_id.wrapping_add(1).max(1);
+        self.next_id
+    }
+
+    /// Returns (id, newly_registered).
+    fn participant(&mut self, identity: &str) -> (u32, bool) {
+        if let Some(id) = self.participant_ids.get(identity) {
+            return (*id, false);
         }
+        let id = self.alloc();
+        self.participant_ids.insert(identity.to_string(), id);
+        self.participant_names.insert(id, CString::new(identity).unwrap_or_default());
+        (id, true)
+    }
+
+    /// Returns (id, newly_registered). Keyed by track SID.
+    fn track(&mut self, sid: &str, participant_id: u32, name: &str) -> (u32, bool) {
+        if let Some(id) = self.track_ids.get(sid) {
+            return (*id, false);
+        }
+        let id = self.alloc();
+        self.track_ids.insert(sid.to_string(), id);
+        self.track_info.insert(id, (participant_id, CString::new(name).unwrap_or_default()));
+        (id, true)
     }
 }
 
 struct ClientState {
-    room: Option<Room>,
+    room: Option<Arc<Room>>,
     audio_tracks: HashMap<u64, AudioPipeline>,
     default_audio_track_id: Option<u64>,
     next_audio_track_id: u64,
+    state_channels: HashMap<u64, StateChannelWorker>,
+    next_state_channel_id: u64,
     rt: Arc<Runtime>,
     
     // Callbacks
@@ -304,6 +1051,57 @@ struct ClientState {
     data_cb_ex: Option<(extern "C" fn(*mut c_void, *const c_char, LkReliability, *const u8, usize), UserPtr)>,
     audio_cb: Option<(extern "C" fn(*mut c_void, *const i16, usize, c_int, c_int), UserPtr)>,
     audio_cb_ex: Option<(extern "C" fn(*mut c_void, *const i16, usize, c_int, c_int, *const c_char, *const c_char), UserPtr)>,
+    audio_cb_ids: Option<(extern "C" fn(*mut c_void, *const i16, usize, c_int, c_int, u32, u32), UserPtr)>,
+    data_cb_from: Option<(extern "C" fn(*mut c_void, u32, *const c_char, LkReliability, *const u8, usize), UserPtr)>,
+    data_cb_buffered: Option<(DataCallbackBuffered, UserPtr)>,
+    registry_cb: Option<(extern "C" fn(*mut c_void, LkRegistryEvent, u32, u32, *const c_char, *const c_char), UserPtr)>,
+    data_handlers: HashMap<String, DataHandler>,
+    /// C copies of the topics handed to the catch-all data callbacks, so a message does not
+    /// allocate one. Bounded by TOPIC_NAMES_MAX.
+    topic_names: HashMap<String, CString>,
+    state_handlers: HashMap<String, StateHandler>,
+    batching: Option<BatchingState>,
+    stream_handlers: HashMap<String, StreamHandler>,
+    transfers: HashMap<u64, Arc<TransferCtl>>,
+    next_transfer_id: u64,
+    stream_pool: Vec<Vec<u8>>,
+    unordered: Option<UnorderedState>,
+    send_queue: Option<SendQueueWorker>,
+    send_classes: HashMap<String, scheduler::ClassConfig>,
+    /// Labels that have sent through the queue since connect. Their later sends are queued
+    /// too, so a plain send cannot overtake queued ones.
+    queued_labels: HashSet<String>,
+    scheduler_mode: scheduler::Mode,
+    seq_windows: HashMap<u32, framing::SeqWindow>,
+    /// Labels with the sequenced receive filter: newest sequence delivered per sender.
+    sequenced_labels: HashMap<String, HashMap<u32, u32>>,
+    delta_tx: HashMap<String, DeltaEncoder>,
+    /// Last keyframe per sender and label.
+    delta_rx: HashMap<u32, HashMap<String, DeltaDecoder>>,
+    delta_stats: HashMap<String, DeltaStats>,
+    compression: HashMap<String, LabelCodec>,
+    /// Dictionary-less zstd context for inbound messages, created on first use.
+    zstd_plain: Option<zstd::bulk::Decompressor<'static>>,
+    clock: ClockEstimator,
+    /// Identity of the participant whose clock is the room clock; None when it is ours.
+    clock_reference: Option<String>,
+    clock_worker: Option<ClockSyncWorker>,
+    /// Labels whose sends carry the sender's clock (`lk_set_data_timestamps`).
+    timestamped_labels: HashSet<String>,
+    fec_tx: HashMap<String, FecEncoder>,
+    /// Open FEC groups per sender and label.
+    fec_rx: HashMap<u32, HashMap<String, FecDecoder>>,
+    link: LinkEstimate,
+    link_quality: LkConnectionQuality,
+    /// Local clock at the last stats poll, 0 before the first.
+    link_updated_us: i64,
+    link_monitor: Option<LinkMonitor>,
+    rate_controls: HashMap<String, RateController>,
+    rate_cb: Option<(extern "C" fn(*mut c_void, *const c_char, c_float), UserPtr)>,
+    rtc_stats: RtcStatsCache,
+    latency: Arc<Latencies>,
+    /// Subscribed audio tracks by registry track ID.
+    remote_audio: HashMap<u32, RemoteAudio>,
     audio_format_change_cb: Option<(extern "C" fn(*mut c_void, c_int, c_int), UserPtr)>,
     connection_cb: Option<(extern "C" fn(*mut c_void, LkConnectionState, c_int, *const c_char), UserPtr)>,
     
@@ -312,8 +1110,11 @@ struct ClientState {
     audio_publish_opts: AudioPublishOptions,
     audio_output_format: AudioOutputFormat,
     data_labels: DataLabels,
-    log_level: LkLogLevel,
+    log: Arc<Logger>,
     
+    // Participant/track ID interning
+    registry: IdRegistry,
+
     // Statistics
     data_stats: Arc<DataStatsCounters>,
 }
@@ -341,18 +1142,60 @@ pub extern "C" fn lk_client_create() -> *mut LkClientHandle {
         audio_tracks: HashMap::new(),
         default_audio_track_id: None,
         next_audio_track_id: 1,
+        state_channels: HashMap::new(),
+        next_state_channel_id: 1,
         rt: runtime(),
         data_cb: None,
         data_cb_ex: None,
         audio_cb: None,
         audio_cb_ex: None,
+        audio_cb_ids: None,
+        data_cb_from: None,
+        data_cb_buffered: None,
+        registry_cb: None,
+        data_handlers: HashMap::new(),
+        topic_names: HashMap::new(),
+        state_handlers: HashMap::new(),
+        batching: None,
+        stream_handlers: HashMap::new(),
+        transfers: HashMap::new(),
+        next_transfer_id: 1,
+        stream_pool: Vec::new(),
+        unordered: None,
+        send_queue: None,
+        send_classes: HashMap::new(),
+        queued_labels: HashSet::new(),
+        scheduler_mode: scheduler::Mode::Strict,
+        seq_windows: HashMap::new(),
+        sequenced_labels: HashMap::new(),
+        delta_tx: HashMap::new(),
+        delta_rx: HashMap::new(),
+        delta_stats: HashMap::new(),
+        compression: HashMap::new(),
+        zstd_plain: None,
+        clock: ClockEstimator::default(),
+        clock_reference: None,
+        clock_worker: None,
+        timestamped_labels: HashSet::new(),
+        fec_tx: HashMap::new(),
+        fec_rx: HashMap::new(),
+        link: LinkEstimate::default(),
+        link_quality: LkConnectionQuality::Unknown,
+        link_updated_us: 0,
+        link_monitor: None,
+        rate_controls: HashMap::new(),
+        rtc_stats: RtcStatsCache::default(),
+        latency: Arc::new(Latencies::default()),
+        remote_audio: HashMap::new(),
+        rate_cb: None,
         audio_format_change_cb: None,
         connection_cb: None,
         role: LkRole::Both,
         audio_publish_opts: AudioPublishOptions::default(),
         audio_output_format: AudioOutputFormat::default(),
         data_labels: DataLabels::default(),
-        log_level: LkLogLevel::Error,
+        log: Arc::new(Logger::default()),
+        registry: IdRegistry::default(),
         data_stats: Arc::new(DataStatsCounters::default()),
     };
     let boxed = Box::new(Client(Arc::new(Mutex::new(state))));
@@ -364,7 +1207,17 @@ pub extern "C" fn lk_client_destroy(client: *mut LkClientHandle) {
     if client.is_null() {
         return;
     }
-    unsafe { drop(Box::from_raw(client as *mut Client)); }
+    let boxed = unsafe { Box::from_raw(client as *mut Client) };
+    // Close the room like lk_disconnect so nothing outbound is left mid-write
+    let (pending, room) = boxed.0.lock().map(|mut g| (cancel_transfers(&mut g), g.room.take().map(|r| (r, g.rt.clone())))).unwrap_or_default();
+    if let Some((room, rt)) = room {
+        rt.block_on(async move {
+            let _ = room.close().await;
+        });
+    }
+    wait_transfers(&pending);
+    logger(&boxed.0).close();
+    drop(boxed);
 }
 
 #[no_mangle]
@@ -390,9 +1243,10 @@ pub extern "C" fn lk_client_set_audio_callback(
     let c = unsafe { &*(client as *const Client) };
     let mut g = c.0.lock().unwrap();
     g.audio_cb = cb.map(|f| (f, UserPtr(user)));
-    // Clear extended callback if standard callback is set
+    // Clear extended callbacks if standard callback is set
     if cb.is_some() {
         g.audio_cb_ex = None;
+        g.audio_cb_ids = None;
     }
     ok()
 }
@@ -407,75 +1261,235 @@ pub extern "C" fn lk_client_set_audio_callback_ex(
     let c = unsafe { &*(client as *const Client) };
     let mut g = c.0.lock().unwrap();
     g.audio_cb_ex = cb.map(|f| (f, UserPtr(user)));
-    // Clear standard callback if extended callback is set
+    // Clear other audio callbacks if extended callback is set
     if cb.is_some() {
         g.audio_cb = None;
+        g.audio_cb_ids = None;
     }
     ok()
 }
 
 #[no_mangle]
-pub extern "C" fn lk_client_set_data_callback_ex(
+pub extern "C" fn lk_client_set_audio_callback_ids(
     client: *mut LkClientHandle,
-    cb: Option<extern "C" fn(user: *mut c_void, label: *const c_char, reliability: LkReliability, bytes: *const u8, len: usize)>,
+    cb: Option<extern "C" fn(user: *mut c_void, pcm: *const i16, frames_per_channel: usize, channels: c_int, sample_rate: c_int, participant_id: u32, track_id: u32)>,
     user: *mut c_void,
 ) -> LkResult {
     if client.is_null() { return err(1, "client null"); }
     let c = unsafe { &*(client as *const Client) };
     let mut g = c.0.lock().unwrap();
-    g.data_cb_ex = cb.map(|f| (f, UserPtr(user)));
+    g.audio_cb_ids = cb.map(|f| (f, UserPtr(user)));
+    // Clear other audio callbacks if the ID-based callback is set
+    if cb.is_some() {
+        g.audio_cb = None;
+        g.audio_cb_ex = None;
+    }
     ok()
 }
 
 #[no_mangle]
-pub extern "C" fn lk_set_audio_format_change_callback(
+pub extern "C" fn lk_client_set_data_callback_ex(
     client: *mut LkClientHandle,
-    cb: Option<extern "C" fn(user: *mut c_void, sample_rate: c_int, channels: c_int)>,
+    cb: Option<extern "C" fn(user: *mut c_void, label: *const c_char, reliability: LkReliability, bytes: *const u8, len: usize)>,
     user: *mut c_void,
 ) -> LkResult {
     if client.is_null() { return err(1, "client null"); }
     let c = unsafe { &*(client as *const Client) };
     let mut g = c.0.lock().unwrap();
-    g.audio_format_change_cb = cb.map(|f| (f, UserPtr(user)));
+    g.data_cb_ex = cb.map(|f| (f, UserPtr(user)));
     ok()
 }
 
 #[no_mangle]
-pub extern "C" fn lk_set_connection_callback(
+pub extern "C" fn lk_client_set_data_callback_from(
     client: *mut LkClientHandle,
-    cb: Option<extern "C" fn(user: *mut c_void, state: LkConnectionState, reason_code: c_int, message: *const c_char)>,
+    cb: Option<extern "C" fn(user: *mut c_void, participant_id: u32, label: *const c_char, reliability: LkReliability, bytes: *const u8, len: usize)>,
     user: *mut c_void,
 ) -> LkResult {
     if client.is_null() { return err(1, "client null"); }
     let c = unsafe { &*(client as *const Client) };
     let mut g = c.0.lock().unwrap();
-    g.connection_cb = cb.map(|f| (f, UserPtr(user)));
+    g.data_cb_from = cb.map(|f| (f, UserPtr(user)));
     ok()
 }
 
-// --------- Configuration Functions ---------
-
+/// Set a data callback that takes ownership of each message. `bytes` stays valid after the
+/// callback returns, until the callee passes `buffer` to `lk_data_release`, so processing can
+/// be deferred to another thread without copying. Takes precedence over the other data
+/// callbacks.
 #[no_mangle]
-pub extern "C" fn lk_set_audio_publish_options(
+pub extern "C" fn lk_client_set_data_callback_buffered(
     client: *mut LkClientHandle,
-    bitrate_bps: c_int,
-    enable_dtx: c_int,
-    stereo: c_int,
+    cb: Option<DataCallbackBuffered>,
+    user: *mut c_void,
 ) -> LkResult {
     if client.is_null() { return err(1, "client null"); }
     let c = unsafe { &*(client as *const Client) };
     let mut g = c.0.lock().unwrap();
-    g.audio_publish_opts = AudioPublishOptions {
-        bitrate_bps,
-        enable_dtx: enable_dtx != 0,
-        stereo: stereo != 0,
-    };
-    lk_log!(g, LkLogLevel::Debug, "Audio publish options set: bitrate={}bps, dtx={}, stereo={}", bitrate_bps, enable_dtx != 0, stereo != 0);
+    g.data_cb_buffered = cb.map(|f| (f, UserPtr(user)));
     ok()
 }
 
+/// Release a buffer handed out by the buffered data callback. NULL is ignored.
 #[no_mangle]
-pub extern "C" fn lk_set_audio_output_format(
+pub extern "C" fn lk_data_release(buffer: *mut LkDataBuffer) {
+    if buffer.is_null() { return; }
+    unsafe { drop(Box::from_raw(buffer)); }
+}
+
+#[no_mangle]
+pub extern "C" fn lk_set_registry_callback(
+    client: *mut LkClientHandle,
+    cb: Option<extern "C" fn(user: *mut c_void, event: LkRegistryEvent, participant_id: u32, track_id: u32, participant_identity: *const c_char, track_name: *const c_char)>,
+    user: *mut c_void,
+) -> LkResult {
+    if client.is_null() { return err(1, "client null"); }
+    let c = unsafe { &*(client as *const Client) };
+    let mut g = c.0.lock().unwrap();
+    g.registry_cb = cb.map(|f| (f, UserPtr(user)));
+    ok()
+}
+
+/// Register `cb` for messages on topic `label`; only that topic is delivered to it.
+/// Passing a NULL `cb` removes the handler. Topics with a handler bypass the
+/// catch-all data callbacks.
+///
+/// # Safety
+/// `label` must be a valid NUL-terminated UTF-8 string.
+#[no_mangle]
+pub unsafe extern "C" fn lk_register_data_handler(
+    client: *mut LkClientHandle,
+    label: *const c_char,
+    cb: Option<extern "C" fn(user: *mut c_void, info: *const LkDataMessageInfo, bytes: *const u8, len: usize)>,
+    user: *mut c_void,
+) -> LkResult {
+    if client.is_null() { return err(1, "client null"); }
+    let topic = match cstr(label) {
+        Ok(s) if !s.is_empty() => s.to_string(),
+        Ok(_) => return err(5, "label empty"),
+        Err(e) => return err(2, &format!("label: {e}")),
+    };
+    let c = &*(client as *const Client);
+    let mut g = c.0.lock().unwrap();
+    match cb {
+        Some(cb) => {
+            let label = CString::new(topic.as_str()).unwrap_or_default();
+            g.data_handlers.insert(topic, DataHandler { label, cb, user: UserPtr(user) });
+        }
+        None => {
+            g.data_handlers.remove(&topic);
+        }
+    }
+    ok()
+}
+
+/// Copy a NUL-terminated string into a caller buffer, truncating if needed.
+unsafe fn copy_to_buf(src: &CStr, buf: *mut c_char, buf_len: usize) {
+    if buf.is_null() || buf_len == 0 {
+        return;
+    }
+    let bytes = src.to_bytes();
+    let n = bytes.len().min(buf_len - 1);
+    ptr::copy_nonoverlapping(bytes.as_ptr() as *const c_char, buf, n);
+    *buf.add(n) = 0;
+}
+
+/// # Safety
+/// `buf` must point to at least `buf_len` writable bytes (or be NULL when `buf_len` is 0).
+#[no_mangle]
+pub unsafe extern "C" fn lk_get_participant_identity(
+    client: *mut LkClientHandle,
+    participant_id: u32,
+    buf: *mut c_char,
+    buf_len: usize,
+) -> LkResult {
+    if client.is_null() { return err(1, "client null"); }
+    let c = &*(client as *const Client);
+    let g = c.0.lock().unwrap();
+    match g.registry.participant_names.get(&participant_id) {
+        Some(name) => {
+            copy_to_buf(name, buf, buf_len);
+            ok()
+        }
+        None => err(5, "unknown participant id"),
+    }
+}
+
+/// # Safety
+/// `buf` must point to at least `buf_len` writable bytes (or be NULL when `buf_len` is 0).
+/// `out_participant_id` may be NULL.
+#[no_mangle]
+pub unsafe extern "C" fn lk_get_track_info(
+    client: *mut LkClientHandle,
+    track_id: u32,
+    out_participant_id: *mut u32,
+    buf: *mut c_char,
+    buf_len: usize,
+) -> LkResult {
+    if client.is_null() { return err(1, "client null"); }
+    let c = &*(client as *const Client);
+    let g = c.0.lock().unwrap();
+    match g.registry.track_info.get(&track_id) {
+        Some((participant_id, name)) => {
+            if !out_participant_id.is_null() {
+                *out_participant_id = *participant_id;
+            }
+            copy_to_buf(name, buf, buf_len);
+            ok()
+        }
+        None => err(5, "unknown track id"),
+    }
+}
+
+#[no_mangle]
+pub extern "C" fn lk_set_audio_format_change_callback(
+    client: *mut LkClientHandle,
+    cb: Option<extern "C" fn(user: *mut c_void, sample_rate: c_int, channels: c_int)>,
+    user: *mut c_void,
+) -> LkResult {
+    if client.is_null() { return err(1, "client null"); }
+    let c = unsafe { &*(client as *const Client) };
+    let mut g = c.0.lock().unwrap();
+    g.audio_format_change_cb = cb.map(|f| (f, UserPtr(user)));
+    ok()
+}
+
+#[no_mangle]
+pub extern "C" fn lk_set_connection_callback(
+    client: *mut LkClientHandle,
+    cb: Option<extern "C" fn(user: *mut c_void, state: LkConnectionState, reason_code: c_int, message: *const c_char)>,
+    user: *mut c_void,
+) -> LkResult {
+    if client.is_null() { return err(1, "client null"); }
+    let c = unsafe { &*(client as *const Client) };
+    let mut g = c.0.lock().unwrap();
+    g.connection_cb = cb.map(|f| (f, UserPtr(user)));
+    ok()
+}
+
+// --------- Configuration Functions ---------
+
+#[no_mangle]
+pub extern "C" fn lk_set_audio_publish_options(
+    client: *mut LkClientHandle,
+    bitrate_bps: c_int,
+    enable_dtx: c_int,
+    stereo: c_int,
+) -> LkResult {
+    if client.is_null() { return err(1, "client null"); }
+    let c = unsafe { &*(client as *const Client) };
+    let mut g = c.0.lock().unwrap();
+    g.audio_publish_opts = AudioPublishOptions {
+        bitrate_bps,
+        enable_dtx: enable_dtx != 0,
+        stereo: stereo != 0,
+    };
+    lk_log!(g, LkLogLevel::Debug, "Audio publish options set: bitrate={}bps, dtx={}, stereo={}", bitrate_bps, enable_dtx != 0, stereo != 0);
+    ok()
+}
+
+#[no_mangle]
+pub extern "C" fn lk_set_audio_output_format(
     client: *mut LkClientHandle,
     sample_rate: c_int,
     channels: c_int,
@@ -565,12 +1579,28 @@ pub extern "C" fn lk_set_log_level(
 ) -> LkResult {
     if client.is_null() { return err(1, "client null"); }
     let c = unsafe { &*(client as *const Client) };
-    let mut g = c.0.lock().unwrap();
-    g.log_level = level;
+    let g = c.0.lock().unwrap();
+    g.log.set_level(level);
     lk_log!(g, LkLogLevel::Debug, "Log level set to: {:?}", level);
     ok()
 }
 
+/// Route log lines to `cb` instead of stdout; NULL restores stdout. The callback runs on the
+/// client's log thread, never inside another API call.
+#[no_mangle]
+pub extern "C" fn lk_set_log_callback(
+    client: *mut LkClientHandle,
+    cb: Option<LogCallback>,
+    user: *mut c_void,
+) -> LkResult {
+    if client.is_null() { return err(1, "client null"); }
+    let c = unsafe { &*(client as *const Client) };
+    let log = c.0.lock().unwrap().log.clone();
+    // Outside the client lock: this waits for a line being delivered, whose callback may call in
+    log.set_callback(cb, user);
+    ok()
+}
+
 // --------- Connection Functions ---------
 
 #[no_mangle]
@@ -617,7 +1647,7 @@ pub extern "C" fn lk_connect_with_role(
     });
 
     match res {
-        Ok((room, mut events)) => {
+        Ok((room, events)) => {
             g.role = role_copy;
             let client_arc = c.0.clone();
             lk_log!(g, LkLogLevel::Info, "Connected. role={:?} auto_subscribe={}", role_copy, !matches!(role_copy, LkRole::Publisher));
@@ -628,312 +1658,844 @@ pub extern "C" fn lk_connect_with_role(
             }
             
             // Spawn event processor to handle incoming data/audio
-            g.rt.spawn(async move {
-                while let Some(ev) = events.recv().await {
-                    match ev {
-                        RoomEvent::ByteStreamOpened { reader, topic, participant_identity: _ } => {
-                            let Some(reader) = reader.take() else { continue; };
-                            // Read all bytes, then invoke callback if set
-                            let bytes_res = reader.read_all().await;
-                            if let Ok(content) = bytes_res {
-                                // Copy to Vec to ensure stable backing memory for callback
-                                let buf: Vec<u8> = content.to_vec();
-                                lk_log_arc!(client_arc, LkLogLevel::Debug, "ByteStreamOpened: received {} bytes on topic '{}'", buf.len(), topic);
-                                let guard_opt = client_arc.lock().ok();
-                                if let Some(guard) = guard_opt {
-                                    // Invoke extended callback with label if set, otherwise fall back to basic callback
-                                    if let Some((cb, user)) = guard.data_cb_ex.as_ref() {
-                                        // Create C string for the topic label
-                                        let topic_cstr = std::ffi::CString::new(topic.as_str()).unwrap_or_else(|_| std::ffi::CString::new("").unwrap());
-                                        // SAFETY: We call user-provided callback with stable C string and buffer
-                                        // Note: Reliability defaults to Reliable since that's the safe default and
-                                        // LiveKit's ByteStreamOpened event doesn't provide explicit reliability info
-                                        cb(user.0, topic_cstr.as_ptr(), LkReliability::Reliable, buf.as_ptr(), buf.len());
-                                    } else if let Some((cb, user)) = guard.data_cb.as_ref() {
-                                        // SAFETY: We call user-provided callback synchronously with stable buffer
-                                        cb(user.0, buf.as_ptr(), buf.len());
-                                    }
-                                }
-                                drop(buf);
-                            }
-                        }
-                        RoomEvent::Disconnected { reason } => {
-                            lk_log_arc!(client_arc, LkLogLevel::Info, "Disconnected event: reason={:?}", reason);
-                            let guard_opt = client_arc.lock().ok();
-                            if let Some(guard) = guard_opt {
-                                if let Some((cb, user)) = guard.connection_cb.as_ref() {
-                                    let msg = CString::new(format!("{:?}", reason)).unwrap_or_default();
-                                    cb(user.0, LkConnectionState::Disconnected, 0, msg.as_ptr());
-                                }
-                            }
-                        }
-                        RoomEvent::ConnectionStateChanged(state) => {
-                            lk_log_arc!(client_arc, LkLogLevel::Debug, "ConnectionStateChanged: {:?}", state);
-                            let guard_opt = client_arc.lock().ok();
-                            if let Some(guard) = guard_opt {
-                                if let Some((cb, user)) = guard.connection_cb.as_ref() {
-                                    let lk_state = match state {
-                                        livekit::ConnectionState::Disconnected => LkConnectionState::Disconnected,
-                                        livekit::ConnectionState::Connected => LkConnectionState::Connected,
-                                        livekit::ConnectionState::Reconnecting => LkConnectionState::Reconnecting,
-                                    };
-                                    cb(user.0, lk_state, 0, ptr::null());
-                                }
-                            }
-                        }
-                        RoomEvent::TrackSubscribed { track, publication, participant } => {
-                            // Remote audio subscribed - set up a NativeAudioStream and forward frames to audio callback
-                            if let RemoteTrack::Audio(audio) = track {
-                                lk_log_arc!(client_arc, LkLogLevel::Info, "TrackSubscribed audio: name='{}', sid='{}', participant='{}'", publication.name(), publication.sid(), participant.identity());
-                                // Extract underlying RTC track to build a stream reader
-                                let rtc = audio.rtc_track();
-                                let client_arc2 = client_arc.clone();
-                                let track_name = publication.name().to_string();
-                                let participant_name = participant.identity().to_string();
-
-                                // Use configured audio output format
-                                let (sample_rate, channels) = {
-                                    let guard_opt = client_arc.lock().ok();
-                                    if let Some(guard) = guard_opt {
-                                        (guard.audio_output_format.sample_rate as u32, guard.audio_output_format.channels as u32)
-                                    } else {
-                                        (48_000u32, 1u32)
-                                    }
-                                };
-
-                                // Spawn a task to poll audio frames and invoke the user callback synchronously per frame
-                                tokio::spawn(async move {
-                                    let mut stream = NativeAudioStream::new(rtc, sample_rate as i32, channels as i32);
-                                    let mut logged_first = false;
-                                    while let Some(frame) = stream.next().await {
-                                        // Copy to Vec to ensure stable memory for callback
-                                        let buf: Vec<i16> = frame.data.as_ref().to_vec();
-
-                                        if let Ok(guard) = client_arc2.lock() {
-                                            // Try extended callback first, fall back to standard callback
-                                            if let Some((cb, user)) = guard.audio_cb_ex.as_ref() {
-                                                let frames_per_channel = frame.samples_per_channel as usize;
-                                                let ch = frame.num_channels as c_int;
-                                                let sr = frame.sample_rate as c_int;
-                                                let track_name_cstr = CString::new(track_name.as_str()).unwrap_or_default();
-                                                let participant_name_cstr = CString::new(participant_name.as_str()).unwrap_or_default();
-                                                cb(user.0, buf.as_ptr(), frames_per_channel, ch, sr, participant_name_cstr.as_ptr(), track_name_cstr.as_ptr());
-                                            } else if let Some((cb, user)) = guard.audio_cb.as_ref() {
-                                                let frames_per_channel = frame.samples_per_channel as usize;
-                                                let ch = frame.num_channels as c_int;
-                                                let sr = frame.sample_rate as c_int;
-                                                cb(user.0, buf.as_ptr(), frames_per_channel, ch, sr);
-                                            }
-                                        }
-                                        // buf drops after callback returns
-
-                                        if !logged_first {
-                                            lk_log_arc!(client_arc2, LkLogLevel::Debug, "First remote audio frame: sr={}Hz, ch={}, fpc={}", frame.sample_rate, frame.num_channels, frame.samples_per_channel);
-                                            logged_first = true;
-                                        }
-                                    }
-                                });
-                            }
-                        }
-                        other => {
-                            // Trace level catch-all
-                            lk_log_arc!(client_arc, LkLogLevel::Trace, "Event: {:?}", other);
-                        }
-                    }
-                }
-            });
-            g.room = Some(room);
+            register_existing_participants(&mut g, &room);
+            spawn_event_loop(client_arc, events);
+            g.room = Some(Arc::new(room));
             ok()
         }
         Err(e) => err(3, &format!("connect failed: {e}")),
     }
 }
 
-#[no_mangle]
-pub extern "C" fn lk_connect_async(
-    client: *mut LkClientHandle,
-    url: *const c_char,
-    token: *const c_char,
-) -> LkResult {
-    // Default to Both
-    lk_connect_with_role_async(client, url, token, LkRole::Both)
+/// Invoke the registry callback (if set) for a newly interned ID.
+fn announce(g: &ClientState, event: LkRegistryEvent, participant_id: u32, track_id: u32) {
+    let Some((cb, user)) = g.registry_cb.as_ref() else { return; };
+    let identity = g.registry.participant_names.get(&participant_id).map(|c| c.as_ptr()).unwrap_or(ptr::null());
+    if identity.is_null() {
+        return;
+    }
+    let track_name = g.registry.track_info.get(&track_id).map(|(_, n)| n.as_ptr()).unwrap_or(ptr::null());
+    cb(user.0, event, participant_id, track_id, identity, track_name);
 }
 
-#[no_mangle]
-pub extern "C" fn lk_connect_with_role_async(
-    client: *mut LkClientHandle,
-    url: *const c_char,
-    token: *const c_char,
-    role: LkRole,
-) -> LkResult {
-    if client.is_null() {
-        return err(1, "client null");
+/// Intern a participant identity. IDs are stable for the client's lifetime, so a participant
+/// who leaves and rejoins keeps its ID.
+fn intern_participant(g: &mut ClientState, identity: &str) -> u32 {
+    g.registry.participant(identity).0
+}
+
+/// Intern a participant and announce that it joined. Runs on every ParticipantConnected,
+/// rejoins included, so each Left is followed by a Joined when the participant returns.
+fn join_participant(g: &mut ClientState, identity: &str) -> u32 {
+    let id = intern_participant(g, identity);
+    announce(g, LkRegistryEvent::ParticipantJoined, id, 0);
+    id
+}
+
+/// Participants already in the room at connect time are announced as joined.
+fn register_existing_participants(g: &mut ClientState, room: &Room) {
+    for identity in room.remote_participants().keys() {
+        join_participant(g, identity.as_str());
     }
+}
 
-    let url = unsafe { match cstr(url) {
-        Ok(s) => s.to_string(),
-        Err(e) => return err(2, &e.to_string()),
-    }};
-    let token = unsafe { match cstr(token) {
-        Ok(s) => s.to_string(),
-        Err(e) => return err(2, &e.to_string()),
-    }};
+/// True if a topic handler or any catch-all data callback would consume `topic`.
+fn wants_topic(g: &ClientState, topic: &str) -> bool {
+    g.data_handlers.contains_key(topic)
+        || g.data_cb_buffered.is_some()
+        || g.data_cb_from.is_some()
+        || g.data_cb_ex.is_some()
+        || g.data_cb.is_some()
+}
 
-    let c = unsafe { &*(client as *const Client) };
-    let client_arc = c.0.clone();
+/// True if `topic` would be delivered through the buffered callback, which keeps the bytes.
+fn wants_buffered(g: &ClientState, topic: &str) -> bool {
+    g.data_cb_buffered.is_some() && !g.data_handlers.contains_key(topic)
+}
 
-    // Early-out if already connected
-    if let Ok(g) = client_arc.lock() {
-        if g.room.is_some() {
-            return err(104, "already connected");
-        }
-        // Notify connecting state if callback present
-        if let Some((cb, user)) = g.connection_cb.as_ref() {
-            cb(user.0, LkConnectionState::Connecting, 0, ptr::null());
+/// Deliver one raw message. A topic handler takes precedence; otherwise prefer the
+/// buffered callback, then the sender-aware one, then the labelled one, then the basic one.
+/// `bytes` is borrowed for the duration of the call, except by the buffered callback, which
+/// gets a reference to `packet` (the allocation `bytes` points into) or, without one, a copy.
+/// Distinct topics whose C strings are kept for the catch-all callbacks; past this the cache
+/// starts over, so a sender cycling through topics cannot grow it without bound.
+const TOPIC_NAMES_MAX: usize = 256;
+
+fn topic_name<'a>(names: &'a mut HashMap<String, CString>, topic: &str) -> &'a CString {
+    if !names.contains_key(topic) {
+        if names.len() >= TOPIC_NAMES_MAX {
+            names.clear();
         }
+        names.insert(topic.to_string(), CString::new(topic).unwrap_or_default());
     }
+    &names[topic]
+}
 
-    // Spawn the connection attempt without blocking the caller
-    let rt = runtime();
-    rt.spawn(async move {
-        let mut opts = RoomOptions::default();
-        if matches!(role, LkRole::Publisher) { opts.auto_subscribe = false; }
-        let res = Room::connect(&url, &token, opts).await;
-        match res {
-            Ok((room, mut events)) => {
-                // On success, update state and notify
-                if let Ok(mut g) = client_arc.lock() {
-                    g.role = role;
-                    g.room = Some(room);
-                    if let Some((cb, user)) = g.connection_cb.as_ref() {
-                        cb(user.0, LkConnectionState::Connected, 0, ptr::null());
-                    }
-                }
-
-                // Spawn event processing loop (mirrors sync connect)
-                let client_arc2 = client_arc.clone();
-                runtime().spawn(async move {
-                    while let Some(ev) = events.recv().await {
-                        match ev {
-                            RoomEvent::ByteStreamOpened { reader, topic: _, participant_identity: _ } => {
-                                let Some(reader) = reader.take() else { continue; };
-                                if let Ok(content) = reader.read_all().await {
-                                    let buf: Vec<u8> = content.to_vec();
-                                    if let Ok(guard) = client_arc2.lock() {
-                                        lk_log!(guard, LkLogLevel::Debug, "ByteStreamOpened: received {} bytes", buf.len());
-                                        if let Some((cb, user)) = guard.data_cb.as_ref() { cb(user.0, buf.as_ptr(), buf.len()); }
-                                    }
-                                }
-                            }
-                            RoomEvent::Disconnected { reason } => {
-                                if let Ok(guard) = client_arc2.lock() {
-                                    if let Some((cb, user)) = guard.connection_cb.as_ref() {
-                                        let msg = CString::new(format!("{:?}", reason)).unwrap_or_default();
-                                        cb(user.0, LkConnectionState::Disconnected, 0, msg.as_ptr());
-                                    }
-                                }
-                            }
-                            RoomEvent::ConnectionStateChanged(state) => {
-                                if let Ok(guard) = client_arc2.lock() {
-                                    if let Some((cb, user)) = guard.connection_cb.as_ref() {
-                                        let lk_state = match state {
-                                            livekit::ConnectionState::Disconnected => LkConnectionState::Disconnected,
-                                            livekit::ConnectionState::Connected => LkConnectionState::Connected,
-                                            livekit::ConnectionState::Reconnecting => LkConnectionState::Reconnecting,
-                                        };
-                                        cb(user.0, lk_state, 0, ptr::null());
-                                    }
-                                }
-                            }
-                            RoomEvent::TrackSubscribed { track, publication, participant } => {
-                                if let RemoteTrack::Audio(audio) = track {
-                                    lk_log_arc!(client_arc2, LkLogLevel::Info, "TrackSubscribed audio: name='{}', sid='{}', participant='{}'", publication.name(), publication.sid(), participant.identity());
-                                    let rtc = audio.rtc_track();
-                                    let client_arc3 = client_arc2.clone();
-                                    let track_name = publication.name().to_string();
-                                    let participant_name = participant.identity().to_string();
-                                    let (sample_rate, channels) = if let Ok(guard) = client_arc2.lock() { (guard.audio_output_format.sample_rate as u32, guard.audio_output_format.channels as u32) } else { (48_000u32, 1u32) };
-                                    tokio::spawn(async move {
-                                        let mut stream = NativeAudioStream::new(rtc, sample_rate as i32, channels as i32);
-                                        let mut logged_first = false;
-                                        while let Some(frame) = stream.next().await {
-                                            let buf: Vec<i16> = frame.data.as_ref().to_vec();
-                                            if let Ok(guard) = client_arc3.lock() {
-                                                // Try extended callback first, fall back to standard callback
-                                                if let Some((cb, user)) = guard.audio_cb_ex.as_ref() {
-                                                    let frames_per_channel = frame.samples_per_channel as usize;
-                                                    let ch = frame.num_channels as c_int;
-                                                    let sr = frame.sample_rate as c_int;
-                                                    let track_name_cstr = CString::new(track_name.as_str()).unwrap_or_default();
-                                                    let participant_name_cstr = CString::new(participant_name.as_str()).unwrap_or_default();
-                                                    cb(user.0, buf.as_ptr(), frames_per_channel, ch, sr, participant_name_cstr.as_ptr(), track_name_cstr.as_ptr());
-                                                } else if let Some((cb, user)) = guard.audio_cb.as_ref() {
-                                                    let frames_per_channel = frame.samples_per_channel as usize;
-                                                    let ch = frame.num_channels as c_int;
-                                                    let sr = frame.sample_rate as c_int;
-                                                    cb(user.0, buf.as_ptr(), frames_per_channel, ch, sr);
-                                                }
-                                            }
-                                            if !logged_first {
-                                                lk_log_arc!(client_arc3, LkLogLevel::Debug, "First remote audio frame: sr={}Hz, ch={}, fpc={}", frame.sample_rate, frame.num_channels, frame.samples_per_channel);
-                                                logged_first = true;
-                                            }
-                                        }
-                                    });
-                                }
-                            }
-                            other => { lk_log_arc!(client_arc2, LkLogLevel::Trace, "Event: {:?}", other); }
-                        }
-                    }
-                });
-            }
-            Err(e) => {
-                if let Ok(guard) = client_arc.lock() {
-                    if let Some((cb, user)) = guard.connection_cb.as_ref() {
-                        let msg = CString::new(format!("{}", e)).unwrap_or_default();
-                        cb(user.0, LkConnectionState::Failed, 1, msg.as_ptr());
-                    }
-                }
-            }
+fn dispatch_data(g: &mut ClientState, participant_id: u32, topic: &str, reliability: LkReliability, bytes: &[u8], packet: Option<&Arc<Vec<u8>>>) {
+    trace_span!("data.dispatch");
+    timed_callback(&g.latency, rx_arrived(), || {
+        if let Some(handler) = g.data_handlers.get(topic) {
+            let info = LkDataMessageInfo { label: handler.label.as_ptr(), participant_id, reliability, sender_time_us: rx_sender_time() };
+            (handler.cb)(handler.user.0, &info, bytes.as_ptr(), bytes.len());
+        } else if let Some((cb, user)) = g.data_cb_buffered.as_ref() {
+            let packet = packet.cloned().unwrap_or_else(|| Arc::new(bytes.to_vec()));
+            let buffer = Box::into_raw(Box::new(LkDataBuffer { _packet: packet }));
+            cb(user.0, participant_id, topic_name(&mut g.topic_names, topic).as_ptr(), reliability, bytes.as_ptr(), bytes.len(), buffer);
+        } else if let Some((cb, user)) = g.data_cb_from.as_ref() {
+            cb(user.0, participant_id, topic_name(&mut g.topic_names, topic).as_ptr(), reliability, bytes.as_ptr(), bytes.len());
+        } else if let Some((cb, user)) = g.data_cb_ex.as_ref() {
+            cb(user.0, topic_name(&mut g.topic_names, topic).as_ptr(), reliability, bytes.as_ptr(), bytes.len());
+        } else if let Some((cb, user)) = g.data_cb.as_ref() {
+            cb(user.0, bytes.as_ptr(), bytes.len());
+        } else {
+            return false;
         }
+        true
     });
-
-    ok()
 }
-#[no_mangle]
-pub extern "C" fn lk_disconnect(client: *mut LkClientHandle) -> LkResult {
-    if client.is_null() {
-        return err(1, "client null");
-    }
-    let c = unsafe { &*(client as *const Client) };
-    let mut g = c.0.lock().unwrap();
 
-    if let Some(room) = g.room.take() {
-        let rt = g.rt.clone();
-        let _ = rt.block_on(async move {
-            let _ = room.close().await; // graceful shutdown
-        });
+/// Run `deliver`, which returns whether it invoked a callback, and if it did record how long
+/// the callback took and how long the message waited since `arrived`.
+fn timed_callback(latency: &Latencies, arrived: Option<Instant>, deliver: impl FnOnce() -> bool) {
+    let started = Instant::now();
+    if deliver() {
+        latency.callback.record(started.elapsed());
+        if let Some(arrived) = arrived {
+            latency.dispatch.record(started.saturating_duration_since(arrived));
+        }
     }
-    lk_log!(g, LkLogLevel::Info, "Disconnected");
-    g.audio_tracks.clear();
-    g.default_audio_track_id = None;
-    ok()
 }
 
-#[no_mangle]
-pub extern "C" fn lk_client_is_ready(client: *mut LkClientHandle) -> c_int {
-    if client.is_null() {
-        return 0;
-    }
-    let c = unsafe { &*(client as *const Client) };
-    let g = c.0.lock().unwrap();
-    if g.room.is_some() { 1 } else { 0 }
+thread_local! {
+    /// Sender time of the message being dispatched on this thread, in the local clock.
+    static RX_SENDER_TIME_US: Cell<i64> = const { Cell::new(0) };
+    /// When the room event carrying the message being dispatched on this thread arrived.
+    static RX_ARRIVED: Cell<Option<Instant>> = const { Cell::new(None) };
 }
 
-fn next_audio_track_id(g: &mut ClientState) -> u64 {
-    let id = g.next_audio_track_id;
-    g.next_audio_track_id = g.next_audio_track_id.wrapping_add(1);
-    if g.next_audio_track_id == 0 {
+fn rx_sender_time() -> i64 {
+    RX_SENDER_TIME_US.with(|t| t.get())
+}
+
+fn rx_arrived() -> Option<Instant> {
+    RX_ARRIVED.with(|t| t.get())
+}
+
+/// Deliver a framed packet received on `lkf:<label>`. Malformed or unknown frames are ignored.
+/// Framed payloads nest at most FEC, then timed, then one other kind. Anything deeper only
+/// comes from a malformed or hostile sender and would recurse without bound.
+fn may_nest(outer: FrameKind, inner: &[u8]) -> bool {
+    match framing::parse_header(inner) {
+        Some((FrameKind::Fec, _)) => false,
+        Some((FrameKind::Timed, _)) => outer == FrameKind::Fec,
+        _ => true,
+    }
+}
+
+fn dispatch_framed(g: &mut ClientState, participant_id: u32, label: &str, reliability: LkReliability, shared: &Arc<Vec<u8>>) {
+    let packet = shared.as_slice();
+    let Some((kind, body)) = framing::parse_header(packet) else {
+        lk_log!(g, LkLogLevel::Debug, "Ignoring malformed framed packet on '{}' ({} bytes)", label, packet.len());
+        return;
+    };
+    match kind {
+        FrameKind::Batch => {
+            if !wants_topic(g, label) {
+                return;
+            }
+            // Split back into the original messages; receivers never see the batch framing
+            for msg in framing::batch_entries(packet, body) {
+                dispatch_data(g, participant_id, label, reliability, msg, Some(shared));
+            }
+        }
+        FrameKind::State => {
+            let Some(handler) = g.state_handlers.get_mut(label) else { return; };
+            let Some((epoch, tick, entries)) = framing::parse_state_body(packet, body) else { return; };
+            if handler.epochs.insert(participant_id, epoch).is_some_and(|prev| prev != epoch) {
+                handler.last_tick.retain(|(p, _), _| *p != participant_id);
+            }
+            let info = LkDataMessageInfo { label: handler.label.as_ptr(), participant_id, reliability, sender_time_us: rx_sender_time() };
+            for (key, bytes) in entries {
+                let last = handler.last_tick.entry((participant_id, key)).or_insert(tick.wrapping_sub(1));
+                if !framing::tick_newer(tick, *last) {
+                    continue; // an older update arriving after a newer one
+                }
+                *last = tick;
+                timed_callback(&g.latency, rx_arrived(), || {
+                    (handler.cb)(handler.user.0, &info, key, bytes.as_ptr(), bytes.len());
+                    true
+                });
+            }
+        }
+        FrameKind::Seq => {
+            let Some((seq, flags, msg)) = framing::parse_seq_body(packet, body) else { return; };
+            let reliable = flags & framing::SEQ_RELIABLE != 0;
+            let verdict = g.seq_windows.entry(participant_id).or_default().accept(seq);
+            // Ack duplicates too: the earlier ack may have been the packet that got lost. A
+            // packet behind the window is not acked, since it may never have been delivered.
+            if reliable && verdict != framing::SeqVerdict::TooOld {
+                queue_ack(g, participant_id, seq);
+            }
+            if verdict != framing::SeqVerdict::New {
+                g.data_stats.duplicates_dropped.fetch_add(1, Ordering::Relaxed);
+                return;
+            }
+            if let Some(last) = g.sequenced_labels.get_mut(label) {
+                let last = last.entry(participant_id).or_insert(seq.wrapping_sub(1));
+                if !framing::tick_newer(seq, *last) {
+                    g.data_stats.stale_dropped.fetch_add(1, Ordering::Relaxed);
+                    return;
+                }
+                *last = seq;
+            }
+            if wants_topic(g, label) {
+                let reliability = if reliable { LkReliability::Reliable } else { LkReliability::Lossy };
+                dispatch_data(g, participant_id, label, reliability, msg, Some(shared));
+            }
+        }
+        FrameKind::Delta => {
+            if !wants_topic(g, label) {
+                return;
+            }
+            let started = Instant::now();
+            let decoders = g.delta_rx.entry(participant_id).or_default();
+            if !decoders.contains_key(label) {
+                decoders.insert(label.to_string(), DeltaDecoder::default());
+            }
+            let Some(decoder) = decoders.get_mut(label) else { return; };
+            let mut frame = Vec::new();
+            let res = decoder.decode(packet, body, &mut frame);
+            let stats = delta_stats_mut(&mut g.delta_stats, label);
+            match res {
+                Ok(()) => {
+                    stats.frames_received += 1;
+                    stats.decode_ns += started.elapsed().as_nanos() as i64;
+                }
+                Err(delta::DecodeError::NoBase) => stats.undecodable_dropped += 1,
+                Err(delta::DecodeError::Malformed) => {
+                    lk_log!(g, LkLogLevel::Debug, "Ignoring malformed delta frame on '{}' ({} bytes)", label, packet.len());
+                }
+            }
+            if res.is_ok() {
+                let frame = Arc::new(frame);
+                dispatch_data(g, participant_id, label, reliability, &frame, Some(&frame));
+            }
+        }
+        FrameKind::Compressed => {
+            if !wants_topic(g, label) {
+                return;
+            }
+            match compress::decompress(packet, body, g.compression.get_mut(label), &mut g.zstd_plain) {
+                Ok(msg) => {
+                    let msg = Arc::new(msg);
+                    dispatch_data(g, participant_id, label, reliability, &msg, Some(&msg));
+                }
+                Err(e) => {
+                    g.data_stats.decompress_failed.fetch_add(1, Ordering::Relaxed);
+                    lk_log!(g, LkLogLevel::Debug, "Dropping compressed message on '{}' ({} bytes): {:?}", label, packet.len(), e);
+                }
+            }
+        }
+        FrameKind::Timed => {
+            let Some((time, flags, inner)) = framing::parse_timed_body(packet, body) else { return; };
+            // Room time maps into the local clock only when both ends are synchronized
+            let local = if flags & framing::TIMED_SYNCED != 0 && g.clock.synced { time.checked_sub(g.clock.offset_us).unwrap_or(0) } else { 0 };
+            if flags & framing::TIMED_FRAMED != 0 && !may_nest(FrameKind::Timed, inner) {
+                lk_log!(g, LkLogLevel::Debug, "Dropping nested timed packet on '{}' ({} bytes)", label, packet.len());
+                return;
+            }
+            let outer = RX_SENDER_TIME_US.with(|t| t.replace(local));
+            if flags & framing::TIMED_FRAMED != 0 {
+                let inner = Arc::new(inner.to_vec());
+                dispatch_framed(g, participant_id, label, reliability, &inner);
+            } else if wants_topic(g, label) {
+                dispatch_data(g, participant_id, label, reliability, inner, Some(shared));
+            }
+            RX_SENDER_TIME_US.with(|t| t.set(outer));
+        }
+        FrameKind::Fec => {
+            let decoders = g.fec_rx.entry(participant_id).or_default();
+            if !decoders.contains_key(label) {
+                decoders.insert(label.to_string(), FecDecoder::default());
+            }
+            let Some(decoder) = decoders.get_mut(label) else { return; };
+            let Some(decoded) = decoder.receive(packet, body) else {
+                lk_log!(g, LkLogLevel::Debug, "Ignoring malformed FEC packet on '{}' ({} bytes)", label, packet.len());
+                return;
+            };
+            g.data_stats.fec_unrecovered.fetch_add(decoded.lost as i64, Ordering::Relaxed);
+            if decoded.duplicate {
+                g.data_stats.duplicates_dropped.fetch_add(1, Ordering::Relaxed);
+            }
+            if let Some((framed, msg)) = decoded.message {
+                if framed && !may_nest(FrameKind::Fec, msg) {
+                    lk_log!(g, LkLogLevel::Debug, "Dropping nested FEC packet on '{}' ({} bytes)", label, packet.len());
+                } else if framed {
+                    dispatch_framed(g, participant_id, label, reliability, &Arc::new(msg.to_vec()));
+                } else if wants_topic(g, label) {
+                    dispatch_data(g, participant_id, label, reliability, msg, Some(shared));
+                }
+            }
+            // Rebuilt from parity once the rest of its group arrived, so usually after later messages
+            if let Some((framed, msg)) = decoded.recovered {
+                g.data_stats.fec_recovered.fetch_add(1, Ordering::Relaxed);
+                let msg = Arc::new(msg);
+                if framed && !may_nest(FrameKind::Fec, &msg) {
+                    lk_log!(g, LkLogLevel::Debug, "Dropping nested FEC message recovered on '{}'", label);
+                } else if framed {
+                    dispatch_framed(g, participant_id, label, reliability, &msg);
+                } else if wants_topic(g, label) {
+                    dispatch_data(g, participant_id, label, reliability, &msg, Some(&msg));
+                }
+            }
+        }
+        FrameKind::Clock => {
+            let received = clock_sync::now_us();
+            let Some((flags, t0, t1, t2)) = framing::parse_clock_body(packet, body) else { return; };
+            let Some(identity) = g.registry.participant_names.get(&participant_id).and_then(|n| n.to_str().ok()).map(str::to_string) else { return; };
+            if flags & framing::CLOCK_PONG == 0 {
+                // Answer every ping, synchronized or not; t2 is read just before publishing
+                let Some(participant) = g.room.as_ref().map(|r| r.local_participant()) else { return; };
+                g.rt.spawn(async move {
+                    let mut pong = Vec::new();
+                    framing::put_clock_pong(&mut pong, t0, received, clock_sync::now_us());
+                    let _ = participant
+                        .publish_data(DataPacket {
+                            payload: pong,
+                            topic: Some(framing::framed_topic(framing::ACK_LABEL)),
+                            reliable: false,
+                            destination_identities: vec![identity.into()],
+                            ..Default::default()
+                        })
+                        .await;
+                });
+            } else if g.clock_reference.as_deref() == Some(identity.as_str()) {
+                let first = !g.clock.synced;
+                if g.clock.add(t0, t1, t2, received) && first {
+                    lk_log!(g, LkLogLevel::Info, "Clock synchronized to '{}': offset {} us, rtt {} us", identity, g.clock.offset_us, g.clock.rtt_us);
+                }
+            }
+        }
+        FrameKind::Ack => {
+            let (Some(state), Some(identity)) = (g.unordered.as_ref(), g.registry.participant_names.get(&participant_id)) else { return; };
+            let Ok(identity) = identity.to_str() else { return; };
+            let mut queues = state.queues.lock().unwrap();
+            for seq in framing::ack_entries(packet, body) {
+                if let Some(entry) = queues.unacked.get_mut(&seq) {
+                    entry.pending.retain(|p| p != identity);
+                    if entry.pending.is_empty() {
+                        queues.unacked.remove(&seq);
+                    }
+                }
+            }
+        }
+    }
+}
+
+fn queue_ack(g: &mut ClientState, participant_id: u32, seq: u32) {
+    let Some(identity) = g.registry.participant_names.get(&participant_id).and_then(|n| n.to_str().ok()).map(str::to_string) else { return; };
+    let Some(state) = unordered_state(g) else { return; };
+    state.queues.lock().unwrap().acks_out.entry(identity).or_default().push(seq);
+}
+
+fn begin_transfer(g: &mut ClientState, outbound: bool) -> (u64, Arc<TransferCtl>) {
+    let id = g.next_transfer_id;
+    g.next_transfer_id += 1;
+    let ctl = Arc::new(TransferCtl { outbound, ..Default::default() });
+    g.transfers.insert(id, ctl.clone());
+    (id, ctl)
+}
+
+fn end_transfer(client: &Mutex<ClientState>, transfer_id: u64, ctl: &TransferCtl) {
+    ctl.finish();
+    if let Ok(mut g) = client.lock() {
+        g.transfers.remove(&transfer_id);
+    }
+}
+
+/// Cancel every in-flight transfer and return the outbound ones, which may still be reading
+/// caller buffers. Wait on them with `wait_transfers` after releasing the client lock.
+fn cancel_transfers(g: &mut ClientState) -> Vec<Arc<TransferCtl>> {
+    let ctls: Vec<Arc<TransferCtl>> = g.transfers.drain().map(|(_, ctl)| ctl).collect();
+    for ctl in &ctls {
+        ctl.cancel();
+    }
+    ctls.into_iter().filter(|ctl| ctl.outbound).collect()
+}
+
+/// Block until every transfer has reported its terminal state. Cancellation abandons pending
+/// writes, so this does not wait on the network.
+fn wait_transfers(ctls: &[Arc<TransferCtl>]) {
+    for ctl in ctls {
+        ctl.wait();
+    }
+}
+
+/// The client's logger, for tasks that hold the client only behind its lock. A poisoned client
+/// gets a quiet one.
+fn logger(client_arc: &Mutex<ClientState>) -> Arc<Logger> {
+    client_arc.lock().map(|g| g.log.clone()).unwrap_or_default()
+}
+
+/// Read one inbound byte stream chunk by chunk. Progressive routes hand every chunk to the
+/// topic's stream handler as it arrives; otherwise chunks are reassembled into a pooled
+/// buffer and delivered once through the normal data dispatch. Reassembly stops with
+/// `Failed` once the stream passes `limit` bytes, whatever length the sender announced.
+async fn receive_stream(
+    client_arc: Arc<Mutex<ClientState>>,
+    mut reader: ByteStreamReader,
+    topic: String,
+    participant_id: u32,
+    transfer_id: u64,
+    ctl: Arc<TransferCtl>,
+    progressive: bool,
+    limit: usize,
+) {
+    let total = reader.info().total_length.unwrap_or(0);
+    let mut buf = if progressive {
+        Vec::new()
+    } else {
+        let mut b = client_arc.lock().ok().and_then(|mut g| g.stream_pool.pop()).unwrap_or_default();
+        b.clear();
+        // The announced length comes from the peer; never reserve more than a pooled buffer
+        b.reserve((total as usize).min(STREAM_POOL_MAX_RETAINED));
+        b
+    };
+    let mut offset = 0u64;
+    let mut state = LkTransferState::Completed;
+    while let Some(chunk) = reader.next().await {
+        if ctl.cancel.load(Ordering::Acquire) {
+            state = LkTransferState::Cancelled;
+            break;
+        }
+        let chunk = match chunk {
+            Ok(c) => c,
+            Err(_) => {
+                state = LkTransferState::Failed;
+                break;
+            }
+        };
+        if progressive {
+            let Ok(guard) = client_arc.lock() else { break; };
+            let Some(handler) = guard.stream_handlers.get(topic.as_str()) else {
+                state = LkTransferState::Cancelled;
+                break;
+            };
+            let info = LkStreamChunkInfo {
+                label: handler.label.as_ptr(),
+                participant_id,
+                transfer_id,
+                offset,
+                total_length: total,
+                state: LkTransferState::InProgress,
+            };
+            (handler.cb)(handler.user.0, &info, chunk.as_ptr(), chunk.len());
+        } else {
+            if buf.len() + chunk.len() > limit {
+                offset += chunk.len() as u64;
+                state = LkTransferState::Failed;
+                break;
+            }
+            buf.extend_from_slice(&chunk);
+        }
+        offset += chunk.len() as u64;
+    }
+    lk_log_to!(logger(&client_arc), LkLogLevel::Debug, "Byte stream on '{}' finished: {} bytes, {:?}", topic, offset, state);
+
+    if let Ok(mut guard) = client_arc.lock() {
+        if progressive {
+            if let Some(handler) = guard.stream_handlers.get(topic.as_str()) {
+                let info = LkStreamChunkInfo {
+                    label: handler.label.as_ptr(),
+                    participant_id,
+                    transfer_id,
+                    offset,
+                    total_length: total,
+                    state,
+                };
+                (handler.cb)(handler.user.0, &info, ptr::null(), 0);
+            }
+        } else {
+            if state == LkTransferState::Completed {
+                // Byte streams are always delivered reliably
+                if wants_buffered(&guard, topic.as_str()) {
+                    // Hand the reassembly buffer itself to the callee instead of pooling it
+                    let packet = Arc::new(std::mem::take(&mut buf));
+                    dispatch_data(&mut guard, participant_id, topic.as_str(), LkReliability::Reliable, &packet, Some(&packet));
+                } else {
+                    dispatch_data(&mut guard, participant_id, topic.as_str(), LkReliability::Reliable, &buf, None);
+                }
+            }
+            if guard.stream_pool.len() < STREAM_POOL_MAX_BUFFERS && buf.capacity() <= STREAM_POOL_MAX_RETAINED {
+                guard.stream_pool.push(buf);
+            }
+        }
+    }
+    end_transfer(&client_arc, transfer_id, &ctl);
+}
+
+fn spawn_event_loop(client_arc: Arc<Mutex<ClientState>>, mut events: tokio::sync::mpsc::UnboundedReceiver<RoomEvent>) {
+    let log = logger(&client_arc);
+    runtime().spawn(async move {
+        while let Some(ev) = events.recv().await {
+            trace_span!("room.event");
+            match ev {
+                RoomEvent::ParticipantConnected(participant) => {
+                    if let Ok(mut guard) = client_arc.lock() {
+                        join_participant(&mut guard, participant.identity().as_str());
+                        // The newcomer can only decode deltas against a keyframe it has seen
+                        for encoder in guard.delta_tx.values_mut() {
+                            encoder.force_keyframe();
+                        }
+                    }
+                }
+                RoomEvent::ParticipantDisconnected(participant) => {
+                    if let Ok(mut guard) = client_arc.lock() {
+                        let identity = participant.identity();
+                        if let Some(id) = guard.registry.participant_ids.get(identity.as_str()).copied() {
+                            announce(&guard, LkRegistryEvent::ParticipantLeft, id, 0);
+                            // A rejoining peer restarts its sequence numbers
+                            guard.seq_windows.remove(&id);
+                            guard.delta_rx.remove(&id);
+                            guard.fec_rx.remove(&id);
+                            for handler in guard.state_handlers.values_mut() {
+                                handler.forget_participant(id);
+                            }
+                            for last in guard.sequenced_labels.values_mut() {
+                                last.remove(&id);
+                            }
+                        }
+                        if let Some(state) = guard.unordered.as_ref() {
+                            let mut queues = state.queues.lock().unwrap();
+                            queues.acks_out.remove(identity.as_str());
+                            queues.unacked.retain(|_, entry| {
+                                entry.pending.retain(|p| p != identity.as_str());
+                                !entry.pending.is_empty()
+                            });
+                        }
+                    }
+                }
+                RoomEvent::ByteStreamOpened { reader, topic, participant_identity } => {
+                    // Route on the topic before reading: streams nobody listens to are dropped
+                    // without copying or allocating anything.
+                    let route = match client_arc.lock() {
+                        Ok(mut guard) => {
+                            if guard.stream_handlers.contains_key(topic.as_str()) {
+                                let participant_id = intern_participant(&mut guard, participant_identity.as_str());
+                                Some((true, participant_id, begin_transfer(&mut guard, false)))
+                            } else if wants_topic(&guard, topic.as_str()) {
+                                let participant_id = intern_participant(&mut guard, participant_identity.as_str());
+                                Some((false, participant_id, begin_transfer(&mut guard, false)))
+                            } else {
+                                None
+                            }
+                        }
+                        Err(_) => None,
+                    };
+                    let Some((progressive, participant_id, (transfer_id, ctl))) = route else { continue; };
+                    let Some(reader) = reader.take() else { continue; };
+                    let total = reader.info().total_length.unwrap_or(0);
+                    // Large, progressive or unsized transfers read on their own task so they never
+                    // stall room events; small ones stay inline to keep message order, and stop
+                    // at RELIABLE_MAX in case the sender understated the length.
+                    let inline = !progressive && total != 0 && total as usize <= framing::RELIABLE_MAX;
+                    let limit = if inline { framing::RELIABLE_MAX } else { STREAM_REASSEMBLY_MAX };
+                    let task = receive_stream(client_arc.clone(), reader, topic, participant_id, transfer_id, ctl, progressive, limit);
+                    if inline {
+                        task.await;
+                    } else {
+                        runtime().spawn(task);
+                    }
+                }
+                RoomEvent::DataReceived { payload, topic, kind, participant } => {
+                    trace_span!("data.receive");
+                    RX_ARRIVED.with(|t| t.set(Some(Instant::now())));
+                    let topic = topic.as_deref().unwrap_or("");
+                    let reliability = match kind {
+                        DataPacketKind::Reliable => LkReliability::Reliable,
+                        DataPacketKind::Lossy => LkReliability::Lossy,
+                    };
+                    if let Ok(mut guard) = client_arc.lock() {
+                        let participant_id = participant
+                            .map(|p| intern_participant(&mut guard, p.identity().as_str()))
+                            .unwrap_or(0);
+                        if let Some(label) = framing::split_framed_topic(topic) {
+                            dispatch_framed(&mut guard, participant_id, label, reliability, &payload);
+                        } else if wants_topic(&guard, topic) {
+                            dispatch_data(&mut guard, participant_id, topic, reliability, &payload, Some(&payload));
+                        }
+                    }
+                    RX_ARRIVED.with(|t| t.set(None));
+                }
+                RoomEvent::Disconnected { reason } => {
+                    lk_log_to!(log, LkLogLevel::Info, "Disconnected event: reason={:?}", reason);
+                    if let Ok(guard) = client_arc.lock() {
+                        if let Some((cb, user)) = guard.connection_cb.as_ref() {
+                            let msg = CString::new(format!("{:?}", reason)).unwrap_or_default();
+                            cb(user.0, LkConnectionState::Disconnected, 0, msg.as_ptr());
+                        }
+                    }
+                }
+                RoomEvent::ConnectionQualityChanged { quality, participant: Participant::Local(_) } => {
+                    if let Ok(mut guard) = client_arc.lock() {
+                        guard.link_quality = match quality {
+                            ConnectionQuality::Excellent => LkConnectionQuality::Excellent,
+                            ConnectionQuality::Good => LkConnectionQuality::Good,
+                            ConnectionQuality::Poor => LkConnectionQuality::Poor,
+                            ConnectionQuality::Lost => LkConnectionQuality::Lost,
+                        };
+                        guard.link.poor = matches!(quality, ConnectionQuality::Poor | ConnectionQuality::Lost);
+                    }
+                }
+                RoomEvent::ConnectionStateChanged(state) => {
+                    lk_log_to!(log, LkLogLevel::Debug, "ConnectionStateChanged: {:?}", state);
+                    if let Ok(guard) = client_arc.lock() {
+                        if let Some((cb, user)) = guard.connection_cb.as_ref() {
+                            let lk_state = match state {
+                                livekit::ConnectionState::Disconnected => LkConnectionState::Disconnected,
+                                livekit::ConnectionState::Connected => LkConnectionState::Connected,
+                                livekit::ConnectionState::Reconnecting => LkConnectionState::Reconnecting,
+                            };
+                            cb(user.0, lk_state, 0, ptr::null());
+                        }
+                    }
+                }
+                RoomEvent::TrackSubscribed { track, publication, participant } => {
+                    // Remote audio subscribed - set up a NativeAudioStream and forward frames to audio callback
+                    if let RemoteTrack::Audio(audio) = track {
+                        lk_log_to!(log, LkLogLevel::Info, "TrackSubscribed audio: name='{}', sid='{}', participant='{}'", publication.name(), publication.sid(), participant.identity());
+                        // Extract underlying RTC track to build a stream reader
+                        let rtc = audio.rtc_track();
+                        let client_arc2 = client_arc.clone();
+                        let log2 = log.clone();
+
+                        // Intern IDs once and build the C strings once per subscription, not per frame
+                        let track_name = publication.name().to_string();
+                        let participant_name = participant.identity().to_string();
+                        let track_name_cstr = CString::new(track_name.as_str()).unwrap_or_default();
+                        let participant_name_cstr = CString::new(participant_name.as_str()).unwrap_or_default();
+
+                        // Use configured audio output format
+                        let counters = Arc::new(RemoteAudioCounters::default());
+                        let (sample_rate, channels, participant_id, track_id) = {
+                            let guard_opt = client_arc.lock().ok();
+                            if let Some(mut guard) = guard_opt {
+                                let participant_id = intern_participant(&mut guard, &participant_name);
+                                let sid = publication.sid().to_string();
+                                let (track_id, _) = guard.registry.track(&sid, participant_id, &track_name);
+                                guard.remote_audio.insert(track_id, RemoteAudio {
+                                    participant_id,
+                                    counters: counters.clone(),
+                                    samples_received: 0,
+                                    concealed_samples: 0,
+                                    jitter_buffer_ms: 0.0,
+                                    prev_jitter_buffer: (0.0, 0),
+                                });
+                                announce(&guard, LkRegistryEvent::TrackSubscribed, participant_id, track_id);
+                                (guard.audio_output_format.sample_rate as u32, guard.audio_output_format.channels as u32, participant_id, track_id)
+                            } else {
+                                (48_000u32, 1u32, 0, 0)
+                            }
+                        };
+
+                        // Spawn a task to poll audio frames and invoke the user callback synchronously per frame
+                        tokio::spawn(async move {
+                            let mut stream = NativeAudioStream::new(rtc, sample_rate as i32, channels as i32);
+                            let mut logged_first = false;
+                            while let Some(frame) = stream.next().await {
+                                let arrived = Instant::now();
+                                let pcm: &[i16] = frame.data.as_ref();
+                                let frames_per_channel = frame.samples_per_channel as usize;
+                                let ch = frame.num_channels as c_int;
+                                let sr = frame.sample_rate as c_int;
+                                counters.frames.fetch_add(1, Ordering::Relaxed);
+                                counters.last_frame_us.store(clock_sync::now_us(), Ordering::Relaxed);
+                                counters.sample_rate.store(sr, Ordering::Relaxed);
+                                counters.channels.store(ch, Ordering::Relaxed);
+
+                                if let Ok(guard) = client_arc2.lock() {
+                                    trace_span!("audio.callback");
+                                    timed_callback(&guard.latency, Some(arrived), || {
+                                        // Try ID callback first, then extended, then standard
+                                        if let Some((cb, user)) = guard.audio_cb_ids.as_ref() {
+                                            cb(user.0, pcm.as_ptr(), frames_per_channel, ch, sr, participant_id, track_id);
+                                        } else if let Some((cb, user)) = guard.audio_cb_ex.as_ref() {
+                                            cb(user.0, pcm.as_ptr(), frames_per_channel, ch, sr, participant_name_cstr.as_ptr(), track_name_cstr.as_ptr());
+                                        } else if let Some((cb, user)) = guard.audio_cb.as_ref() {
+                                            cb(user.0, pcm.as_ptr(), frames_per_channel, ch, sr);
+                                        } else {
+                                            return false;
+                                        }
+                                        true
+                                    });
+                                }
+
+                                if !logged_first {
+                                    lk_log_to!(log2, LkLogLevel::Debug, "First remote audio frame: sr={}Hz, ch={}, fpc={}", frame.sample_rate, frame.num_channels, frame.samples_per_channel);
+                                    logged_first = true;
+                                }
+                            }
+                        });
+                    }
+                }
+                RoomEvent::TrackUnsubscribed { publication, .. } => {
+                    if let Ok(mut guard) = client_arc.lock() {
+                        let sid = publication.sid().to_string();
+                        if let Some(track_id) = guard.registry.track_ids.get(&sid).copied() {
+                            guard.remote_audio.remove(&track_id);
+                            let participant_id = guard.registry.track_info.get(&track_id).map(|(p, _)| *p).unwrap_or(0);
+                            announce(&guard, LkRegistryEvent::TrackUnsubscribed, participant_id, track_id);
+                        }
+                    }
+                }
+                other => {
+                    // Trace level catch-all
+                    lk_log_to!(log, LkLogLevel::Trace, "Event: {:?}", other);
+                }
+            }
+        }
+    });
+}
+
+#[no_mangle]
+pub extern "C" fn lk_connect_async(
+    client: *mut LkClientHandle,
+    url: *const c_char,
+    token: *const c_char,
+) -> LkResult {
+    // Default to Both
+    lk_connect_with_role_async(client, url, token, LkRole::Both)
+}
+
+#[no_mangle]
+pub extern "C" fn lk_connect_with_role_async(
+    client: *mut LkClientHandle,
+    url: *const c_char,
+    token: *const c_char,
+    role: LkRole,
+) -> LkResult {
+    if client.is_null() {
+        return err(1, "client null");
+    }
+
+    let url = unsafe { match cstr(url) {
+        Ok(s) => s.to_string(),
+        Err(e) => return err(2, &e.to_string()),
+    }};
+    let token = unsafe { match cstr(token) {
+        Ok(s) => s.to_string(),
+        Err(e) => return err(2, &e.to_string()),
+    }};
+
+    let c = unsafe { &*(client as *const Client) };
+    let client_arc = c.0.clone();
+
+    // Early-out if already connected
+    if let Ok(g) = client_arc.lock() {
+        if g.room.is_some() {
+            return err(104, "already connected");
+        }
+        // Notify connecting state if callback present
+        if let Some((cb, user)) = g.connection_cb.as_ref() {
+            cb(user.0, LkConnectionState::Connecting, 0, ptr::null());
+        }
+    }
+
+    // Spawn the connection attempt without blocking the caller
+    let rt = runtime();
+    rt.spawn(async move {
+        let mut opts = RoomOptions::default();
+        if matches!(role, LkRole::Publisher) { opts.auto_subscribe = false; }
+        let res = Room::connect(&url, &token, opts).await;
+        match res {
+            Ok((room, events)) => {
+                // On success, update state and notify
+                if let Ok(mut g) = client_arc.lock() {
+                    g.role = role;
+                    register_existing_participants(&mut g, &room);
+                    g.room = Some(Arc::new(room));
+                    if let Some((cb, user)) = g.connection_cb.as_ref() {
+                        cb(user.0, LkConnectionState::Connected, 0, ptr::null());
+                    }
+                }
+
+                // Spawn event processing loop (shared with sync connect)
+                spawn_event_loop(client_arc, events);
+            }
+            Err(e) => {
+                if let Ok(guard) = client_arc.lock() {
+                    if let Some((cb, user)) = guard.connection_cb.as_ref() {
+                        let msg = CString::new(format!("{}", e)).unwrap_or_default();
+                        cb(user.0, LkConnectionState::Failed, 1, msg.as_ptr());
+                    }
+                }
+            }
+        }
+    });
+
+    ok()
+}
+#[no_mangle]
+pub extern "C" fn lk_disconnect(client: *mut LkClientHandle) -> LkResult {
+    if client.is_null() {
+        return err(1, "client null");
+    }
+    let c = unsafe { &*(client as *const Client) };
+    let mut g = c.0.lock().unwrap();
+    let pending = cancel_transfers(&mut g);
+
+    if let Some(room) = g.room.take() {
+        let rt = g.rt.clone();
+        let _ = rt.block_on(async move {
+            let _ = room.close().await; // graceful shutdown
+        });
+    }
+    lk_log!(g, LkLogLevel::Info, "Disconnected");
+    g.audio_tracks.clear();
+    g.default_audio_track_id = None;
+    g.state_channels.clear();
+    g.unordered = None;
+    // Queued owned buffers are released after the lock, like in send_data
+    let send_queue = g.send_queue.take();
+    g.queued_labels.clear();
+    g.seq_windows.clear();
+    g.delta_rx.clear();
+    g.fec_rx.clear();
+    for handler in g.state_handlers.values_mut() {
+        handler.last_tick.clear();
+        handler.epochs.clear();
+    }
+    g.link = LinkEstimate::default();
+    g.link_quality = LkConnectionQuality::Unknown;
+    g.rtc_stats.reset();
+    g.remote_audio.clear();
+    // The next room may have a different reference: start over from the local clock
+    g.clock = ClockEstimator::default();
+    g.clock_reference = None;
+    for encoder in g.delta_tx.values_mut() {
+        encoder.force_keyframe();
+    }
+    drop(g);
+    drop(send_queue);
+    // Outbound transfers finish on the runtime and need the client lock to unregister
+    wait_transfers(&pending);
+    ok()
+}
+
+#[no_mangle]
+pub extern "C" fn lk_client_is_ready(client: *mut LkClientHandle) -> c_int {
+    if client.is_null() {
+        return 0;
+    }
+    let c = unsafe { &*(client as *const Client) };
+    let g = c.0.lock().unwrap();
+    if g.room.is_some() { 1 } else { 0 }
+}
+
+fn next_audio_track_id(g: &mut ClientState) -> u64 {
+    let id = g.next_audio_track_id;
+    g.next_audio_track_id = g.next_audio_track_id.wrapping_add(1);
+    if g.next_audio_track_id == 0 {
         g.next_audio_track_id = 1;
     }
     id
@@ -1030,27 +2592,33 @@ fn create_audio_pipeline(
         .max(samples_per_10ms as usize * channels as usize)
         .max(1);
     let (prod, mut cons) = RingBuffer::<i16>::new(capacity_samples);
+    let (marks, mut marks_cons) = RingBuffer::<(u64, Instant)>::new(AUDIO_MARKS);
     let frame_samples = ((sample_rate as usize / 100) * channels as usize).max(1);
     let underruns = Arc::new(AtomicI32::new(0));
     let overruns = Arc::new(AtomicI32::new(0));
     let underruns_clone = underruns.clone();
     let src_clone = src.clone();
     let consumer_rt = g.rt.clone();
+    let latency = g.latency.clone();
 
     let worker = consumer_rt.spawn(async move {
         let mut tick = interval(Duration::from_millis(10));
         let mut buf: Vec<i16> = vec![0; frame_samples];
+        let mut popped_samples = 0u64;
         loop {
             tick.tick().await;
 
             let mut got = 0usize;
-            while got < buf.len() {
-                match cons.pop() {
-                    Ok(s) => {
-                        buf[got] = s;
-                        got += 1;
+            {
+                trace_span!("audio.ring_pop");
+                while got < buf.len() {
+                    match cons.pop() {
+                        Ok(s) => {
+                            buf[got] = s;
+                            got += 1;
+                        }
+                        Err(_) => break,
                     }
-                    Err(_) => break,
                 }
             }
             if got < buf.len() {
@@ -1060,6 +2628,17 @@ fn create_audio_pipeline(
                 }
             }
 
+            // Every push whose last sample is in this frame has now left the ring
+            popped_samples += got as u64;
+            let now = Instant::now();
+            while let Ok(&(end, pushed_at)) = marks_cons.peek() {
+                if end > popped_samples {
+                    break;
+                }
+                latency.audio_ring.record(now.saturating_duration_since(pushed_at));
+                let _ = marks_cons.pop();
+            }
+
             let samples_per_channel = (buf.len() as u32) / safe_channels_for_worker;
             let frame = AudioFrame {
                 data: Cow::Borrowed(&buf[..]),
@@ -1067,6 +2646,7 @@ fn create_audio_pipeline(
                 num_channels: channels,
                 samples_per_channel,
             };
+            trace_span!("audio.capture_frame");
             let _ = src_clone.capture_frame(&frame).await;
         }
     });
@@ -1076,6 +2656,10 @@ fn create_audio_pipeline(
         capacity_frames: (capacity_samples / (safe_channels as usize)).max(1),
         underruns,
         overruns,
+        high_water_frames: 0,
+        last_push_us: 0,
+        marks,
+        pushed_samples: 0,
     };
 
     Ok(AudioPipeline {
@@ -1125,151 +2709,2399 @@ pub extern "C" fn lk_publish_audio_pcm_i16(
         }
     };
 
-    let total = frames_per_channel * channels as usize;
-    let slice = unsafe { std::slice::from_raw_parts(pcm, total) };
+    let total = frames_per_channel * channels as usize;
+    let slice = unsafe { std::slice::from_raw_parts(pcm, total) };
+
+    match g.audio_tracks.get_mut(&track_id) {
+        Some(pipeline) => {
+            if let Err(e) = pipeline.push(slice) {
+                let msg = format!("audio ring push failed: {}", e);
+                lk_log!(g, LkLogLevel::Error, "{}", msg);
+                return err(8, &msg);
+            }
+        }
+        None => {
+            let msg = "audio pipeline disappeared";
+            lk_log!(g, LkLogLevel::Error, "{}", msg);
+            return err(8, msg);
+        }
+    }
+
+    ok()
+}
+
+#[no_mangle]
+pub extern "C" fn lk_audio_track_create(
+    client: *mut LkClientHandle,
+    config: *const LkAudioTrackConfig,
+    out_track: *mut *mut LkAudioTrackHandle,
+) -> LkResult {
+    if client.is_null() {
+        return err(1, "client null");
+    }
+    if config.is_null() {
+        return err(5, "config null");
+    }
+    if out_track.is_null() {
+        return err(5, "out_track null");
+    }
+
+    let cfg = unsafe { &*config };
+    if cfg.sample_rate <= 0 || cfg.channels <= 0 {
+        return err(5, "invalid audio track parameters");
+    }
+
+    let label = if cfg.track_name.is_null() {
+        "ue-audio-track"
+    } else {
+        match unsafe { cstr(cfg.track_name) } {
+            Ok(s) => s,
+            Err(_) => "ue-audio-track",
+        }
+    };
+    let buffer_ms = if cfg.buffer_ms <= 0 { 1_000 } else { cfg.buffer_ms };
+
+    let c = unsafe { &*(client as *const Client) };
+    let mut g = c.0.lock().unwrap();
+    let track_id = match register_audio_pipeline(
+        &mut g,
+        label,
+        cfg.sample_rate as u32,
+        cfg.channels as u32,
+        buffer_ms as u32,
+    ) {
+        Ok(id) => id,
+        Err(e) => {
+            let msg = format!("audio track create failed: {}", e);
+            return err(7, &msg);
+        }
+    };
+
+    let handle = Box::new(LkAudioTrackHandle(AudioTrackHandleRef {
+        client: c.0.clone(),
+        track_id,
+    }));
+    unsafe {
+        *out_track = Box::into_raw(handle);
+    }
+    ok()
+}
+
+#[no_mangle]
+pub extern "C" fn lk_audio_track_destroy(track: *mut LkAudioTrackHandle) -> LkResult {
+    if track.is_null() {
+        return err(1, "track null");
+    }
+    unsafe {
+        let handle = Box::from_raw(track);
+        let client = handle.0.client.clone();
+        let track_id = handle.0.track_id;
+        drop(handle);
+
+        let mut g = client.lock().unwrap();
+        let _ = g.audio_tracks.remove(&track_id);
+        if g.default_audio_track_id == Some(track_id) {
+            g.default_audio_track_id = None;
+        }
+    }
+    ok()
+}
+
+#[no_mangle]
+pub extern "C" fn lk_audio_track_publish_pcm_i16(
+    track: *mut LkAudioTrackHandle,
+    pcm: *const i16,
+    frames_per_channel: usize,
+) -> LkResult {
+    if track.is_null() {
+        return err(1, "track null");
+    }
+    if pcm.is_null() {
+        return err(4, "pcm null");
+    }
+    let handle = unsafe { &*(track as *mut LkAudioTrackHandle) };
+    let client = handle.0.client.clone();
+    let mut g = client.lock().unwrap();
+    let pipeline = match g.audio_tracks.get_mut(&handle.0.track_id) {
+        Some(p) => p,
+        None => return err(6, "audio track not found"),
+    };
+    let total = frames_per_channel * pipeline.channels as usize;
+    let slice = unsafe { std::slice::from_raw_parts(pcm, total) };
+    if let Err(e) = pipeline.push(slice) {
+        let msg = format!("audio ring push failed: {}", e);
+        return err(8, &msg);
+    }
+    ok()
+}
+
+#[repr(C)]
+#[derive(Copy, Clone, Debug)]
+pub struct LkAudioTrackStats {
+    /// NUL-terminated, truncated to fit.
+    pub name: [c_char; TRACK_NAME_LEN],
+    /// 0 for a track this client publishes, 1 for a subscribed one.
+    pub remote: c_int,
+    pub sample_rate: c_int,
+    pub channels: c_int,
+    /// Published: audio waiting in the ring, its peak since the track was created, and the ring size.
+    pub queued_ms: c_int,
+    pub high_water_ms: c_int,
+    pub capacity_ms: c_int,
+    /// Published: 10 ms frames padded with silence for lack of audio, and pushes cut short by a full ring.
+    pub underruns: c_int,
+    pub overruns: c_int,
+    /// `lk_now_local_us` of the last push (published) or delivered frame (subscribed); 0 if none yet.
+    pub last_frame_us: i64,
+    /// Subscribed: registry IDs, as passed to the audio callback.
+    pub participant_id: u32,
+    pub track_id: u32,
+    /// Subscribed: frames delivered to the audio callback.
+    pub frames_received: i64,
+    /// Subscribed, from the last stats poll: samples played out and those WebRTC synthesized
+    /// to conceal loss, and the jitter buffer's average delay over the last poll interval.
+    pub samples_received: i64,
+    pub concealed_samples: i64,
+    pub jitter_buffer_ms: c_float,
+}
+
+impl Default for LkAudioTrackStats {
+    fn default() -> Self {
+        Self {
+            name: [0; TRACK_NAME_LEN],
+            remote: 0,
+            sample_rate: 0,
+            channels: 0,
+            queued_ms: 0,
+            high_water_ms: 0,
+            capacity_ms: 0,
+            underruns: 0,
+            overruns: 0,
+            last_frame_us: 0,
+            participant_id: 0,
+            track_id: 0,
+            frames_received: 0,
+            samples_received: 0,
+            concealed_samples: 0,
+            jitter_buffer_ms: 0.0,
+        }
+    }
+}
+
+fn local_audio_stats(p: &AudioPipeline) -> LkAudioTrackStats {
+    let ms = |frames: usize| (frames as u64 * 1000 / p.sample_rate.max(1) as u64).min(c_int::MAX as u64) as c_int;
+    let mut s = LkAudioTrackStats {
+        sample_rate: p.sample_rate as c_int,
+        channels: p.channels as c_int,
+        queued_ms: ms(p.ring.queued_frames(p.channels)),
+        high_water_ms: ms(p.ring.high_water_frames),
+        capacity_ms: ms(p.ring.capacity_frames),
+        underruns: p.ring.underruns.load(Ordering::Relaxed),
+        overruns: p.ring.overruns.load(Ordering::Relaxed),
+        last_frame_us: p.ring.last_push_us,
+        ..Default::default()
+    };
+    copy_name(&mut s.name, p.label.as_bytes());
+    s
+}
+
+fn remote_audio_stats(g: &ClientState, track_id: u32, a: &RemoteAudio) -> LkAudioTrackStats {
+    let mut s = LkAudioTrackStats {
+        remote: 1,
+        sample_rate: a.counters.sample_rate.load(Ordering::Relaxed),
+        channels: a.counters.channels.load(Ordering::Relaxed),
+        last_frame_us: a.counters.last_frame_us.load(Ordering::Relaxed),
+        participant_id: a.participant_id,
+        track_id,
+        frames_received: a.counters.frames.load(Ordering::Relaxed),
+        samples_received: a.samples_received,
+        concealed_samples: a.concealed_samples,
+        jitter_buffer_ms: a.jitter_buffer_ms as c_float,
+        ..Default::default()
+    };
+    if let Some((_, name)) = g.registry.track_info.get(&track_id) {
+        copy_name(&mut s.name, name.as_bytes());
+    }
+    s
+}
+
+/// Ring state of one published track.
+///
+/// # Safety
+/// `track` must be a live handle; `out_stats` must be valid for writes.
+#[no_mangle]
+pub unsafe extern "C" fn lk_audio_track_get_stats(track: *mut LkAudioTrackHandle, out_stats: *mut LkAudioTrackStats) -> LkResult {
+    if track.is_null() { return err(1, "track null"); }
+    if out_stats.is_null() { return err(4, "out_stats null"); }
+    let handle = &*(track as *const LkAudioTrackHandle);
+    let g = handle.0.client.lock().unwrap();
+    match g.audio_tracks.get(&handle.0.track_id) {
+        Some(p) => {
+            *out_stats = local_audio_stats(p);
+            ok()
+        }
+        None => err(6, "audio track not found"),
+    }
+}
+
+/// Every audio track: published ones (including the default track) first, then subscribed
+/// ones. Writes at most `capacity` entries; `out_count` gets the number available. Starts the
+/// stats poll that fills in the subscribed tracks' concealment and jitter buffer figures.
+///
+/// # Safety
+/// `out_tracks` must be valid for `capacity` writes (NULL if 0); `out_count` must be valid.
+#[no_mangle]
+pub unsafe extern "C" fn lk_get_audio_track_stats(
+    client: *mut LkClientHandle,
+    out_tracks: *mut LkAudioTrackStats,
+    capacity: usize,
+    out_count: *mut usize,
+) -> LkResult {
+    if client.is_null() { return err(1, "client null"); }
+    if out_count.is_null() || (out_tracks.is_null() && capacity > 0) { return err(4, "null pointer"); }
+    let c = &*(client as *const Client);
+    let mut g = c.0.lock().unwrap();
+    request_rtc_stats(&mut g, &c.0);
+    let mut ids: Vec<u64> = g.audio_tracks.keys().copied().collect();
+    ids.sort_unstable();
+    let mut remote: Vec<u32> = g.remote_audio.keys().copied().collect();
+    remote.sort_unstable();
+    let out: &mut [LkAudioTrackStats] = if out_tracks.is_null() { &mut [] } else { std::slice::from_raw_parts_mut(out_tracks, capacity) };
+    let mut n = 0usize;
+    for id in &ids {
+        if let (Some(slot), Some(p)) = (out.get_mut(n), g.audio_tracks.get(id)) {
+            *slot = local_audio_stats(p);
+        }
+        n += 1;
+    }
+    for id in &remote {
+        if let (Some(slot), Some(a)) = (out.get_mut(n), g.remote_audio.get(id)) {
+            *slot = remote_audio_stats(&g, *id, a);
+        }
+        n += 1;
+    }
+    *out_count = n;
+    ok()
+}
+
+// --------- Keyed state channels ---------
+
+/// A fresh epoch for a new state channel. RandomState is seeded per process and stepped per
+/// call, so channels created in turn, or by a restarted sender, get different epochs.
+fn new_state_epoch() -> u32 {
+    use std::hash::{BuildHasher, Hasher};
+    let mut h = std::collections::hash_map::RandomState::new().build_hasher();
+    h.write_i64(clock_sync::now_us());
+    h.finish() as u32
+}
+
+fn spawn_state_scheduler(rt: &Runtime, participant: LocalParticipant, channel: Arc<StateChannel>, tick_hz: u32) -> JoinHandle<()> {
+    rt.spawn(async move {
+        let mut tick = interval(Duration::from_micros(1_000_000 / tick_hz as u64));
+        tick.set_missed_tick_behavior(tokio::time::MissedTickBehavior::Skip);
+        let mut tick_no: u32 = 0;
+        loop {
+            tick.tick().await;
+            tick_no = tick_no.wrapping_add(1);
+            let (packets, updates) = channel.collect(tick_no);
+            if packets.is_empty() {
+                continue;
+            }
+            channel.updates_sent.fetch_add(updates, Ordering::Relaxed);
+            // While a publish is in flight, writers keep overwriting slots, so a slow link
+            // sees fewer, fresher updates instead of a growing queue.
+            for payload in packets {
+                let len = payload.len() as i64;
+                let packet = DataPacket {
+                    payload,
+                    topic: Some(channel.topic.clone()),
+                    reliable: channel.reliable,
+                    ..Default::default()
+                };
+                match participant.publish_data(packet).await {
+                    Ok(_) => {
+                        channel.packets_sent.fetch_add(1, Ordering::Relaxed);
+                        channel.bytes_sent.fetch_add(len, Ordering::Relaxed);
+                    }
+                    Err(_) => {
+                        channel.packets_dropped.fetch_add(1, Ordering::Relaxed);
+                    }
+                }
+            }
+        }
+    })
+}
+
+/// # Safety
+/// `config` must point to a valid config; `out_channel` must be writable.
+#[no_mangle]
+pub unsafe extern "C" fn lk_state_channel_create(
+    client: *mut LkClientHandle,
+    config: *const LkStateChannelConfig,
+    out_channel: *mut *mut LkStateChannelHandle,
+) -> LkResult {
+    if client.is_null() {
+        return err(1, "client null");
+    }
+    if config.is_null() || out_channel.is_null() {
+        return err(4, "config or out_channel null");
+    }
+    let cfg = &*config;
+    let label = match cstr(cfg.label) {
+        Ok(s) if !s.is_empty() => s,
+        Ok(_) => return err(5, "label empty"),
+        Err(e) => return err(2, &format!("label: {e}")),
+    };
+    let reliable = matches!(cfg.reliability, LkReliability::Reliable);
+    let limit = if reliable { framing::RELIABLE_MAX } else { framing::LOSSY_MTU };
+    let max_packet = if cfg.max_packet_bytes <= 0 { framing::LOSSY_MTU } else { (cfg.max_packet_bytes as usize).min(limit) };
+    if max_packet <= framing::state_packet_overhead(u32::MAX, u32::MAX) {
+        return err(5, "max_packet_bytes too small");
+    }
+    let tick_hz = if cfg.tick_hz <= 0 { 60 } else { cfg.tick_hz.min(1_000) as u32 };
+
+    let c = &*(client as *const Client);
+    let mut g = c.0.lock().unwrap();
+    let participant = match g.room.as_ref() {
+        Some(room) => room.local_participant(),
+        None => return err(6, "not connected"),
+    };
+    let channel = Arc::new(StateChannel {
+        label: label.to_string(),
+        topic: framing::framed_topic(label),
+        epoch: new_state_epoch(),
+        reliable,
+        max_packet,
+        closed: AtomicBool::new(false),
+        slots: Mutex::new(BTreeMap::new()),
+        updates_written: AtomicI64::new(0),
+        updates_superseded: AtomicI64::new(0),
+        updates_sent: AtomicI64::new(0),
+        packets_sent: AtomicI64::new(0),
+        bytes_sent: AtomicI64::new(0),
+        packets_dropped: AtomicI64::new(0),
+    });
+    let worker = spawn_state_scheduler(&g.rt, participant, channel.clone(), tick_hz);
+    let channel_id = g.next_state_channel_id;
+    g.next_state_channel_id += 1;
+    g.state_channels.insert(channel_id, StateChannelWorker { channel: channel.clone(), worker });
+    lk_log!(g, LkLogLevel::Info, "Created state channel '{}' (reliable={}, {} Hz, packet<={} bytes)", label, reliable, tick_hz, max_packet);
+
+    *out_channel = Box::into_raw(Box::new(LkStateChannelHandle(StateChannelHandleRef {
+        client: c.0.clone(),
+        channel_id,
+        channel,
+    })));
+    ok()
+}
+
+#[no_mangle]
+pub extern "C" fn lk_state_channel_destroy(channel: *mut LkStateChannelHandle) -> LkResult {
+    if channel.is_null() {
+        return err(1, "channel null");
+    }
+    let handle = unsafe { Box::from_raw(channel) };
+    let mut g = handle.0.client.lock().unwrap();
+    g.state_channels.remove(&handle.0.channel_id);
+    ok()
+}
+
+/// Store the newest value for `key`. Never blocks on the network; the value is sent on
+/// the channel's next tick unless a later write for the same key replaces it first.
+///
+/// # Safety
+/// `bytes` must point to `len` readable bytes.
+#[no_mangle]
+pub unsafe extern "C" fn lk_state_channel_write(
+    channel: *mut LkStateChannelHandle,
+    key: u32,
+    bytes: *const u8,
+    len: usize,
+) -> LkResult {
+    if channel.is_null() {
+        return err(1, "channel null");
+    }
+    if bytes.is_null() && len > 0 {
+        return err(4, "bytes null");
+    }
+    let ch = &(*channel).0.channel;
+    if ch.closed.load(Ordering::Acquire) {
+        return err(6, "state channel closed");
+    }
+    if framing::state_packet_overhead(u32::MAX, u32::MAX) + framing::state_entry_len(key, len) > ch.max_packet {
+        return err(5, &format!("state value of {} bytes does not fit a {} byte packet on '{}'", len, ch.max_packet, ch.label));
+    }
+    let slice = if len == 0 { &[][..] } else { std::slice::from_raw_parts(bytes, len) };
+    ch.write(key, slice);
+    ok()
+}
+
+/// # Safety
+/// `out_stats` must point to writable memory.
+#[no_mangle]
+pub unsafe extern "C" fn lk_state_channel_get_stats(
+    channel: *mut LkStateChannelHandle,
+    out_stats: *mut LkStateChannelStats,
+) -> LkResult {
+    if channel.is_null() {
+        return err(1, "channel null");
+    }
+    if out_stats.is_null() {
+        return err(4, "out_stats null");
+    }
+    *out_stats = (*channel).0.channel.stats();
+    ok()
+}
+
+/// Register `cb` for keyed updates arriving on state channel `label`. Only values newer than
+/// the last one delivered for the same (sender, key) are passed on. NULL `cb` removes it.
+///
+/// # Safety
+/// `label` must be a valid NUL-terminated UTF-8 string.
+#[no_mangle]
+pub unsafe extern "C" fn lk_register_state_handler(
+    client: *mut LkClientHandle,
+    label: *const c_char,
+    cb: Option<extern "C" fn(user: *mut c_void, info: *const LkDataMessageInfo, key: u32, bytes: *const u8, len: usize)>,
+    user: *mut c_void,
+) -> LkResult {
+    if client.is_null() { return err(1, "client null"); }
+    let label = match cstr(label) {
+        Ok(s) if !s.is_empty() => s.to_string(),
+        Ok(_) => return err(5, "label empty"),
+        Err(e) => return err(2, &format!("label: {e}")),
+    };
+    let c = &*(client as *const Client);
+    let mut g = c.0.lock().unwrap();
+    match cb {
+        Some(cb) => {
+            let cl = CString::new(label.as_str()).unwrap_or_default();
+            g.state_handlers.insert(label, StateHandler { label: cl, cb, user: UserPtr(user), last_tick: HashMap::new(), epochs: HashMap::new() });
+        }
+        None => {
+            g.state_handlers.remove(&label);
+        }
+    }
+    ok()
+}
+
+// --------- Large payload transfers ---------
+
+/// Slice size handed to the byte stream writer; also the progress granularity.
+const LARGE_CHUNK: usize = 64 * 1024;
+
+/// Stream a large reliable payload straight from caller memory. Returns immediately with the
+/// transfer ID; `cb` reports progress after every chunk and exactly one terminal state.
+/// The buffer must stay valid until that terminal callback.
+///
+/// # Safety
+/// `bytes` must point to `len` readable bytes that outlive the transfer; `label` must be a
+/// valid NUL-terminated string.
+#[no_mangle]
+pub unsafe extern "C" fn lk_send_large(
+    client: *mut LkClientHandle,
+    bytes: *const u8,
+    len: usize,
+    label: *const c_char,
+    cb: Option<extern "C" fn(user: *mut c_void, transfer_id: u64, state: LkTransferState, bytes_done: u64, bytes_total: u64)>,
+    user: *mut c_void,
+    out_transfer_id: *mut u64,
+) -> LkResult {
+    if client.is_null() {
+        return err(1, "client null");
+    }
+    if bytes.is_null() {
+        return err(4, "bytes null");
+    }
+    if len == 0 {
+        return err(5, "len zero");
+    }
+    let Some(cb) = cb else { return err(4, "progress callback required"); };
+    let topic = match cstr(label) {
+        Ok(s) if !s.is_empty() => s.to_string(),
+        Ok(_) => return err(5, "label empty"),
+        Err(e) => return err(2, &format!("label: {e}")),
+    };
+    let c = &*(client as *const Client);
+    let mut g = c.0.lock().unwrap();
+    let participant = match g.room.as_ref() {
+        Some(room) => room.local_participant(),
+        None => return err(6, "not connected"),
+    };
+    let (transfer_id, ctl) = begin_transfer(&mut g, true);
+    if !out_transfer_id.is_null() {
+        *out_transfer_id = transfer_id;
+    }
+    lk_log!(g, LkLogLevel::Info, "Large transfer {} started: {} bytes on '{}'", transfer_id, len, topic);
+
+    let client_weak = Arc::downgrade(&c.0);
+    let stats = g.data_stats.clone();
+    let payload = BorrowedPayload(bytes, len);
+    let user = UserPtr(user);
+    g.rt.spawn(async move {
+        let (payload, user) = (payload, user);
+        let data = payload.as_slice();
+        let total = data.len() as u64;
+        let options = StreamByteOptions { topic, total_length: Some(total), ..Default::default() };
+        let mut done = 0u64;
+        // Every await races cancellation: dropping a pending write stops it reading caller memory
+        let opened = tokio::select! {
+            res = participant.stream_bytes(options) => Some(res),
+            _ = ctl.until_cancelled() => None,
+        };
+        let state = match opened {
+            None => LkTransferState::Cancelled,
+            Some(Ok(writer)) => {
+                let mut state = LkTransferState::Completed;
+                for chunk in data.chunks(LARGE_CHUNK) {
+                    let written = tokio::select! {
+                        res = writer.write(chunk) => Some(res),
+                        _ = ctl.until_cancelled() => None,
+                    };
+                    match written {
+                        None => {
+                            state = LkTransferState::Cancelled;
+                            break;
+                        }
+                        Some(Err(_)) => {
+                            state = LkTransferState::Failed;
+                            break;
+                        }
+                        Some(Ok(_)) => {}
+                    }
+                    done += chunk.len() as u64;
+                    if done < total {
+                        cb(user.0, transfer_id, LkTransferState::InProgress, done, total);
+                    }
+                }
+                if state == LkTransferState::Completed {
+                    state = tokio::select! {
+                        res = writer.close() => if res.is_ok() { state } else { LkTransferState::Failed },
+                        _ = ctl.until_cancelled() => LkTransferState::Cancelled,
+                    };
+                }
+                state
+            }
+            Some(Err(_)) => LkTransferState::Failed,
+        };
+        match state {
+            LkTransferState::Completed => stats.record_sent(true, done as i64),
+            _ => stats.record_dropped(true, 1),
+        }
+        // The buffer is no longer read. Report the terminal state before finishing the
+        // transfer: disconnect and destroy wait on it, and `user` may be freed once they return.
+        cb(user.0, transfer_id, state, done, total);
+        if let Some(client) = client_weak.upgrade() {
+            end_transfer(&client, transfer_id, &ctl);
+        } else {
+            ctl.finish();
+        }
+    });
+    ok()
+}
+
+/// Cancel an in-flight large transfer (sent or received). A pending chunk write is abandoned;
+/// receives stop at the next chunk boundary.
+#[no_mangle]
+pub extern "C" fn lk_cancel_transfer(client: *mut LkClientHandle, transfer_id: u64) -> LkResult {
+    if client.is_null() {
+        return err(1, "client null");
+    }
+    let c = unsafe { &*(client as *const Client) };
+    let g = c.0.lock().unwrap();
+    match g.transfers.get(&transfer_id) {
+        Some(ctl) => {
+            ctl.cancel();
+            ok()
+        }
+        None => err(5, "unknown transfer id"),
+    }
+}
+
+/// Register a progressive handler for byte streams on topic `label`: chunks are delivered as
+/// they arrive instead of after the whole stream is buffered. NULL `cb` removes it.
+///
+/// # Safety
+/// `label` must be a valid NUL-terminated UTF-8 string.
+#[no_mangle]
+pub unsafe extern "C" fn lk_register_stream_handler(
+    client: *mut LkClientHandle,
+    label: *const c_char,
+    cb: Option<extern "C" fn(user: *mut c_void, info: *const LkStreamChunkInfo, bytes: *const u8, len: usize)>,
+    user: *mut c_void,
+) -> LkResult {
+    if client.is_null() { return err(1, "client null"); }
+    let topic = match cstr(label) {
+        Ok(s) if !s.is_empty() => s.to_string(),
+        Ok(_) => return err(5, "label empty"),
+        Err(e) => return err(2, &format!("label: {e}")),
+    };
+    let c = &*(client as *const Client);
+    let mut g = c.0.lock().unwrap();
+    match cb {
+        Some(cb) => {
+            let label = CString::new(topic.as_str()).unwrap_or_default();
+            g.stream_handlers.insert(topic, StreamHandler { label, cb, user: UserPtr(user) });
+        }
+        None => {
+            g.stream_handlers.remove(&topic);
+        }
+    }
+    ok()
+}
+
+// --------- Send queue ---------
+
+/// The client's send queue, started on first use. None when not connected.
+fn send_queue(g: &mut ClientState) -> Option<&SendQueue> {
+    if g.send_queue.is_none() {
+        let participant = g.room.as_ref()?.local_participant();
+        let queue = Arc::new(SendQueue::default());
+        *queue.scheduler.lock().unwrap() = Some(Scheduler::new(g.scheduler_mode, &g.send_classes));
+        let worker = spawn_send_queue_worker(&g.rt, participant, queue.clone(), g.data_stats.clone());
+        g.send_queue = Some(SendQueueWorker { queue, worker });
+    }
+    g.send_queue.as_ref().map(|w| w.queue.as_ref())
+}
+
+fn spawn_send_queue_worker(
+    rt: &Runtime,
+    participant: LocalParticipant,
+    queue: Arc<SendQueue>,
+    stats: Arc<DataStatsCounters>,
+) -> JoinHandle<()> {
+    rt.spawn(async move {
+        loop {
+            // Expiry is checked right before transmission, after any wait behind earlier sends
+            let Some((next, expired)) = queue.with(|s| s.next(Instant::now())) else { return; };
+            stats.expired_dropped.fetch_add(expired.len() as i64, Ordering::Relaxed);
+            // Released here, outside the scheduler lock
+            drop(expired);
+            let msg = match next {
+                scheduler::Next::Send(msg) => msg,
+                scheduler::Next::WaitUntil(at) => {
+                    tokio::select! {
+                        _ = tokio::time::sleep_until(at.into()) => {}
+                        _ = queue.ready.notified() => {}
+                    }
+                    continue;
+                }
+                scheduler::Next::Idle => {
+                    queue.ready.notified().await;
+                    continue;
+                }
+            };
+            trace_span!("data.publish");
+            let len = msg.payload.len() as i64;
+            let enqueued = msg.enqueued;
+            let destination_identities = msg.destinations.into_iter().map(Into::into).collect();
+            let res = match msg.payload {
+                // Caller-owned reliable buffers are written straight from caller memory
+                Payload::Owned(owned) if msg.reliable => {
+                    let options = StreamByteOptions { topic: msg.topic, destination_identities, ..Default::default() };
+                    let bytes: &[u8] = (*owned).as_ref();
+                    match participant.stream_bytes(options).await {
+                        Ok(writer) => match writer.write(bytes).await {
+                            Ok(_) => writer.close().await.map_err(anyhow::Error::from),
+                            Err(e) => Err(anyhow::Error::from(e)),
+                        },
+                        Err(e) => Err(anyhow::Error::from(e)),
+                    }
+                }
+                payload => participant
+                    .publish_data(DataPacket {
+                        payload: payload.into_vec(),
+                        topic: Some(msg.topic),
+                        reliable: msg.reliable,
+                        destination_identities,
+                        ..Default::default()
+                    })
+                    .await
+                    .map_err(anyhow::Error::from),
+            };
+            match res {
+                Ok(_) => {
+                    stats.record_sent(msg.reliable, len);
+                    stats.send_latency.record(enqueued.elapsed());
+                }
+                Err(_) => stats.record_dropped(msg.reliable, 1),
+            }
+        }
+    })
+}
+
+#[repr(C)]
+#[derive(Copy, Clone, Debug, PartialEq, Eq)]
+pub enum LkSchedulerMode {
+    Strict = 0,
+    Weighted = 1,
+}
+
+#[repr(C)]
+pub struct LkDataClassConfig {
+    pub priority: c_int,
+    pub weight: c_int,
+    pub rate_bytes_per_sec: c_int,
+    pub burst_bytes: c_int,
+}
+
+#[repr(C)]
+#[derive(Default)]
+pub struct LkDataClassStats {
+    pub queue_depth: i64,
+    pub queued_bytes: i64,
+    pub sent_messages: i64,
+    pub sent_bytes: i64,
+    pub expired_dropped: i64,
+    pub wait_p50_us: i64,
+    pub wait_p95_us: i64,
+    pub wait_p99_us: i64,
+}
+
+/// Give `label` its own send class: ordered sends on it go through the scheduler with the
+/// configured priority, weight and token-bucket rate limit. NULL `config` removes the class.
+///
+/// # Safety
+/// `label` must be a valid NUL-terminated string; `config` must be NULL or valid.
+#[no_mangle]
+pub unsafe extern "C" fn lk_set_data_class(
+    client: *mut LkClientHandle,
+    label: *const c_char,
+    config: *const LkDataClassConfig,
+) -> LkResult {
+    if client.is_null() { return err(1, "client null"); }
+    let topic = match cstr(label) {
+        Ok(s) if !s.is_empty() => s.to_string(),
+        Ok(_) => return err(5, "label empty"),
+        Err(e) => return err(2, &format!("label: {e}")),
+    };
+    let class = if config.is_null() {
+        None
+    } else {
+        let cfg = &*config;
+        if cfg.weight < 0 || cfg.rate_bytes_per_sec < 0 || cfg.burst_bytes < 0 {
+            return err(5, "negative class parameter");
+        }
+        Some(scheduler::ClassConfig {
+            priority: cfg.priority,
+            weight: (cfg.weight as u32).max(1),
+            rate: cfg.rate_bytes_per_sec as u32,
+            burst: cfg.burst_bytes as u32,
+        })
+    };
+    let c = &*(client as *const Client);
+    let mut g = c.0.lock().unwrap();
+    match class {
+        Some(cfg) => {
+            g.send_classes.insert(topic.clone(), cfg);
+        }
+        None => {
+            g.send_classes.remove(&topic);
+        }
+    }
+    if let Some(worker) = g.send_queue.as_ref() {
+        worker.queue.with(|s| s.configure(&topic, class));
+        worker.queue.ready.notify_one();
+    }
+    lk_log!(g, LkLogLevel::Info, "Send class for '{}': {:?}", topic, class);
+    ok()
+}
+
+/// Choose how the scheduler arbitrates between send classes.
+#[no_mangle]
+pub extern "C" fn lk_set_send_scheduler(client: *mut LkClientHandle, mode: LkSchedulerMode) -> LkResult {
+    if client.is_null() { return err(1, "client null"); }
+    let c = unsafe { &*(client as *const Client) };
+    let mut g = c.0.lock().unwrap();
+    let mode = match mode {
+        LkSchedulerMode::Strict => scheduler::Mode::Strict,
+        LkSchedulerMode::Weighted => scheduler::Mode::Weighted,
+    };
+    g.scheduler_mode = mode;
+    if let Some(worker) = g.send_queue.as_ref() {
+        worker.queue.with(|s| s.set_mode(mode));
+        worker.queue.ready.notify_one();
+    }
+    ok()
+}
+
+/// Queue depth, throughput and queue wait percentiles for one send class
+/// (NULL or empty label = the default class). Zeroed before the first queued send.
+///
+/// # Safety
+/// `label` must be NULL or a valid NUL-terminated string; `out_stats` must be valid.
+#[no_mangle]
+pub unsafe extern "C" fn lk_get_data_class_stats(
+    client: *mut LkClientHandle,
+    label: *const c_char,
+    out_stats: *mut LkDataClassStats,
+) -> LkResult {
+    if client.is_null() { return err(1, "client null"); }
+    if out_stats.is_null() { return err(4, "out_stats null"); }
+    let topic = if label.is_null() {
+        ""
+    } else {
+        match cstr(label) {
+            Ok(s) => s,
+            Err(e) => return err(2, &format!("label: {e}")),
+        }
+    };
+    let c = &*(client as *const Client);
+    let g = c.0.lock().unwrap();
+    if !topic.is_empty() && !g.send_classes.contains_key(topic) {
+        return err(5, "no send class for label");
+    }
+    let stats = g
+        .send_queue
+        .as_ref()
+        .and_then(|w| {
+            w.queue.with(|s| {
+                s.class(topic).map(|class| {
+                    let (p50, p95, p99) = class.wait_percentiles_us();
+                    LkDataClassStats {
+                        queue_depth: class.depth() as i64,
+                        queued_bytes: class.queued_bytes() as i64,
+                        sent_messages: class.sent_messages,
+                        sent_bytes: class.sent_bytes,
+                        expired_dropped: class.expired,
+                        wait_p50_us: p50 as i64,
+                        wait_p95_us: p95 as i64,
+                        wait_p99_us: p99 as i64,
+                    }
+                })
+            })
+        })
+        .flatten()
+        .unwrap_or_default();
+    *out_stats = stats;
+    ok()
+}
+
+// --------- Delta-coded channels ---------
+
+#[repr(C)]
+pub struct LkDeltaConfig {
+    pub keyframe_interval: c_int,
+    pub use_lz4: c_int,
+}
+
+#[repr(C)]
+#[derive(Default)]
+pub struct LkDeltaStats {
+    pub frames_sent: i64,
+    pub keyframes_sent: i64,
+    pub raw_bytes_sent: i64,
+    pub encoded_bytes_sent: i64,
+    pub encode_ns_per_frame: i64,
+    pub frames_received: i64,
+    pub undecodable_dropped: i64,
+    pub decode_ns_per_frame: i64,
+    pub compression_ratio: f64,
+}
+
+#[derive(Default)]
+struct DeltaStats {
+    frames_sent: i64,
+    keyframes_sent: i64,
+    raw_bytes: i64,
+    encoded_bytes: i64,
+    encode_ns: i64,
+    frames_received: i64,
+    undecodable_dropped: i64,
+    decode_ns: i64,
+}
+
+fn delta_stats_mut<'a>(stats: &'a mut HashMap<String, DeltaStats>, label: &str) -> &'a mut DeltaStats {
+    if !stats.contains_key(label) {
+        stats.insert(label.to_string(), DeltaStats::default());
+    }
+    stats.get_mut(label).unwrap()
+}
+
+/// Delta-code sends on `label`: periodic keyframes, the frames between them XORed against
+/// the last keyframe and packed as zero runs, optionally LZ4-compressed. Receivers decode
+/// transparently. NULL `config` turns it off.
+///
+/// # Safety
+/// `label` must be a valid NUL-terminated string; `config` must be NULL or valid.
+#[no_mangle]
+pub unsafe extern "C" fn lk_set_delta_channel(
+    client: *mut LkClientHandle,
+    label: *const c_char,
+    config: *const LkDeltaConfig,
+) -> LkResult {
+    if client.is_null() { return err(1, "client null"); }
+    let topic = match cstr(label) {
+        Ok(s) if !s.is_empty() => s.to_string(),
+        Ok(_) => return err(5, "label empty"),
+        Err(e) => return err(2, &format!("label: {e}")),
+    };
+    let c = &*(client as *const Client);
+    let mut g = c.0.lock().unwrap();
+    if config.is_null() {
+        g.delta_tx.remove(&topic);
+        return ok();
+    }
+    let cfg = &*config;
+    if cfg.keyframe_interval < 0 {
+        return err(5, "negative keyframe_interval");
+    }
+    let interval = if cfg.keyframe_interval == 0 { delta::DEFAULT_KEYFRAME_INTERVAL } else { cfg.keyframe_interval as u32 };
+    lk_log!(g, LkLogLevel::Info, "Delta coding on '{}': keyframe every {} frames, lz4={}", topic, interval, cfg.use_lz4 != 0);
+    // Reconfiguring keeps the frame numbering, which receivers compare against their keyframe
+    match g.delta_tx.get_mut(&topic) {
+        Some(encoder) => encoder.reconfigure(interval, cfg.use_lz4 != 0),
+        None => {
+            g.delta_tx.insert(topic, DeltaEncoder::new(interval, cfg.use_lz4 != 0));
+        }
+    }
+    ok()
+}
+
+/// Delta coding counters for `label`, both directions. Zeroed before any traffic.
+///
+/// # Safety
+/// `label` must be a valid NUL-terminated string; `out_stats` must be valid.
+#[no_mangle]
+pub unsafe extern "C" fn lk_get_delta_stats(
+    client: *mut LkClientHandle,
+    label: *const c_char,
+    out_stats: *mut LkDeltaStats,
+) -> LkResult {
+    if client.is_null() { return err(1, "client null"); }
+    if out_stats.is_null() { return err(4, "out_stats null"); }
+    let topic = match cstr(label) {
+        Ok(s) => s,
+        Err(e) => return err(2, &format!("label: {e}")),
+    };
+    let c = &*(client as *const Client);
+    let g = c.0.lock().unwrap();
+    let per = |total: i64, n: i64| if n > 0 { total / n } else { 0 };
+    *out_stats = g
+        .delta_stats
+        .get(topic)
+        .map(|s| LkDeltaStats {
+            frames_sent: s.frames_sent,
+            keyframes_sent: s.keyframes_sent,
+            raw_bytes_sent: s.raw_bytes,
+            encoded_bytes_sent: s.encoded_bytes,
+            encode_ns_per_frame: per(s.encode_ns, s.frames_sent),
+            frames_received: s.frames_received,
+            undecodable_dropped: s.undecodable_dropped,
+            decode_ns_per_frame: per(s.decode_ns, s.frames_received),
+            compression_ratio: if s.encoded_bytes > 0 { s.raw_bytes as f64 / s.encoded_bytes as f64 } else { 0.0 },
+        })
+        .unwrap_or_default();
+    ok()
+}
+
+// --------- Clock sync ---------
+
+/// Pings go out this often until the filter window has filled, so a new connection
+/// synchronizes within about a second.
+const CLOCK_FAST_INTERVAL: Duration = Duration::from_millis(125);
+
+#[repr(C)]
+#[derive(Default)]
+pub struct LkClockSyncStats {
+    /// 1 once the room clock is known (immediately when this participant is the reference).
+    pub synced: c_int,
+    /// Participant whose clock is the room clock; 0 when it is this one.
+    pub reference_participant_id: u32,
+    /// Room clock minus local clock.
+    pub offset_us: i64,
+    /// Round trip of the sample the offset comes from.
+    pub rtt_us: i64,
+    pub samples: i64,
+    /// Samples delayed well beyond the best recent round trip (queueing, retransmission).
+    pub outliers: i64,
+}
+
+/// Prefix `payload` with the sender's room time when `label` carries timestamps.
+fn stamp_packet(g: &ClientState, label: &str, payload: Vec<u8>, framed: bool) -> Vec<u8> {
+    if !g.timestamped_labels.contains(label) {
+        return payload;
+    }
+    let mut flags = if framed { framing::TIMED_FRAMED } else { 0 };
+    if g.clock.synced {
+        flags |= framing::TIMED_SYNCED;
+    }
+    let mut out = Vec::with_capacity(payload.len() + 12);
+    framing::begin_timed_packet(&mut out, clock_sync::now_us() + g.clock.offset_us, flags);
+    out.extend_from_slice(&payload);
+    out
+}
+
+/// Pick the room clock reference, the lowest identity present, and return who to ping.
+/// None when not connected or when this participant is the reference.
+fn clock_ping_target(g: &mut ClientState) -> Option<(LocalParticipant, String)> {
+    let room = g.room.as_ref()?;
+    let local = room.local_participant();
+    let local_identity = local.identity().as_str().to_string();
+    let reference = room
+        .remote_participants()
+        .keys()
+        .map(|k| k.as_str())
+        .filter(|k| *k < local_identity.as_str())
+        .min()
+        .map(str::to_string);
+    if reference != g.clock_reference {
+        lk_log!(g, LkLogLevel::Debug, "Clock reference is now {}", reference.as_deref().unwrap_or("this participant"));
+        g.clock.reset();
+        g.clock_reference = reference.clone();
+    }
+    match reference {
+        Some(identity) => Some((local, identity)),
+        None => {
+            g.clock.set_reference();
+            None
+        }
+    }
+}
+
+fn spawn_clock_worker(rt: &Runtime, client: Weak<Mutex<ClientState>>, period: Duration) -> JoinHandle<()> {
+    rt.spawn(async move {
+        let mut delay = Duration::ZERO;
+        loop {
+            tokio::time::sleep(delay).await;
+            let Some(client) = client.upgrade() else { return; };
+            let (target, fast) = match client.lock() {
+                Ok(mut g) => {
+                    let target = clock_ping_target(&mut g);
+                    let fast = target.is_some() && g.clock.settling();
+                    (target, fast)
+                }
+                Err(_) => return,
+            };
+            drop(client);
+            delay = if fast { CLOCK_FAST_INTERVAL.min(period) } else { period };
+            let Some((participant, identity)) = target else { continue; };
+            let mut ping = Vec::new();
+            framing::put_clock_ping(&mut ping, clock_sync::now_us());
+            let _ = participant
+                .publish_data(DataPacket {
+                    payload: ping,
+                    topic: Some(framing::framed_topic(framing::ACK_LABEL)),
+                    reliable: false,
+                    destination_identities: vec![identity.into()],
+                    ..Default::default()
+                })
+                .await;
+        }
+    })
+}
+
+/// Synchronize to the room clock every `interval_ms` (0 stops). The room clock is the
+/// local clock of the participant with the lowest identity; the others estimate their
+/// offset from lossy ping/pong exchanges. Participants always answer pings, so only the
+/// ones that need synced time have to enable this.
+#[no_mangle]
+pub extern "C" fn lk_set_clock_sync(client: *mut LkClientHandle, interval_ms: c_int) -> LkResult {
+    if client.is_null() { return err(1, "client null"); }
+    if interval_ms < 0 { return err(5, "negative interval_ms"); }
+    let c = unsafe { &*(client as *const Client) };
+    let mut g = c.0.lock().unwrap();
+    g.clock_worker = None;
+    if interval_ms == 0 {
+        return ok();
+    }
+    let period = Duration::from_millis(interval_ms as u64);
+    let worker = spawn_clock_worker(&g.rt, Arc::downgrade(&c.0), period);
+    g.clock_worker = Some(ClockSyncWorker(worker));
+    lk_log!(g, LkLogLevel::Info, "Clock sync enabled (every {:?})", period);
+    ok()
+}
+
+/// # Safety
+/// `out_stats` must be valid for writes.
+#[no_mangle]
+pub unsafe extern "C" fn lk_get_clock_sync_stats(client: *mut LkClientHandle, out_stats: *mut LkClockSyncStats) -> LkResult {
+    if client.is_null() { return err(1, "client null"); }
+    if out_stats.is_null() { return err(4, "out_stats null"); }
+    let c = &*(client as *const Client);
+    let g = c.0.lock().unwrap();
+    let reference = g.clock_reference.as_ref().and_then(|r| g.registry.participant_ids.get(r.as_str()).copied());
+    *out_stats = LkClockSyncStats {
+        synced: g.clock.synced as c_int,
+        reference_participant_id: reference.unwrap_or(0),
+        offset_us: g.clock.offset_us,
+        rtt_us: g.clock.rtt_us,
+        samples: g.clock.samples,
+        outliers: g.clock.outliers,
+    };
+    ok()
+}
+
+/// Room clock in microseconds (about Unix time) as estimated by `client`; the local clock
+/// while it is not synchronized, or for a NULL client.
+///
+/// # Safety
+/// `client` must be NULL or a valid handle.
+#[no_mangle]
+pub unsafe extern "C" fn lk_now_synced_us(client: *mut LkClientHandle) -> i64 {
+    if client.is_null() {
+        return clock_sync::now_us();
+    }
+    let c = &*(client as *const Client);
+    let g = c.0.lock().unwrap();
+    g.clock.now_synced_us()
+}
+
+/// Local clock in microseconds: Unix time at first use, advanced by a monotonic clock.
+/// Sender timestamps are mapped into this clock.
+#[no_mangle]
+pub extern "C" fn lk_now_local_us() -> i64 {
+    clock_sync::now_us()
+}
+
+/// Send time of the message being delivered, in the local clock (`lk_now_local_us`).
+/// Only meaningful inside a data callback; 0 if the label does not carry timestamps or
+/// either end is not synchronized.
+#[no_mangle]
+pub extern "C" fn lk_data_sender_time_us() -> i64 {
+    rx_sender_time()
+}
+
+/// Stamp sends on `label` with the sender's room time. Receivers read it with
+/// `lk_data_sender_time_us` or `LkDataMessageInfo::sender_time_us`.
+///
+/// # Safety
+/// `label` must be a valid NUL-terminated string.
+#[no_mangle]
+pub unsafe extern "C" fn lk_set_data_timestamps(client: *mut LkClientHandle, label: *const c_char, enabled: c_int) -> LkResult {
+    if client.is_null() { return err(1, "client null"); }
+    let topic = match cstr(label) {
+        Ok(s) if !s.is_empty() => s.to_string(),
+        Ok(_) => return err(5, "label empty"),
+        Err(e) => return err(2, &format!("label: {e}")),
+    };
+    let c = &*(client as *const Client);
+    let mut g = c.0.lock().unwrap();
+    if enabled != 0 {
+        g.timestamped_labels.insert(topic);
+    } else {
+        g.timestamped_labels.remove(&topic);
+    }
+    ok()
+}
+
+// --------- Compression ---------
+
+#[repr(C)]
+#[derive(Copy, Clone, Debug, PartialEq, Eq)]
+pub enum LkCompression {
+    /// Send uncompressed; still decodes inbound messages with the configured dictionary.
+    None = 0,
+    Lz4 = 1,
+    Zstd = 2,
+}
+
+#[repr(C)]
+pub struct LkCompressionConfig {
+    pub codec: LkCompression,
+    /// zstd level (1-22, negative for faster modes); 0 = zstd's default. Ignored for LZ4.
+    pub level: c_int,
+    /// Optional zstd dictionary (see `lk_train_compression_dictionary`); both ends need it.
+    pub dictionary: *const u8,
+    pub dictionary_len: usize,
+}
+
+/// Compress `bytes` for a label with compression on and queue the packet on the framed
+/// topic, which keeps it in order with the label's other traffic. None if the label does
+/// not compress or the message would not shrink: the caller sends it raw.
+fn send_compressed(
+    g: &mut ClientState,
+    topic: &str,
+    bytes: &[u8],
+    reliability: LkReliability,
+    destinations: &mut Vec<String>,
+    max_age: Option<Duration>,
+) -> Option<LkResult> {
+    let codec = g.compression.get_mut(topic).filter(|c| c.sends())?;
+    let mut packet = Vec::with_capacity(bytes.len() / 2 + 16);
+    if !codec.compress(bytes, &mut packet) {
+        return None;
+    }
+    let packet = stamp_packet(g, topic, packet, true);
+    if packet.len() > framing::RELIABLE_MAX {
+        return Some(err(202, &format!("compressed data size {} exceeds limit {}", packet.len(), framing::RELIABLE_MAX)));
+    }
+    let reliable = matches!(reliability, LkReliability::Reliable) || packet.len() > framing::LOSSY_MTU;
+    g.data_stats.record_compressed(bytes.len(), packet.len());
+    Some(queue_framed(g, topic, packet, true, reliable, std::mem::take(destinations), max_age))
+}
+
+/// Compress sends on `label` with LZ4 (fast) or zstd (smaller, more so with a dictionary).
+/// Each message carries a one-byte codec id, so receivers decode transparently; only a
+/// dictionary must be configured on both ends. Messages that would not shrink go out raw.
+/// NULL `config` turns it off.
+///
+/// # Safety
+/// `label` must be a valid NUL-terminated string; `config` must be NULL or valid, with
+/// `dictionary` readable for `dictionary_len` bytes. The dictionary is copied.
+#[no_mangle]
+pub unsafe extern "C" fn lk_set_data_compression(
+    client: *mut LkClientHandle,
+    label: *const c_char,
+    config: *const LkCompressionConfig,
+) -> LkResult {
+    if client.is_null() { return err(1, "client null"); }
+    let topic = match cstr(label) {
+        Ok(s) if !s.is_empty() => s.to_string(),
+        Ok(_) => return err(5, "label empty"),
+        Err(e) => return err(2, &format!("label: {e}")),
+    };
+    let c = &*(client as *const Client);
+    if config.is_null() {
+        c.0.lock().unwrap().compression.remove(&topic);
+        return ok();
+    }
+    let cfg = &*config;
+    let dictionary = match (cfg.dictionary.is_null(), cfg.dictionary_len) {
+        (_, 0) => None,
+        (true, _) => return err(4, "dictionary null"),
+        (false, n) => Some(std::slice::from_raw_parts(cfg.dictionary, n)),
+    };
+    let codec = match cfg.codec {
+        LkCompression::None if dictionary.is_none() => return err(5, "codec None needs a dictionary"),
+        LkCompression::None => compress::Codec::None,
+        LkCompression::Lz4 => compress::Codec::Lz4,
+        LkCompression::Zstd => compress::Codec::Zstd,
+    };
+    // Building the zstd contexts digests the dictionary: do it outside the client lock
+    let label_codec = match LabelCodec::new(codec, cfg.level, dictionary) {
+        Ok(codec) => codec,
+        Err(e) => return err(5, &format!("compression: {e}")),
+    };
+    let mut g = c.0.lock().unwrap();
+    lk_log!(g, LkLogLevel::Info, "Compression on '{}': {:?}, level {}, dictionary {} bytes",
+        topic, cfg.codec, cfg.level, cfg.dictionary_len);
+    g.compression.insert(topic, label_codec);
+    ok()
+}
+
+/// Train a zstd dictionary from `count` representative messages laid out back to back in
+/// `samples`, with their sizes in `sample_sizes`. At most `capacity` bytes are written to
+/// `out`; 100 KiB is a good size. Needs a few hundred samples to be worthwhile.
+///
+/// # Safety
+/// `samples` must be readable for the sum of `sample_sizes`, `sample_sizes` for `count`
+/// entries, `out` writable for `capacity` bytes and `out_len` valid.
+#[no_mangle]
+pub unsafe extern "C" fn lk_train_compression_dictionary(
+    samples: *const u8,
+    sample_sizes: *const usize,
+    count: usize,
+    out: *mut u8,
+    capacity: usize,
+    out_len: *mut usize,
+) -> LkResult {
+    if samples.is_null() || sample_sizes.is_null() || out.is_null() || out_len.is_null() {
+        return err(4, "null pointer");
+    }
+    if count == 0 || capacity == 0 {
+        return err(5, "no samples or no capacity");
+    }
+    let sizes = std::slice::from_raw_parts(sample_sizes, count);
+    let total = sizes.iter().try_fold(0usize, |acc, n| acc.checked_add(*n));
+    let Some(total) = total else { return err(5, "sample sizes overflow"); };
+    let samples = std::slice::from_raw_parts(samples, total);
+    match compress::train_dictionary(samples, sizes, capacity) {
+        Ok(dict) => {
+            let n = dict.len().min(capacity);
+            ptr::copy_nonoverlapping(dict.as_ptr(), out, n);
+            *out_len = n;
+            ok()
+        }
+        Err(e) => err(5, &format!("dictionary training failed: {e}")),
+    }
+}
+
+// --------- Forward error correction ---------
+
+/// True if a message of `len` bytes on `label` goes out in an FEC group. Targeted sends are
+/// left out: receivers outside the destinations would see gaps in every group.
+fn fec_protects(g: &ClientState, label: &str, reliable: bool, destinations: &[String], len: usize) -> bool {
+    !reliable && destinations.is_empty() && len <= fec::MAX_MESSAGE && g.fec_tx.contains_key(label)
+}
+
+/// Queue `packet` on `label`'s framed topic, in an FEC group when `fec_protects` allows,
+/// followed by the group's parity if it completes one. `framed` says whether `packet` is
+/// already a framed packet; raw messages may only be passed when FEC protects them.
+fn queue_framed(
+    g: &mut ClientState,
+    label: &str,
+    packet: Vec<u8>,
+    framed: bool,
+    reliable: bool,
+    destinations: Vec<String>,
+    max_age: Option<Duration>,
+) -> LkResult {
+    let mut parity = None;
+    let protect = fec_protects(g, label, reliable, &destinations, packet.len());
+    let packet = match g.fec_tx.get_mut(label).filter(|_| protect) {
+        Some(encoder) => {
+            let mut wrapped = Vec::with_capacity(packet.len() + framing::FEC_PACKET_OVERHEAD);
+            parity = encoder.encode(&packet, framed, &mut wrapped);
+            g.data_stats.record_fec(packet.len(), wrapped.len(), parity.as_ref().map(Vec::len));
+            wrapped
+        }
+        None => packet,
+    };
+    let now = Instant::now();
+    let deadline = max_age.map(|age| now + age);
+    let topic = framing::framed_topic(label);
+    let Some(queue) = send_queue(g) else { return err(6, "not connected"); };
+    queue.push(label, QueuedSend { topic: topic.clone(), payload: Payload::Copied(packet), reliable, destinations, enqueued: now, deadline });
+    if let Some(parity) = parity {
+        queue.push(label, QueuedSend { topic, payload: Payload::Copied(parity), reliable: false, destinations: Vec::new(), enqueued: now, deadline });
+    }
+    ok()
+}
+
+/// Protect lossy sends on `label` with XOR parity: after every `group_size` messages
+/// (2-32) one parity packet goes out, from which receivers rebuild any single lost message
+/// of the group before delivering it. Messages over 1287 bytes and targeted
+/// sends go out unprotected. 0 turns it off.
+///
+/// # Safety
+/// `label` must be a valid NUL-terminated string.
+#[no_mangle]
+pub unsafe extern "C" fn lk_set_data_fec(client: *mut LkClientHandle, label: *const c_char, group_size: c_int) -> LkResult {
+    if client.is_null() { return err(1, "client null"); }
+    let topic = match cstr(label) {
+        Ok(s) if !s.is_empty() => s.to_string(),
+        Ok(_) => return err(5, "label empty"),
+        Err(e) => return err(2, &format!("label: {e}")),
+    };
+    if group_size != 0 && !(fec::MIN_GROUP as c_int..=fec::MAX_GROUP as c_int).contains(&group_size) {
+        return err(5, "group_size must be 0 or 2-32");
+    }
+    let c = &*(client as *const Client);
+    let mut g = c.0.lock().unwrap();
+    if group_size == 0 {
+        g.fec_tx.remove(&topic);
+        return ok();
+    }
+    lk_log!(g, LkLogLevel::Info, "FEC on '{}': one parity packet per {} messages", topic, group_size);
+    // Keep the encoder, so receivers see the group numbers carry on
+    match g.fec_tx.get_mut(&topic) {
+        Some(encoder) => encoder.set_count(group_size as u32),
+        None => { g.fec_tx.insert(topic, FecEncoder::new(group_size as u32)); }
+    }
+    ok()
+}
+
+
+// --------- Link estimates and rate control ---------
+
+/// How often the link monitor polls peer connection stats.
+const LINK_POLL_INTERVAL: Duration = Duration::from_secs(1);
+
+#[repr(C)]
+#[derive(Copy, Clone, Debug, PartialEq, Eq)]
+pub enum LkConnectionQuality {
+    Unknown = 0,
+    Excellent = 1,
+    Good = 2,
+    Poor = 3,
+    Lost = 4,
+}
+
+#[repr(C)]
+pub struct LkLinkStats {
+    /// Round trip of the publisher transport; 0 if unknown.
+    pub rtt_us: i64,
+    /// Fraction of published media packets lost (0..1), as the remote end reports it.
+    pub loss: f64,
+    /// Outgoing bandwidth estimate of the publisher transport; 0 if unknown.
+    pub available_outgoing_bps: f64,
+    /// The server's rating of this participant's connection.
+    pub quality: LkConnectionQuality,
+    /// `lk_now_local_us` at the last stats poll; 0 before the first.
+    pub updated_us: i64,
+}
+
+#[repr(C)]
+pub struct LkRateControlConfig {
+    pub min_hz: c_float,
+    pub max_hz: c_float,
+    /// Fraction of the available outgoing bandwidth the label may use; 0 = 0.5.
+    pub bandwidth_share: c_float,
+}
+
+/// Fold one peer connection stats poll into the link estimate. RTT comes from the nominated
+/// candidate pair, falling back to clock sync; loss from the remote end's RTCP reports.
+fn update_link(g: &mut ClientState, stats: &[livekit::webrtc::stats::RtcStats]) {
+    use livekit::webrtc::stats::RtcStats;
+    let mut rtt_us = 0i64;
+    let mut available = 0.0f64;
+    let mut loss = 0.0f64;
+    for s in stats {
+        match s {
+            RtcStats::CandidatePair(pair) if pair.candidate_pair.nominated => {
+                rtt_us = (pair.candidate_pair.current_round_trip_time * 1e6) as i64;
+                available = pair.candidate_pair.available_outgoing_bitrate;
+            }
+            RtcStats::RemoteInboundRtp(remote) => loss = loss.max(remote.remote_inbound.fraction_lost),
+            _ => {}
+        }
+    }
+    if rtt_us <= 0 && g.clock.synced {
+        rtt_us = g.clock.rtt_us;
+    }
+    g.link.rtt_us = rtt_us;
+    g.link.available_bps = available;
+    g.link.loss = loss;
+    g.link_updated_us = clock_sync::now_us();
+}
+
+/// Run every rate controller on the current link estimate; returns the rates to report.
+fn update_rates(g: &mut ClientState) -> Vec<(CString, f32)> {
+    let link = g.link;
+    let mut changed = Vec::new();
+    for (label, rc) in g.rate_controls.iter_mut() {
+        // The label's own class if it has one; otherwise the shared default class
+        let class = if g.send_classes.contains_key(label) { label.as_str() } else { "" };
+        let wait = g.send_queue.as_ref().and_then(|w| w.queue.with(|s| s.class(class).map(|c| c.wait_percentiles_us().1))).flatten();
+        if let Some(hz) = rc.update(&link, wait.unwrap_or(0) as i64) {
+            changed.push((CString::new(label.as_str()).unwrap_or_default(), hz as f32));
+        }
+    }
+    for (label, hz) in &changed {
+        lk_log!(g, LkLogLevel::Debug, "Recommended rate for '{}' is now {:.1} Hz", label.to_string_lossy(), hz);
+    }
+    changed
+}
+
+fn spawn_link_monitor(rt: &Runtime, client: Weak<Mutex<ClientState>>) -> JoinHandle<()> {
+    rt.spawn(async move {
+        loop {
+            tokio::time::sleep(LINK_POLL_INTERVAL).await;
+            let Some(strong) = client.upgrade() else { return; };
+            let (room, locals) = match strong.lock() {
+                Ok(g) => {
+                    // Per-track sender stats only once someone has asked for transport stats
+                    let locals: Vec<(String, LocalAudioTrack)> = if g.rtc_stats.requested {
+                        g.audio_tracks.values().map(|p| (p.label.clone(), p.local_track.clone())).collect()
+                    } else {
+                        Vec::new()
+                    };
+                    (g.room.clone(), locals)
+                }
+                Err(_) => return,
+            };
+            drop(strong);
+            let Some(room) = room else { continue; };
+            let Ok(stats) = room.get_stats().await else { continue; };
+            let mut local_stats = Vec::with_capacity(locals.len());
+            for (name, track) in locals {
+                if let Ok(track_stats) = track.get_stats().await {
+                    local_stats.push((name, track_stats));
+                }
+            }
+            let Some(client) = client.upgrade() else { return; };
+            let (changed, cb) = {
+                let Ok(mut g) = client.lock() else { return; };
+                update_link(&mut g, &stats.publisher_stats);
+                if g.rtc_stats.requested {
+                    update_rtc_stats(&mut g, &stats.publisher_stats, &stats.subscriber_stats, &local_stats);
+                }
+                let changed = update_rates(&mut g);
+                (changed, g.rate_cb.as_ref().map(|(cb, user)| (*cb, UserPtr(user.0))))
+            };
+            // Outside the lock, so the callback may call back into the FFI
+            if let Some((cb, user)) = cb {
+                for (label, hz) in &changed {
+                    cb(user.0, label.as_ptr(), *hz);
+                }
+            }
+        }
+    })
+}
+
+fn ensure_link_monitor(g: &mut ClientState, client: &Arc<Mutex<ClientState>>) {
+    if g.link_monitor.is_none() {
+        g.link_monitor = Some(LinkMonitor(spawn_link_monitor(&g.rt, Arc::downgrade(client))));
+    }
+}
+
+/// Latest link estimate: RTT, loss and available bandwidth of the publisher transport,
+/// polled once a second while rate control or transport stats are in use, plus the server's
+/// quality rating.
+///
+/// # Safety
+/// `out_stats` must be valid for writes.
+#[no_mangle]
+pub unsafe extern "C" fn lk_get_link_stats(client: *mut LkClientHandle, out_stats: *mut LkLinkStats) -> LkResult {
+    if client.is_null() { return err(1, "client null"); }
+    if out_stats.is_null() { return err(4, "out_stats null"); }
+    let c = &*(client as *const Client);
+    let g = c.0.lock().unwrap();
+    *out_stats = LkLinkStats {
+        rtt_us: g.link.rtt_us,
+        loss: g.link.loss,
+        available_outgoing_bps: g.link.available_bps,
+        quality: g.link_quality,
+        updated_us: g.link_updated_us,
+    };
+    ok()
+}
+
+/// Recommend a send rate for `label` between `min_hz` and `max_hz`, from the link estimate
+/// and the label's send queue. Advisory only: read it with `lk_get_recommended_rate` or
+/// get `lk_set_rate_callback` calls. NULL `config` turns it off.
+///
+/// # Safety
+/// `label` must be a valid NUL-terminated string; `config` must be NULL or valid.
+#[no_mangle]
+pub unsafe extern "C" fn lk_set_rate_control(
+    client: *mut LkClientHandle,
+    label: *const c_char,
+    config: *const LkRateControlConfig,
+) -> LkResult {
+    if client.is_null() { return err(1, "client null"); }
+    let topic = match cstr(label) {
+        Ok(s) if !s.is_empty() => s.to_string(),
+        Ok(_) => return err(5, "label empty"),
+        Err(e) => return err(2, &format!("label: {e}")),
+    };
+    let c = &*(client as *const Client);
+    let mut g = c.0.lock().unwrap();
+    if config.is_null() {
+        g.rate_controls.remove(&topic);
+        return ok();
+    }
+    let cfg = &*config;
+    if !(cfg.min_hz > 0.0 && cfg.max_hz >= cfg.min_hz) || !(0.0..=1.0).contains(&cfg.bandwidth_share) {
+        return err(5, "need 0 < min_hz <= max_hz and bandwidth_share in 0..1");
+    }
+    let share = if cfg.bandwidth_share == 0.0 { 0.5 } else { cfg.bandwidth_share };
+    lk_log!(g, LkLogLevel::Info, "Rate control on '{}': {}-{} Hz", topic, cfg.min_hz, cfg.max_hz);
+    g.rate_controls.insert(topic, RateController::new(cfg.min_hz as f64, cfg.max_hz as f64, share as f64));
+    ensure_link_monitor(&mut g, &c.0);
+    ok()
+}
+
+/// # Safety
+/// `label` must be a valid NUL-terminated string; `out_hz` must be valid for writes.
+#[no_mangle]
+pub unsafe extern "C" fn lk_get_recommended_rate(client: *mut LkClientHandle, label: *const c_char, out_hz: *mut c_float) -> LkResult {
+    if client.is_null() { return err(1, "client null"); }
+    if out_hz.is_null() { return err(4, "out_hz null"); }
+    let topic = match cstr(label) {
+        Ok(s) => s,
+        Err(e) => return err(2, &format!("label: {e}")),
+    };
+    let c = &*(client as *const Client);
+    let g = c.0.lock().unwrap();
+    match g.rate_controls.get(topic) {
+        Some(rc) => {
+            *out_hz = rc.rate_hz() as c_float;
+            ok()
+        }
+        None => err(5, "no rate control for label"),
+    }
+}
+
+/// Called from the link monitor thread, without the client lock held, when a label's
+/// recommended rate moves by more than 10% or reaches its bound.
+#[no_mangle]
+pub extern "C" fn lk_set_rate_callback(
+    client: *mut LkClientHandle,
+    cb: Option<extern "C" fn(user: *mut c_void, label: *const c_char, hz: c_float)>,
+    user: *mut c_void,
+) -> LkResult {
+    if client.is_null() { return err(1, "client null"); }
+    let c = unsafe { &*(client as *const Client) };
+    let mut g = c.0.lock().unwrap();
+    g.rate_cb = cb.map(|f| (f, UserPtr(user)));
+    ok()
+}
+
+// --------- Transport statistics ---------
+
+/// Bytes of the track name kept in `LkTrackStats`, including the terminating NUL.
+const TRACK_NAME_LEN: usize = 64;
+
+#[repr(C)]
+#[derive(Copy, Clone, Debug, Default, PartialEq, Eq)]
+pub enum LkCandidateType {
+    #[default]
+    Unknown = 0,
+    Host = 1,
+    Srflx = 2,
+    Prflx = 3,
+    Relay = 4,
+}
+
+#[repr(C)]
+#[derive(Copy, Clone, Debug, Default)]
+pub struct LkTransportStats {
+    /// 1 once ICE has nominated a candidate pair; the other fields are 0 until then.
+    pub connected: c_int,
+    pub rtt_us: i64,
+    pub available_outgoing_bps: f64,
+    pub available_incoming_bps: f64,
+    pub bytes_sent: i64,
+    pub bytes_received: i64,
+    /// Over the last poll interval.
+    pub send_bps: f64,
+    pub receive_bps: f64,
+    pub local_candidate: LkCandidateType,
+    pub remote_candidate: LkCandidateType,
+    /// 1 if the local candidate is TCP (ICE-TCP or TURN over TCP).
+    pub tcp: c_int,
+    /// `lk_now_local_us` at the poll these figures come from; 0 before the first.
+    pub updated_us: i64,
+}
+
+#[repr(C)]
+#[derive(Copy, Clone, Debug)]
+pub struct LkTrackStats {
+    /// NUL-terminated, truncated to fit.
+    pub name: [c_char; TRACK_NAME_LEN],
+    /// 1 for a track this client publishes, 0 for a subscribed one.
+    pub outbound: c_int,
+    pub video: c_int,
+    /// Registry IDs of a subscribed track; 0 for outbound tracks.
+    pub participant_id: u32,
+    pub track_id: u32,
+    /// Sent or received.
+    pub packets: i64,
+    pub bytes: i64,
+    pub bitrate_bps: f64,
+    /// Inbound: lost on the way here; outbound: as the receiving end reports it.
+    pub packets_lost: i64,
+    /// Fraction lost (0..1). Inbound: over the track's lifetime; outbound: latest RTCP report.
+    pub loss: f64,
+    pub jitter_us: i64,
+    /// Outbound only, from RTCP.
+    pub rtt_us: i64,
+    pub nack_count: i64,
+    pub pli_count: i64,
+    /// Outbound only.
+    pub retransmitted_packets: i64,
+    /// Outbound only: the encoder's target bitrate.
+    pub target_bitrate_bps: f64,
+}
+
+impl Default for LkTrackStats {
+    fn default() -> Self {
+        Self {
+            name: [0; TRACK_NAME_LEN],
+            outbound: 0,
+            video: 0,
+            participant_id: 0,
+            track_id: 0,
+            packets: 0,
+            bytes: 0,
+            bitrate_bps: 0.0,
+            packets_lost: 0,
+            loss: 0.0,
+            jitter_us: 0,
+            rtt_us: 0,
+            nack_count: 0,
+            pli_count: 0,
+            retransmitted_packets: 0,
+            target_bitrate_bps: 0.0,
+        }
+    }
+}
+
+/// Copy a track name into a fixed stats field, truncated and NUL-terminated.
+fn copy_name(dst: &mut [c_char; TRACK_NAME_LEN], name: &[u8]) {
+    let n = name.len().min(TRACK_NAME_LEN - 1);
+    for (d, s) in dst.iter_mut().zip(&name[..n]) {
+        *d = *s as c_char;
+    }
+    dst[n] = 0;
+}
+
+/// Transport and track stats as of the last poll, so callers can read them at any rate.
+#[derive(Default)]
+struct RtcStatsCache {
+    /// Set by the first stats call; until then polls only feed the link estimate.
+    requested: bool,
+    publisher: LkTransportStats,
+    subscriber: LkTransportStats,
+    tracks: Vec<LkTrackStats>,
+    /// Byte counters of the previous poll by stats id, for bitrates.
+    prev_bytes: HashMap<String, i64>,
+    prev_us: i64,
+}
+
+impl RtcStatsCache {
+    fn reset(&mut self) {
+        *self = Self { requested: self.requested, ..Self::default() };
+    }
+}
+
+/// Bitrates between two polls; counters seen in this poll are kept for the next.
+struct Bitrates {
+    prev: HashMap<String, i64>,
+    next: HashMap<String, i64>,
+    secs: f64,
+}
+
+impl Bitrates {
+    fn of(&mut self, key: &str, bytes: i64) -> f64 {
+        self.next.insert(key.to_string(), bytes);
+        match self.prev.get(key) {
+            Some(prev) if self.secs > 0.0 && bytes >= *prev => (bytes - prev) as f64 * 8.0 / self.secs,
+            _ => 0.0,
+        }
+    }
+}
+
+fn candidate_type(t: Option<livekit::webrtc::stats::IceCandidateType>) -> LkCandidateType {
+    use livekit::webrtc::stats::IceCandidateType;
+    match t {
+        Some(IceCandidateType::Host) => LkCandidateType::Host,
+        Some(IceCandidateType::Srflx) => LkCandidateType::Srflx,
+        Some(IceCandidateType::Prflx) => LkCandidateType::Prflx,
+        Some(IceCandidateType::Relay) => LkCandidateType::Relay,
+        _ => LkCandidateType::Unknown,
+    }
+}
+
+/// One peer connection's nominated candidate pair and the candidates it joins.
+fn transport_stats(stats: &[livekit::webrtc::stats::RtcStats], rates: &mut Bitrates, side: &str, now: i64) -> LkTransportStats {
+    use livekit::webrtc::stats::RtcStats;
+    let mut out = LkTransportStats { updated_us: now, ..Default::default() };
+    let Some(pair) = stats.iter().find_map(|s| match s {
+        RtcStats::CandidatePair(p) if p.candidate_pair.nominated => Some(&p.candidate_pair),
+        _ => None,
+    }) else {
+        return out;
+    };
+    out.connected = 1;
+    out.rtt_us = (pair.current_round_trip_time * 1e6) as i64;
+    out.available_outgoing_bps = pair.available_outgoing_bitrate;
+    out.available_incoming_bps = pair.available_incoming_bitrate;
+    out.bytes_sent = pair.bytes_sent as i64;
+    out.bytes_received = pair.bytes_received as i64;
+    out.send_bps = rates.of(&format!("{side}/sent"), out.bytes_sent);
+    out.receive_bps = rates.of(&format!("{side}/received"), out.bytes_received);
+    for s in stats {
+        match s {
+            RtcStats::LocalCandidate(c) if c.rtc.id == pair.local_candidate_id => {
+                out.local_candidate = candidate_type(c.local_candidate.candidate_type);
+                out.tcp = c.local_candidate.protocol.eq_ignore_ascii_case("tcp") as c_int;
+            }
+            RtcStats::RemoteCandidate(c) if c.rtc.id == pair.remote_candidate_id => {
+                out.remote_candidate = candidate_type(c.remote_candidate.candidate_type);
+            }
+            _ => {}
+        }
+    }
+    out
+}
+
+/// Rebuild the cache from one poll: the two peer connections' stats for the transports and
+/// subscribed tracks, and `locals` (track name, that track's sender stats) for published ones.
+fn update_rtc_stats(
+    g: &mut ClientState,
+    publisher: &[livekit::webrtc::stats::RtcStats],
+    subscriber: &[livekit::webrtc::stats::RtcStats],
+    locals: &[(String, Vec<livekit::webrtc::stats::RtcStats>)],
+) {
+    use livekit::webrtc::stats::RtcStats;
+    let now = clock_sync::now_us();
+    let cache = &mut g.rtc_stats;
+    let secs = if cache.prev_us > 0 { (now - cache.prev_us) as f64 / 1e6 } else { 0.0 };
+    let mut rates = Bitrates { prev: std::mem::take(&mut cache.prev_bytes), next: HashMap::new(), secs };
+    cache.publisher = transport_stats(publisher, &mut rates, "publisher", now);
+    cache.subscriber = transport_stats(subscriber, &mut rates, "subscriber", now);
+
+    cache.tracks.clear();
+    for (name, stats) in locals {
+        for s in stats {
+            let RtcStats::OutboundRtp(o) = s else { continue; };
+            let mut t = LkTrackStats { outbound: 1, video: (o.stream.kind == "video") as c_int, ..Default::default() };
+            copy_name(&mut t.name, name.as_bytes());
+            t.packets = o.sent.packets_sent as i64;
+            t.bytes = o.sent.bytes_sent as i64;
+            t.bitrate_bps = rates.of(&o.rtc.id, t.bytes);
+            t.nack_count = o.outbound.nack_count as i64;
+            t.pli_count = o.outbound.pli_count as i64;
+            t.retransmitted_packets = o.outbound.retransmitted_packets_sent as i64;
+            t.target_bitrate_bps = o.outbound.target_bitrate;
+            // The receiving end's RTCP view of this stream
+            let remote = stats.iter().find_map(|r| match r {
+                RtcStats::RemoteInboundRtp(r) if r.remote_inbound.local_id == o.rtc.id => Some(r),
+                _ => None,
+            });
+            if let Some(r) = remote {
+                t.packets_lost = r.received.packets_lost;
+                t.loss = r.remote_inbound.fraction_lost;
+                t.jitter_us = (r.received.jitter * 1e6) as i64;
+                t.rtt_us = (r.remote_inbound.round_trip_time * 1e6) as i64;
+            }
+            cache.tracks.push(t);
+        }
+    }
+    for s in subscriber {
+        let RtcStats::InboundRtp(i) = s else { continue; };
+        let mut t = LkTrackStats { video: (i.stream.kind == "video") as c_int, ..Default::default() };
+        // LiveKit names remote media tracks by their track SID
+        if let Some(track_id) = g.registry.track_ids.get(&i.inbound.track_identifier) {
+            t.track_id = *track_id;
+            if let Some((participant_id, name)) = g.registry.track_info.get(track_id) {
+                t.participant_id = *participant_id;
+                copy_name(&mut t.name, name.as_bytes());
+            }
+        } else {
+            copy_name(&mut t.name, i.inbound.track_identifier.as_bytes());
+        }
+        t.packets = i.received.packets_received as i64;
+        t.bytes = i.inbound.bytes_received as i64;
+        t.bitrate_bps = rates.of(&i.rtc.id, t.bytes);
+        t.packets_lost = i.received.packets_lost.max(0);
+        let expected = t.packets + t.packets_lost;
+        t.loss = if expected > 0 { t.packets_lost as f64 / expected as f64 } else { 0.0 };
+        t.jitter_us = (i.received.jitter * 1e6) as i64;
+        t.nack_count = i.inbound.nack_count as i64;
+        t.pli_count = i.inbound.pli_count as i64;
+        if let Some(audio) = g.remote_audio.get_mut(&t.track_id) {
+            audio.samples_received = i.inbound.total_samples_received as i64;
+            audio.concealed_samples = i.inbound.concealed_samples as i64;
+            // Average delay of the samples emitted since the previous poll
+            let (prev_delay, prev_emitted) = audio.prev_jitter_buffer;
+            let emitted = i.inbound.jitter_buffer_emitted_count.saturating_sub(prev_emitted);
+            if emitted > 0 {
+                audio.jitter_buffer_ms = (i.inbound.jitter_buffer_delay - prev_delay) / emitted as f64 * 1000.0;
+            }
+            audio.prev_jitter_buffer = (i.inbound.jitter_buffer_delay, i.inbound.jitter_buffer_emitted_count);
+        }
+        cache.tracks.push(t);
+    }
+    cache.prev_bytes = rates.next;
+    cache.prev_us = now;
+}
+
+/// Starts the once-a-second poll on first use; until the first poll completes the stats
+/// are zero (`updated_us` 0).
+fn request_rtc_stats(g: &mut ClientState, client: &Arc<Mutex<ClientState>>) {
+    g.rtc_stats.requested = true;
+    ensure_link_monitor(g, client);
+}
+
+/// Publisher and subscriber transport stats from the last poll; reading them is cheap. Either
+/// output may be NULL.
+///
+/// # Safety
+/// Non-null outputs must be valid for writes.
+#[no_mangle]
+pub unsafe extern "C" fn lk_get_transport_stats(
+    client: *mut LkClientHandle,
+    out_publisher: *mut LkTransportStats,
+    out_subscriber: *mut LkTransportStats,
+) -> LkResult {
+    if client.is_null() { return err(1, "client null"); }
+    let c = &*(client as *const Client);
+    let mut g = c.0.lock().unwrap();
+    request_rtc_stats(&mut g, &c.0);
+    if !out_publisher.is_null() {
+        *out_publisher = g.rtc_stats.publisher;
+    }
+    if !out_subscriber.is_null() {
+        *out_subscriber = g.rtc_stats.subscriber;
+    }
+    ok()
+}
+
+/// Per-track RTP stats from the last poll: published tracks first, then subscribed ones.
+/// Writes at most `capacity` entries; `out_count` gets the number available.
+///
+/// # Safety
+/// `out_tracks` must be valid for `capacity` writes (NULL if 0); `out_count` must be valid.
+#[no_mangle]
+pub unsafe extern "C" fn lk_get_track_stats(
+    client: *mut LkClientHandle,
+    out_tracks: *mut LkTrackStats,
+    capacity: usize,
+    out_count: *mut usize,
+) -> LkResult {
+    if client.is_null() { return err(1, "client null"); }
+    if out_count.is_null() || (out_tracks.is_null() && capacity > 0) { return err(4, "null pointer"); }
+    let c = &*(client as *const Client);
+    let mut g = c.0.lock().unwrap();
+    request_rtc_stats(&mut g, &c.0);
+    let tracks = &g.rtc_stats.tracks;
+    let n = tracks.len().min(capacity);
+    if n > 0 {
+        std::ptr::copy_nonoverlapping(tracks.as_ptr(), out_tracks, n);
+    }
+    *out_count = tracks.len();
+    ok()
+}
+
+// --------- Unordered delivery ---------
+
+/// The client's unordered-delivery state, started on first use. None when not connected.
+fn unordered_state(g: &mut ClientState) -> Option<&UnorderedState> {
+    if g.unordered.is_none() {
+        let participant = g.room.as_ref()?.local_participant();
+        let queues = Arc::new(Mutex::new(UnorderedQueues::default()));
+        let (tx, rx) = tokio::sync::mpsc::unbounded_channel();
+        spawn_unordered_worker(&g.rt, participant, queues.clone(), g.data_stats.clone(), rx);
+        g.unordered = Some(UnorderedState { queues, tx });
+    }
+    g.unordered.as_ref()
+}
+
+fn send_unordered(
+    g: &mut ClientState,
+    label: &str,
+    reliable: bool,
+    bytes: &[u8],
+    deadline: Option<Instant>,
+    destinations: Vec<String>,
+) -> LkResult {
+    // The addressed peers, or everyone present now, are the ones a reliable message must reach
+    let peers: Vec<String> = match (reliable, g.room.as_ref()) {
+        (true, _) if !destinations.is_empty() => destinations.clone(),
+        (true, Some(room)) => room.remote_participants().keys().map(|k| k.as_str().to_string()).collect(),
+        _ => Vec::new(),
+    };
+    let stats = g.data_stats.clone();
+    let Some(state) = unordered_state(g) else { return err(6, "not connected"); };
+    let topic = framing::framed_topic(label);
+    let mut packet = Vec::with_capacity(framing::seq_packet_overhead(u32::MAX) + bytes.len());
+    {
+        let mut queues = state.queues.lock().unwrap();
+        let seq = queues.next_seq;
+        queues.next_seq = seq.wrapping_add(1);
+        framing::put_seq_packet(&mut packet, seq, if reliable { framing::SEQ_RELIABLE } else { 0 }, bytes);
+        // Receivers could no longer tell a retransmission this far behind from a duplicate
+        while let Some((&oldest, _)) = queues.unacked.first_key_value() {
+            if seq.wrapping_sub(oldest) < framing::SeqWindow::SPAN {
+                break;
+            }
+            queues.unacked.pop_first();
+            stats.record_dropped(true, 1);
+        }
+        if !peers.is_empty() {
+            if queues.unacked.len() >= UNORDERED_MAX_IN_FLIGHT {
+                queues.unacked.pop_first();
+                stats.record_dropped(true, 1);
+            }
+            queues.unacked.insert(seq, Unacked {
+                topic: topic.clone(),
+                packet: packet.clone(),
+                pending: peers,
+                attempts: 0,
+                next_retx: Instant::now() + UNORDERED_RTO,
+                deadline,
+            });
+        }
+    }
+    if state.tx.send(SeqPacket { topic, packet, destinations, deadline, enqueued: Some(Instant::now()) }).is_err() {
+        return err(203, "unordered sender stopped");
+    }
+    ok()
+}
+
+/// Collect retransmissions that are due and pending acks, expiring messages that ran out of
+/// attempts or passed their deadline.
+fn take_unordered_due(queues: &Mutex<UnorderedQueues>, now: Instant, stats: &DataStatsCounters) -> Vec<SeqPacket> {
+    let mut out = Vec::new();
+    let mut queues = queues.lock().unwrap();
+    queues.unacked.retain(|_, entry| {
+        if entry.deadline.is_some_and(|d| now > d) {
+            stats.expired_dropped.fetch_add(1, Ordering::Relaxed);
+            return false;
+        }
+        if entry.next_retx > now {
+            return true;
+        }
+        if entry.attempts >= UNORDERED_MAX_ATTEMPTS {
+            stats.record_dropped(true, 1);
+            return false;
+        }
+        entry.attempts += 1;
+        let backoff = UNORDERED_RTO.saturating_mul(1 << entry.attempts.min(5)).min(UNORDERED_RTO_MAX);
+        entry.next_retx = now + backoff;
+        stats.unordered_retransmits.fetch_add(1, Ordering::Relaxed);
+        out.push(SeqPacket { topic: entry.topic.clone(), packet: entry.packet.clone(), destinations: entry.pending.clone(), deadline: entry.deadline, enqueued: None });
+        true
+    });
+    let ack_topic = framing::framed_topic(framing::ACK_LABEL);
+    for (identity, seqs) in queues.acks_out.drain() {
+        let mut packet = Vec::new();
+        framing::begin_ack_packet(&mut packet);
+        for seq in seqs {
+            if packet.len() + framing::varint_len(seq as u64) > framing::LOSSY_MTU {
+                out.push(SeqPacket { topic: ack_topic.clone(), packet: packet.clone(), destinations: vec![identity.clone()], deadline: None, enqueued: None });
+                framing::begin_ack_packet(&mut packet);
+            }
+            framing::put_varint(&mut packet, seq as u64);
+        }
+        out.push(SeqPacket { topic: ack_topic.clone(), packet, destinations: vec![identity], deadline: None, enqueued: None });
+    }
+    out
+}
+
+/// Sends first transmissions as they are queued; every tick, retransmits unacked messages to
+/// the peers that have not acked them and flushes acks. Exits when the client drops the sender.
+fn spawn_unordered_worker(
+    rt: &Runtime,
+    participant: LocalParticipant,
+    queues: Arc<Mutex<UnorderedQueues>>,
+    stats: Arc<DataStatsCounters>,
+    mut rx: tokio::sync::mpsc::UnboundedReceiver<SeqPacket>,
+) {
+    rt.spawn(async move {
+        let mut tick = interval(UNORDERED_TICK);
+        tick.set_missed_tick_behavior(tokio::time::MissedTickBehavior::Skip);
+        loop {
+            let ready = tokio::select! {
+                msg = rx.recv() => match msg {
+                    Some(packet) => vec![packet],
+                    None => return,
+                },
+                _ = tick.tick() => take_unordered_due(&queues, Instant::now(), &stats),
+            };
+            for seq_packet in ready {
+                if seq_packet.deadline.is_some_and(|d| Instant::now() > d) {
+                    stats.expired_dropped.fetch_add(1, Ordering::Relaxed);
+                    continue;
+                }
+                trace_span!("data.publish_unordered");
+                let len = seq_packet.packet.len() as i64;
+                let res = participant
+                    .publish_data(DataPacket {
+                        payload: seq_packet.packet,
+                        topic: Some(seq_packet.topic),
+                        reliable: false,
+                        destination_identities: seq_packet.destinations.into_iter().map(Into::into).collect(),
+                        ..Default::default()
+                    })
+                    .await;
+                // Failed sends of reliable messages are covered by retransmission
+                if res.is_ok() {
+                    stats.record_sent(false, len);
+                    if let Some(enqueued) = seq_packet.enqueued {
+                        stats.send_latency.record(enqueued.elapsed());
+                    }
+                }
+            }
+        }
+    });
+}
+
+/// Choose how sequenced (`ordered = 0`) messages on `label` are filtered on receipt.
+/// Duplicates are always dropped; `Sequenced` also drops anything older than the newest
+/// message already delivered from the same sender.
+///
+/// # Safety
+/// `label` must be a valid NUL-terminated UTF-8 string.
+#[no_mangle]
+pub unsafe extern "C" fn lk_set_receive_filter(
+    client: *mut LkClientHandle,
+    label: *const c_char,
+    filter: LkReceiveFilter,
+) -> LkResult {
+    if client.is_null() { return err(1, "client null"); }
+    let topic = match cstr(label) {
+        Ok(s) if !s.is_empty() => s.to_string(),
+        Ok(_) => return err(5, "label empty"),
+        Err(e) => return err(2, &format!("label: {e}")),
+    };
+    let c = &*(client as *const Client);
+    let mut g = c.0.lock().unwrap();
+    match filter {
+        LkReceiveFilter::Sequenced => {
+            g.sequenced_labels.entry(topic).or_default();
+        }
+        LkReceiveFilter::Dedup => {
+            g.sequenced_labels.remove(&topic);
+        }
+    }
+    ok()
+}
+
+// --------- Send batching ---------
 
-    match g.audio_tracks.get_mut(&track_id) {
-        Some(pipeline) => {
-            if let Err(e) = pipeline.push(slice) {
-                let msg = format!("audio ring push failed: {}", e);
-                lk_log!(g, LkLogLevel::Error, "{}", msg);
-                return err(8, &msg);
+async fn publish_batch(participant: &LocalParticipant, packet: BatchPacket, stats: &DataStatsCounters) {
+    trace_span!("data.publish_batch");
+    let len = packet.payload.len() as i64;
+    let (reliable, messages, opened, batched) = (packet.reliable, packet.messages, packet.opened, packet.batched);
+    let res = participant
+        .publish_data(DataPacket {
+            payload: packet.payload,
+            topic: Some(packet.topic),
+            reliable,
+            destination_identities: packet.destinations.into_iter().map(Into::into).collect(),
+            ..Default::default()
+        })
+        .await;
+    match res {
+        Ok(_) => {
+            stats.record_sent(reliable, len);
+            if batched {
+                stats.batched_messages.fetch_add(messages, Ordering::Relaxed);
+                stats.batch_packets.fetch_add(1, Ordering::Relaxed);
             }
+            stats.send_latency.record(opened.elapsed());
         }
-        None => {
-            let msg = "audio pipeline disappeared";
-            lk_log!(g, LkLogLevel::Error, "{}", msg);
-            return err(8, msg);
-        }
+        Err(_) => stats.record_dropped(reliable, messages),
     }
+}
 
-    ok()
+/// Publishes sealed batches in submission order and flushes expired ones. Holds only a weak
+/// reference to the client; exits once the sender side is dropped (after a final flush).
+fn spawn_batch_worker(
+    rt: &Runtime,
+    client: Weak<Mutex<ClientState>>,
+    batcher: Arc<DataBatcher>,
+    stats: Arc<DataStatsCounters>,
+    mut rx: tokio::sync::mpsc::UnboundedReceiver<BatchPacket>,
+) -> JoinHandle<()> {
+    let period = (batcher.flush_window / 2).max(Duration::from_millis(1));
+    rt.spawn(async move {
+        let mut tick = interval(period);
+        tick.set_missed_tick_behavior(tokio::time::MissedTickBehavior::Skip);
+        loop {
+            // Sealed batches first: they are older than anything take_due can seal
+            let (ready, last) = tokio::select! {
+                biased;
+                msg = rx.recv() => match msg {
+                    Some(packet) => (vec![packet], false),
+                    None => (batcher.take_due(Instant::now(), true), true),
+                },
+                _ = tick.tick() => {
+                    let due = batcher.take_due(Instant::now(), false);
+                    // Anything sealed before take_due got the lock is already in the channel
+                    let mut ready = Vec::new();
+                    while let Ok(packet) = rx.try_recv() {
+                        ready.push(packet);
+                    }
+                    ready.extend(due);
+                    (ready, false)
+                }
+            };
+            if !ready.is_empty() {
+                let participant = client
+                    .upgrade()
+                    .and_then(|c| c.lock().ok().and_then(|g| g.room.as_ref().map(|r| r.local_participant())));
+                match participant {
+                    Some(p) => {
+                        for packet in ready {
+                            publish_batch(&p, packet, &stats).await;
+                        }
+                    }
+                    None => {
+                        for packet in ready {
+                            stats.record_dropped(packet.reliable, packet.messages);
+                        }
+                    }
+                }
+            }
+            if last {
+                return;
+            }
+        }
+    })
 }
 
+/// Enable or disable send batching for lk_send_data / lk_send_data_ex.
+/// Disabling flushes whatever is still pending before returning; so does reconfiguring, so
+/// the previous worker's packets all go out before the new worker's first.
 #[no_mangle]
-pub extern "C" fn lk_audio_track_create(
+pub extern "C" fn lk_set_data_batching(
     client: *mut LkClientHandle,
-    config: *const LkAudioTrackConfig,
-    out_track: *mut *mut LkAudioTrackHandle,
+    enabled: c_int,
+    flush_window_ms: c_int,
+    max_packet_bytes: c_int,
 ) -> LkResult {
     if client.is_null() {
         return err(1, "client null");
     }
-    if config.is_null() {
-        return err(5, "config null");
-    }
-    if out_track.is_null() {
-        return err(5, "out_track null");
+    let c = unsafe { &*(client as *const Client) };
+    let mut g = c.0.lock().unwrap();
+    // Dropping the previous sender makes its worker flush and exit. It needs the client lock
+    // to find the participant, so wait for it unlocked.
+    if let Some(prev) = g.batching.take() {
+        let rt = g.rt.clone();
+        drop(prev.tx);
+        drop(g);
+        let _ = rt.block_on(prev.worker);
+        g = c.0.lock().unwrap();
     }
-
-    let cfg = unsafe { &*config };
-    if cfg.sample_rate <= 0 || cfg.channels <= 0 {
-        return err(5, "invalid audio track parameters");
+    if enabled == 0 {
+        return ok();
     }
-
-    let label = if cfg.track_name.is_null() {
-        "ue-audio-track"
+    let flush_window = Duration::from_millis(if flush_window_ms <= 0 { 5 } else { flush_window_ms as u64 });
+    let max_packet = if max_packet_bytes <= 0 {
+        framing::LOSSY_MTU
     } else {
-        match unsafe { cstr(cfg.track_name) } {
-            Ok(s) => s,
-            Err(_) => "ue-audio-track",
-        }
+        (max_packet_bytes as usize).clamp(64, framing::RELIABLE_MAX)
     };
-    let buffer_ms = if cfg.buffer_ms <= 0 { 1_000 } else { cfg.buffer_ms };
+    let batcher = Arc::new(DataBatcher { flush_window, max_packet, pending: Mutex::new(HashMap::new()) });
+    let (tx, rx) = tokio::sync::mpsc::unbounded_channel();
+    let worker = spawn_batch_worker(&g.rt, Arc::downgrade(&c.0), batcher.clone(), g.data_stats.clone(), rx);
+    g.batching = Some(BatchingState { batcher, tx, worker });
+    lk_log!(g, LkLogLevel::Info, "Data batching enabled (window={:?}, packet<={} bytes)", flush_window, max_packet);
+    ok()
+}
 
-    let c = unsafe { &*(client as *const Client) };
-    let mut g = c.0.lock().unwrap();
-    let track_id = match register_audio_pipeline(
-        &mut g,
-        label,
-        cfg.sample_rate as u32,
-        cfg.channels as u32,
-        buffer_ms as u32,
-    ) {
-        Ok(id) => id,
-        Err(e) => {
-            let msg = format!("audio track create failed: {}", e);
-            return err(7, &msg);
-        }
-    };
+#[no_mangle]
+pub extern "C" fn lk_send_data(
+    client: *mut LkClientHandle,
+    bytes: *const u8,
+    len: usize,
+    reliability: LkReliability,
+) -> LkResult {
+    // Delegate to lk_send_data_ex with default parameters
+    lk_send_data_ex(client, bytes, len, reliability, 1, ptr::null())
+}
 
-    let handle = Box::new(LkAudioTrackHandle(AudioTrackHandleRef {
-        client: c.0.clone(),
-        track_id,
-    }));
-    unsafe {
-        *out_track = Box::into_raw(handle);
-    }
-    ok()
+#[no_mangle]
+pub extern "C" fn lk_send_data_ex(
+    client: *mut LkClientHandle,
+    bytes: *const u8,
+    len: usize,
+    reliability: LkReliability,
+    ordered: c_int,
+    label: *const c_char,
+) -> LkResult {
+    send_data(client, bytes, len, reliability, ordered, label, None, Vec::new(), None)
 }
 
+/// Send a caller-allocated buffer without copying it. The FFI takes ownership and calls
+/// `release` exactly once when it no longer needs the bytes: after they are on the wire, or
+/// on failure (possibly before this function returns). Ordered sends return immediately and
+/// go out in order through the send queue. `release` never runs under the client lock.
+/// A positive `max_age_ms` is a deadline, as in `lk_send_data_opts`.
+///
+/// # Safety
+/// `bytes` must stay valid and unmodified until `release` is called.
 #[no_mangle]
-pub extern "C" fn lk_audio_track_destroy(track: *mut LkAudioTrackHandle) -> LkResult {
-    if track.is_null() {
-        return err(1, "track null");
+pub unsafe extern "C" fn lk_send_data_owned(
+    client: *mut LkClientHandle,
+    bytes: *const u8,
+    len: usize,
+    reliability: LkReliability,
+    ordered: c_int,
+    label: *const c_char,
+    max_age_ms: c_int,
+    release: Option<extern "C" fn(user: *mut c_void, bytes: *const u8, len: usize)>,
+    user: *mut c_void,
+) -> LkResult {
+    let Some(release) = release else { return err(4, "release callback required"); };
+    if bytes.is_null() {
+        release(user, bytes, len);
+        return err(4, "bytes null");
     }
-    unsafe {
-        let handle = Box::from_raw(track);
-        let client = handle.0.client.clone();
-        let track_id = handle.0.track_id;
-        drop(handle);
+    let owned = OwnedBuffer { bytes, len, release, user: UserPtr(user) };
+    send_data(client, bytes, len, reliability, ordered, label, max_age(max_age_ms), Vec::new(), Some(owned))
+}
 
-        let mut g = client.lock().unwrap();
-        let _ = g.audio_tracks.remove(&track_id);
-        if g.default_audio_track_id == Some(track_id) {
-            g.default_audio_track_id = None;
+/// Send only to the listed participants (by identity) instead of the whole room, so fan-out
+/// bandwidth scales with recipients rather than room size. A positive `max_age_ms` is a
+/// deadline, as in `lk_send_data_opts`.
+///
+/// # Safety
+/// `identities` must point to `count` valid NUL-terminated strings.
+#[no_mangle]
+pub unsafe extern "C" fn lk_send_data_to(
+    client: *mut LkClientHandle,
+    bytes: *const u8,
+    len: usize,
+    reliability: LkReliability,
+    ordered: c_int,
+    label: *const c_char,
+    max_age_ms: c_int,
+    identities: *const *const c_char,
+    count: usize,
+) -> LkResult {
+    if identities.is_null() || count == 0 {
+        return err(4, "identities null");
+    }
+    let mut destinations = Vec::with_capacity(count);
+    for &identity in std::slice::from_raw_parts(identities, count) {
+        match cstr(identity) {
+            Ok(s) if !s.is_empty() => destinations.push(s.to_string()),
+            Ok(_) => return err(5, "identity empty"),
+            Err(e) => return err(2, &format!("identity: {e}")),
         }
     }
-    ok()
+    send_data(client, bytes, len, reliability, ordered, label, max_age(max_age_ms), destinations, None)
 }
 
+/// `lk_send_data_to` addressed by interned participant IDs. Returns error 5 for an unknown ID.
+///
+/// # Safety
+/// `participant_ids` must point to `count` IDs.
 #[no_mangle]
-pub extern "C" fn lk_audio_track_publish_pcm_i16(
-    track: *mut LkAudioTrackHandle,
-    pcm: *const i16,
-    frames_per_channel: usize,
+pub unsafe extern "C" fn lk_send_data_to_ids(
+    client: *mut LkClientHandle,
+    bytes: *const u8,
+    len: usize,
+    reliability: LkReliability,
+    ordered: c_int,
+    label: *const c_char,
+    max_age_ms: c_int,
+    participant_ids: *const u32,
+    count: usize,
 ) -> LkResult {
-    if track.is_null() {
-        return err(1, "track null");
+    if client.is_null() {
+        return err(1, "client null");
     }
-    if pcm.is_null() {
-        return err(4, "pcm null");
+    if participant_ids.is_null() || count == 0 {
+        return err(4, "participant_ids null");
     }
-    let handle = unsafe { &*(track as *mut LkAudioTrackHandle) };
-    let client = handle.0.client.clone();
-    let mut g = client.lock().unwrap();
-    let pipeline = match g.audio_tracks.get_mut(&handle.0.track_id) {
-        Some(p) => p,
-        None => return err(6, "audio track not found"),
+    let destinations = {
+        let c = &*(client as *const Client);
+        let g = c.0.lock().unwrap();
+        let mut destinations = Vec::with_capacity(count);
+        for id in std::slice::from_raw_parts(participant_ids, count) {
+            match g.registry.participant_names.get(id).and_then(|n| n.to_str().ok()) {
+                Some(identity) => destinations.push(identity.to_string()),
+                None => return err(5, &format!("unknown participant id {id}")),
+            }
+        }
+        destinations
     };
-    let total = frames_per_channel * pipeline.channels as usize;
-    let slice = unsafe { std::slice::from_raw_parts(pcm, total) };
-    if let Err(e) = pipeline.push(slice) {
-        let msg = format!("audio ring push failed: {}", e);
-        return err(8, &msg);
-    }
-    ok()
+    send_data(client, bytes, len, reliability, ordered, label, max_age(max_age_ms), destinations, None)
 }
 
+/// Send with per-message options. A positive `max_age_ms` routes the message through the
+/// send queue, which discards it instead of transmitting it once it is older than that.
+///
+/// # Safety
+/// `opts` must be NULL or point to a valid `LkSendOptions`.
 #[no_mangle]
-pub extern "C" fn lk_send_data(
+pub unsafe extern "C" fn lk_send_data_opts(
     client: *mut LkClientHandle,
     bytes: *const u8,
     len: usize,
-    reliability: LkReliability,
+    opts: *const LkSendOptions,
 ) -> LkResult {
-    // Delegate to lk_send_data_ex with default parameters
-    lk_send_data_ex(client, bytes, len, reliability, 1, ptr::null())
+    if opts.is_null() {
+        return err(4, "opts null");
+    }
+    let opts = &*opts;
+    send_data(client, bytes, len, opts.reliability, opts.ordered, opts.label, max_age(opts.max_age_ms), Vec::new(), None)
 }
 
-#[no_mangle]
-pub extern "C" fn lk_send_data_ex(
+/// A send deadline in milliseconds; 0 or less = none.
+fn max_age(ms: c_int) -> Option<Duration> {
+    (ms > 0).then(|| Duration::from_millis(ms as u64))
+}
+
+fn send_data(
     client: *mut LkClientHandle,
     bytes: *const u8,
     len: usize,
     reliability: LkReliability,
-    _ordered: c_int,
+    ordered: c_int,
     label: *const c_char,
+    max_age: Option<Duration>,
+    destinations: Vec<String>,
+    mut owned: Option<OwnedBuffer>,
 ) -> LkResult {
     if client.is_null() {
         return err(1, "client null");
@@ -1277,17 +5109,58 @@ pub extern "C" fn lk_send_data_ex(
     if bytes.is_null() {
         return err(4, "bytes null");
     }
+    trace_span!("data.send");
+    let called = Instant::now();
     
     let c = unsafe { &*(client as *const Client) };
-    let g = c.0.lock().unwrap();
-    let room = match g.room.as_ref() {
-        Some(r) => r,
-        None => return err(6, "not connected"),
-    };
+    let mut g = c.0.lock().unwrap();
+    if g.room.is_none() {
+        drop(g);
+        return err(6, "not connected");
+    }
+
+    let res = send_data_locked(&mut g, bytes, len, reliability, ordered, label, max_age, destinations, &mut owned, called);
+    // Only messages that went out (or were queued to) count towards the rate controller's
+    // message size estimate
+    if res.code == 0 && !label.is_null() && !g.rate_controls.is_empty() {
+        if let Some(rc) = unsafe { cstr(label) }.ok().and_then(|t| g.rate_controls.get_mut(t)) {
+            rc.record_send(len);
+        }
+    }
+    // An owned buffer the send did not keep (it failed, or the bytes were copied) is released
+    // only once the lock is free, so the release callback may call back into the FFI
+    drop(g);
+    drop(owned);
+    res
+}
+
+fn send_data_locked(
+    g: &mut ClientState,
+    bytes: *const u8,
+    len: usize,
+    reliability: LkReliability,
+    ordered: c_int,
+    label: *const c_char,
+    max_age: Option<Duration>,
+    mut destinations: Vec<String>,
+    owned: &mut Option<OwnedBuffer>,
+    called: Instant,
+) -> LkResult {
+    // Compressed label: the size limits apply to the compressed packet. Delta-coded labels
+    // carry their own LZ4 pass and are left alone.
+    if !label.is_null() && len <= compress::MAX_UNCOMPRESSED {
+        let topic = unsafe { cstr(label) }.unwrap_or("custom");
+        if !g.delta_tx.contains_key(topic) {
+            let slice = unsafe { std::slice::from_raw_parts(bytes, len) };
+            if let Some(res) = send_compressed(g, topic, slice, reliability, &mut destinations, max_age) {
+                return res;
+            }
+        }
+    }
 
     // Enforce size limits (lossy traffic auto-falls back to reliable if payload exceeds MTU)
-    const LOSSY_MAX: usize = 1300;
-    const RELIABLE_MAX: usize = 15 * 1024;
+    const LOSSY_MAX: usize = framing::LOSSY_MTU;
+    const RELIABLE_MAX: usize = framing::RELIABLE_MAX;
     let mut effective_rel = reliability;
     if matches!(reliability, LkReliability::Lossy) && len > LOSSY_MAX {
         effective_rel = LkReliability::Reliable;
@@ -1308,8 +5181,6 @@ pub extern "C" fn lk_send_data_ex(
         }
     }
 
-    let payload = unsafe { std::slice::from_raw_parts(bytes, len) }.to_vec();
-    
     // Determine topic from label or defaults
     let topic = if !label.is_null() {
         unsafe { cstr(label) }.unwrap_or("custom").to_string()
@@ -1320,10 +5191,116 @@ pub extern "C" fn lk_send_data_ex(
         }
     };
 
+    // Delta-coded label: the coded frame goes out on the framed topic through the send queue,
+    // which keeps frames in order. Targeted sends go out uncoded: other participants would
+    // miss keyframes sent only to the targets.
+    if destinations.is_empty() && g.delta_tx.contains_key(&topic) {
+        let slice = unsafe { std::slice::from_raw_parts(bytes, len) };
+        let started = Instant::now();
+        let mut packet = Vec::with_capacity(len + 16);
+        let key = match g.delta_tx.get_mut(&topic) {
+            Some(encoder) => encoder.encode(slice, &mut packet),
+            None => return err(5, "no delta channel"),
+        };
+        let stats = delta_stats_mut(&mut g.delta_stats, &topic);
+        stats.frames_sent += 1;
+        stats.keyframes_sent += key as i64;
+        stats.raw_bytes += len as i64;
+        stats.encoded_bytes += packet.len() as i64;
+        stats.encode_ns += started.elapsed().as_nanos() as i64;
+        let packet = stamp_packet(g, &topic, packet, true);
+        if packet.len() > RELIABLE_MAX {
+            return err(202, &format!("coded frame size {} exceeds limit {}", packet.len(), RELIABLE_MAX));
+        }
+        // An LZ4-less keyframe can outgrow the lossy limit by its few header bytes
+        let reliable = matches!(effective_rel, LkReliability::Reliable) || packet.len() > LOSSY_MAX;
+        return queue_framed(g, &topic, packet, true, reliable, destinations, max_age);
+    }
+
+    // Timestamped label: the message goes out in a timed packet on the framed topic, through
+    // the send queue like other framed traffic. It is neither batched nor sent unordered.
+    if g.timestamped_labels.contains(&topic) {
+        let slice = unsafe { std::slice::from_raw_parts(bytes, len) };
+        let packet = stamp_packet(g, &topic, slice.to_vec(), false);
+        if packet.len() > RELIABLE_MAX {
+            return err(202, &format!("timestamped data size {} exceeds limit {}", packet.len(), RELIABLE_MAX));
+        }
+        let reliable = matches!(effective_rel, LkReliability::Reliable) || packet.len() > LOSSY_MAX;
+        return queue_framed(g, &topic, packet, true, reliable, destinations, max_age);
+    }
+
+    // FEC label: lossy broadcasts are numbered into parity groups on the framed topic, through
+    // the send queue. They are neither batched nor sent unordered.
+    let lossy = matches!(effective_rel, LkReliability::Lossy);
+    if fec_protects(g, &topic, !lossy, &destinations, len) {
+        let slice = unsafe { std::slice::from_raw_parts(bytes, len) };
+        return queue_framed(g, &topic, slice.to_vec(), false, false, destinations, max_age);
+    }
+
+    // Unordered: one sequenced packet per message, never queued behind other traffic
+    if ordered == 0 {
+        if len + framing::seq_packet_overhead(u32::MAX) <= LOSSY_MAX {
+            let slice = unsafe { std::slice::from_raw_parts(bytes, len) };
+            let deadline = max_age.map(|age| Instant::now() + age);
+            return send_unordered(g, &topic, matches!(effective_rel, LkReliability::Reliable), slice, deadline, destinations);
+        }
+        lk_log!(g, LkLogLevel::Debug,
+            "Unordered payload ({} bytes) does not fit one packet; sending ordered", len);
+    }
+
+    // Deadline, send class or owned buffer: queue it for the scheduler, which also drops it
+    // unsent if it waits longer than max_age. Owned buffers are queued without a copy. Once a
+    // label has queued a message, all its sends are queued so none overtakes another.
+    if owned.is_some() || max_age.is_some() || g.send_classes.contains_key(&topic) || g.queued_labels.contains(&topic) {
+        let reliable = matches!(effective_rel, LkReliability::Reliable);
+        let now = Instant::now();
+        if !g.queued_labels.contains(&topic) {
+            g.queued_labels.insert(topic.clone());
+            // Best effort: earlier batched messages go out ahead of the first queued one
+            if let Some(batching) = g.batching.as_ref() {
+                batching.batcher.flush_label(&topic, &batching.tx);
+            }
+        }
+        let Some(queue) = send_queue(g) else { return err(6, "not connected"); };
+        let payload = match owned.take() {
+            Some(buffer) => Payload::Owned(Box::new(buffer)),
+            None => Payload::Copied(unsafe { std::slice::from_raw_parts(bytes, len) }.to_vec()),
+        };
+        let label = topic.clone();
+        queue.push(&label, QueuedSend { topic, payload, reliable, destinations, enqueued: now, deadline: max_age.map(|age| now + age) });
+        return ok();
+    }
+
+    // Batching: append to the label's open packet and return; the batch worker publishes it.
+    // Batches are broadcast, so targeted sends skip them. Messages that are not batched still
+    // go through the worker, behind the label's open batch, so they cannot overtake it.
+    if let Some(batching) = g.batching.as_ref() {
+        let reliable = matches!(effective_rel, LkReliability::Reliable);
+        let slice = unsafe { std::slice::from_raw_parts(bytes, len) };
+        if destinations.is_empty() && batching.batcher.fits(reliable, len) {
+            batching.batcher.push(&topic, reliable, slice, &batching.tx);
+        } else {
+            let message = BatchPacket {
+                topic: topic.clone(),
+                reliable,
+                payload: slice.to_vec(),
+                messages: 1,
+                opened: called,
+                batched: false,
+                destinations,
+            };
+            batching.batcher.pass_through(&topic, message, &batching.tx);
+        }
+        return ok();
+    }
+
+    let payload = unsafe { std::slice::from_raw_parts(bytes, len) }.to_vec();
+
+    let Some(room) = g.room.as_ref() else { return err(6, "not connected"); };
     let rt = g.rt.clone();
     let stats = g.data_stats.clone();
     let effective_rel_copy = effective_rel;
-    let current_log_level = g.log_level;
+    let log = g.log.clone();
     
     let res = rt.block_on(async {
         // Helper to perform one send attempt
@@ -1331,8 +5308,13 @@ pub extern "C" fn lk_send_data_ex(
             room: &Room,
             topic: &str,
             payload: &[u8],
+            destinations: &[String],
         ) -> Result<(), anyhow::Error> {
-            let options = StreamByteOptions { topic: topic.to_string(), ..Default::default() };
+            let options = StreamByteOptions {
+                topic: topic.to_string(),
+                destination_identities: destinations.iter().map(|d| d.clone().into()).collect(),
+                ..Default::default()
+            };
             let writer: ByteStreamWriter = room
                 .local_participant()
                 .stream_bytes(options)
@@ -1343,15 +5325,13 @@ pub extern "C" fn lk_send_data_ex(
         }
 
         // First attempt
-        match send_once(room, &topic, &payload).await {
+        match send_once(room, &topic, &payload, &destinations).await {
             Ok(_) => Ok(()),
             Err(e1) => {
                 // Brief backoff then one retry; common when engine is still settling right after join
-                if (LkLogLevel::Warn as i32) <= (current_log_level as i32) {
-                    println!("[livekit_ffi] send_data first attempt failed, retrying: {}", e1);
-                }
+                lk_log_to!(log, LkLogLevel::Warn, "send_data first attempt failed, retrying: {}", e1);
                 tokio::time::sleep(Duration::from_millis(100)).await;
-                send_once(room, &topic, &payload).await
+                send_once(room, &topic, &payload, &destinations).await
             }
         }
     });
@@ -1367,6 +5347,7 @@ pub extern "C" fn lk_send_data_ex(
                     stats.lossy_sent_bytes.fetch_add(len as i64, Ordering::Relaxed);
                 }
             }
+            stats.send_latency.record(called.elapsed());
             lk_log!(g, LkLogLevel::Debug, "Sent data: {} bytes, topic='{}'", len, topic);
             ok()
         },
@@ -1452,13 +5433,111 @@ pub unsafe extern "C" fn lk_get_data_stats(
     
     let c = &*(client as *const Client);
     let g = c.0.lock().unwrap();
+    let raw = g.data_stats.compressed_raw_bytes.load(Ordering::Relaxed);
+    let wire = g.data_stats.compressed_wire_bytes.load(Ordering::Relaxed);
+    let fec_bytes = g.data_stats.fec_message_bytes.load(Ordering::Relaxed);
+    let fec_overhead = g.data_stats.fec_overhead_bytes.load(Ordering::Relaxed);
     
     *out_stats = LkDataStats {
         reliable_sent_bytes: g.data_stats.reliable_sent_bytes.load(Ordering::Relaxed),
         reliable_dropped: g.data_stats.reliable_dropped.load(Ordering::Relaxed),
         lossy_sent_bytes: g.data_stats.lossy_sent_bytes.load(Ordering::Relaxed),
         lossy_dropped: g.data_stats.lossy_dropped.load(Ordering::Relaxed),
+        batched_messages: g.data_stats.batched_messages.load(Ordering::Relaxed),
+        batch_packets: g.data_stats.batch_packets.load(Ordering::Relaxed),
+        unordered_retransmits: g.data_stats.unordered_retransmits.load(Ordering::Relaxed),
+        duplicates_dropped: g.data_stats.duplicates_dropped.load(Ordering::Relaxed),
+        stale_dropped: g.data_stats.stale_dropped.load(Ordering::Relaxed),
+        expired_dropped: g.data_stats.expired_dropped.load(Ordering::Relaxed),
+        compressed_messages: g.data_stats.compressed_messages.load(Ordering::Relaxed),
+        compressed_raw_bytes: raw,
+        compressed_wire_bytes: wire,
+        compression_ratio: if wire > 0 { raw as f64 / wire as f64 } else { 0.0 },
+        decompress_failed: g.data_stats.decompress_failed.load(Ordering::Relaxed),
+        fec_messages: g.data_stats.fec_messages.load(Ordering::Relaxed),
+        fec_parity_packets: g.data_stats.fec_parity_packets.load(Ordering::Relaxed),
+        fec_overhead_ratio: if fec_bytes > 0 { fec_overhead as f64 / fec_bytes as f64 } else { 0.0 },
+        fec_recovered: g.data_stats.fec_recovered.load(Ordering::Relaxed),
+        fec_unrecovered: g.data_stats.fec_unrecovered.load(Ordering::Relaxed),
     };
     
     ok()
 }
+
+/// # Safety
+/// The caller must ensure `out_stats` points to valid writable memory.
+#[no_mangle]
+pub unsafe extern "C" fn lk_get_latency_stats(
+    client: *mut LkClientHandle,
+    out_stats: *mut LkLatencyStats,
+    reset: i32,
+) -> LkResult {
+    if client.is_null() {
+        return err(1, "client null");
+    }
+    if out_stats.is_null() {
+        return err(4, "out_stats null");
+    }
+    let c = &*(client as *const Client);
+    // Only the Arcs are taken under the lock; the snapshots run without it
+    let (data_stats, latency) = {
+        let g = c.0.lock().unwrap();
+        (g.data_stats.clone(), g.latency.clone())
+    };
+    let reset = reset != 0;
+    *out_stats = LkLatencyStats {
+        audio_ring: latency.audio_ring.snapshot(reset).into(),
+        send: data_stats.send_latency.snapshot(reset).into(),
+        dispatch: latency.dispatch.snapshot(reset).into(),
+        callback: latency.callback.snapshot(reset).into(),
+    };
+    ok()
+}
+
+// --------- Tracing ---------
+
+/// Start (non-zero) or stop recording hot-path spans, process-wide. 501 without `trace_spans`.
+#[no_mangle]
+pub extern "C" fn lk_trace_enable(enabled: i32) -> LkResult {
+    #[cfg(feature = "trace_spans")]
+    {
+        crate::trace::set_enabled(enabled != 0);
+        ok()
+    }
+    #[cfg(not(feature = "trace_spans"))]
+    {
+        let _ = enabled;
+        err(501, "built without the trace_spans feature")
+    }
+}
+
+/// Write the recorded spans to `path` as Chrome trace JSON and clear them. `out_spans`, if not
+/// NULL, gets the number written. 501 without `trace_spans`.
+///
+/// # Safety
+/// `path` must be a valid NUL-terminated UTF-8 string; `out_spans` NULL or writable.
+#[no_mangle]
+pub unsafe extern "C" fn lk_trace_dump(path: *const c_char, out_spans: *mut usize) -> LkResult {
+    #[cfg(feature = "trace_spans")]
+    {
+        let path = match cstr(path) {
+            Ok(s) if !s.is_empty() => s,
+            Ok(_) => return err(5, "path empty"),
+            Err(e) => return err(2, &format!("path: {e}")),
+        };
+        match crate::trace::dump(std::path::Path::new(path)) {
+            Ok(spans) => {
+                if !out_spans.is_null() {
+                    *out_spans = spans;
+                }
+                ok()
+            }
+            Err(e) => err(500, &format!("trace dump to '{path}' failed: {e}")),
+        }
+    }
+    #[cfg(not(feature = "trace_spans"))]
+    {
+        let _ = (path, out_spans);
+        err(501, "built without the trace_spans feature")
+    }
+}
@@ -3,6 +3,7 @@
 use std::os::raw::{c_char, c_int, c_void, c_float};
 use std::ffi::CString;
 use std::sync::{Arc, Mutex};
+use std::sync::atomic::{AtomicU64, Ordering};
 
 #[repr(C)]
 pub struct LkResult { pub code: c_int, pub message: *const c_char }
@@ -26,6 +27,9 @@ pub unsafe extern "C" fn lk_free_str(p: *mut c_char) {
 #[repr(C)] pub enum LkRole { Auto = 0, Publisher = 1, Subscriber = 2, Both = 3 }
 #[repr(C)] pub enum LkConnectionState { Connecting = 0, Connected = 1, Reconnecting = 2, Disconnected = 3, Failed = 4 }
 #[repr(C)] pub enum LkLogLevel { Error = 0, Warn = 1, Info = 2, Debug = 3, Trace = 4 }
+#[repr(C)] pub enum LkRegistryEvent { ParticipantJoined = 0, ParticipantLeft = 1, TrackSubscribed = 2, TrackUnsubscribed = 3 }
+#[repr(C)] pub enum LkReceiveFilter { Dedup = 0, Sequenced = 1 }
+#[repr(C)] #[derive(Copy, Clone, Debug, PartialEq, Eq)] pub enum LkTransferState { InProgress = 0, Completed = 1, Failed = 2, Cancelled = 3 }
 #[repr(C)] pub struct LkClientHandle { _private: [u8;0] }
 
 #[repr(C)]
@@ -44,6 +48,30 @@ pub struct LkDataStats {
     pub reliable_dropped: i64,
     pub lossy_sent_bytes: i64,
     pub lossy_dropped: i64,
+    pub batched_messages: i64,
+    pub batch_packets: i64,
+    pub unordered_retransmits: i64,
+    pub duplicates_dropped: i64,
+    pub stale_dropped: i64,
+    pub expired_dropped: i64,
+    pub compressed_messages: i64,
+    pub compressed_raw_bytes: i64,
+    pub compressed_wire_bytes: i64,
+    pub compression_ratio: f64,
+    pub decompress_failed: i64,
+    pub fec_messages: i64,
+    pub fec_parity_packets: i64,
+    pub fec_overhead_ratio: f64,
+    pub fec_recovered: i64,
+    pub fec_unrecovered: i64,
+}
+
+#[repr(C)]
+pub struct LkSendOptions {
+    pub reliability: LkReliability,
+    pub ordered: c_int,
+    pub label: *const c_char,
+    pub max_age_ms: c_int,
 }
 
 #[repr(C)]
@@ -97,6 +125,75 @@ struct Client(std::sync::Arc<std::sync::Mutex<ClientState>>);
     _user: *mut c_void
 ) -> LkResult { ok() }
 
+#[no_mangle] pub extern "C" fn lk_client_set_audio_callback_ids(
+    _client: *mut LkClientHandle,
+    _cb: Option<extern "C" fn(user:*mut c_void, pcm:*const i16, frames_per_channel:usize, channels:c_int, sample_rate:c_int, participant_id:u32, track_id:u32)>,
+    _user: *mut c_void
+) -> LkResult { ok() }
+
+#[no_mangle] pub extern "C" fn lk_client_set_data_callback_from(
+    _client: *mut LkClientHandle,
+    _cb: Option<extern "C" fn(user:*mut c_void, participant_id:u32, label:*const c_char, reliability: LkReliability, bytes:*const u8, len:usize)>,
+    _user: *mut c_void
+) -> LkResult { ok() }
+
+#[repr(C)] pub struct LkDataBuffer { _private: [u8; 0] }
+
+#[no_mangle] pub extern "C" fn lk_client_set_data_callback_buffered(
+    _client: *mut LkClientHandle,
+    _cb: Option<extern "C" fn(user:*mut c_void, participant_id:u32, label:*const c_char, reliability: LkReliability, bytes:*const u8, len:usize, buffer:*mut LkDataBuffer)>,
+    _user: *mut c_void
+) -> LkResult { ok() }
+
+// The stub never hands out buffers
+#[no_mangle] pub extern "C" fn lk_data_release(_buffer: *mut LkDataBuffer) {}
+
+#[no_mangle] pub extern "C" fn lk_set_registry_callback(
+    _client: *mut LkClientHandle,
+    _cb: Option<extern "C" fn(user:*mut c_void, event: LkRegistryEvent, participant_id:u32, track_id:u32, participant_identity:*const c_char, track_name:*const c_char)>,
+    _user: *mut c_void
+) -> LkResult { ok() }
+
+#[repr(C)]
+pub struct LkDataMessageInfo {
+    pub label: *const c_char,
+    pub participant_id: u32,
+    pub reliability: LkReliability,
+    pub sender_time_us: i64,
+}
+
+#[no_mangle] pub extern "C" fn lk_register_data_handler(
+    client: *mut LkClientHandle,
+    label: *const c_char,
+    _cb: Option<extern "C" fn(user:*mut c_void, info:*const LkDataMessageInfo, bytes:*const u8, len:usize)>,
+    _user: *mut c_void
+) -> LkResult {
+    if client.is_null() { return err("client null", 1); }
+    if label.is_null() { return err("label null", 2); }
+    ok()
+}
+
+#[no_mangle] pub extern "C" fn lk_get_participant_identity(
+    client: *mut LkClientHandle,
+    _participant_id: u32,
+    _buf: *mut c_char,
+    _buf_len: usize
+) -> LkResult {
+    if client.is_null() { return err("client null", 1); }
+    err("unknown participant id", 5)
+}
+
+#[no_mangle] pub extern "C" fn lk_get_track_info(
+    client: *mut LkClientHandle,
+    _track_id: u32,
+    _out_participant_id: *mut u32,
+    _buf: *mut c_char,
+    _buf_len: usize
+) -> LkResult {
+    if client.is_null() { return err("client null", 1); }
+    err("unknown track id", 5)
+}
+
 #[no_mangle] pub extern "C" fn lk_set_audio_format_change_callback(
     _client: *mut LkClientHandle,
     _cb: Option<extern "C" fn(user:*mut c_void, sample_rate:c_int, channels:c_int)>,
@@ -207,6 +304,189 @@ pub extern "C" fn lk_audio_track_publish_pcm_i16(
     ok()
 }
 
+#[repr(C)]
+pub struct LkAudioTrackStats {
+    pub name: [c_char; 64],
+    pub remote: c_int,
+    pub sample_rate: c_int,
+    pub channels: c_int,
+    pub queued_ms: c_int,
+    pub high_water_ms: c_int,
+    pub capacity_ms: c_int,
+    pub underruns: c_int,
+    pub overruns: c_int,
+    pub last_frame_us: i64,
+    pub participant_id: u32,
+    pub track_id: u32,
+    pub frames_received: i64,
+    pub samples_received: i64,
+    pub concealed_samples: i64,
+    pub jitter_buffer_ms: c_float,
+}
+
+// Stub tracks hold no audio
+#[no_mangle]
+pub unsafe extern "C" fn lk_audio_track_get_stats(track: *mut LkAudioTrackHandle, out_stats: *mut LkAudioTrackStats) -> LkResult {
+    if track.is_null() { return err("track null", 1); }
+    if out_stats.is_null() { return err("out_stats null", 4); }
+    std::ptr::write_bytes(out_stats, 0, 1);
+    ok()
+}
+
+#[no_mangle]
+pub unsafe extern "C" fn lk_get_audio_track_stats(
+    client: *mut LkClientHandle,
+    out_tracks: *mut LkAudioTrackStats,
+    capacity: usize,
+    out_count: *mut usize,
+) -> LkResult {
+    if client.is_null() { return err("client null", 1); }
+    if out_count.is_null() || (out_tracks.is_null() && capacity > 0) { return err("null pointer", 4); }
+    *out_count = 0;
+    ok()
+}
+
+#[repr(C)]
+pub struct LkStateChannelConfig {
+    pub label: *const c_char,
+    pub reliability: LkReliability,
+    pub tick_hz: c_int,
+    pub max_packet_bytes: c_int,
+}
+
+#[repr(C)]
+#[derive(Default)]
+pub struct LkStateChannelStats {
+    pub updates_written: i64,
+    pub updates_superseded: i64,
+    pub updates_sent: i64,
+    pub packets_sent: i64,
+    pub bytes_sent: i64,
+    pub packets_dropped: i64,
+}
+
+#[repr(C)]
+pub struct LkStateChannelHandle {
+    _private: [u8; 0],
+}
+
+#[no_mangle]
+pub extern "C" fn lk_state_channel_create(
+    client: *mut LkClientHandle,
+    _config: *const LkStateChannelConfig,
+    out_channel: *mut *mut LkStateChannelHandle,
+) -> LkResult {
+    if client.is_null() { return err("client null", 1); }
+    if out_channel.is_null() { return err("out_channel null", 4); }
+    unsafe {
+        *out_channel = Box::into_raw(Box::new(LkStateChannelHandle { _private: [] }));
+    }
+    ok()
+}
+
+#[no_mangle]
+pub extern "C" fn lk_state_channel_destroy(channel: *mut LkStateChannelHandle) -> LkResult {
+    if channel.is_null() { return err("channel null", 1); }
+    unsafe { drop(Box::from_raw(channel)); }
+    ok()
+}
+
+#[no_mangle]
+pub extern "C" fn lk_state_channel_write(
+    channel: *mut LkStateChannelHandle,
+    _key: u32,
+    _bytes: *const u8,
+    _len: usize,
+) -> LkResult {
+    if channel.is_null() { return err("channel null", 1); }
+    ok()
+}
+
+/// # Safety
+/// The caller must ensure `out_stats` points to valid writable memory.
+#[no_mangle]
+pub unsafe extern "C" fn lk_state_channel_get_stats(
+    channel: *mut LkStateChannelHandle,
+    out_stats: *mut LkStateChannelStats,
+) -> LkResult {
+    if channel.is_null() { return err("channel null", 1); }
+    if out_stats.is_null() { return err("out_stats null", 4); }
+    *out_stats = LkStateChannelStats::default();
+    ok()
+}
+
+#[no_mangle] pub extern "C" fn lk_register_state_handler(
+    client: *mut LkClientHandle,
+    label: *const c_char,
+    _cb: Option<extern "C" fn(user:*mut c_void, info:*const LkDataMessageInfo, key:u32, bytes:*const u8, len:usize)>,
+    _user: *mut c_void
+) -> LkResult {
+    if client.is_null() { return err("client null", 1); }
+    if label.is_null() { return err("label null", 2); }
+    ok()
+}
+
+#[no_mangle] pub extern "C" fn lk_set_data_batching(
+    client:*mut LkClientHandle,
+    _enabled: c_int,
+    _flush_window_ms: c_int,
+    _max_packet_bytes: c_int
+) -> LkResult {
+    if client.is_null() { return err("client null", 1); }
+    ok()
+}
+
+#[repr(C)]
+pub struct LkStreamChunkInfo {
+    pub label: *const c_char,
+    pub participant_id: u32,
+    pub transfer_id: u64,
+    pub offset: u64,
+    pub total_length: u64,
+    pub state: LkTransferState,
+}
+
+static NEXT_TRANSFER_ID: AtomicU64 = AtomicU64::new(1);
+
+// Stub transfers complete immediately so callers release their buffers.
+#[no_mangle] pub extern "C" fn lk_send_large(
+    client:*mut LkClientHandle,
+    bytes:*const u8,
+    len: usize,
+    label: *const c_char,
+    cb: Option<extern "C" fn(user:*mut c_void, transfer_id:u64, state:LkTransferState, bytes_done:u64, bytes_total:u64)>,
+    user: *mut c_void,
+    out_transfer_id: *mut u64
+) -> LkResult {
+    if client.is_null() { return err("client null", 1); }
+    if bytes.is_null() || len == 0 { return err("bytes null", 4); }
+    if label.is_null() { return err("label null", 2); }
+    let Some(cb) = cb else { return err("progress callback required", 4); };
+    let id = NEXT_TRANSFER_ID.fetch_add(1, Ordering::Relaxed);
+    if !out_transfer_id.is_null() { unsafe { *out_transfer_id = id; } }
+    cb(user, id, LkTransferState::Completed, len as u64, len as u64);
+    ok()
+}
+
+#[no_mangle] pub extern "C" fn lk_cancel_transfer(
+    client:*mut LkClientHandle,
+    _transfer_id: u64
+) -> LkResult {
+    if client.is_null() { return err("client null", 1); }
+    err("unknown transfer id", 5)
+}
+
+#[no_mangle] pub extern "C" fn lk_register_stream_handler(
+    client: *mut LkClientHandle,
+    label: *const c_char,
+    _cb: Option<extern "C" fn(user:*mut c_void, info:*const LkStreamChunkInfo, bytes:*const u8, len:usize)>,
+    _user: *mut c_void
+) -> LkResult {
+    if client.is_null() { return err("client null", 1); }
+    if label.is_null() { return err("label null", 2); }
+    ok()
+}
+
 #[no_mangle] pub extern "C" fn lk_send_data(
     client:*mut LkClientHandle,
     _bytes:*const u8,
@@ -229,6 +509,328 @@ pub extern "C" fn lk_audio_track_publish_pcm_i16(
     ok()
 }
 
+#[no_mangle] pub extern "C" fn lk_send_data_to(
+    client:*mut LkClientHandle,
+    _bytes:*const u8,
+    _len: usize,
+    _rel: LkReliability,
+    _ordered: c_int,
+    _label: *const c_char,
+    _max_age_ms: c_int,
+    identities: *const *const c_char,
+    count: usize
+) -> LkResult {
+    if client.is_null() { return err("client null", 1); }
+    if identities.is_null() || count == 0 { return err("identities null", 4); }
+    ok()
+}
+
+#[no_mangle] pub extern "C" fn lk_send_data_to_ids(
+    client:*mut LkClientHandle,
+    _bytes:*const u8,
+    _len: usize,
+    _rel: LkReliability,
+    _ordered: c_int,
+    _label: *const c_char,
+    _max_age_ms: c_int,
+    participant_ids: *const u32,
+    count: usize
+) -> LkResult {
+    if client.is_null() { return err("client null", 1); }
+    if participant_ids.is_null() || count == 0 { return err("participant_ids null", 4); }
+    ok()
+}
+
+#[no_mangle] pub extern "C" fn lk_send_data_opts(
+    client:*mut LkClientHandle,
+    _bytes:*const u8,
+    _len: usize,
+    opts: *const LkSendOptions
+) -> LkResult {
+    if client.is_null() { return err("client null", 1); }
+    if opts.is_null() { return err("opts null", 4); }
+    ok()
+}
+
+#[no_mangle] pub extern "C" fn lk_send_data_owned(
+    client:*mut LkClientHandle,
+    bytes:*const u8,
+    len: usize,
+    _reliability: LkReliability,
+    _ordered: c_int,
+    _label:*const c_char,
+    _max_age_ms: c_int,
+    release: Option<extern "C" fn(*mut c_void, *const u8, usize)>,
+    user:*mut c_void
+) -> LkResult {
+    let Some(release) = release else { return err("release callback required", 4); };
+    release(user, bytes, len);
+    if client.is_null() { return err("client null", 1); }
+    ok()
+}
+
+#[repr(C)] pub enum LkSchedulerMode { Strict = 0, Weighted = 1 }
+
+#[repr(C)]
+pub struct LkDataClassConfig {
+    pub priority: c_int,
+    pub weight: c_int,
+    pub rate_bytes_per_sec: c_int,
+    pub burst_bytes: c_int,
+}
+
+#[repr(C)]
+#[derive(Default)]
+pub struct LkDataClassStats {
+    pub queue_depth: i64,
+    pub queued_bytes: i64,
+    pub sent_messages: i64,
+    pub sent_bytes: i64,
+    pub expired_dropped: i64,
+    pub wait_p50_us: i64,
+    pub wait_p95_us: i64,
+    pub wait_p99_us: i64,
+}
+
+#[no_mangle] pub extern "C" fn lk_set_data_class(
+    client:*mut LkClientHandle,
+    label: *const c_char,
+    _config: *const LkDataClassConfig
+) -> LkResult {
+    if client.is_null() { return err("client null", 1); }
+    if label.is_null() { return err("label null", 2); }
+    ok()
+}
+
+#[no_mangle] pub extern "C" fn lk_set_send_scheduler(
+    client:*mut LkClientHandle,
+    _mode: LkSchedulerMode
+) -> LkResult {
+    if client.is_null() { return err("client null", 1); }
+    ok()
+}
+
+#[no_mangle] pub extern "C" fn lk_get_data_class_stats(
+    client:*mut LkClientHandle,
+    _label: *const c_char,
+    out_stats: *mut LkDataClassStats
+) -> LkResult {
+    if client.is_null() { return err("client null", 1); }
+    if out_stats.is_null() { return err("out_stats null", 4); }
+    unsafe { *out_stats = LkDataClassStats::default(); }
+    ok()
+}
+
+#[repr(C)]
+pub struct LkDeltaConfig {
+    pub keyframe_interval: c_int,
+    pub use_lz4: c_int,
+}
+
+#[repr(C)]
+#[derive(Default)]
+pub struct LkDeltaStats {
+    pub frames_sent: i64,
+    pub keyframes_sent: i64,
+    pub raw_bytes_sent: i64,
+    pub encoded_bytes_sent: i64,
+    pub encode_ns_per_frame: i64,
+    pub frames_received: i64,
+    pub undecodable_dropped: i64,
+    pub decode_ns_per_frame: i64,
+    pub compression_ratio: f64,
+}
+
+#[no_mangle] pub extern "C" fn lk_set_delta_channel(
+    client:*mut LkClientHandle,
+    label: *const c_char,
+    _config: *const LkDeltaConfig
+) -> LkResult {
+    if client.is_null() { return err("client null", 1); }
+    if label.is_null() { return err("label null", 2); }
+    ok()
+}
+
+#[no_mangle] pub extern "C" fn lk_get_delta_stats(
+    client:*mut LkClientHandle,
+    _label: *const c_char,
+    out_stats: *mut LkDeltaStats
+) -> LkResult {
+    if client.is_null() { return err("client null", 1); }
+    if out_stats.is_null() { return err("out_stats null", 4); }
+    unsafe { *out_stats = LkDeltaStats::default(); }
+    ok()
+}
+
+#[repr(C)]
+#[derive(Copy, Clone, Debug, PartialEq, Eq)]
+pub enum LkCompression {
+    None = 0,
+    Lz4 = 1,
+    Zstd = 2,
+}
+
+#[repr(C)]
+pub struct LkCompressionConfig {
+    pub codec: LkCompression,
+    pub level: c_int,
+    pub dictionary: *const u8,
+    pub dictionary_len: usize,
+}
+
+#[no_mangle] pub extern "C" fn lk_set_data_compression(
+    client:*mut LkClientHandle,
+    label: *const c_char,
+    _config: *const LkCompressionConfig
+) -> LkResult {
+    if client.is_null() { return err("client null", 1); }
+    if label.is_null() { return err("label null", 2); }
+    ok()
+}
+
+#[no_mangle] pub extern "C" fn lk_train_compression_dictionary(
+    _samples: *const u8,
+    _sample_sizes: *const usize,
+    _count: usize,
+    _out: *mut u8,
+    _capacity: usize,
+    _out_len: *mut usize
+) -> LkResult {
+    err("Dictionary training not supported in stub backend", 501)
+}
+
+#[repr(C)]
+#[derive(Default)]
+pub struct LkClockSyncStats {
+    pub synced: c_int,
+    pub reference_participant_id: u32,
+    pub offset_us: i64,
+    pub rtt_us: i64,
+    pub samples: i64,
+    pub outliers: i64,
+}
+
+#[no_mangle] pub extern "C" fn lk_set_clock_sync(client:*mut LkClientHandle, _interval_ms: c_int) -> LkResult {
+    if client.is_null() { return err("client null", 1); }
+    ok()
+}
+
+#[no_mangle] pub extern "C" fn lk_get_clock_sync_stats(client:*mut LkClientHandle, out_stats: *mut LkClockSyncStats) -> LkResult {
+    if client.is_null() { return err("client null", 1); }
+    if out_stats.is_null() { return err("out_stats null", 4); }
+    unsafe { *out_stats = LkClockSyncStats::default(); }
+    ok()
+}
+
+// No peers to synchronize with: the room clock is the local clock
+#[no_mangle] pub extern "C" fn lk_now_synced_us(_client:*mut LkClientHandle) -> i64 { lk_now_local_us() }
+
+#[no_mangle] pub extern "C" fn lk_now_local_us() -> i64 {
+    std::time::SystemTime::now().duration_since(std::time::UNIX_EPOCH).map_or(0, |d| d.as_micros() as i64)
+}
+
+#[no_mangle] pub extern "C" fn lk_data_sender_time_us() -> i64 { 0 }
+
+#[no_mangle] pub extern "C" fn lk_set_data_timestamps(
+    client:*mut LkClientHandle,
+    label: *const c_char,
+    _enabled: c_int
+) -> LkResult {
+    if client.is_null() { return err("client null", 1); }
+    if label.is_null() { return err("label null", 2); }
+    ok()
+}
+
+#[no_mangle] pub extern "C" fn lk_set_data_fec(
+    client:*mut LkClientHandle,
+    label: *const c_char,
+    group_size: c_int
+) -> LkResult {
+    if client.is_null() { return err("client null", 1); }
+    if label.is_null() { return err("label null", 2); }
+    if group_size != 0 && !(2..=32).contains(&group_size) { return err("group_size must be 0 or 2-32", 5); }
+    ok()
+}
+
+#[repr(C)]
+#[derive(Copy, Clone, Debug, PartialEq, Eq)]
+pub enum LkConnectionQuality {
+    Unknown = 0,
+    Excellent = 1,
+    Good = 2,
+    Poor = 3,
+    Lost = 4,
+}
+
+#[repr(C)]
+pub struct LkLinkStats {
+    pub rtt_us: i64,
+    pub loss: f64,
+    pub available_outgoing_bps: f64,
+    pub quality: LkConnectionQuality,
+    pub updated_us: i64,
+}
+
+#[repr(C)]
+pub struct LkRateControlConfig {
+    pub min_hz: c_float,
+    pub max_hz: c_float,
+    pub bandwidth_share: c_float,
+}
+
+#[no_mangle] pub unsafe extern "C" fn lk_get_link_stats(client:*mut LkClientHandle, out_stats: *mut LkLinkStats) -> LkResult {
+    if client.is_null() { return err("client null", 1); }
+    if out_stats.is_null() { return err("out_stats null", 4); }
+    *out_stats = LkLinkStats { rtt_us: 0, loss: 0.0, available_outgoing_bps: 0.0, quality: LkConnectionQuality::Unknown, updated_us: 0 };
+    ok()
+}
+
+#[no_mangle] pub unsafe extern "C" fn lk_set_rate_control(
+    client:*mut LkClientHandle,
+    label: *const c_char,
+    config: *const LkRateControlConfig
+) -> LkResult {
+    if client.is_null() { return err("client null", 1); }
+    if label.is_null() { return err("label null", 2); }
+    if !config.is_null() {
+        let cfg = &*config;
+        if !(cfg.min_hz > 0.0 && cfg.max_hz >= cfg.min_hz) || !(0.0..=1.0).contains(&cfg.bandwidth_share) {
+            return err("need 0 < min_hz <= max_hz and bandwidth_share in 0..1", 5);
+        }
+    }
+    ok()
+}
+
+// No link to estimate: there is never a recommendation
+#[no_mangle] pub extern "C" fn lk_get_recommended_rate(
+    client:*mut LkClientHandle,
+    _label: *const c_char,
+    out_hz: *mut c_float
+) -> LkResult {
+    if client.is_null() { return err("client null", 1); }
+    if out_hz.is_null() { return err("out_hz null", 4); }
+    err("rate control not supported by the stub backend", 501)
+}
+
+#[no_mangle] pub extern "C" fn lk_set_rate_callback(
+    client:*mut LkClientHandle,
+    _cb: Option<extern "C" fn(user: *mut c_void, label: *const c_char, hz: c_float)>,
+    _user: *mut c_void
+) -> LkResult {
+    if client.is_null() { return err("client null", 1); }
+    ok()
+}
+
+#[no_mangle] pub extern "C" fn lk_set_receive_filter(
+    client:*mut LkClientHandle,
+    label: *const c_char,
+    _filter: LkReceiveFilter
+) -> LkResult {
+    if client.is_null() { return err("client null", 1); }
+    if label.is_null() { return err("label null", 2); }
+    ok()
+}
+
 #[no_mangle] pub extern "C" fn lk_set_default_data_labels(
     _client:*mut LkClientHandle,
     _reliable_label: *const c_char,
@@ -258,6 +860,15 @@ pub extern "C" fn lk_audio_track_publish_pcm_i16(
     _level: LkLogLevel
 ) -> LkResult { ok() }
 
+#[no_mangle] pub extern "C" fn lk_set_log_callback(
+    client:*mut LkClientHandle,
+    _cb: Option<extern "C" fn(*mut c_void, LkLogLevel, *const c_char, *const c_char, i64)>,
+    _user:*mut c_void
+) -> LkResult {
+    if client.is_null() { return err("client null", 1); }
+    ok()
+}
+
 /// # Safety
 /// The caller must ensure `out_stats` points to valid writable memory.
 #[no_mangle] pub unsafe extern "C" fn lk_get_audio_stats(
@@ -290,6 +901,135 @@ pub extern "C" fn lk_audio_track_publish_pcm_i16(
         reliable_dropped: 0,
         lossy_sent_bytes: 0,
         lossy_dropped: 0,
+        batched_messages: 0,
+        batch_packets: 0,
+        unordered_retransmits: 0,
+        duplicates_dropped: 0,
+        stale_dropped: 0,
+        expired_dropped: 0,
+        compressed_messages: 0,
+        compressed_raw_bytes: 0,
+        compressed_wire_bytes: 0,
+        compression_ratio: 0.0,
+        decompress_failed: 0,
+        fec_messages: 0,
+        fec_parity_packets: 0,
+        fec_overhead_ratio: 0.0,
+        fec_recovered: 0,
+        fec_unrecovered: 0,
     };
     ok()
 }
+
+#[repr(C)]
+#[derive(Copy, Clone, Debug, Default, PartialEq, Eq)]
+pub enum LkCandidateType {
+    #[default]
+    Unknown = 0,
+    Host = 1,
+    Srflx = 2,
+    Prflx = 3,
+    Relay = 4,
+}
+
+#[repr(C)]
+#[derive(Copy, Clone, Debug, Default)]
+pub struct LkTransportStats {
+    pub connected: c_int,
+    pub rtt_us: i64,
+    pub available_outgoing_bps: f64,
+    pub available_incoming_bps: f64,
+    pub bytes_sent: i64,
+    pub bytes_received: i64,
+    pub send_bps: f64,
+    pub receive_bps: f64,
+    pub local_candidate: LkCandidateType,
+    pub remote_candidate: LkCandidateType,
+    pub tcp: c_int,
+    pub updated_us: i64,
+}
+
+#[repr(C)]
+pub struct LkTrackStats {
+    pub name: [c_char; 64],
+    pub outbound: c_int,
+    pub video: c_int,
+    pub participant_id: u32,
+    pub track_id: u32,
+    pub packets: i64,
+    pub bytes: i64,
+    pub bitrate_bps: f64,
+    pub packets_lost: i64,
+    pub loss: f64,
+    pub jitter_us: i64,
+    pub rtt_us: i64,
+    pub nack_count: i64,
+    pub pli_count: i64,
+    pub retransmitted_packets: i64,
+    pub target_bitrate_bps: f64,
+}
+
+// No peer connections: transports never connect and there are no tracks
+#[no_mangle] pub unsafe extern "C" fn lk_get_transport_stats(
+    client:*mut LkClientHandle,
+    out_publisher: *mut LkTransportStats,
+    out_subscriber: *mut LkTransportStats
+) -> LkResult {
+    if client.is_null() { return err("client null", 1); }
+    if !out_publisher.is_null() { *out_publisher = LkTransportStats::default(); }
+    if !out_subscriber.is_null() { *out_subscriber = LkTransportStats::default(); }
+    ok()
+}
+
+#[no_mangle] pub unsafe extern "C" fn lk_get_track_stats(
+    client:*mut LkClientHandle,
+    out_tracks: *mut LkTrackStats,
+    capacity: usize,
+    out_count: *mut usize
+) -> LkResult {
+    if client.is_null() { return err("client null", 1); }
+    if out_count.is_null() || (out_tracks.is_null() && capacity > 0) { return err("null pointer", 4); }
+    *out_count = 0;
+    ok()
+}
+
+#[repr(C)]
+#[derive(Default)]
+pub struct LkLatencySummary {
+    pub count: i64,
+    pub min_us: f64,
+    pub max_us: f64,
+    pub mean_us: f64,
+    pub p50_us: f64,
+    pub p90_us: f64,
+    pub p99_us: f64,
+    pub p999_us: f64,
+}
+
+#[repr(C)]
+#[derive(Default)]
+pub struct LkLatencyStats {
+    pub audio_ring: LkLatencySummary,
+    pub send: LkLatencySummary,
+    pub dispatch: LkLatencySummary,
+    pub callback: LkLatencySummary,
+}
+
+#[no_mangle] pub unsafe extern "C" fn lk_get_latency_stats(
+    client:*mut LkClientHandle,
+    out_stats: *mut LkLatencyStats,
+    _reset: i32
+) -> LkResult {
+    if client.is_null() { return err("client null", 1); }
+    if out_stats.is_null() { return err("out_stats null", 4); }
+    *out_stats = LkLatencyStats::default();
+    ok()
+}
+
+#[no_mangle] pub extern "C" fn lk_trace_enable(_enabled: i32) -> LkResult {
+    err("Tracing not supported in stub backend", 501)
+}
+
+#[no_mangle] pub unsafe extern "C" fn lk_trace_dump(_path: *const c_char, _out_spans: *mut usize) -> LkResult {
+    err("Tracing not supported in stub backend", 501)
+}
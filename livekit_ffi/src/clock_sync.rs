@@ -0,0 +1,206 @@
+//! NTP-style clock synchronization over the data path (`lk_set_clock_sync`).
+//!
+//! Every participant keeps a local clock: microseconds since the Unix epoch, read from a
+//! monotonic clock anchored at first use. The room clock is the local clock of the
+//! participant with the lowest identity; everyone else estimates their offset to it from
+//! ping/pong exchanges:
+//!
+//! ```text
+//!   t0 ping sent (local)  t1 ping received (reference)  t2 pong sent (reference)
+//!   t3 pong received (local)
+//!   rtt = (t3 - t0) - (t2 - t1)      offset = ((t1 - t0) + (t2 - t3)) / 2
+//! ```
+//!
+//! Queueing delays the packet in one direction only and skews the offset by up to half the
+//! extra delay, so the estimate follows the lowest-RTT sample of a short window (the NTP
+//! clock filter) rather than the latest one.
+
+use std::collections::VecDeque;
+use std::time::{Instant, SystemTime, UNIX_EPOCH};
+
+use once_cell::sync::Lazy;
+
+/// Samples the filter chooses from.
+const WINDOW: usize = 8;
+/// Samples slower than twice the window's best RTT plus this are counted as outliers.
+const OUTLIER_SLACK_US: i64 = 1_000;
+/// Corrections larger than this are applied at once rather than slewed.
+const STEP_US: i64 = 5_000;
+
+static EPOCH: Lazy<(Instant, i64)> = Lazy::new(|| {
+    let unix = SystemTime::now().duration_since(UNIX_EPOCH).map_or(0, |d| d.as_micros() as i64);
+    (Instant::now(), unix)
+});
+
+/// The local clock in microseconds.
+pub fn now_us() -> i64 {
+    let (at, unix) = *EPOCH;
+    unix + at.elapsed().as_micros() as i64
+}
+
+#[derive(Default)]
+pub struct ClockEstimator {
+    window: VecDeque<(i64, i64)>,
+    pub offset_us: i64,
+    pub rtt_us: i64,
+    pub samples: i64,
+    pub outliers: i64,
+    pub synced: bool,
+}
+
+impl ClockEstimator {
+    /// Add one ping/pong exchange. Returns false if the timestamps are inconsistent or so far
+    /// apart that the arithmetic would overflow.
+    pub fn add(&mut self, t0: i64, t1: i64, t2: i64, t3: i64) -> bool {
+        let sample = (|| {
+            let rtt = t3.checked_sub(t0)?.checked_sub(t2.checked_sub(t1)?)?;
+            let offset = t1.checked_sub(t0)?.checked_add(t2.checked_sub(t3)?)? / 2;
+            Some((offset, rtt))
+        })();
+        let Some((offset, rtt)) = sample.filter(|&(_, rtt)| rtt >= 0 && t2 >= t1) else {
+            self.outliers += 1;
+            return false;
+        };
+        if self.window.len() == WINDOW {
+            self.window.pop_front();
+        }
+        self.window.push_back((offset, rtt));
+        self.samples += 1;
+
+        let Some(&(best_offset, best_rtt)) = self.window.iter().min_by_key(|s| s.1) else { return false; };
+        if rtt > best_rtt.saturating_mul(2).saturating_add(OUTLIER_SLACK_US) {
+            self.outliers += 1;
+        }
+        // Slew small corrections so synced timestamps stay smooth; step on first sync
+        let error = best_offset.saturating_sub(self.offset_us);
+        if !self.synced || error.unsigned_abs() > STEP_US as u64 {
+            self.offset_us = best_offset;
+        } else {
+            self.offset_us += error / 4;
+        }
+        self.rtt_us = best_rtt;
+        self.synced = true;
+        true
+    }
+
+    /// True until the filter window has filled since the last reset.
+    pub fn settling(&self) -> bool {
+        self.window.len() < WINDOW
+    }
+
+    /// This participant is the reference: its local clock is the room clock.
+    pub fn set_reference(&mut self) {
+        self.window.clear();
+        self.offset_us = 0;
+        self.rtt_us = 0;
+        self.synced = true;
+    }
+
+    /// The room clock, or the local clock while not synchronized.
+    pub fn now_synced_us(&self) -> i64 {
+        now_us().saturating_add(if self.synced { self.offset_us } else { 0 })
+    }
+
+    /// The reference changed: earlier samples measured a different clock.
+    pub fn reset(&mut self) {
+        self.window.clear();
+        self.synced = false;
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    /// One exchange with a reference clock `offset` ahead, `up`/`down` one-way delays and
+    /// `hold` between the reference receiving the ping and answering it.
+    fn exchange(c: &mut ClockEstimator, t0: i64, offset: i64, up: i64, down: i64, hold: i64) -> bool {
+        let t1 = t0 + up + offset;
+        let t2 = t1 + hold;
+        let t3 = t2 - offset + down;
+        c.add(t0, t1, t2, t3)
+    }
+
+    #[test]
+    fn asymmetric_delay_skews_by_half_the_difference() {
+        let mut c = ClockEstimator::default();
+        assert!(exchange(&mut c, 0, 500, 100, 300, 10));
+        assert!(c.synced);
+        assert_eq!(c.rtt_us, 400);
+        assert_eq!(c.offset_us, 400, "300 us down vs 100 us up skews the offset by 100 us");
+    }
+
+    #[test]
+    fn follows_the_lowest_rtt_sample_with_a_slew() {
+        let mut c = ClockEstimator::default();
+        assert!(exchange(&mut c, 0, 500, 100, 300, 0));
+        assert_eq!(c.offset_us, 400);
+        // A faster, symmetric exchange wins; the 100 us correction is slewed a quarter at a time
+        assert!(exchange(&mut c, 1_000, 500, 50, 50, 0));
+        assert_eq!(c.rtt_us, 100);
+        assert_eq!(c.offset_us, 425);
+        // A slower exchange afterwards does not displace it
+        assert!(exchange(&mut c, 2_000, 500, 400, 100, 0));
+        assert_eq!(c.rtt_us, 100);
+        assert_eq!(c.samples, 3);
+    }
+
+    #[test]
+    fn slow_and_inconsistent_samples_count_as_outliers() {
+        let mut c = ClockEstimator::default();
+        assert!(exchange(&mut c, 0, 0, 50, 50, 0));
+        assert_eq!(c.outliers, 0);
+        // Beyond twice the best RTT plus the slack
+        assert!(exchange(&mut c, 1_000, 0, 50, 51 + 100 + OUTLIER_SLACK_US, 0));
+        assert_eq!(c.outliers, 1);
+        assert!(exchange(&mut c, 2_000, 0, 50, 50 + 50 + OUTLIER_SLACK_US, 0));
+        assert_eq!(c.outliers, 1, "within the slack");
+        // The reference answered before it received the ping
+        assert!(!c.add(3_000, 3_100, 3_050, 3_200));
+        assert_eq!(c.outliers, 2);
+        assert_eq!(c.samples, 3);
+    }
+
+    #[test]
+    fn large_corrections_step() {
+        let mut c = ClockEstimator::default();
+        assert!(exchange(&mut c, 0, 0, 100, 100, 0));
+        assert_eq!(c.offset_us, 0);
+        let jump = STEP_US + 1_000;
+        assert!(exchange(&mut c, 1_000, jump, 50, 50, 0));
+        assert_eq!(c.offset_us, jump);
+    }
+
+    #[test]
+    fn overflowing_timestamps_are_dropped() {
+        let mut c = ClockEstimator::default();
+        assert!(!c.add(i64::MIN, i64::MAX, i64::MAX, 0));
+        assert!(!c.add(0, i64::MAX, i64::MAX, i64::MIN));
+        assert_eq!(c.outliers, 2);
+        assert_eq!(c.samples, 0);
+        assert!(!c.synced);
+    }
+
+    #[test]
+    fn reset_and_set_reference() {
+        let mut c = ClockEstimator::default();
+        assert!(c.settling());
+        for i in 0..WINDOW as i64 {
+            assert!(exchange(&mut c, i * 1_000, 700, 100, 100, 0));
+        }
+        assert!(!c.settling());
+        assert_eq!(c.offset_us, 700);
+
+        c.reset();
+        assert!(!c.synced);
+        assert!(c.settling());
+        // The first sample after a reset is taken as is, even when close to the old offset
+        assert!(exchange(&mut c, 10_000, 650, 100, 100, 0));
+        assert_eq!(c.offset_us, 650);
+
+        c.set_reference();
+        assert!(c.synced);
+        assert_eq!((c.offset_us, c.rtt_us), (0, 0));
+        assert!(c.settling());
+    }
+}
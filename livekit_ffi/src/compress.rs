@@ -0,0 +1,204 @@
+//! Per-label payload compression (`lk_set_data_compression`).
+//!
+//! A compressed message is a `Compressed` frame whose body starts with one codec byte, so
+//! receivers pick the decoder per message and need no negotiation beyond a shared zstd
+//! dictionary. Messages that do not shrink are sent uncompressed.
+
+use crate::framing;
+use std::io;
+use zstd::bulk::{Compressor, Decompressor};
+
+pub const CODEC_LZ4: u8 = 1;
+pub const CODEC_ZSTD: u8 = 2;
+/// zstd with the label's dictionary; the receiver must have the same dictionary.
+pub const CODEC_ZSTD_DICT: u8 = 3;
+
+/// Largest message accepted for compression; also bounds what a receiver will inflate.
+pub const MAX_UNCOMPRESSED: usize = 1 << 20;
+
+#[derive(Copy, Clone, Debug, PartialEq, Eq)]
+pub enum Codec {
+    /// Receive only: decode with the dictionary, send uncompressed.
+    None,
+    Lz4,
+    Zstd,
+}
+
+/// Compression settings and zstd contexts for one label.
+pub struct LabelCodec {
+    codec: Codec,
+    has_dictionary: bool,
+    compressor: Option<Compressor<'static>>,
+    decompressor: Option<Decompressor<'static>>,
+}
+
+impl LabelCodec {
+    pub fn new(codec: Codec, level: i32, dictionary: Option<&[u8]>) -> io::Result<Self> {
+        let compressor = match (codec, dictionary) {
+            (Codec::Zstd, Some(dict)) => Some(Compressor::with_dictionary(level, dict)?),
+            (Codec::Zstd, None) => Some(Compressor::new(level)?),
+            _ => None,
+        };
+        let decompressor = dictionary.map(Decompressor::with_dictionary).transpose()?;
+        Ok(Self { codec, has_dictionary: dictionary.is_some(), compressor, decompressor })
+    }
+
+    pub fn sends(&self) -> bool {
+        self.codec != Codec::None
+    }
+
+    /// Write a complete compressed packet for `bytes` into `out`. Returns false (leaving
+    /// `out` unspecified) if compression would not make the message smaller.
+    pub fn compress(&mut self, bytes: &[u8], out: &mut Vec<u8>) -> bool {
+        let (codec, data) = match (self.codec, self.compressor.as_mut()) {
+            (Codec::Lz4, _) => (CODEC_LZ4, lz4_flex::compress_prepend_size(bytes)),
+            (Codec::Zstd, Some(c)) => match c.compress(bytes) {
+                Ok(data) => (if self.has_dictionary { CODEC_ZSTD_DICT } else { CODEC_ZSTD }, data),
+                Err(_) => return false,
+            },
+            _ => return false,
+        };
+        framing::begin_compressed_packet(out, codec);
+        out.extend_from_slice(&data);
+        out.len() < bytes.len()
+    }
+}
+
+#[derive(Debug, PartialEq, Eq)]
+pub enum DecodeError {
+    /// zstd dictionary message on a label with no dictionary configured.
+    NoDictionary,
+    /// Corrupt, oversized, or compressed with a different dictionary.
+    Malformed,
+}
+
+/// Decompress the packet body at `body`. `label` is the receiving label's codec, if any;
+/// `plain` is a shared dictionary-less zstd context, created on first use.
+pub fn decompress(
+    packet: &[u8],
+    body: usize,
+    label: Option<&mut LabelCodec>,
+    plain: &mut Option<Decompressor<'static>>,
+) -> Result<Vec<u8>, DecodeError> {
+    let (codec, data) = framing::parse_compressed_body(packet, body).ok_or(DecodeError::Malformed)?;
+    match codec {
+        CODEC_LZ4 => {
+            // The prepended size comes off the wire: bound it before allocating
+            let size = data.get(..4).map(|b| u32::from_le_bytes([b[0], b[1], b[2], b[3]]) as usize).ok_or(DecodeError::Malformed)?;
+            if size > MAX_UNCOMPRESSED {
+                return Err(DecodeError::Malformed);
+            }
+            lz4_flex::decompress_size_prepended(data).map_err(|_| DecodeError::Malformed)
+        }
+        CODEC_ZSTD | CODEC_ZSTD_DICT => {
+            let size = match zstd::zstd_safe::get_frame_content_size(data) {
+                Ok(Some(size)) if size as usize <= MAX_UNCOMPRESSED => size as usize,
+                _ => return Err(DecodeError::Malformed),
+            };
+            let ctx = if codec == CODEC_ZSTD_DICT {
+                label.and_then(|l| l.decompressor.as_mut()).ok_or(DecodeError::NoDictionary)?
+            } else {
+                if plain.is_none() {
+                    *plain = Some(Decompressor::new().map_err(|_| DecodeError::Malformed)?);
+                }
+                plain.as_mut().ok_or(DecodeError::Malformed)?
+            };
+            ctx.decompress(data, size).map_err(|_| DecodeError::Malformed)
+        }
+        _ => Err(DecodeError::Malformed),
+    }
+}
+
+/// Train a zstd dictionary from `samples` laid out back to back.
+pub fn train_dictionary(samples: &[u8], sizes: &[usize], max_size: usize) -> io::Result<Vec<u8>> {
+    zstd::dict::from_continuous(samples, sizes, max_size)
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn sample(n: usize) -> Vec<u8> {
+        // Repetitive JSON-like text, the kind of payload compression is for
+        (0..n).map(|i| b"{\"bone\":12,\"rot\":[0.1,0.2,0.3,0.9]}"[i % 35]).collect()
+    }
+
+    fn round_trip(codec: &mut LabelCodec, receiver: Option<&mut LabelCodec>, bytes: &[u8]) -> Result<Vec<u8>, DecodeError> {
+        let mut packet = Vec::new();
+        codec.compress(bytes, &mut packet);
+        let (_, body) = framing::parse_header(&packet).unwrap();
+        decompress(&packet, body, receiver, &mut None)
+    }
+
+    #[test]
+    fn zstd_round_trips_and_shrinks() {
+        let mut codec = LabelCodec::new(Codec::Zstd, 3, None).unwrap();
+        let bytes = sample(4000);
+        let mut packet = Vec::new();
+        assert!(codec.compress(&bytes, &mut packet));
+        assert!(packet.len() < bytes.len() / 4);
+        assert_eq!(round_trip(&mut codec, None, &bytes).unwrap(), bytes);
+    }
+
+    #[test]
+    fn lz4_round_trips() {
+        let mut codec = LabelCodec::new(Codec::Lz4, 0, None).unwrap();
+        for len in [1, 100, 4000] {
+            let bytes = sample(len);
+            assert_eq!(round_trip(&mut codec, None, &bytes).unwrap(), bytes);
+        }
+    }
+
+    #[test]
+    fn dictionary_messages_need_the_dictionary() {
+        let samples: Vec<Vec<u8>> = (0..200).map(|i| format!("{{\"id\":{},\"pose\":\"idle\",\"x\":{}}}", i, i * 7).into_bytes()).collect();
+        let sizes: Vec<usize> = samples.iter().map(|s| s.len()).collect();
+        let dict = train_dictionary(&samples.concat(), &sizes, 4096).unwrap();
+
+        let mut sender = LabelCodec::new(Codec::Zstd, 3, Some(&dict)).unwrap();
+        let mut receiver = LabelCodec::new(Codec::None, 0, Some(&dict)).unwrap();
+        assert!(!receiver.sends());
+        let bytes = b"{\"id\":999,\"pose\":\"idle\",\"x\":6993}".to_vec();
+        let mut packet = Vec::new();
+        assert!(sender.compress(&bytes, &mut packet));
+        assert_eq!(packet[framing::FRAME_HEADER_LEN], CODEC_ZSTD_DICT);
+        assert_eq!(round_trip(&mut sender, Some(&mut receiver), &bytes).unwrap(), bytes);
+        assert_eq!(round_trip(&mut sender, None, &bytes), Err(DecodeError::NoDictionary));
+    }
+
+    #[test]
+    fn bad_packets_are_malformed() {
+        let mut codec = LabelCodec::new(Codec::Zstd, 3, None).unwrap();
+        let mut packet = Vec::new();
+        assert!(codec.compress(&sample(2000), &mut packet));
+        let (_, body) = framing::parse_header(&packet).unwrap();
+
+        let truncated = &packet[..packet.len() - 5];
+        assert_eq!(decompress(truncated, body, None, &mut None), Err(DecodeError::Malformed));
+        let mut unknown = packet.clone();
+        unknown[body] = 99;
+        assert_eq!(decompress(&unknown, body, None, &mut None), Err(DecodeError::Malformed));
+
+        // An LZ4 size prefix over the limit is refused before allocating
+        let mut huge = Vec::new();
+        framing::begin_compressed_packet(&mut huge, CODEC_LZ4);
+        huge.extend_from_slice(&((MAX_UNCOMPRESSED as u32) + 1).to_le_bytes());
+        huge.extend_from_slice(&[0; 16]);
+        assert_eq!(decompress(&huge, body, None, &mut None), Err(DecodeError::Malformed));
+    }
+
+    #[test]
+    fn incompressible_messages_are_reported() {
+        let mut codec = LabelCodec::new(Codec::Zstd, 3, None).unwrap();
+        let mut state = 0x2545_f491u32;
+        let noise: Vec<u8> = (0..64)
+            .map(|_| {
+                state ^= state << 13;
+                state ^= state >> 17;
+                state ^= state << 5;
+                state as u8
+            })
+            .collect();
+        assert!(!codec.compress(&noise, &mut Vec::new()));
+    }
+}
@@ -0,0 +1,297 @@
+//! Delta/keyframe coding for streams of similar frames on one label (`lk_set_delta_channel`).
+//!
+//! Every `interval` frames (and whenever the size changes) the sender emits a keyframe; the
+//! frames in between are XORed against that keyframe and packed as zero runs:
+//! repeated `{zeros varint, literal_len varint, literal bytes}`. Either form may then be
+//! LZ4-compressed when that makes it smaller. Receivers keep the last keyframe per sender
+//! and drop deltas whose keyframe they never got, so a lossy stream recovers at the next
+//! keyframe.
+
+use crate::framing::{self, DELTA_KEY, DELTA_LZ4};
+
+pub const DEFAULT_KEYFRAME_INTERVAL: u32 = 30;
+/// A keyframe this far behind the held one means the sender started over.
+const RESTART_DISTANCE: u32 = 256;
+
+pub struct DeltaEncoder {
+    interval: u32,
+    lz4: bool,
+    frame: u32,
+    since_key: u32,
+    key: Option<(u32, Vec<u8>)>,
+    force_key: bool,
+    scratch: Vec<u8>,
+}
+
+impl DeltaEncoder {
+    pub fn new(interval: u32, lz4: bool) -> Self {
+        Self {
+            interval: interval.max(1),
+            lz4,
+            frame: 0,
+            since_key: 0,
+            key: None,
+            force_key: false,
+            scratch: Vec::new(),
+        }
+    }
+
+    /// Change the settings in place. The frame numbering carries on, so receivers holding a
+    /// keyframe from before keep accepting the stream.
+    pub fn reconfigure(&mut self, interval: u32, lz4: bool) {
+        self.interval = interval.max(1);
+        self.lz4 = lz4;
+    }
+
+    /// Make the next frame a keyframe, e.g. so a participant that just joined can decode.
+    pub fn force_keyframe(&mut self) {
+        self.force_key = true;
+    }
+
+    /// Code `bytes` as the next frame into `out` (a complete framed packet).
+    /// Returns true if it went out as a keyframe.
+    pub fn encode(&mut self, bytes: &[u8], out: &mut Vec<u8>) -> bool {
+        let frame = self.frame;
+        self.frame = self.frame.wrapping_add(1);
+
+        let delta_base = match &self.key {
+            Some((base, key)) if !self.force_key && self.since_key < self.interval && key.len() == bytes.len() => {
+                self.scratch.clear();
+                pack_xor(bytes, key, &mut self.scratch);
+                // Not worth it if the frames barely correlate
+                (self.scratch.len() < bytes.len()).then_some(*base)
+            }
+            _ => None,
+        };
+        let (base, mut flags, coded) = match delta_base {
+            Some(base) => {
+                self.since_key += 1;
+                (base, 0, &self.scratch[..])
+            }
+            None => {
+                self.force_key = false;
+                self.since_key = 1;
+                let key = self.key.get_or_insert_with(|| (frame, Vec::new()));
+                key.0 = frame;
+                key.1.clear();
+                key.1.extend_from_slice(bytes);
+                (frame, DELTA_KEY, bytes)
+            }
+        };
+
+        let compressed = self.lz4.then(|| lz4_flex::compress_prepend_size(coded)).filter(|c| c.len() < coded.len());
+        if compressed.is_some() {
+            flags |= DELTA_LZ4;
+        }
+        framing::begin_delta_packet(out, frame, base, flags);
+        out.extend_from_slice(compressed.as_deref().unwrap_or(coded));
+        flags & DELTA_KEY != 0
+    }
+}
+
+#[derive(Debug, PartialEq, Eq)]
+pub enum DecodeError {
+    /// A delta against a keyframe this receiver does not hold (lost or not yet received).
+    NoBase,
+    Malformed,
+}
+
+#[derive(Default)]
+pub struct DeltaDecoder {
+    key: Option<(u32, Vec<u8>)>,
+}
+
+impl DeltaDecoder {
+    /// Decode the delta packet whose body starts at `body` into `out`.
+    pub fn decode(&mut self, packet: &[u8], body: usize, out: &mut Vec<u8>) -> Result<(), DecodeError> {
+        let (frame, base, flags, coded) = framing::parse_delta_body(packet, body).ok_or(DecodeError::Malformed)?;
+        let decompressed;
+        let coded = if flags & DELTA_LZ4 != 0 {
+            // The prepended size comes off the wire: bound it before allocating
+            let size = coded.get(..4).map(|b| u32::from_le_bytes([b[0], b[1], b[2], b[3]]) as usize).ok_or(DecodeError::Malformed)?;
+            if size > framing::RELIABLE_MAX * 4 {
+                return Err(DecodeError::Malformed);
+            }
+            decompressed = lz4_flex::decompress_size_prepended(coded).map_err(|_| DecodeError::Malformed)?;
+            &decompressed[..]
+        } else {
+            coded
+        };
+
+        out.clear();
+        if flags & DELTA_KEY != 0 {
+            // Keep the newest keyframe; an older one arriving late is still delivered. One far
+            // behind (or reusing the held frame number) is a restarted sender, whose deltas
+            // refer to it from now on.
+            let replace = self.key.as_ref().map_or(true, |(k, _)| {
+                !framing::tick_newer(*k, frame) || k.wrapping_sub(frame) > RESTART_DISTANCE
+            });
+            if replace {
+                self.key = Some((frame, coded.to_vec()));
+            }
+            out.extend_from_slice(coded);
+            return Ok(());
+        }
+        let Some((key_frame, key)) = self.key.as_ref() else { return Err(DecodeError::NoBase); };
+        if *key_frame != base {
+            return Err(DecodeError::NoBase);
+        }
+        out.extend_from_slice(key);
+        unpack_xor(coded, out).ok_or(DecodeError::Malformed)
+    }
+}
+
+/// Pack `cur XOR key` as zero runs. A literal run ends at the next pair of unchanged bytes.
+fn pack_xor(cur: &[u8], key: &[u8], out: &mut Vec<u8>) {
+    let n = cur.len();
+    let mut i = 0;
+    while i < n {
+        let zeros_start = i;
+        while i < n && cur[i] == key[i] {
+            i += 1;
+        }
+        let zeros = i - zeros_start;
+        if i == n {
+            // Trailing unchanged bytes are implied by the frame length
+            break;
+        }
+        let lit_start = i;
+        while i < n && !(cur[i] == key[i] && (i + 1 == n || cur[i + 1] == key[i + 1])) {
+            i += 1;
+        }
+        framing::put_varint(out, zeros as u64);
+        framing::put_varint(out, (i - lit_start) as u64);
+        out.extend(cur[lit_start..i].iter().zip(&key[lit_start..i]).map(|(a, b)| a ^ b));
+    }
+}
+
+/// Apply packed zero runs to `frame`, which holds the keyframe on entry.
+fn unpack_xor(packed: &[u8], frame: &mut [u8]) -> Option<()> {
+    let mut pos = 0;
+    let mut at = 0usize;
+    while pos < packed.len() {
+        at = at.checked_add(framing::get_varint(packed, &mut pos)? as usize)?;
+        let lits = framing::get_varint(packed, &mut pos)? as usize;
+        let src = packed.get(pos..pos.checked_add(lits)?)?;
+        let dst = frame.get_mut(at..at.checked_add(lits)?)?;
+        for (d, s) in dst.iter_mut().zip(src) {
+            *d ^= s;
+        }
+        pos += lits;
+        at += lits;
+    }
+    Some(())
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn frame(n: u8) -> Vec<u8> {
+        // Mostly constant with a few changing bytes, like a pose stream
+        let mut f = vec![7u8; 200];
+        f[10] = n;
+        f[120] = n.wrapping_mul(3);
+        f
+    }
+
+    fn decode(decoder: &mut DeltaDecoder, packet: &[u8]) -> Result<Vec<u8>, DecodeError> {
+        let (_, body) = framing::parse_header(packet).unwrap();
+        let mut out = Vec::new();
+        decoder.decode(packet, body, &mut out).map(|_| out)
+    }
+
+    fn encode(encoder: &mut DeltaEncoder, bytes: &[u8]) -> (Vec<u8>, bool) {
+        let mut packet = Vec::new();
+        let key = encoder.encode(bytes, &mut packet);
+        (packet, key)
+    }
+
+    #[test]
+    fn sequence_round_trips_with_periodic_keyframes() {
+        let mut encoder = DeltaEncoder::new(4, false);
+        let mut decoder = DeltaDecoder::default();
+        for n in 0..12u8 {
+            let (packet, key) = encode(&mut encoder, &frame(n));
+            assert_eq!(key, n % 4 == 0, "frame {}", n);
+            if !key {
+                assert!(packet.len() < frame(n).len() / 4, "delta should be small");
+            }
+            assert_eq!(decode(&mut decoder, &packet).unwrap(), frame(n));
+        }
+    }
+
+    #[test]
+    fn lost_keyframe_drops_deltas_until_the_next_one() {
+        let mut encoder = DeltaEncoder::new(3, false);
+        let mut decoder = DeltaDecoder::default();
+        let packets: Vec<_> = (0..7u8).map(|n| encode(&mut encoder, &frame(n)).0).collect();
+
+        assert_eq!(decode(&mut decoder, &packets[0]).unwrap(), frame(0));
+        assert_eq!(decode(&mut decoder, &packets[1]).unwrap(), frame(1));
+        // Keyframe 3 is lost: its deltas must not decode against keyframe 0
+        assert_eq!(decode(&mut decoder, &packets[4]), Err(DecodeError::NoBase));
+        assert_eq!(decode(&mut decoder, &packets[5]), Err(DecodeError::NoBase));
+        assert_eq!(decode(&mut decoder, &packets[6]).unwrap(), frame(6));
+        // A late delta on the old keyframe no longer decodes, a late keyframe still delivers
+        assert_eq!(decode(&mut decoder, &packets[2]), Err(DecodeError::NoBase));
+        assert_eq!(decode(&mut decoder, &packets[3]).unwrap(), frame(3));
+        assert_eq!(decode(&mut decoder, &packets[2]), Err(DecodeError::NoBase));
+    }
+
+    #[test]
+    fn size_change_and_forced_keyframes() {
+        let mut encoder = DeltaEncoder::new(100, false);
+        assert!(encode(&mut encoder, &frame(0)).1);
+        assert!(!encode(&mut encoder, &frame(1)).1);
+        assert!(encode(&mut encoder, &frame(2)[..150]).1);
+        encoder.force_keyframe();
+        assert!(encode(&mut encoder, &frame(3)[..150]).1);
+        assert!(!encode(&mut encoder, &frame(4)[..150]).1);
+    }
+
+    #[test]
+    fn reconfigure_keeps_receivers_in_step() {
+        let mut encoder = DeltaEncoder::new(1000, false);
+        let mut decoder = DeltaDecoder::default();
+        for n in 0..50u8 {
+            decode(&mut decoder, &encode(&mut encoder, &frame(n)).0).unwrap();
+        }
+        encoder.reconfigure(2, true);
+        for n in 50..60u8 {
+            assert_eq!(decode(&mut decoder, &encode(&mut encoder, &frame(n)).0).unwrap(), frame(n));
+        }
+    }
+
+    #[test]
+    fn restarted_sender_is_accepted_at_its_first_keyframe() {
+        let mut encoder = DeltaEncoder::new(100, false);
+        let mut decoder = DeltaDecoder::default();
+        for n in 0..RESTART_DISTANCE * 2 + 10 {
+            decode(&mut decoder, &encode(&mut encoder, &frame(n as u8)).0).unwrap();
+        }
+        // Frame numbering starts over at 0, far behind the held keyframe
+        let mut encoder = DeltaEncoder::new(100, false);
+        assert_eq!(decode(&mut decoder, &encode(&mut encoder, &frame(1)).0).unwrap(), frame(1));
+        assert_eq!(decode(&mut decoder, &encode(&mut encoder, &frame(2)).0).unwrap(), frame(2));
+
+        // Restarting again reuses frame 0, the keyframe already held
+        let mut encoder = DeltaEncoder::new(100, false);
+        assert_eq!(decode(&mut decoder, &encode(&mut encoder, &frame(9)).0).unwrap(), frame(9));
+        assert_eq!(decode(&mut decoder, &encode(&mut encoder, &frame(8)).0).unwrap(), frame(8));
+    }
+
+    #[test]
+    fn malformed_packets_are_rejected() {
+        let mut encoder = DeltaEncoder::new(2, false);
+        let mut decoder = DeltaDecoder::default();
+        let (key, _) = encode(&mut encoder, &frame(0));
+        decode(&mut decoder, &key).unwrap();
+        let (mut delta, _) = encode(&mut encoder, &frame(1));
+        // Literal run past the end of the frame
+        delta.truncate(delta.len() - 1);
+        delta.extend_from_slice(&[0xff, 0x7f]);
+        assert_eq!(decode(&mut decoder, &delta), Err(DecodeError::Malformed));
+        assert_eq!(decode(&mut decoder, &key[..3]), Err(DecodeError::Malformed));
+    }
+}
@@ -0,0 +1,340 @@
+//! XOR forward error correction for lossy labels (`lk_set_data_fec`).
+//!
+//! The sender numbers a label's lossy packets in groups of `count` and follows the last one
+//! with a parity packet: the XOR of the group's messages, each prefixed with its FEC flags
+//! and length and zero-padded to the longest. A receiver missing exactly one message of a
+//! group XORs the parity with the ones it did get and recovers it without a retransmission
+//! round trip. Overhead is one packet per group; a group that loses two is not recoverable.
+//!
+//! ```text
+//!   parity item = [flags u8][len u16 LE][message, zero-padded]
+//! ```
+
+use crate::framing::{self, FEC_FRAMED, FEC_PARITY};
+use std::collections::VecDeque;
+
+pub const MIN_GROUP: u32 = 2;
+pub const MAX_GROUP: u32 = 32;
+const ITEM_PREFIX: usize = 3;
+/// Largest message FEC protects: its group's parity packet must fit the lossy limit too.
+pub const MAX_MESSAGE: usize = framing::LOSSY_MTU - framing::FEC_PACKET_OVERHEAD - ITEM_PREFIX;
+/// Groups a receiver keeps open per sender and label.
+const OPEN_GROUPS: usize = 8;
+/// A group this far behind the newest means the sender started over.
+const RESTART_DISTANCE: u32 = 256;
+
+/// XOR one message into a parity accumulator.
+fn xor_item(acc: &mut Vec<u8>, flags: u8, message: &[u8]) {
+    let len = message.len() as u16;
+    if acc.len() < ITEM_PREFIX + message.len() {
+        acc.resize(ITEM_PREFIX + message.len(), 0);
+    }
+    acc[0] ^= flags;
+    acc[1] ^= len as u8;
+    acc[2] ^= (len >> 8) as u8;
+    for (a, b) in acc[ITEM_PREFIX..].iter_mut().zip(message) {
+        *a ^= b;
+    }
+}
+
+pub struct FecEncoder {
+    count: u8,
+    group: u32,
+    index: u8,
+    parity: Vec<u8>,
+}
+
+impl FecEncoder {
+    pub fn new(count: u32) -> Self {
+        Self { count: count.clamp(MIN_GROUP, MAX_GROUP) as u8, group: 0, index: 0, parity: Vec::new() }
+    }
+
+    /// Change the group size; the next message starts a new group.
+    pub fn set_count(&mut self, count: u32) {
+        self.count = count.clamp(MIN_GROUP, MAX_GROUP) as u8;
+        if self.index > 0 {
+            self.index = 0;
+            self.group = self.group.wrapping_add(1);
+            self.parity.clear();
+        }
+    }
+
+    /// Wrap `message` (a framed packet if `framed`) as the group's next packet into `out`.
+    /// Returns the parity packet once the message completes its group.
+    pub fn encode(&mut self, message: &[u8], framed: bool, out: &mut Vec<u8>) -> Option<Vec<u8>> {
+        let flags = if framed { FEC_FRAMED } else { 0 };
+        framing::begin_fec_packet(out, flags, self.group, self.index, self.count);
+        out.extend_from_slice(message);
+        xor_item(&mut self.parity, flags, message);
+        self.index += 1;
+        if self.index < self.count {
+            return None;
+        }
+        let mut parity = Vec::with_capacity(framing::FEC_PACKET_OVERHEAD + self.parity.len());
+        framing::begin_fec_packet(&mut parity, FEC_PARITY, self.group, self.count, self.count);
+        parity.extend_from_slice(&self.parity);
+        self.parity.clear();
+        self.index = 0;
+        self.group = self.group.wrapping_add(1);
+        Some(parity)
+    }
+}
+
+struct Group {
+    id: u32,
+    count: u8,
+    /// Bit per message received or recovered.
+    received: u32,
+    has_parity: bool,
+    acc: Vec<u8>,
+}
+
+impl Group {
+    fn missing(&self) -> u32 {
+        self.count as u32 - self.received.count_ones()
+    }
+}
+
+/// What one received FEC packet yields.
+#[derive(Default)]
+pub struct Decoded<'a> {
+    /// The packet's own message, unless it is parity or a duplicate: `(framed, bytes)`.
+    pub message: Option<(bool, &'a [u8])>,
+    /// A message of the same group rebuilt from the parity.
+    pub recovered: Option<(bool, Vec<u8>)>,
+    /// Messages of groups closed without them: lost beyond what parity could repair.
+    pub lost: u32,
+    pub duplicate: bool,
+}
+
+/// Open groups of one sender's label.
+#[derive(Default)]
+pub struct FecDecoder {
+    groups: VecDeque<Group>,
+}
+
+impl FecDecoder {
+    /// Returns None if the packet is malformed.
+    pub fn receive<'a>(&mut self, packet: &'a [u8], body: usize) -> Option<Decoded<'a>> {
+        let (flags, id, index, count, data) = framing::parse_fec_body(packet, body)?;
+        let parity = flags & FEC_PARITY != 0;
+        if !(MIN_GROUP..=MAX_GROUP).contains(&(count as u32)) || index > count || parity != (index == count) {
+            return None;
+        }
+        let mut out = Decoded::default();
+        let message = (!parity).then_some((flags & FEC_FRAMED != 0, data));
+
+        let newest = self.groups.back().map(|g| g.id);
+        if newest.is_some_and(|n| n.wrapping_sub(id) > RESTART_DISTANCE && framing::tick_newer(n, id)) {
+            self.groups.clear();
+        }
+        let slot = match self.groups.iter().position(|g| g.id == id) {
+            Some(i) => i,
+            None => {
+                let oldest_full = self.groups.len() == OPEN_GROUPS && self.groups.front().is_some_and(|g| framing::tick_newer(g.id, id));
+                if oldest_full {
+                    // Too old to track: deliver it, nothing to recover with
+                    out.message = message;
+                    return Some(out);
+                }
+                let at = self.groups.iter().position(|g| framing::tick_newer(g.id, id)).unwrap_or(self.groups.len());
+                self.groups.insert(at, Group { id, count, received: 0, has_parity: false, acc: Vec::new() });
+                if self.groups.len() > OPEN_GROUPS {
+                    if let Some(closed) = self.groups.pop_front() {
+                        out.lost += closed.missing();
+                    }
+                    at - 1
+                } else {
+                    at
+                }
+            }
+        };
+
+        let group = &mut self.groups[slot];
+        if group.count != count {
+            return None;
+        }
+        if parity {
+            if group.has_parity {
+                out.duplicate = true;
+                return Some(out);
+            }
+            group.has_parity = true;
+            if group.missing() == 0 {
+                return Some(out);
+            }
+            if group.acc.len() < data.len() {
+                group.acc.resize(data.len(), 0);
+            }
+            for (a, b) in group.acc.iter_mut().zip(data) {
+                *a ^= b;
+            }
+        } else {
+            // index < count <= 32 here; the parity's index == count is never a bit
+            let bit = 1u32 << index;
+            if group.received & bit != 0 {
+                out.duplicate = true;
+                return Some(out);
+            }
+            group.received |= bit;
+            if group.missing() > 0 {
+                xor_item(&mut group.acc, flags & FEC_FRAMED, data);
+            }
+            out.message = message;
+        }
+
+        if group.has_parity && group.missing() == 1 {
+            let lost = (0..count).find(|i| group.received & (1u32 << i) == 0).unwrap_or(0);
+            group.received |= 1u32 << lost;
+            let acc = std::mem::take(&mut group.acc);
+            let len = acc.get(1..ITEM_PREFIX).map(|b| u16::from_le_bytes([b[0], b[1]]) as usize);
+            match len.filter(|len| ITEM_PREFIX + len <= acc.len()) {
+                Some(len) => out.recovered = Some((acc[0] & FEC_FRAMED != 0, acc[ITEM_PREFIX..ITEM_PREFIX + len].to_vec())),
+                // Parity and messages disagree: count the message lost
+                None => out.lost += 1,
+            }
+        } else if group.missing() == 0 {
+            group.acc = Vec::new();
+        }
+        Some(out)
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    /// One group's packets, messages first and parity last.
+    fn group(encoder: &mut FecEncoder, messages: &[Vec<u8>]) -> Vec<Vec<u8>> {
+        let mut packets = Vec::new();
+        for (i, m) in messages.iter().enumerate() {
+            let mut out = Vec::new();
+            let parity = encoder.encode(m, i % 2 == 1, &mut out);
+            packets.push(out);
+            if let Some(p) = parity {
+                assert_eq!(i + 1, messages.len(), "parity only after the last message");
+                packets.push(p);
+            }
+        }
+        packets
+    }
+
+    fn messages(seed: u8, count: usize) -> Vec<Vec<u8>> {
+        // Different lengths so the parity must carry them
+        (0..count).map(|i| vec![seed.wrapping_add(i as u8); 10 + i * 7]).collect()
+    }
+
+    fn receive(decoder: &mut FecDecoder, packet: &[u8]) -> (Option<(bool, Vec<u8>)>, Option<(bool, Vec<u8>)>, u32, bool) {
+        let d = decoder.receive(packet, framing::FRAME_HEADER_LEN).expect("well-formed");
+        (d.message.map(|(f, m)| (f, m.to_vec())), d.recovered, d.lost, d.duplicate)
+    }
+
+    #[test]
+    fn one_lost_message_is_recovered() {
+        let mut encoder = FecEncoder::new(4);
+        let sent = messages(1, 4);
+        for lost in 0..4 {
+            let packets = group(&mut encoder, &sent);
+            let mut decoder = FecDecoder::default();
+            let mut recovered = None;
+            for (i, p) in packets.iter().enumerate() {
+                if i == lost {
+                    continue;
+                }
+                let (message, rec, lost_count, duplicate) = receive(&mut decoder, p);
+                assert_eq!(lost_count, 0);
+                assert!(!duplicate);
+                if i < 4 {
+                    assert_eq!(message, Some((i % 2 == 1, sent[i].clone())));
+                }
+                if rec.is_some() {
+                    recovered = rec;
+                }
+            }
+            assert_eq!(recovered, Some((lost % 2 == 1, sent[lost].clone())), "lost message {}", lost);
+        }
+    }
+
+    #[test]
+    fn parity_before_the_last_message_still_recovers() {
+        let mut encoder = FecEncoder::new(3);
+        let sent = messages(9, 3);
+        let packets = group(&mut encoder, &sent);
+        let mut decoder = FecDecoder::default();
+        assert!(receive(&mut decoder, &packets[3]).1.is_none());
+        assert!(receive(&mut decoder, &packets[0]).1.is_none());
+        let (_, recovered, _, _) = receive(&mut decoder, &packets[2]);
+        assert_eq!(recovered, Some((true, sent[1].clone())));
+    }
+
+    #[test]
+    fn duplicates_and_complete_groups() {
+        let mut encoder = FecEncoder::new(2);
+        let packets = group(&mut encoder, &messages(3, 2));
+        let mut decoder = FecDecoder::default();
+        assert!(!receive(&mut decoder, &packets[0]).3);
+        assert!(receive(&mut decoder, &packets[0]).3);
+        assert!(receive(&mut decoder, &packets[1]).1.is_none());
+        // Nothing to recover once every message arrived
+        let (message, recovered, _, duplicate) = receive(&mut decoder, &packets[2]);
+        assert!(message.is_none() && recovered.is_none() && !duplicate);
+        assert!(receive(&mut decoder, &packets[2]).3);
+    }
+
+    #[test]
+    fn groups_closed_with_two_losses_count_them_lost() {
+        let mut encoder = FecEncoder::new(4);
+        let mut decoder = FecDecoder::default();
+        let first = group(&mut encoder, &messages(0, 4));
+        receive(&mut decoder, &first[0]);
+        receive(&mut decoder, &first[1]);
+        receive(&mut decoder, &first[4]);
+        let mut lost = 0;
+        for n in 1..=OPEN_GROUPS as u8 {
+            for p in group(&mut encoder, &messages(n, 4)) {
+                lost += receive(&mut decoder, &p).2;
+            }
+        }
+        assert_eq!(lost, 2);
+    }
+
+    #[test]
+    fn full_size_group_and_bad_indexes() {
+        let mut encoder = FecEncoder::new(MAX_GROUP);
+        let sent = messages(5, MAX_GROUP as usize);
+        let packets = group(&mut encoder, &sent);
+        let mut decoder = FecDecoder::default();
+        // The parity's index is 32: it must not be used as a message bit
+        let mut recovered = None;
+        for p in packets.iter().skip(1) {
+            recovered = recovered.or(receive(&mut decoder, p).1);
+        }
+        assert_eq!(recovered, Some((false, sent[0].clone())));
+
+        let mut bad = Vec::new();
+        framing::begin_fec_packet(&mut bad, 0, 0, 3, 3);
+        assert!(FecDecoder::default().receive(&bad, framing::FRAME_HEADER_LEN).is_none(), "message at the parity index");
+        framing::begin_fec_packet(&mut bad, FEC_PARITY, 0, 1, 3);
+        assert!(FecDecoder::default().receive(&bad, framing::FRAME_HEADER_LEN).is_none(), "parity at a message index");
+        framing::begin_fec_packet(&mut bad, 0, 0, 0, 33);
+        assert!(FecDecoder::default().receive(&bad, framing::FRAME_HEADER_LEN).is_none(), "group over MAX_GROUP");
+    }
+
+    #[test]
+    fn restarted_sender_starts_fresh_groups() {
+        let mut encoder = FecEncoder::new(2);
+        let mut decoder = FecDecoder::default();
+        for n in 0..RESTART_DISTANCE + 2 {
+            for p in group(&mut encoder, &messages(n as u8, 2)) {
+                receive(&mut decoder, &p);
+            }
+        }
+        let mut encoder = FecEncoder::new(2);
+        let sent = messages(200, 2);
+        let packets = group(&mut encoder, &sent);
+        let (message, _, _, duplicate) = receive(&mut decoder, &packets[1]);
+        assert!(!duplicate);
+        assert_eq!(message, Some((true, sent[1].clone())));
+        assert_eq!(receive(&mut decoder, &packets[2]).1, Some((false, sent[0].clone())));
+    }
+}
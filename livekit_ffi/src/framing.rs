@@ -0,0 +1,631 @@
+//! Wire framing for FFI-managed data traffic (keyed state channels, send batching, ...).
+//!
+//! Framed packets travel on topic `FRAMED_TOPIC_PREFIX + label`, so they never collide with
+//! raw `lk_send_data_ex` payloads, and always start with `[version u8][kind u8]`.
+//! Integers after the header are LEB128 varints.
+
+pub const FRAMED_TOPIC_PREFIX: &str = "lkf:";
+pub const FRAME_VERSION: u8 = 1;
+pub const FRAME_HEADER_LEN: usize = 2;
+
+/// Largest payload that reliably fits one lossy SCTP message without IP fragmentation.
+pub const LOSSY_MTU: usize = 1300;
+/// Largest single reliable data message the backend accepts.
+pub const RELIABLE_MAX: usize = 15 * 1024;
+
+#[repr(u8)]
+#[derive(Copy, Clone, Debug, PartialEq, Eq)]
+pub enum FrameKind {
+    /// `[epoch varint][tick varint]` then repeated `{key varint, len varint, bytes}`. The epoch
+    /// is drawn per sending channel, so a recreated channel's ticks restart without looking stale.
+    State = 1,
+    /// Repeated `{len varint, bytes}`; each entry is one application message.
+    Batch = 2,
+    /// `[seq varint][flags u8]` then the message bytes; unordered delivery (see `SEQ_RELIABLE`).
+    Seq = 3,
+    /// Repeated `{seq varint}`: sequence numbers received from the peer the packet is sent to.
+    Ack = 4,
+    /// `[frame varint][base varint][flags u8]` then the coded frame (see `delta`).
+    Delta = 5,
+    /// `[codec u8]` then the compressed message (see `compress`).
+    Compressed = 6,
+    /// `[sender time varint][flags u8]` then the message, or a framed packet (`TIMED_FRAMED`).
+    Timed = 7,
+    /// `[flags u8][t0 varint]`, plus `[t1 varint][t2 varint]` in pongs (see `clock_sync`).
+    Clock = 8,
+    /// `[flags u8][group varint][index u8][count u8]` then a packet of an FEC group or its
+    /// parity (see `fec`).
+    Fec = 9,
+}
+
+impl FrameKind {
+    fn from_u8(v: u8) -> Option<Self> {
+        match v {
+            1 => Some(FrameKind::State),
+            2 => Some(FrameKind::Batch),
+            3 => Some(FrameKind::Seq),
+            4 => Some(FrameKind::Ack),
+            5 => Some(FrameKind::Delta),
+            6 => Some(FrameKind::Compressed),
+            7 => Some(FrameKind::Timed),
+            8 => Some(FrameKind::Clock),
+            9 => Some(FrameKind::Fec),
+            _ => None,
+        }
+    }
+}
+
+pub fn framed_topic(label: &str) -> String {
+    format!("{FRAMED_TOPIC_PREFIX}{label}")
+}
+
+/// Returns the logical label if `topic` carries framed traffic.
+pub fn split_framed_topic(topic: &str) -> Option<&str> {
+    topic.strip_prefix(FRAMED_TOPIC_PREFIX)
+}
+
+pub fn varint_len(mut v: u64) -> usize {
+    let mut n = 1;
+    while v >= 0x80 {
+        v >>= 7;
+        n += 1;
+    }
+    n
+}
+
+pub fn put_varint(out: &mut Vec<u8>, mut v: u64) {
+    while v >= 0x80 {
+        out.push((v as u8) | 0x80);
+        v >>= 7;
+    }
+    out.push(v as u8);
+}
+
+pub fn get_varint(buf: &[u8], pos: &mut usize) -> Option<u64> {
+    let mut v = 0u64;
+    let mut shift = 0u32;
+    loop {
+        let b = *buf.get(*pos)?;
+        *pos += 1;
+        if shift >= 64 {
+            return None;
+        }
+        v |= ((b & 0x7f) as u64) << shift;
+        if b & 0x80 == 0 {
+            return Some(v);
+        }
+        shift += 7;
+    }
+}
+
+/// A timestamp varint; values beyond `i64::MAX` are malformed.
+fn get_time(buf: &[u8], pos: &mut usize) -> Option<i64> {
+    i64::try_from(get_varint(buf, pos)?).ok()
+}
+
+fn put_header(out: &mut Vec<u8>, kind: FrameKind) {
+    out.push(FRAME_VERSION);
+    out.push(kind as u8);
+}
+
+/// Parse the frame header, returning the kind and the body offset.
+pub fn parse_header(buf: &[u8]) -> Option<(FrameKind, usize)> {
+    if buf.len() < FRAME_HEADER_LEN || buf[0] != FRAME_VERSION {
+        return None;
+    }
+    Some((FrameKind::from_u8(buf[1])?, FRAME_HEADER_LEN))
+}
+
+// --------- State packets ---------
+
+/// Bytes a state packet needs before any entries.
+pub fn state_packet_overhead(epoch: u32, tick: u32) -> usize {
+    FRAME_HEADER_LEN + varint_len(epoch as u64) + varint_len(tick as u64)
+}
+
+/// Bytes one entry adds to a state packet.
+pub fn state_entry_len(key: u32, len: usize) -> usize {
+    varint_len(key as u64) + varint_len(len as u64) + len
+}
+
+pub fn begin_state_packet(out: &mut Vec<u8>, epoch: u32, tick: u32) {
+    out.clear();
+    put_header(out, FrameKind::State);
+    put_varint(out, epoch as u64);
+    put_varint(out, tick as u64);
+}
+
+pub fn put_state_entry(out: &mut Vec<u8>, key: u32, bytes: &[u8]) {
+    put_varint(out, key as u64);
+    put_varint(out, bytes.len() as u64);
+    out.extend_from_slice(bytes);
+}
+
+/// Iterates the `(key, bytes)` entries of a state packet body; stops at the first malformed entry.
+pub struct StateEntries<'a> {
+    buf: &'a [u8],
+    pos: usize,
+}
+
+impl<'a> Iterator for StateEntries<'a> {
+    type Item = (u32, &'a [u8]);
+
+    fn next(&mut self) -> Option<Self::Item> {
+        let key = get_varint(self.buf, &mut self.pos)?;
+        let len = get_varint(self.buf, &mut self.pos)? as usize;
+        let end = self.pos.checked_add(len)?;
+        let bytes = self.buf.get(self.pos..end)?;
+        self.pos = end;
+        Some((key as u32, bytes))
+    }
+}
+
+/// Parse a state packet body (after the header) into its epoch, tick and entries.
+pub fn parse_state_body(buf: &[u8], body: usize) -> Option<(u32, u32, StateEntries<'_>)> {
+    let mut pos = body;
+    let epoch = get_varint(buf, &mut pos)? as u32;
+    let tick = get_varint(buf, &mut pos)? as u32;
+    Some((epoch, tick, StateEntries { buf, pos }))
+}
+
+/// Serial-number comparison (RFC 1982) so tick counters may wrap.
+pub fn tick_newer(a: u32, b: u32) -> bool {
+    a != b && a.wrapping_sub(b) < 0x8000_0000
+}
+
+// --------- Batch packets ---------
+
+/// Bytes one message adds to a batch packet.
+pub fn batch_entry_len(len: usize) -> usize {
+    varint_len(len as u64) + len
+}
+
+pub fn begin_batch_packet(out: &mut Vec<u8>) {
+    out.clear();
+    put_header(out, FrameKind::Batch);
+}
+
+pub fn put_batch_entry(out: &mut Vec<u8>, bytes: &[u8]) {
+    put_varint(out, bytes.len() as u64);
+    out.extend_from_slice(bytes);
+}
+
+/// Iterates the messages of a batch packet body; stops at the first malformed entry.
+pub struct BatchEntries<'a> {
+    buf: &'a [u8],
+    pos: usize,
+}
+
+impl<'a> Iterator for BatchEntries<'a> {
+    type Item = &'a [u8];
+
+    fn next(&mut self) -> Option<Self::Item> {
+        let len = get_varint(self.buf, &mut self.pos)? as usize;
+        let end = self.pos.checked_add(len)?;
+        let bytes = self.buf.get(self.pos..end)?;
+        self.pos = end;
+        Some(bytes)
+    }
+}
+
+pub fn batch_entries(buf: &[u8], body: usize) -> BatchEntries<'_> {
+    BatchEntries { buf, pos: body }
+}
+
+// --------- Sequenced (unordered) packets ---------
+
+/// Seq flag: the receiver acknowledges the packet and the sender retransmits until it does.
+pub const SEQ_RELIABLE: u8 = 0x01;
+/// Acks (and clock sync packets) travel on this label, one targeted packet per peer.
+pub const ACK_LABEL: &str = "";
+
+/// Bytes a sequenced packet adds around the message.
+pub fn seq_packet_overhead(seq: u32) -> usize {
+    FRAME_HEADER_LEN + varint_len(seq as u64) + 1
+}
+
+pub fn put_seq_packet(out: &mut Vec<u8>, seq: u32, flags: u8, bytes: &[u8]) {
+    out.clear();
+    put_header(out, FrameKind::Seq);
+    put_varint(out, seq as u64);
+    out.push(flags);
+    out.extend_from_slice(bytes);
+}
+
+/// Parse a sequenced packet body into `(seq, flags, message)`.
+pub fn parse_seq_body(buf: &[u8], body: usize) -> Option<(u32, u8, &[u8])> {
+    let mut pos = body;
+    let seq = get_varint(buf, &mut pos)? as u32;
+    let flags = *buf.get(pos)?;
+    Some((seq, flags, &buf[pos + 1..]))
+}
+
+pub fn begin_ack_packet(out: &mut Vec<u8>) {
+    out.clear();
+    put_header(out, FrameKind::Ack);
+}
+
+/// Iterates the sequence numbers of an ack packet body.
+pub struct AckEntries<'a> {
+    buf: &'a [u8],
+    pos: usize,
+}
+
+impl<'a> Iterator for AckEntries<'a> {
+    type Item = u32;
+
+    fn next(&mut self) -> Option<Self::Item> {
+        get_varint(self.buf, &mut self.pos).map(|v| v as u32)
+    }
+}
+
+pub fn ack_entries(buf: &[u8], body: usize) -> AckEntries<'_> {
+    AckEntries { buf, pos: body }
+}
+
+// --------- Delta-coded packets ---------
+
+/// Delta flag: the frame is a keyframe (`base` is the frame itself).
+pub const DELTA_KEY: u8 = 0x01;
+/// Delta flag: the coded bytes are LZ4-compressed with the size prepended.
+pub const DELTA_LZ4: u8 = 0x02;
+
+pub fn begin_delta_packet(out: &mut Vec<u8>, frame: u32, base: u32, flags: u8) {
+    out.clear();
+    put_header(out, FrameKind::Delta);
+    put_varint(out, frame as u64);
+    put_varint(out, base as u64);
+    out.push(flags);
+}
+
+/// Parse a delta packet body into `(frame, base, flags, coded bytes)`.
+pub fn parse_delta_body(buf: &[u8], body: usize) -> Option<(u32, u32, u8, &[u8])> {
+    let mut pos = body;
+    let frame = get_varint(buf, &mut pos)? as u32;
+    let base = get_varint(buf, &mut pos)? as u32;
+    let flags = *buf.get(pos)?;
+    Some((frame, base, flags, &buf[pos + 1..]))
+}
+
+// --------- Compressed packets ---------
+
+pub fn begin_compressed_packet(out: &mut Vec<u8>, codec: u8) {
+    out.clear();
+    put_header(out, FrameKind::Compressed);
+    out.push(codec);
+}
+
+/// Parse a compressed packet body into `(codec, compressed bytes)`.
+pub fn parse_compressed_body(buf: &[u8], body: usize) -> Option<(u8, &[u8])> {
+    let codec = *buf.get(body)?;
+    Some((codec, &buf[body + 1..]))
+}
+
+// --------- Timestamped packets ---------
+
+/// Timed flag: the sender's clock was synchronized, so the time is in room clock.
+pub const TIMED_SYNCED: u8 = 0x01;
+/// Timed flag: the payload is itself a framed packet (delta-coded or compressed).
+pub const TIMED_FRAMED: u8 = 0x02;
+
+pub fn begin_timed_packet(out: &mut Vec<u8>, time_us: i64, flags: u8) {
+    out.clear();
+    put_header(out, FrameKind::Timed);
+    put_varint(out, time_us.max(0) as u64);
+    out.push(flags);
+}
+
+/// Parse a timed packet body into `(sender time, flags, payload)`.
+pub fn parse_timed_body(buf: &[u8], body: usize) -> Option<(i64, u8, &[u8])> {
+    let mut pos = body;
+    let time = get_time(buf, &mut pos)?;
+    let flags = *buf.get(pos)?;
+    Some((time, flags, &buf[pos + 1..]))
+}
+
+// --------- Clock sync ---------
+
+pub const CLOCK_PONG: u8 = 0x01;
+
+pub fn put_clock_ping(out: &mut Vec<u8>, t0: i64) {
+    out.clear();
+    put_header(out, FrameKind::Clock);
+    out.push(0);
+    put_varint(out, t0.max(0) as u64);
+}
+
+pub fn put_clock_pong(out: &mut Vec<u8>, t0: i64, t1: i64, t2: i64) {
+    out.clear();
+    put_header(out, FrameKind::Clock);
+    out.push(CLOCK_PONG);
+    for t in [t0, t1, t2] {
+        put_varint(out, t.max(0) as u64);
+    }
+}
+
+/// Parse a clock packet body into `(flags, t0, t1, t2)`; t1 and t2 are 0 in pings.
+pub fn parse_clock_body(buf: &[u8], body: usize) -> Option<(u8, i64, i64, i64)> {
+    let mut pos = body;
+    let flags = *buf.get(pos)?;
+    pos += 1;
+    let t0 = get_time(buf, &mut pos)?;
+    if flags & CLOCK_PONG == 0 {
+        return Some((flags, t0, 0, 0));
+    }
+    let t1 = get_time(buf, &mut pos)?;
+    let t2 = get_time(buf, &mut pos)?;
+    Some((flags, t0, t1, t2))
+}
+
+// --------- FEC packets ---------
+
+/// FEC flag: the packet is the group's parity rather than one of its messages.
+pub const FEC_PARITY: u8 = 0x01;
+/// FEC flag: the message is itself a framed packet (timestamped, delta-coded or compressed).
+pub const FEC_FRAMED: u8 = 0x02;
+/// Most bytes an FEC packet adds around its body.
+pub const FEC_PACKET_OVERHEAD: usize = FRAME_HEADER_LEN + 1 + 5 + 2;
+
+pub fn begin_fec_packet(out: &mut Vec<u8>, flags: u8, group: u32, index: u8, count: u8) {
+    out.clear();
+    put_header(out, FrameKind::Fec);
+    out.push(flags);
+    put_varint(out, group as u64);
+    out.push(index);
+    out.push(count);
+}
+
+/// Parse an FEC packet body into `(flags, group, index, count, body)`.
+pub fn parse_fec_body(buf: &[u8], body: usize) -> Option<(u8, u32, u8, u8, &[u8])> {
+    let mut pos = body;
+    let flags = *buf.get(pos)?;
+    pos += 1;
+    let group = get_varint(buf, &mut pos)? as u32;
+    let index = *buf.get(pos)?;
+    let count = *buf.get(pos + 1)?;
+    Some((flags, group, index, count, &buf[pos + 2..]))
+}
+
+/// What a `SeqWindow` knows about a sequence number.
+#[derive(Copy, Clone, Debug, PartialEq, Eq)]
+pub enum SeqVerdict {
+    New,
+    Duplicate,
+    /// Behind the window: it cannot tell whether the number was seen.
+    TooOld,
+}
+
+/// Sliding duplicate window over one sender's sequence numbers. Senders give up on
+/// retransmitting anything `SPAN` or more numbers behind their latest, so retransmissions
+/// always land inside the window.
+pub struct SeqWindow {
+    highest: u32,
+    /// Bit `seq % SPAN` is set if `seq` was seen; covers `highest - SPAN + 1 ..= highest`.
+    seen: [u64; (SeqWindow::SPAN / 64) as usize],
+    primed: bool,
+}
+
+impl Default for SeqWindow {
+    fn default() -> Self {
+        Self { highest: 0, seen: [0; (Self::SPAN / 64) as usize], primed: false }
+    }
+}
+
+impl SeqWindow {
+    /// A power of two, so `seq % SPAN` stays continuous across u32 wrap.
+    pub const SPAN: u32 = 4096;
+
+    fn bit(seq: u32) -> (usize, u64) {
+        let i = seq % Self::SPAN;
+        ((i / 64) as usize, 1u64 << (i % 64))
+    }
+
+    fn set(&mut self, seq: u32) {
+        let (word, mask) = Self::bit(seq);
+        self.seen[word] |= mask;
+    }
+
+    pub fn accept(&mut self, seq: u32) -> SeqVerdict {
+        if !self.primed {
+            self.primed = true;
+            self.highest = seq;
+            self.set(seq);
+            return SeqVerdict::New;
+        }
+        if tick_newer(seq, self.highest) {
+            let shift = seq.wrapping_sub(self.highest);
+            if shift >= Self::SPAN {
+                self.seen = [0; (Self::SPAN / 64) as usize];
+            } else {
+                // Forget the numbers that slide out of the window
+                for n in 1..=shift {
+                    let (word, mask) = Self::bit(self.highest.wrapping_add(n));
+                    self.seen[word] &= !mask;
+                }
+            }
+            self.highest = seq;
+            self.set(seq);
+            return SeqVerdict::New;
+        }
+        if self.highest.wrapping_sub(seq) >= Self::SPAN {
+            return SeqVerdict::TooOld;
+        }
+        let (word, mask) = Self::bit(seq);
+        if self.seen[word] & mask != 0 {
+            return SeqVerdict::Duplicate;
+        }
+        self.seen[word] |= mask;
+        SeqVerdict::New
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn body(packet: &[u8], kind: FrameKind) -> usize {
+        let (k, body) = parse_header(packet).unwrap();
+        assert_eq!(k, kind);
+        body
+    }
+
+    #[test]
+    fn varints_round_trip() {
+        let mut out = Vec::new();
+        let values = [0u64, 1, 127, 128, 16_383, 16_384, u32::MAX as u64, u64::MAX];
+        for v in values {
+            let before = out.len();
+            put_varint(&mut out, v);
+            assert_eq!(out.len() - before, varint_len(v));
+        }
+        let mut pos = 0;
+        for v in values {
+            assert_eq!(get_varint(&out, &mut pos), Some(v));
+        }
+        assert_eq!(get_varint(&out, &mut pos), None);
+        assert_eq!(get_varint(&[0x80, 0x80], &mut 0), None);
+    }
+
+    #[test]
+    fn state_packets_carry_epoch_tick_and_entries() {
+        let mut out = Vec::new();
+        begin_state_packet(&mut out, 0xdead_beef, 42);
+        assert_eq!(out.len(), state_packet_overhead(0xdead_beef, 42));
+        put_state_entry(&mut out, 7, b"seven");
+        put_state_entry(&mut out, 300, b"");
+        assert_eq!(out.len(), state_packet_overhead(0xdead_beef, 42) + state_entry_len(7, 5) + state_entry_len(300, 0));
+
+        let (epoch, tick, entries) = parse_state_body(&out, body(&out, FrameKind::State)).unwrap();
+        assert_eq!((epoch, tick), (0xdead_beef, 42));
+        assert_eq!(entries.collect::<Vec<_>>(), [(7, &b"seven"[..]), (300, &b""[..])]);
+
+        // A truncated entry ends iteration instead of reading past the packet
+        out.truncate(out.len() - 4);
+        let (_, _, entries) = parse_state_body(&out, FRAME_HEADER_LEN).unwrap();
+        assert_eq!(entries.count(), 0);
+    }
+
+    #[test]
+    fn tick_comparison_wraps() {
+        assert!(tick_newer(1, 0));
+        assert!(!tick_newer(0, 1));
+        assert!(!tick_newer(5, 5));
+        assert!(tick_newer(2, u32::MAX - 2));
+    }
+
+    #[test]
+    fn batch_entries_round_trip() {
+        let mut out = Vec::new();
+        begin_batch_packet(&mut out);
+        for m in [&b"a"[..], &b""[..], &[9u8; 300][..]] {
+            put_batch_entry(&mut out, m);
+        }
+        let entries: Vec<_> = batch_entries(&out, body(&out, FrameKind::Batch)).collect();
+        assert_eq!(entries.len(), 3);
+        assert_eq!(entries[2], &[9u8; 300][..]);
+    }
+
+    #[test]
+    fn ack_entries_round_trip() {
+        let mut out = Vec::new();
+        begin_ack_packet(&mut out);
+        for seq in [1u32, 500, u32::MAX] {
+            put_varint(&mut out, seq as u64);
+        }
+        assert_eq!(ack_entries(&out, body(&out, FrameKind::Ack)).collect::<Vec<_>>(), [1, 500, u32::MAX]);
+    }
+
+    #[test]
+    fn seq_packets_round_trip() {
+        let mut out = Vec::new();
+        put_seq_packet(&mut out, 70_000, SEQ_RELIABLE, b"msg");
+        assert_eq!(out.len(), seq_packet_overhead(70_000) + 3);
+        assert_eq!(parse_seq_body(&out, body(&out, FrameKind::Seq)), Some((70_000, SEQ_RELIABLE, &b"msg"[..])));
+    }
+
+    #[test]
+    fn delta_packets_round_trip() {
+        let mut out = Vec::new();
+        begin_delta_packet(&mut out, 12, 10, DELTA_LZ4);
+        out.extend_from_slice(b"xy");
+        assert_eq!(parse_delta_body(&out, body(&out, FrameKind::Delta)), Some((12, 10, DELTA_LZ4, &b"xy"[..])));
+    }
+
+    #[test]
+    fn timed_and_clock_packets_round_trip() {
+        let mut out = Vec::new();
+        begin_timed_packet(&mut out, 1_700_000_000_000_000, TIMED_SYNCED);
+        out.extend_from_slice(b"t");
+        assert_eq!(parse_timed_body(&out, body(&out, FrameKind::Timed)), Some((1_700_000_000_000_000, TIMED_SYNCED, &b"t"[..])));
+
+        put_clock_pong(&mut out, 1, 2, 3);
+        assert_eq!(parse_clock_body(&out, body(&out, FrameKind::Clock)), Some((CLOCK_PONG, 1, 2, 3)));
+        put_clock_ping(&mut out, 9);
+        assert_eq!(parse_clock_body(&out, body(&out, FrameKind::Clock)), Some((0, 9, 0, 0)));
+    }
+
+    #[test]
+    fn fec_packets_round_trip() {
+        let mut out = Vec::new();
+        begin_fec_packet(&mut out, FEC_PARITY, u32::MAX, 4, 4);
+        assert!(out.len() <= FEC_PACKET_OVERHEAD);
+        assert_eq!(parse_fec_body(&out, body(&out, FrameKind::Fec)), Some((FEC_PARITY, u32::MAX, 4, 4, &b""[..])));
+    }
+
+    #[test]
+    fn bad_headers_are_rejected() {
+        assert_eq!(parse_header(&[FRAME_VERSION]), None);
+        assert_eq!(parse_header(&[FRAME_VERSION + 1, 1]), None);
+        assert_eq!(parse_header(&[FRAME_VERSION, 0]), None);
+        assert_eq!(split_framed_topic(&framed_topic("pose")), Some("pose"));
+        assert_eq!(split_framed_topic("pose"), None);
+    }
+
+    #[test]
+    fn out_of_range_timestamps_are_rejected() {
+        let mut out = Vec::new();
+        begin_timed_packet(&mut out, 1_234, 0);
+        out.push(7);
+        assert_eq!(parse_timed_body(&out, body(&out, FrameKind::Timed)), Some((1_234, 0, &[7u8][..])));
+
+        out.clear();
+        put_header(&mut out, FrameKind::Timed);
+        put_varint(&mut out, u64::MAX);
+        out.push(0);
+        assert_eq!(parse_timed_body(&out, body(&out, FrameKind::Timed)), None);
+
+        put_clock_pong(&mut out, 1, 2, 3);
+        assert_eq!(parse_clock_body(&out, body(&out, FrameKind::Clock)), Some((CLOCK_PONG, 1, 2, 3)));
+        out.truncate(out.len() - 1);
+        put_varint(&mut out, i64::MAX as u64 + 1);
+        assert_eq!(parse_clock_body(&out, body(&out, FrameKind::Clock)), None);
+    }
+
+    #[test]
+    fn seq_window_rejects_duplicates_and_stale() {
+        let mut w = SeqWindow::default();
+        assert_eq!(w.accept(u32::MAX - 1), SeqVerdict::New);
+        assert_eq!(w.accept(1), SeqVerdict::New);
+        assert_eq!(w.accept(1), SeqVerdict::Duplicate);
+        assert_eq!(w.accept(u32::MAX), SeqVerdict::New);
+        assert_eq!(w.accept(u32::MAX - 1), SeqVerdict::Duplicate);
+        assert_eq!(w.accept(1 + SeqWindow::SPAN), SeqVerdict::New);
+        assert_eq!(w.accept(1), SeqVerdict::TooOld, "older than the window");
+    }
+
+    #[test]
+    fn seq_window_keeps_late_retransmits() {
+        let mut w = SeqWindow::default();
+        assert_eq!(w.accept(0), SeqVerdict::New);
+        for seq in 2..=1030 {
+            assert_eq!(w.accept(seq), SeqVerdict::New);
+        }
+        assert_eq!(w.accept(1), SeqVerdict::New, "a retransmit far behind the newest");
+        assert_eq!(w.accept(1), SeqVerdict::Duplicate);
+        // Numbers sliding out of the window are forgotten, not reported as seen
+        assert_eq!(w.accept(SeqWindow::SPAN + 5), SeqVerdict::New);
+        assert_eq!(w.accept(SeqWindow::SPAN + 1), SeqVerdict::New);
+        assert_eq!(w.accept(6), SeqVerdict::Duplicate, "still inside the window");
+        assert_eq!(w.accept(5), SeqVerdict::TooOld);
+    }
+}
@@ -0,0 +1,202 @@
+//! Lock-free latency histograms for the hot paths (`lk_get_latency_stats`).
+//!
+//! Buckets are log-linear in nanoseconds: values below 16 get a bucket each, and every power
+//! of two above that is split into 16 linear sub-buckets, so any value is off by at most 1/16
+//! (about 6%) from its bucket. Recording is a handful of relaxed atomic adds, safe from any
+//! thread; a snapshot reads the buckets without stopping writers, so a sample recorded during
+//! it may be counted in the total but not the percentiles, or the other way round.
+
+use std::sync::atomic::{AtomicU64, Ordering};
+use std::time::Duration;
+
+const SUB_BITS: u32 = 4;
+const SUB_COUNT: usize = 1 << SUB_BITS;
+const BUCKETS: usize = (64 - SUB_BITS as usize + 1) * SUB_COUNT;
+
+fn bucket_index(v: u64) -> usize {
+    if v < SUB_COUNT as u64 {
+        return v as usize;
+    }
+    let shift = 63 - v.leading_zeros() - SUB_BITS;
+    (shift as usize + 1) * SUB_COUNT + ((v >> shift) as usize & (SUB_COUNT - 1))
+}
+
+/// Midpoint of bucket `i`, the value reported for samples that landed in it.
+fn bucket_value(i: usize) -> u64 {
+    if i < SUB_COUNT {
+        return i as u64;
+    }
+    let shift = (i / SUB_COUNT - 1) as u32;
+    let low = ((SUB_COUNT + i % SUB_COUNT) as u64) << shift;
+    low + ((1u64 << shift) >> 1)
+}
+
+pub struct Histogram {
+    buckets: Box<[AtomicU64]>,
+    count: AtomicU64,
+    sum_ns: AtomicU64,
+    min_ns: AtomicU64,
+    max_ns: AtomicU64,
+}
+
+impl Default for Histogram {
+    fn default() -> Self {
+        Self {
+            buckets: (0..BUCKETS).map(|_| AtomicU64::new(0)).collect(),
+            count: AtomicU64::new(0),
+            sum_ns: AtomicU64::new(0),
+            min_ns: AtomicU64::new(u64::MAX),
+            max_ns: AtomicU64::new(0),
+        }
+    }
+}
+
+/// Summary of one histogram, in microseconds. All zero when nothing was recorded.
+#[derive(Copy, Clone, Debug, Default)]
+pub struct Summary {
+    pub count: u64,
+    pub min_us: f64,
+    pub max_us: f64,
+    pub mean_us: f64,
+    pub p50_us: f64,
+    pub p90_us: f64,
+    pub p99_us: f64,
+    pub p999_us: f64,
+}
+
+impl Histogram {
+    pub fn record(&self, elapsed: Duration) {
+        let ns = elapsed.as_nanos().min(u64::MAX as u128) as u64;
+        self.buckets[bucket_index(ns)].fetch_add(1, Ordering::Relaxed);
+        self.count.fetch_add(1, Ordering::Relaxed);
+        self.sum_ns.fetch_add(ns, Ordering::Relaxed);
+        self.min_ns.fetch_min(ns, Ordering::Relaxed);
+        self.max_ns.fetch_max(ns, Ordering::Relaxed);
+    }
+
+    /// Summarize what was recorded; with `reset`, also start over from empty.
+    pub fn snapshot(&self, reset: bool) -> Summary {
+        let take = |a: &AtomicU64, empty: u64| if reset { a.swap(empty, Ordering::Relaxed) } else { a.load(Ordering::Relaxed) };
+        let counts: Vec<u64> = self.buckets.iter().map(|b| take(b, 0)).collect();
+        let count = take(&self.count, 0);
+        let sum_ns = take(&self.sum_ns, 0);
+        let min_ns = take(&self.min_ns, u64::MAX);
+        let max_ns = take(&self.max_ns, 0);
+        let total: u64 = counts.iter().sum();
+        if count == 0 || total == 0 {
+            return Summary::default();
+        }
+
+        let percentile = |q: f64| {
+            let rank = ((total as f64 * q).ceil() as u64).max(1);
+            let mut seen = 0u64;
+            for (i, &c) in counts.iter().enumerate() {
+                seen += c;
+                if seen >= rank {
+                    return bucket_value(i).clamp(min_ns, max_ns.max(min_ns));
+                }
+            }
+            max_ns
+        };
+        let us = |ns: u64| ns as f64 / 1_000.0;
+        Summary {
+            count,
+            min_us: us(min_ns.min(max_ns)),
+            max_us: us(max_ns),
+            mean_us: sum_ns as f64 / count as f64 / 1_000.0,
+            p50_us: us(percentile(0.50)),
+            p90_us: us(percentile(0.90)),
+            p99_us: us(percentile(0.99)),
+            p999_us: us(percentile(0.999)),
+        }
+    }
+}
+
+/// The per-client receive and audio histograms; send latency lives with the data counters,
+/// which every send path already carries.
+#[derive(Default)]
+pub struct Latencies {
+    /// A published PCM block waiting in the ring until its frame goes to `capture_frame`.
+    pub audio_ring: Histogram,
+    /// A received data message or audio frame from arrival until its callback starts.
+    pub dispatch: Histogram,
+    /// Time spent inside data and audio callbacks.
+    pub callback: Histogram,
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn small_values_get_exact_buckets() {
+        for v in 0..SUB_COUNT as u64 {
+            assert_eq!(bucket_index(v), v as usize);
+            assert_eq!(bucket_value(v as usize), v);
+        }
+        assert_eq!(bucket_index(SUB_COUNT as u64), SUB_COUNT);
+    }
+
+    #[test]
+    fn largest_value_lands_in_the_last_bucket() {
+        assert_eq!(bucket_index(u64::MAX), BUCKETS - 1);
+        assert!(bucket_value(BUCKETS - 1) > u64::MAX - (u64::MAX >> SUB_BITS));
+    }
+
+    #[test]
+    fn buckets_are_ordered_and_within_a_sixteenth() {
+        let mut values: Vec<u64> = (0..64)
+            .flat_map(|shift| [1u64 << shift, (1u64 << shift) + 1, (1u64 << shift) + (1u64 << shift >> 1), u64::MAX >> (63 - shift)])
+            .collect();
+        values.sort_unstable();
+        let mut last = 0;
+        for v in values {
+            let i = bucket_index(v);
+            assert!(i >= last && i < BUCKETS, "{v} went to bucket {i} after {last}");
+            let mid = bucket_value(i);
+            assert!(mid.abs_diff(v) <= v / SUB_COUNT as u64, "{v} reported as {mid}");
+            last = i;
+        }
+    }
+
+    #[test]
+    fn percentiles_are_accurate_to_a_sixteenth() {
+        let h = Histogram::default();
+        for us in 1..=1_000u64 {
+            h.record(Duration::from_micros(us));
+        }
+        let s = h.snapshot(false);
+        assert_eq!(s.count, 1_000);
+        assert_eq!(s.min_us, 1.0);
+        assert_eq!(s.max_us, 1_000.0);
+        assert!((s.mean_us - 500.5).abs() < 1e-9);
+        for (got, want) in [(s.p50_us, 500.0), (s.p90_us, 900.0), (s.p99_us, 990.0), (s.p999_us, 999.0)] {
+            assert!((got - want).abs() <= want / 16.0, "expected about {want}, got {got}");
+        }
+    }
+
+    #[test]
+    fn percentiles_stay_within_min_and_max() {
+        let h = Histogram::default();
+        h.record(Duration::from_nanos(1_000_001));
+        let s = h.snapshot(false);
+        assert_eq!(s.p50_us, s.min_us);
+        assert_eq!(s.p999_us, s.max_us);
+    }
+
+    #[test]
+    fn snapshot_resets_only_when_asked() {
+        let h = Histogram::default();
+        assert_eq!(h.snapshot(true).count, 0);
+        h.record(Duration::from_micros(5));
+        h.record(Duration::from_micros(7));
+        assert_eq!(h.snapshot(false).count, 2);
+        let s = h.snapshot(true);
+        assert_eq!((s.count, s.min_us, s.max_us), (2, 5.0, 7.0));
+        let empty = h.snapshot(false);
+        assert_eq!((empty.count, empty.min_us, empty.max_us, empty.p50_us), (0, 0.0, 0.0, 0.0));
+        h.record(Duration::from_micros(9));
+        let s = h.snapshot(true);
+        assert_eq!((s.count, s.min_us, s.max_us, s.p50_us), (1, 9.0, 9.0, 9.0));
+    }
+}
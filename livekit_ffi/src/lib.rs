@@ -7,7 +7,31 @@ mod backend { pub use super::backend_stub::*; }
 
 #[cfg(feature = "with_livekit")]
 mod backend_livekit;
+#[cfg(feature = "with_livekit")]
+mod clock_sync;
+#[cfg(feature = "with_livekit")]
+mod compress;
+#[cfg(feature = "with_livekit")]
+mod delta;
+#[cfg(feature = "with_livekit")]
+mod fec;
+#[cfg(feature = "with_livekit")]
+mod framing;
+#[cfg(feature = "with_livekit")]
+mod latency;
+#[cfg(feature = "with_livekit")]
+mod logging;
+#[cfg(feature = "with_livekit")]
+mod rate_control;
+#[cfg(feature = "with_livekit")]
+mod scheduler;
+#[cfg(feature = "trace_spans")]
+mod trace;
 #[cfg(not(feature = "with_livekit"))]
 mod backend_stub;
+mod playout;
+mod pose_codec;
 
 pub use backend::*;
+pub use playout::*;
+pub use pose_codec::*;
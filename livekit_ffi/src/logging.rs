@@ -0,0 +1,168 @@
+//! Client log output (`lk_set_log_level`, `lk_set_log_callback`).
+//!
+//! Checking whether a level is enabled is one relaxed atomic load, so disabled log lines cost
+//! nothing on hot paths. Enabled lines are formatted on the calling thread and pushed onto a
+//! bounded queue without blocking; a background thread, started by the first line, hands them
+//! to the callback or, without one, prints them to stdout. When the queue is full lines are
+//! dropped and counted. Each call site may emit a burst of lines per second; the rest are
+//! counted and reported with that site's next line.
+
+use std::ffi::CString;
+use std::os::raw::{c_char, c_void};
+use std::sync::atomic::{AtomicI32, AtomicI64, AtomicU32, AtomicU64, Ordering};
+use std::sync::{Arc, Mutex, OnceLock};
+
+use tokio::sync::mpsc;
+
+use crate::backend_livekit::LkLogLevel;
+use crate::clock_sync;
+
+pub type LogCallback = extern "C" fn(*mut c_void, LkLogLevel, *const c_char, *const c_char, i64);
+
+/// Lines waiting for the log thread before new ones are dropped.
+const QUEUE_LEN: usize = 1024;
+/// Lines one call site may emit per window.
+const SITE_BURST: u32 = 20;
+const SITE_WINDOW_US: i64 = 1_000_000;
+
+/// Rate limit state of one log call site; `lk_log!` keeps one in a static.
+pub struct CallSite {
+    window_start_us: AtomicI64,
+    count: AtomicU32,
+    suppressed: AtomicU32,
+}
+
+impl CallSite {
+    pub const fn new() -> Self {
+        Self { window_start_us: AtomicI64::new(i64::MIN), count: AtomicU32::new(0), suppressed: AtomicU32::new(0) }
+    }
+
+    /// Some(lines suppressed since the last admitted one) if this line may be emitted.
+    /// Approximate under contention, which only shifts a line between windows.
+    fn admit(&self, now_us: i64) -> Option<u32> {
+        let start = self.window_start_us.load(Ordering::Relaxed);
+        if now_us.saturating_sub(start) >= SITE_WINDOW_US
+            && self.window_start_us.compare_exchange(start, now_us, Ordering::Relaxed, Ordering::Relaxed).is_ok()
+        {
+            self.count.store(1, Ordering::Relaxed);
+            return Some(self.suppressed.swap(0, Ordering::Relaxed));
+        }
+        if self.count.fetch_add(1, Ordering::Relaxed) < SITE_BURST {
+            Some(0)
+        } else {
+            self.suppressed.fetch_add(1, Ordering::Relaxed);
+            None
+        }
+    }
+}
+
+struct Record {
+    level: LkLogLevel,
+    target: &'static str,
+    message: String,
+    timestamp_us: i64,
+    suppressed: u32,
+}
+
+enum Sink {
+    Stdout,
+    Callback(LogCallback, *mut c_void),
+    /// The client is destroyed; queued lines are discarded.
+    Closed,
+}
+
+unsafe impl Send for Sink {}
+
+pub struct Logger {
+    level: AtomicI32,
+    tx: OnceLock<mpsc::Sender<Record>>,
+    sink: Arc<Mutex<Sink>>,
+    dropped: Arc<AtomicU64>,
+}
+
+impl Default for Logger {
+    fn default() -> Self {
+        Self {
+            level: AtomicI32::new(LkLogLevel::Error as i32),
+            tx: OnceLock::new(),
+            sink: Arc::new(Mutex::new(Sink::Stdout)),
+            dropped: Arc::new(AtomicU64::new(0)),
+        }
+    }
+}
+
+impl Logger {
+    #[inline]
+    pub fn enabled(&self, level: LkLogLevel) -> bool {
+        (level as i32) <= self.level.load(Ordering::Relaxed)
+    }
+
+    pub fn set_level(&self, level: LkLogLevel) {
+        self.level.store(level as i32, Ordering::Relaxed);
+    }
+
+    /// Route lines to `cb`, or back to stdout with None. Waits for a callback in progress, so
+    /// the previous callback is not called after this returns.
+    pub fn set_callback(&self, cb: Option<LogCallback>, user: *mut c_void) {
+        let mut sink = self.sink.lock().unwrap();
+        if !matches!(*sink, Sink::Closed) {
+            *sink = match cb {
+                Some(cb) => Sink::Callback(cb, user),
+                None => Sink::Stdout,
+            };
+        }
+    }
+
+    /// Stop delivering; called when the client is destroyed.
+    pub fn close(&self) {
+        *self.sink.lock().unwrap() = Sink::Closed;
+    }
+
+    /// Queue one line; callers check `enabled` first (see `lk_log!`).
+    pub fn emit(&self, level: LkLogLevel, target: &'static str, site: &CallSite, args: std::fmt::Arguments) {
+        let timestamp_us = clock_sync::now_us();
+        let Some(suppressed) = site.admit(timestamp_us) else { return; };
+        let record = Record { level, target, message: args.to_string(), timestamp_us, suppressed };
+        let tx = self.tx.get_or_init(|| self.start());
+        if tx.try_send(record).is_err() {
+            self.dropped.fetch_add(1, Ordering::Relaxed);
+        }
+    }
+
+    fn start(&self) -> mpsc::Sender<Record> {
+        let (tx, mut rx) = mpsc::channel::<Record>(QUEUE_LEN);
+        let sink = self.sink.clone();
+        let dropped = self.dropped.clone();
+        // Exits once the logger, and with it the sender, is gone and the queue is drained. If
+        // the thread cannot start, the receiver goes with it and every line counts as dropped.
+        let _ = std::thread::Builder::new().name("livekit_ffi-log".into()).spawn(move || {
+            while let Some(record) = rx.blocking_recv() {
+                let sink = sink.lock().unwrap();
+                let lost = dropped.swap(0, Ordering::Relaxed);
+                if lost > 0 {
+                    let message = format!("{lost} log lines dropped: queue full");
+                    deliver(&sink, LkLogLevel::Warn, record.target, &message, record.timestamp_us);
+                }
+                if record.suppressed > 0 {
+                    let message = format!("{} ({} similar lines suppressed)", record.message, record.suppressed);
+                    deliver(&sink, record.level, record.target, &message, record.timestamp_us);
+                } else {
+                    deliver(&sink, record.level, record.target, &record.message, record.timestamp_us);
+                }
+            }
+        });
+        tx
+    }
+}
+
+fn deliver(sink: &Sink, level: LkLogLevel, target: &str, message: &str, timestamp_us: i64) {
+    match *sink {
+        Sink::Stdout => println!("[livekit_ffi] {}", message),
+        Sink::Callback(cb, user) => {
+            let target = CString::new(target).unwrap_or_default();
+            let message = CString::new(message).unwrap_or_default();
+            cb(user, level, target.as_ptr(), message.as_ptr(), timestamp_us);
+        }
+        Sink::Closed => {}
+    }
+}
@@ -0,0 +1,480 @@
+//! Receive-side playout buffer for pose streams (`lk_playout_*`).
+//!
+//! Frames are pushed with the sender's timestamp and their local arrival time, and sampled at
+//! an arbitrary local render time. The buffer plays each frame out a target delay after the
+//! fastest transit seen recently (`arrival - sample_time`), so it works with unsynchronized
+//! sender clocks: only their rate matters. The target is the 95th percentile of transit
+//! jitter plus one frame interval, since interpolating needs the next frame on hand; it rises
+//! at once and falls slowly, so playback is as early as the network allows.
+//!
+//! Between frames, rotations are normalized-lerped along the shorter arc and positions and
+//! scales are lerped; past the newest frame the last two frames are extrapolated for a short
+//! while, then the newest frame is held.
+//!
+//! Works with either backend; a buffer may be pushed and sampled from different threads.
+
+use crate::backend::LkResult;
+use crate::pose_codec::LkBoneTransform;
+use std::collections::VecDeque;
+use std::ffi::CString;
+use std::os::raw::c_int;
+use std::sync::Mutex;
+
+/// Transit samples kept for the jitter estimate.
+const TRANSIT_WINDOW: usize = 128;
+/// Applied per push when the jitter target falls, so a short calm spell does not undo it.
+const TARGET_DECAY: i64 = 64;
+
+const DEFAULT_MAX_DELAY_MS: c_int = 200;
+const DEFAULT_MAX_EXTRAPOLATE_MS: c_int = 50;
+const DEFAULT_CAPACITY: c_int = 64;
+
+#[repr(C)]
+#[derive(Copy, Clone, Debug)]
+pub struct LkPlayoutConfig {
+    pub bone_count: u32,
+    /// Floor for the jitter target.
+    pub min_delay_ms: c_int,
+    /// Cap for the jitter target; 0 = 200.
+    pub max_delay_ms: c_int,
+    /// How long to extrapolate past the newest frame before holding it; 0 = 50, <0 = never.
+    pub max_extrapolate_ms: c_int,
+    /// Frames buffered at most; 0 = 64.
+    pub capacity: c_int,
+}
+
+#[repr(C)]
+#[derive(Copy, Clone, Debug, PartialEq, Eq)]
+pub enum LkPlayoutMode {
+    /// Nothing pushed yet; the output is untouched.
+    Empty = 0,
+    Interpolated = 1,
+    Extrapolated = 2,
+    /// Before the first frame or out of extrapolation time: a buffered frame as is.
+    Held = 3,
+}
+
+#[repr(C)]
+#[derive(Copy, Clone, Debug, Default)]
+pub struct LkPlayoutStats {
+    /// Frames buffered ahead of the last render time.
+    pub depth: c_int,
+    pub target_delay_us: i64,
+    /// 95th percentile transit minus the fastest transit over the recent window.
+    pub jitter_us: i64,
+    pub frames_pushed: i64,
+    /// Frames that arrived after their play time had passed.
+    pub late_dropped: i64,
+    pub duplicates_dropped: i64,
+    /// Frames discarded because the buffer was full.
+    pub overflow_dropped: i64,
+    pub interpolated: i64,
+    pub extrapolated: i64,
+    pub held: i64,
+}
+
+struct Frame {
+    time: i64,
+    bones: Vec<LkBoneTransform>,
+}
+
+struct Playout {
+    bones: usize,
+    min_delay: i64,
+    max_delay: i64,
+    max_extrapolate: i64,
+    capacity: usize,
+    frames: VecDeque<Frame>,
+    pool: Vec<Vec<LkBoneTransform>>,
+    transits: VecDeque<i64>,
+    sorted: Vec<i64>,
+    /// Fastest recent transit: where the sender timeline sits on the local clock.
+    base: i64,
+    target: i64,
+    /// Sender time of the last sample; frames older than this are late.
+    played: Option<i64>,
+    newest: Option<i64>,
+    /// Smoothed interval between frames, in sender time.
+    interval: i64,
+    stats: LkPlayoutStats,
+}
+
+impl Playout {
+    fn new(cfg: &LkPlayoutConfig) -> Result<Self, &'static str> {
+        if cfg.bone_count == 0 {
+            return Err("bone_count must be positive");
+        }
+        let ms = |v: c_int, default: c_int| if v == 0 { default } else { v } as i64 * 1000;
+        let min_delay = cfg.min_delay_ms.max(0) as i64 * 1000;
+        let max_delay = ms(cfg.max_delay_ms, DEFAULT_MAX_DELAY_MS).max(min_delay);
+        Ok(Self {
+            bones: cfg.bone_count as usize,
+            min_delay,
+            max_delay,
+            max_extrapolate: ms(cfg.max_extrapolate_ms, DEFAULT_MAX_EXTRAPOLATE_MS).max(0),
+            capacity: (if cfg.capacity <= 0 { DEFAULT_CAPACITY } else { cfg.capacity }).max(2) as usize,
+            frames: VecDeque::new(),
+            pool: Vec::new(),
+            transits: VecDeque::with_capacity(TRANSIT_WINDOW),
+            sorted: Vec::with_capacity(TRANSIT_WINDOW),
+            base: 0,
+            target: min_delay,
+            played: None,
+            newest: None,
+            interval: 0,
+            stats: LkPlayoutStats::default(),
+        })
+    }
+
+    fn update_jitter(&mut self, transit: i64) {
+        if self.transits.len() == TRANSIT_WINDOW {
+            self.transits.pop_front();
+        }
+        self.transits.push_back(transit);
+        self.sorted.clear();
+        self.sorted.extend(self.transits.iter().copied());
+        self.sorted.sort_unstable();
+        self.base = self.sorted[0];
+        let jitter = self.sorted[(self.sorted.len() - 1) * 95 / 100] - self.base;
+        self.stats.jitter_us = jitter;
+        let wanted = (jitter + self.interval).clamp(self.min_delay, self.max_delay);
+        if wanted > self.target {
+            self.target = wanted;
+        } else {
+            self.target -= (self.target - wanted) / TARGET_DECAY;
+        }
+        self.stats.target_delay_us = self.target;
+    }
+
+    fn push(&mut self, time: i64, arrival: i64, bones: &[LkBoneTransform]) {
+        self.stats.frames_pushed += 1;
+        // Far behind what already played: the sender restarted or its clock stepped back.
+        // Start over on the new timeline instead of dropping every frame as late.
+        if self.played.is_some_and(|p| time < p.saturating_sub(self.max_delay)) {
+            self.reset();
+        }
+        if let Some(newest) = self.newest.filter(|n| time > *n) {
+            // Lost frames double a step; the average still settles near the send interval
+            let step = time - newest;
+            self.interval = if self.interval == 0 { step } else { self.interval + (step - self.interval) / 16 };
+        }
+        self.newest = Some(self.newest.map_or(time, |n| n.max(time)));
+        self.update_jitter(arrival - time);
+        if self.played.is_some_and(|p| time <= p) {
+            self.stats.late_dropped += 1;
+            return;
+        }
+        // Usually the newest frame: search from the back
+        let at = self.frames.iter().rposition(|f| f.time <= time).map_or(0, |i| i + 1);
+        if at > 0 && self.frames[at - 1].time == time {
+            self.stats.duplicates_dropped += 1;
+            return;
+        }
+        if self.frames.len() == self.capacity {
+            if at == 0 {
+                self.stats.overflow_dropped += 1;
+                return;
+            }
+            if let Some(old) = self.frames.pop_front() {
+                self.pool.push(old.bones);
+            }
+            self.stats.overflow_dropped += 1;
+            self.insert(at - 1, time, bones);
+        } else {
+            self.insert(at, time, bones);
+        }
+    }
+
+    /// Forget the sender timeline; statistics and the jitter target are kept.
+    fn reset(&mut self) {
+        for frame in self.frames.drain(..) {
+            self.pool.push(frame.bones);
+        }
+        self.transits.clear();
+        self.played = None;
+        self.newest = None;
+        self.interval = 0;
+    }
+
+    fn insert(&mut self, at: usize, time: i64, bones: &[LkBoneTransform]) {
+        let mut buf = self.pool.pop().unwrap_or_default();
+        buf.clear();
+        buf.extend_from_slice(bones);
+        self.frames.insert(at, Frame { time, bones: buf });
+    }
+
+    fn sample(&mut self, render: i64, out: &mut [LkBoneTransform]) -> LkPlayoutMode {
+        let s = render - self.base - self.target;
+        // Keep the frame at or before s (or the last two, for extrapolation) and everything after
+        while self.frames.len() > 2 && self.frames[1].time <= s {
+            if let Some(old) = self.frames.pop_front() {
+                self.pool.push(old.bones);
+            }
+        }
+        self.played = Some(self.played.map_or(s, |p| p.max(s)));
+        self.stats.depth = self.frames.iter().filter(|f| f.time > s).count() as c_int;
+
+        let Some(first) = self.frames.front() else { return LkPlayoutMode::Empty; };
+        let n = self.frames.len();
+        let last = &self.frames[n - 1];
+        let mode = if s < first.time || n == 1 {
+            let frame = if s < first.time { first } else { last };
+            out.copy_from_slice(&frame.bones);
+            LkPlayoutMode::Held
+        } else if s <= last.time {
+            let (a, b) = (&self.frames[0], &self.frames[1]);
+            blend(&a.bones, &b.bones, (s - a.time) as f32 / (b.time - a.time).max(1) as f32, out);
+            LkPlayoutMode::Interpolated
+        } else if s - last.time <= self.max_extrapolate {
+            let prev = &self.frames[n - 2];
+            blend(&prev.bones, &last.bones, (s - prev.time) as f32 / (last.time - prev.time).max(1) as f32, out);
+            LkPlayoutMode::Extrapolated
+        } else {
+            out.copy_from_slice(&last.bones);
+            LkPlayoutMode::Held
+        };
+        match mode {
+            LkPlayoutMode::Interpolated => self.stats.interpolated += 1,
+            LkPlayoutMode::Extrapolated => self.stats.extrapolated += 1,
+            _ => self.stats.held += 1,
+        }
+        mode
+    }
+}
+
+/// Blend two poses at `t` (beyond 1 extrapolates). Rotations take the shorter arc and are
+/// renormalized; adequate for the small per-frame angles of a pose stream.
+fn blend(a: &[LkBoneTransform], b: &[LkBoneTransform], t: f32, out: &mut [LkBoneTransform]) {
+    let lerp = |x: f32, y: f32| x + (y - x) * t;
+    for ((o, a), b) in out.iter_mut().zip(a).zip(b) {
+        let dot: f32 = a.rotation.iter().zip(&b.rotation).map(|(x, y)| x * y).sum();
+        let sign = if dot < 0.0 { -1.0 } else { 1.0 };
+        let mut q = [0.0f32; 4];
+        for i in 0..4 {
+            q[i] = lerp(a.rotation[i], b.rotation[i] * sign);
+        }
+        let norm = q.iter().map(|v| v * v).sum::<f32>().sqrt();
+        let inv = if norm > 0.0 { 1.0 / norm } else { 0.0 };
+        o.rotation = [q[0] * inv, q[1] * inv, q[2] * inv, q[3] * inv];
+        for i in 0..3 {
+            o.position[i] = lerp(a.position[i], b.position[i]);
+            o.scale[i] = lerp(a.scale[i], b.scale[i]);
+        }
+    }
+}
+
+/// Opaque playout buffer handle.
+pub struct LkPlayoutBuffer(Mutex<Playout>);
+
+fn ok() -> LkResult {
+    LkResult { code: 0, message: std::ptr::null() }
+}
+
+fn err(code: c_int, msg: &str) -> LkResult {
+    let c = CString::new(msg).unwrap_or_else(|_| CString::new("ffi error").unwrap());
+    LkResult { code, message: c.into_raw() }
+}
+
+/// Create a playout buffer; NULL if `config` is NULL or invalid.
+#[no_mangle]
+pub extern "C" fn lk_playout_create(config: *const LkPlayoutConfig) -> *mut LkPlayoutBuffer {
+    if config.is_null() {
+        return std::ptr::null_mut();
+    }
+    match Playout::new(unsafe { &*config }) {
+        Ok(p) => Box::into_raw(Box::new(LkPlayoutBuffer(Mutex::new(p)))),
+        Err(_) => std::ptr::null_mut(),
+    }
+}
+
+#[no_mangle]
+pub extern "C" fn lk_playout_destroy(buffer: *mut LkPlayoutBuffer) {
+    if !buffer.is_null() {
+        drop(unsafe { Box::from_raw(buffer) });
+    }
+}
+
+/// Add a frame of `bone_count` transforms. `sample_time_us` is the sender's capture time on
+/// any clock that is consistent per sender; `arrival_us` is the local receive time, on the
+/// clock later passed to `lk_playout_sample`.
+#[no_mangle]
+pub extern "C" fn lk_playout_push(
+    buffer: *mut LkPlayoutBuffer,
+    sample_time_us: i64,
+    arrival_us: i64,
+    bones: *const LkBoneTransform,
+    count: usize,
+) -> LkResult {
+    if buffer.is_null() || bones.is_null() {
+        return err(4, "null pointer");
+    }
+    let mut p = unsafe { &*buffer }.0.lock().unwrap();
+    if count != p.bones {
+        return err(5, "bone count does not match the buffer");
+    }
+    let bones = unsafe { std::slice::from_raw_parts(bones, count) };
+    p.push(sample_time_us, arrival_us, bones);
+    ok()
+}
+
+/// Write the pose for local time `render_time_us` to `out_bones` and how it was produced to
+/// `out_mode` (optional). With `LkPlayoutEmpty` the output is left untouched.
+#[no_mangle]
+pub extern "C" fn lk_playout_sample(
+    buffer: *mut LkPlayoutBuffer,
+    render_time_us: i64,
+    out_bones: *mut LkBoneTransform,
+    capacity: usize,
+    out_mode: *mut LkPlayoutMode,
+) -> LkResult {
+    if buffer.is_null() || out_bones.is_null() {
+        return err(4, "null pointer");
+    }
+    let mut p = unsafe { &*buffer }.0.lock().unwrap();
+    if capacity < p.bones {
+        return err(601, "output buffer too small");
+    }
+    let out = unsafe { std::slice::from_raw_parts_mut(out_bones, p.bones) };
+    let mode = p.sample(render_time_us, out);
+    if !out_mode.is_null() {
+        unsafe { *out_mode = mode; }
+    }
+    ok()
+}
+
+#[no_mangle]
+pub extern "C" fn lk_playout_get_stats(buffer: *mut LkPlayoutBuffer, out_stats: *mut LkPlayoutStats) -> LkResult {
+    if buffer.is_null() || out_stats.is_null() {
+        return err(4, "null pointer");
+    }
+    let p = unsafe { &*buffer }.0.lock().unwrap();
+    unsafe { *out_stats = p.stats; }
+    ok()
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    const FRAME_US: i64 = 10_000;
+
+    fn playout(capacity: c_int) -> Playout {
+        Playout::new(&LkPlayoutConfig { bone_count: 1, min_delay_ms: 20, max_delay_ms: 100, max_extrapolate_ms: 30, capacity }).unwrap()
+    }
+
+    fn pose(x: f32) -> [LkBoneTransform; 1] {
+        [LkBoneTransform { rotation: [0.0, 0.0, 0.0, 1.0], position: [x, 0.0, 0.0], scale: [1.0; 3] }]
+    }
+
+    /// Push frame `n` (position x = n) sent at n * FRAME_US and arriving `transit` later.
+    fn push(p: &mut Playout, n: i64, transit: i64) {
+        p.push(n * FRAME_US, n * FRAME_US + transit, &pose(n as f32));
+    }
+
+    fn sample(p: &mut Playout, render: i64) -> (LkPlayoutMode, f32) {
+        let mut out = pose(-1.0);
+        let mode = p.sample(render, &mut out);
+        (mode, out[0].position[0])
+    }
+
+    #[test]
+    fn steady_stream_interpolates_behind_the_target_delay() {
+        let mut p = playout(0);
+        assert_eq!(sample(&mut p, 0).0, LkPlayoutMode::Empty);
+        for n in 0..20 {
+            push(&mut p, n, 5_000);
+        }
+        assert_eq!(p.stats.target_delay_us, 20_000, "min delay with no jitter");
+        // Render time 155 ms plays sender time 155 - 5 (transit) - 20 (target) = 130 ms
+        let (mode, x) = sample(&mut p, 155_000);
+        assert_eq!(mode, LkPlayoutMode::Interpolated);
+        assert!((x - 13.0).abs() < 1e-4, "x = {}", x);
+        let (mode, x) = sample(&mut p, 160_000);
+        assert_eq!(mode, LkPlayoutMode::Interpolated);
+        assert!((x - 13.5).abs() < 1e-4, "x = {}", x);
+    }
+
+    #[test]
+    fn extrapolates_briefly_then_holds() {
+        let mut p = playout(0);
+        for n in 0..5 {
+            push(&mut p, n, 0);
+        }
+        // Newest frame is 40 ms; 20 ms past it is within the 30 ms extrapolation limit
+        let (mode, x) = sample(&mut p, 80_000);
+        assert_eq!(mode, LkPlayoutMode::Extrapolated);
+        assert!((x - 6.0).abs() < 1e-4, "x = {}", x);
+        let (mode, x) = sample(&mut p, 200_000);
+        assert_eq!(mode, LkPlayoutMode::Held);
+        assert_eq!(x, 4.0);
+    }
+
+    #[test]
+    fn late_and_duplicate_frames_are_dropped() {
+        let mut p = playout(0);
+        for n in 0..10 {
+            push(&mut p, n, 1_000);
+        }
+        push(&mut p, 9, 1_000);
+        assert_eq!(p.stats.duplicates_dropped, 1);
+
+        sample(&mut p, 81_000); // plays sender time 60 ms
+        push(&mut p, 5, 30_000);
+        push(&mut p, 6, 30_000);
+        assert_eq!(p.stats.late_dropped, 2);
+        // Out of order but not yet played: kept in order
+        p.push(75_000, 80_000, &pose(7.5));
+        let render = 75_000 + p.base + p.target;
+        let (_, x) = sample(&mut p, render);
+        assert!((x - 7.5).abs() < 1e-4, "x = {}", x);
+        assert_eq!(p.stats.frames_pushed, 14);
+    }
+
+    #[test]
+    fn overflow_drops_the_oldest_frame() {
+        let mut p = playout(4);
+        for n in 0..6 {
+            push(&mut p, n, 0);
+        }
+        assert_eq!(p.stats.overflow_dropped, 2);
+        assert_eq!(p.frames.len(), 4);
+        assert_eq!(p.frames.front().unwrap().time, 2 * FRAME_US);
+        // A full buffer refuses a frame older than all it holds
+        p.push(FRAME_US + 5_000, FRAME_US + 5_000, &pose(1.5));
+        assert_eq!(p.stats.overflow_dropped, 3);
+        assert_eq!(p.frames.front().unwrap().time, 2 * FRAME_US);
+    }
+
+    #[test]
+    fn jitter_raises_the_target_up_to_max_delay() {
+        let mut p = playout(0);
+        for n in 0..50 {
+            push(&mut p, n, if n % 4 == 0 { 60_000 } else { 0 });
+        }
+        assert_eq!(p.stats.jitter_us, 60_000);
+        assert_eq!(p.stats.target_delay_us, 70_000, "jitter plus one frame interval");
+        for n in 50..100 {
+            push(&mut p, n, if n % 4 == 0 { 500_000 } else { 0 });
+        }
+        assert_eq!(p.stats.target_delay_us, 100_000, "capped at max_delay");
+    }
+
+    #[test]
+    fn restarted_sender_starts_over() {
+        let mut p = playout(0);
+        let epoch = 1_000_000_000;
+        for n in 0..20 {
+            p.push(epoch + n * FRAME_US, n * FRAME_US, &pose(n as f32));
+        }
+        sample(&mut p, 180_000);
+        // The sender restarts with its clock at zero; frames keep arriving on the local clock
+        for n in 0..5 {
+            p.push(n * FRAME_US, 200_000 + n * FRAME_US, &pose(100.0 + n as f32));
+        }
+        assert_eq!(p.stats.late_dropped, 0);
+        // Transit is now 200 ms: render time 240 ms plays the new sender time 20 ms
+        let (mode, x) = sample(&mut p, 240_000);
+        assert_eq!(mode, LkPlayoutMode::Interpolated);
+        assert!((x - 102.0).abs() < 1e-3, "x = {}", x);
+    }
+}
@@ -0,0 +1,653 @@
+//! Quantized skeletal pose codec exposed through the C ABI (`lk_pose_*`).
+//!
+//! A packet is a small self-describing header followed by a bit-packed body:
+//!
+//! `[version u8][flags u8][rotation_bits u8][position_bits u8][scale_bits u8][bone_count u16]`
+//! then `[position_range f32]` if positions are encoded and `[scale_min f32][scale_max f32]`
+//! if scales are, all little-endian. The body holds every bone's rotation, then every bone's
+//! position, then every bone's scale, so decode can dequantize each section in one flat loop.
+//!
+//! - Rotations use smallest-three: the index of the largest component (2 bits) and the
+//!   other three, each in [-1/sqrt(2), 1/sqrt(2)], at `rotation_bits`.
+//! - Bone 0 is the root: its position is sent as three raw f32. Other positions are
+//!   fixed-point offsets from the root within +/- `position_range` at `position_bits`.
+//! - Scales are fixed-point within [scale_min, scale_max] at `scale_bits`; without them,
+//!   decoded scales are 1.
+//!
+//! Pure functions over caller buffers; works with either backend.
+
+use crate::backend::LkResult;
+use std::ffi::CString;
+use std::f32::consts::FRAC_1_SQRT_2;
+use std::os::raw::c_int;
+
+const POSE_VERSION: u8 = 1;
+const FLAG_POSITIONS: u8 = 0x01;
+const FLAG_SCALES: u8 = 0x02;
+const HEADER_LEN: usize = 7;
+const MAX_BONES: u32 = u16::MAX as u32;
+
+const DEFAULT_ROTATION_BITS: c_int = 11;
+const DEFAULT_POSITION_BITS: c_int = 16;
+
+#[repr(C)]
+#[derive(Copy, Clone, Debug, Default, PartialEq)]
+pub struct LkBoneTransform {
+    /// x, y, z, w; need not be normalized.
+    pub rotation: [f32; 4],
+    pub position: [f32; 3],
+    pub scale: [f32; 3],
+}
+
+#[repr(C)]
+#[derive(Copy, Clone, Debug)]
+pub struct LkPoseCodecConfig {
+    pub bone_count: u32,
+    pub rotation_bits: c_int,
+    pub encode_positions: c_int,
+    pub position_bits: c_int,
+    pub position_range: f32,
+    pub scale_bits: c_int,
+    pub scale_min: f32,
+    pub scale_max: f32,
+}
+
+/// A validated config with defaults applied; also what a decoded header describes.
+#[derive(Copy, Clone, Debug, PartialEq)]
+struct Layout {
+    bones: usize,
+    rotation_bits: u32,
+    position_bits: u32,
+    position_range: f32,
+    scale_bits: u32,
+    scale_min: f32,
+    scale_max: f32,
+}
+
+impl Layout {
+    fn from_config(cfg: &LkPoseCodecConfig) -> Result<Self, &'static str> {
+        if cfg.bone_count == 0 || cfg.bone_count > MAX_BONES {
+            return Err("bone_count must be 1..65535");
+        }
+        let rotation_bits = if cfg.rotation_bits == 0 { DEFAULT_ROTATION_BITS } else { cfg.rotation_bits };
+        if !(4..=16).contains(&rotation_bits) {
+            return Err("rotation_bits must be 4..16");
+        }
+        let mut layout = Layout {
+            bones: cfg.bone_count as usize,
+            rotation_bits: rotation_bits as u32,
+            position_bits: 0,
+            position_range: 0.0,
+            scale_bits: 0,
+            scale_min: 0.0,
+            scale_max: 0.0,
+        };
+        if cfg.encode_positions != 0 {
+            let bits = if cfg.position_bits == 0 { DEFAULT_POSITION_BITS } else { cfg.position_bits };
+            if !(4..=24).contains(&bits) {
+                return Err("position_bits must be 4..24");
+            }
+            if !(cfg.position_range > 0.0 && cfg.position_range.is_finite()) {
+                return Err("position_range must be positive");
+            }
+            layout.position_bits = bits as u32;
+            layout.position_range = cfg.position_range;
+        }
+        if cfg.scale_bits != 0 {
+            if !(4..=16).contains(&cfg.scale_bits) {
+                return Err("scale_bits must be 0 or 4..16");
+            }
+            if !(cfg.scale_min < cfg.scale_max && cfg.scale_min.is_finite() && cfg.scale_max.is_finite()) {
+                return Err("scale_min must be below scale_max");
+            }
+            layout.scale_bits = cfg.scale_bits as u32;
+            layout.scale_min = cfg.scale_min;
+            layout.scale_max = cfg.scale_max;
+        }
+        Ok(layout)
+    }
+
+    fn header_len(&self) -> usize {
+        HEADER_LEN + if self.position_bits > 0 { 4 } else { 0 } + if self.scale_bits > 0 { 8 } else { 0 }
+    }
+
+    fn body_bits(&self) -> usize {
+        let n = self.bones;
+        let mut bits = n * (2 + 3 * self.rotation_bits as usize);
+        if self.position_bits > 0 {
+            bits += 3 * 32 + (n - 1) * 3 * self.position_bits as usize;
+        }
+        bits + n * 3 * self.scale_bits as usize
+    }
+
+    fn encoded_len(&self) -> usize {
+        self.header_len() + self.body_bits().div_ceil(8)
+    }
+
+    fn write_header(&self, out: &mut [u8]) -> usize {
+        let mut flags = 0;
+        if self.position_bits > 0 {
+            flags |= FLAG_POSITIONS;
+        }
+        if self.scale_bits > 0 {
+            flags |= FLAG_SCALES;
+        }
+        out[..HEADER_LEN].copy_from_slice(&[
+            POSE_VERSION,
+            flags,
+            self.rotation_bits as u8,
+            self.position_bits as u8,
+            self.scale_bits as u8,
+            self.bones as u8,
+            (self.bones >> 8) as u8,
+        ]);
+        let mut at = HEADER_LEN;
+        let mut put = |v: f32| {
+            out[at..at + 4].copy_from_slice(&v.to_le_bytes());
+            at += 4;
+        };
+        if self.position_bits > 0 {
+            put(self.position_range);
+        }
+        if self.scale_bits > 0 {
+            put(self.scale_min);
+            put(self.scale_max);
+        }
+        at
+    }
+
+    fn read_header(bytes: &[u8]) -> Option<Self> {
+        let h = bytes.get(..HEADER_LEN)?;
+        if h[0] != POSE_VERSION {
+            return None;
+        }
+        let flags = h[1];
+        let f32_at = |at: usize| bytes.get(at..at + 4).map(|b| f32::from_le_bytes([b[0], b[1], b[2], b[3]]));
+        let mut layout = Layout {
+            bones: u16::from_le_bytes([h[5], h[6]]) as usize,
+            rotation_bits: h[2] as u32,
+            position_bits: 0,
+            position_range: 0.0,
+            scale_bits: 0,
+            scale_min: 0.0,
+            scale_max: 0.0,
+        };
+        let mut at = HEADER_LEN;
+        // A section flag with zero bits would shift the body; reject it
+        if (flags & FLAG_POSITIONS != 0 && h[3] == 0) || (flags & FLAG_SCALES != 0 && h[4] == 0) {
+            return None;
+        }
+        if flags & FLAG_POSITIONS != 0 {
+            layout.position_bits = h[3] as u32;
+            layout.position_range = f32_at(at)?;
+            at += 4;
+        }
+        if flags & FLAG_SCALES != 0 {
+            layout.scale_bits = h[4] as u32;
+            layout.scale_min = f32_at(at)?;
+            layout.scale_max = f32_at(at + 4)?;
+        }
+        // Same limits the encoder enforces
+        let valid = layout.bones > 0
+            && (4..=16).contains(&layout.rotation_bits)
+            && (layout.position_bits == 0 || ((4..=24).contains(&layout.position_bits) && layout.position_range > 0.0))
+            && (layout.scale_bits == 0 || ((4..=16).contains(&layout.scale_bits) && layout.scale_min < layout.scale_max));
+        valid.then_some(layout)
+    }
+}
+
+/// LSB-first bit packer.
+struct BitWriter<'a> {
+    out: &'a mut [u8],
+    at: usize,
+    acc: u64,
+    filled: u32,
+}
+
+impl<'a> BitWriter<'a> {
+    fn new(out: &'a mut [u8]) -> Self {
+        Self { out, at: 0, acc: 0, filled: 0 }
+    }
+
+    fn put(&mut self, value: u32, bits: u32) {
+        self.acc |= ((value as u64) & ((1u64 << bits) - 1)) << self.filled;
+        self.filled += bits;
+        while self.filled >= 8 {
+            self.out[self.at] = self.acc as u8;
+            self.at += 1;
+            self.acc >>= 8;
+            self.filled -= 8;
+        }
+    }
+
+    fn finish(self) {
+        if self.filled > 0 {
+            self.out[self.at] = self.acc as u8;
+        }
+    }
+}
+
+struct BitReader<'a> {
+    bytes: &'a [u8],
+    at: usize,
+    acc: u64,
+    filled: u32,
+}
+
+impl<'a> BitReader<'a> {
+    fn new(bytes: &'a [u8]) -> Self {
+        Self { bytes, at: 0, acc: 0, filled: 0 }
+    }
+
+    /// Callers check the body length up front, so reads never run past the end.
+    fn get(&mut self, bits: u32) -> u32 {
+        while self.filled < bits {
+            self.acc |= (self.bytes[self.at] as u64) << self.filled;
+            self.at += 1;
+            self.filled += 8;
+        }
+        let v = (self.acc & ((1u64 << bits) - 1)) as u32;
+        self.acc >>= bits;
+        self.filled -= bits;
+        v
+    }
+}
+
+fn quantize(v: f32, min: f32, max: f32, bits: u32) -> u32 {
+    let steps = ((1u32 << bits) - 1) as f32;
+    let t = ((v - min) / (max - min)).clamp(0.0, 1.0);
+    (t * steps).round() as u32
+}
+
+/// Dequantize a whole section in one pass; a flat loop the compiler vectorizes.
+fn dequantize(q: &[u32], min: f32, max: f32, bits: u32, out: &mut Vec<f32>) {
+    let step = (max - min) / ((1u32 << bits) - 1) as f32;
+    out.clear();
+    out.extend(q.iter().map(|&v| v as f32 * step + min));
+}
+
+fn normalized(q: [f32; 4]) -> [f32; 4] {
+    let len = (q[0] * q[0] + q[1] * q[1] + q[2] * q[2] + q[3] * q[3]).sqrt();
+    if !(len > 1e-6 && len.is_finite()) {
+        return [0.0, 0.0, 0.0, 1.0];
+    }
+    [q[0] / len, q[1] / len, q[2] / len, q[3] / len]
+}
+
+fn encode(layout: &Layout, bones: &[LkBoneTransform], out: &mut [u8]) -> usize {
+    let header = layout.write_header(out);
+    let body_len = layout.body_bits().div_ceil(8);
+    let mut w = BitWriter::new(&mut out[header..header + body_len]);
+
+    let rb = layout.rotation_bits;
+    for bone in bones {
+        let q = normalized(bone.rotation);
+        let mut largest = 0;
+        for i in 1..4 {
+            if q[i].abs() > q[largest].abs() {
+                largest = i;
+            }
+        }
+        // q and -q are the same rotation: make the dropped component positive
+        let sign = if q[largest] < 0.0 { -1.0 } else { 1.0 };
+        w.put(largest as u32, 2);
+        for (i, c) in q.iter().enumerate() {
+            if i != largest {
+                w.put(quantize(c * sign, -FRAC_1_SQRT_2, FRAC_1_SQRT_2, rb), rb);
+            }
+        }
+    }
+
+    if layout.position_bits > 0 {
+        let root = bones[0].position;
+        for c in root {
+            w.put(c.to_bits(), 32);
+        }
+        let (pb, range) = (layout.position_bits, layout.position_range);
+        for bone in &bones[1..] {
+            for axis in 0..3 {
+                w.put(quantize(bone.position[axis] - root[axis], -range, range, pb), pb);
+            }
+        }
+    }
+
+    if layout.scale_bits > 0 {
+        let sb = layout.scale_bits;
+        for bone in bones {
+            for c in bone.scale {
+                w.put(quantize(c, layout.scale_min, layout.scale_max, sb), sb);
+            }
+        }
+    }
+    w.finish();
+    header + body_len
+}
+
+/// Bit unpacking is sequential; everything after it works on flat arrays per section.
+fn decode(layout: &Layout, body: &[u8], out: &mut [LkBoneTransform]) {
+    let n = layout.bones;
+    let mut r = BitReader::new(body);
+    let mut q = Vec::with_capacity(n * 3);
+    let mut values = Vec::with_capacity(n * 3);
+
+    let rb = layout.rotation_bits;
+    let mut largest = Vec::with_capacity(n);
+    for _ in 0..n {
+        largest.push(r.get(2) as usize);
+        for _ in 0..3 {
+            q.push(r.get(rb));
+        }
+    }
+    dequantize(&q, -FRAC_1_SQRT_2, FRAC_1_SQRT_2, rb, &mut values);
+    for (i, bone) in out.iter_mut().enumerate() {
+        let (a, b, c) = (values[i * 3], values[i * 3 + 1], values[i * 3 + 2]);
+        let d = (1.0 - a * a - b * b - c * c).max(0.0).sqrt();
+        bone.rotation = match largest[i] {
+            0 => [d, a, b, c],
+            1 => [a, d, b, c],
+            2 => [a, b, d, c],
+            _ => [a, b, c, d],
+        };
+    }
+
+    if layout.position_bits > 0 {
+        let root = [f32::from_bits(r.get(32)), f32::from_bits(r.get(32)), f32::from_bits(r.get(32))];
+        let (pb, range) = (layout.position_bits, layout.position_range);
+        q.clear();
+        for _ in 0..(n - 1) * 3 {
+            q.push(r.get(pb));
+        }
+        dequantize(&q, -range, range, pb, &mut values);
+        out[0].position = root;
+        for (i, bone) in out[1..].iter_mut().enumerate() {
+            for axis in 0..3 {
+                bone.position[axis] = root[axis] + values[i * 3 + axis];
+            }
+        }
+    } else {
+        for bone in out.iter_mut() {
+            bone.position = [0.0; 3];
+        }
+    }
+
+    if layout.scale_bits > 0 {
+        let sb = layout.scale_bits;
+        q.clear();
+        for _ in 0..n * 3 {
+            q.push(r.get(sb));
+        }
+        dequantize(&q, layout.scale_min, layout.scale_max, sb, &mut values);
+        for (i, bone) in out.iter_mut().enumerate() {
+            bone.scale.copy_from_slice(&values[i * 3..i * 3 + 3]);
+        }
+    } else {
+        for bone in out.iter_mut() {
+            bone.scale = [1.0; 3];
+        }
+    }
+}
+
+fn ok() -> LkResult {
+    LkResult { code: 0, message: std::ptr::null() }
+}
+
+fn err(code: c_int, msg: &str) -> LkResult {
+    let c = CString::new(msg).unwrap_or_else(|_| CString::new("ffi error").unwrap());
+    LkResult { code, message: c.into_raw() }
+}
+
+/// Encoded size of one pose under `config`; 0 if the config is invalid.
+#[no_mangle]
+pub extern "C" fn lk_pose_encoded_size(config: *const LkPoseCodecConfig) -> usize {
+    if config.is_null() { return 0; }
+    Layout::from_config(unsafe { &*config }).map_or(0, |l| l.encoded_len())
+}
+
+/// Encode `config.bone_count` transforms into `out`.
+#[no_mangle]
+pub extern "C" fn lk_pose_encode(
+    config: *const LkPoseCodecConfig,
+    bones: *const LkBoneTransform,
+    out: *mut u8,
+    out_capacity: usize,
+    out_len: *mut usize,
+) -> LkResult {
+    if config.is_null() || bones.is_null() || out.is_null() || out_len.is_null() {
+        return err(4, "null pointer");
+    }
+    let layout = match Layout::from_config(unsafe { &*config }) {
+        Ok(l) => l,
+        Err(msg) => return err(5, msg),
+    };
+    let len = layout.encoded_len();
+    if out_capacity < len {
+        return err(601, "output buffer too small");
+    }
+    let bones = unsafe { std::slice::from_raw_parts(bones, layout.bones) };
+    let out = unsafe { std::slice::from_raw_parts_mut(out, len) };
+    unsafe { *out_len = encode(&layout, bones, out); }
+    ok()
+}
+
+/// Decode a pose packet into `out_bones`. The packet describes its own layout; `out_count`
+/// receives the bone count (also on error 601, so the caller can size its buffer).
+#[no_mangle]
+pub extern "C" fn lk_pose_decode(
+    bytes: *const u8,
+    len: usize,
+    out_bones: *mut LkBoneTransform,
+    capacity: usize,
+    out_count: *mut usize,
+) -> LkResult {
+    if bytes.is_null() || out_count.is_null() {
+        return err(4, "null pointer");
+    }
+    let bytes = unsafe { std::slice::from_raw_parts(bytes, len) };
+    let Some(layout) = Layout::read_header(bytes) else {
+        return err(602, "malformed pose packet");
+    };
+    if bytes.len() < layout.encoded_len() {
+        return err(602, "truncated pose packet");
+    }
+    unsafe { *out_count = layout.bones; }
+    if out_bones.is_null() || capacity < layout.bones {
+        return err(601, "output buffer too small");
+    }
+    let out = unsafe { std::slice::from_raw_parts_mut(out_bones, layout.bones) };
+    decode(&layout, &bytes[layout.header_len()..layout.encoded_len()], out);
+    ok()
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use std::f32::consts::SQRT_2;
+    use std::time::Instant;
+
+    /// Deterministic xorshift so failures reproduce.
+    struct Rng(u32);
+
+    impl Rng {
+        fn unit(&mut self) -> f32 {
+            self.0 ^= self.0 << 13;
+            self.0 ^= self.0 >> 17;
+            self.0 ^= self.0 << 5;
+            (self.0 >> 8) as f32 / (1u32 << 24) as f32
+        }
+
+        fn range(&mut self, min: f32, max: f32) -> f32 {
+            min + (max - min) * self.unit()
+        }
+    }
+
+    fn config(bones: u32) -> LkPoseCodecConfig {
+        LkPoseCodecConfig {
+            bone_count: bones,
+            rotation_bits: 0,
+            encode_positions: 1,
+            position_bits: 0,
+            position_range: 2.0,
+            scale_bits: 8,
+            scale_min: 0.5,
+            scale_max: 2.0,
+        }
+    }
+
+    fn skeleton(rng: &mut Rng, bones: usize) -> Vec<LkBoneTransform> {
+        let root = [rng.range(-500.0, 500.0), rng.range(-500.0, 500.0), rng.range(0.0, 200.0)];
+        (0..bones)
+            .map(|i| LkBoneTransform {
+                rotation: [rng.range(-1.0, 1.0), rng.range(-1.0, 1.0), rng.range(-1.0, 1.0), rng.range(-1.0, 1.0)],
+                position: if i == 0 {
+                    root
+                } else {
+                    [root[0] + rng.range(-2.0, 2.0), root[1] + rng.range(-2.0, 2.0), root[2] + rng.range(-2.0, 2.0)]
+                },
+                scale: [rng.range(0.5, 2.0), rng.range(0.5, 2.0), rng.range(0.5, 2.0)],
+            })
+            .collect()
+    }
+
+    fn round_trip(cfg: &LkPoseCodecConfig, bones: &[LkBoneTransform]) -> Vec<LkBoneTransform> {
+        let layout = Layout::from_config(cfg).unwrap();
+        let mut packet = vec![0u8; layout.encoded_len()];
+        assert_eq!(encode(&layout, bones, &mut packet), packet.len());
+        let read = Layout::read_header(&packet).unwrap();
+        assert_eq!(read, layout);
+        let mut out = vec![LkBoneTransform::default(); layout.bones];
+        decode(&read, &packet[read.header_len()..], &mut out);
+        out
+    }
+
+    /// Largest component error between two rotations, ignoring the q/-q ambiguity.
+    fn rotation_error(a: [f32; 4], b: [f32; 4]) -> f32 {
+        let a = normalized(a);
+        let dot: f32 = (0..4).map(|i| a[i] * b[i]).sum();
+        let sign = if dot < 0.0 { -1.0 } else { 1.0 };
+        (0..4).map(|i| (a[i] - sign * b[i]).abs()).fold(0.0, f32::max)
+    }
+
+    #[test]
+    fn round_trip_stays_within_quantization_error() {
+        let mut rng = Rng(0x1234_5678);
+        let cfg = config(64);
+        let bones = skeleton(&mut rng, 64);
+        let out = round_trip(&cfg, &bones);
+
+        assert_eq!(out[0].position, bones[0].position, "root position is sent raw");
+        let position_step = 2.0 * cfg.position_range / ((1u32 << DEFAULT_POSITION_BITS) - 1) as f32;
+        let scale_step = (cfg.scale_max - cfg.scale_min) / ((1u32 << cfg.scale_bits) - 1) as f32;
+        for (sent, got) in bones.iter().zip(&out) {
+            for axis in 0..3 {
+                // Half a step, plus f32 slack around the large root offset
+                assert!((sent.position[axis] - got.position[axis]).abs() <= position_step * 0.5 + 1e-4);
+                assert!((sent.scale[axis] - got.scale[axis]).abs() <= scale_step * 0.5 + 1e-6);
+            }
+        }
+    }
+
+    #[test]
+    fn rotation_error_is_bounded_by_bit_depth() {
+        let mut rng = Rng(0x9e37_79b9);
+        for bits in [4, 8, 11, 16] {
+            let mut cfg = config(256);
+            cfg.rotation_bits = bits;
+            let bones = skeleton(&mut rng, 256);
+            let out = round_trip(&cfg, &bones);
+            // The three sent components are off by at most half a step; the rebuilt largest one
+            // (>= 1/2) amplifies their error by at most 3 * (1/sqrt(2)) / (1/2).
+            let half_step = 0.5 * SQRT_2 / ((1u32 << bits) - 1) as f32;
+            let bound = half_step * (1.0 + 3.0 * SQRT_2) + 1e-5;
+            for (sent, got) in bones.iter().zip(&out) {
+                let e = rotation_error(sent.rotation, got.rotation);
+                assert!(e <= bound, "{} bits: error {} over bound {}", bits, e, bound);
+                let len: f32 = got.rotation.iter().map(|c| c * c).sum();
+                assert!((len - 1.0).abs() < 4.0 * half_step + 1e-5, "{} bits: decoded length {}", bits, len);
+            }
+        }
+    }
+
+    #[test]
+    fn degenerate_rotations_decode_as_identity() {
+        let mut bones = skeleton(&mut Rng(7), 3);
+        bones[0].rotation = [0.0; 4];
+        bones[1].rotation = [f32::NAN, 0.0, 0.0, 1.0];
+        bones[2].rotation = [0.0, 0.0, 0.0, -3.0];
+        for got in round_trip(&config(3), &bones) {
+            assert!(rotation_error([0.0, 0.0, 0.0, 1.0], got.rotation) < 1e-3);
+        }
+    }
+
+    #[test]
+    fn sections_can_be_omitted() {
+        let mut cfg = config(4);
+        cfg.encode_positions = 0;
+        cfg.scale_bits = 0;
+        let out = round_trip(&cfg, &skeleton(&mut Rng(11), 4));
+        for bone in out {
+            assert_eq!(bone.position, [0.0; 3]);
+            assert_eq!(bone.scale, [1.0; 3]);
+        }
+    }
+
+    #[test]
+    fn abi_rejects_small_buffers_and_bad_packets() {
+        let cfg = config(16);
+        let bones = skeleton(&mut Rng(3), 16);
+        let size = lk_pose_encoded_size(&cfg);
+        let mut packet = vec![0u8; size];
+        let mut len = 0usize;
+        assert_eq!(lk_pose_encode(&cfg, bones.as_ptr(), packet.as_mut_ptr(), size - 1, &mut len).code, 601);
+        assert_eq!(lk_pose_encode(&cfg, bones.as_ptr(), packet.as_mut_ptr(), size, &mut len).code, 0);
+        assert_eq!(len, size);
+
+        let mut out = vec![LkBoneTransform::default(); 16];
+        let mut count = 0usize;
+        assert_eq!(lk_pose_decode(packet.as_ptr(), len, out.as_mut_ptr(), 8, &mut count).code, 601);
+        assert_eq!(count, 16, "bone count is reported so the caller can size its buffer");
+        assert_eq!(lk_pose_decode(packet.as_ptr(), len - 1, out.as_mut_ptr(), 16, &mut count).code, 602);
+        packet[0] = POSE_VERSION + 1;
+        assert_eq!(lk_pose_decode(packet.as_ptr(), len, out.as_mut_ptr(), 16, &mut count).code, 602);
+
+        let mut bad = cfg;
+        bad.rotation_bits = 17;
+        assert_eq!(lk_pose_encoded_size(&bad), 0);
+    }
+
+    /// `cargo test --release -- --ignored --nocapture pose_codec_throughput`
+    #[test]
+    #[ignore]
+    fn pose_codec_throughput() {
+        const BONES: u32 = 160;
+        const ITERATIONS: u32 = 20_000;
+        let cfg = config(BONES);
+        let layout = Layout::from_config(&cfg).unwrap();
+        let bones = skeleton(&mut Rng(42), BONES as usize);
+        let mut packet = vec![0u8; layout.encoded_len()];
+        let mut out = vec![LkBoneTransform::default(); BONES as usize];
+
+        let started = Instant::now();
+        for _ in 0..ITERATIONS {
+            std::hint::black_box(encode(&layout, std::hint::black_box(&bones), &mut packet));
+        }
+        let encode_time = started.elapsed();
+
+        let started = Instant::now();
+        for _ in 0..ITERATIONS {
+            decode(&layout, std::hint::black_box(&packet[layout.header_len()..]), &mut out);
+            std::hint::black_box(&out);
+        }
+        let decode_time = started.elapsed();
+
+        let per_second = |d: std::time::Duration| ITERATIONS as f64 / d.as_secs_f64();
+        println!(
+            "{} bones, {} bytes/pose: encode {:.0} poses/s ({:.2} us), decode {:.0} poses/s ({:.2} us)",
+            BONES,
+            packet.len(),
+            per_second(encode_time),
+            encode_time.as_secs_f64() * 1e6 / ITERATIONS as f64,
+            per_second(decode_time),
+            decode_time.as_secs_f64() * 1e6 / ITERATIONS as f64,
+        );
+    }
+}
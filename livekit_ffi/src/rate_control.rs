@@ -0,0 +1,196 @@
+//! Advisory per-label send rates from link estimates (`lk_set_rate_control`).
+//!
+//! Each link sample adjusts every controlled label AIMD-style: the rate halves when the link
+//! shows congestion (heavy loss, RTT well above its recent floor, a backed-up send queue or a
+//! poor connection-quality rating), holds while loss is elevated, and otherwise climbs by an
+//! eighth of the maximum. It is also capped so the label's share of the estimated available
+//! bandwidth covers its messages. Nothing is enforced: senders read the rate or get a
+//! callback when it moves.
+
+use std::collections::VecDeque;
+
+/// Loss above this halves the rate.
+const LOSS_CONGESTED: f64 = 0.10;
+/// Loss above this stops the rate from climbing.
+const LOSS_ELEVATED: f64 = 0.02;
+/// RTT this far above the recent floor (or the floor again, if larger) counts as queueing.
+const RTT_INFLATION_US: i64 = 50_000;
+/// Send queue wait (p95) that counts as congestion.
+const QUEUE_CONGESTED_US: i64 = 100_000;
+/// RTT samples the floor is taken over.
+const RTT_WINDOW: usize = 30;
+/// Samples to wait after a decrease before climbing again.
+const HOLD_SAMPLES: u32 = 2;
+/// Transport headers per message (SCTP, DTLS, UDP, IP), for the bandwidth cap.
+const MESSAGE_OVERHEAD: f64 = 48.0;
+/// A rate change is reported when it moves this fraction from the last reported rate.
+const REPORT_CHANGE: f64 = 0.1;
+
+/// Link condition from the latest stats poll; zero fields are unknown.
+#[derive(Copy, Clone, Debug, Default)]
+pub struct LinkEstimate {
+    pub rtt_us: i64,
+    /// Fraction of packets lost, 0..1.
+    pub loss: f64,
+    pub available_bps: f64,
+    /// The server rates the connection poor or lost.
+    pub poor: bool,
+}
+
+pub struct RateController {
+    min_hz: f64,
+    max_hz: f64,
+    share: f64,
+    rate_hz: f64,
+    reported_hz: f64,
+    /// Smoothed message size, 0 before the first send.
+    message_bytes: f64,
+    rtts: VecDeque<i64>,
+    hold: u32,
+}
+
+impl RateController {
+    /// Starts at `max_hz`. `share` is the fraction of the available bandwidth the label may use.
+    pub fn new(min_hz: f64, max_hz: f64, share: f64) -> Self {
+        Self {
+            min_hz,
+            max_hz,
+            share,
+            rate_hz: max_hz,
+            reported_hz: max_hz,
+            message_bytes: 0.0,
+            rtts: VecDeque::with_capacity(RTT_WINDOW),
+            hold: 0,
+        }
+    }
+
+    pub fn rate_hz(&self) -> f64 {
+        self.rate_hz
+    }
+
+    pub fn record_send(&mut self, bytes: usize) {
+        let bytes = bytes as f64;
+        self.message_bytes = if self.message_bytes == 0.0 { bytes } else { self.message_bytes + (bytes - self.message_bytes) / 16.0 };
+    }
+
+    fn congested(&mut self, link: &LinkEstimate, queue_wait_us: i64) -> bool {
+        let mut inflated = false;
+        if link.rtt_us > 0 {
+            if self.rtts.len() == RTT_WINDOW {
+                self.rtts.pop_front();
+            }
+            self.rtts.push_back(link.rtt_us);
+            let floor = self.rtts.iter().copied().min().unwrap_or(link.rtt_us);
+            inflated = link.rtt_us > floor + floor.max(RTT_INFLATION_US);
+        }
+        link.poor || link.loss > LOSS_CONGESTED || inflated || queue_wait_us > QUEUE_CONGESTED_US
+    }
+
+    /// Fold in one link sample. Returns the new rate when it moved enough to report.
+    pub fn update(&mut self, link: &LinkEstimate, queue_wait_us: i64) -> Option<f64> {
+        if self.congested(link, queue_wait_us) {
+            self.rate_hz *= 0.5;
+            self.hold = HOLD_SAMPLES;
+        } else if self.hold > 0 {
+            self.hold -= 1;
+        } else if link.loss <= LOSS_ELEVATED {
+            self.rate_hz += self.max_hz / 8.0;
+        }
+        if link.available_bps > 0.0 && self.message_bytes > 0.0 {
+            let cap = link.available_bps * self.share / 8.0 / (self.message_bytes + MESSAGE_OVERHEAD);
+            self.rate_hz = self.rate_hz.min(cap);
+        }
+        self.rate_hz = self.rate_hz.clamp(self.min_hz, self.max_hz);
+
+        let at_bound = self.rate_hz == self.min_hz || self.rate_hz == self.max_hz;
+        let moved = (self.rate_hz - self.reported_hz).abs() > self.reported_hz * REPORT_CHANGE;
+        if self.rate_hz != self.reported_hz && (moved || at_bound) {
+            self.reported_hz = self.rate_hz;
+            return Some(self.rate_hz);
+        }
+        None
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn link(rtt_us: i64, loss: f64) -> LinkEstimate {
+        LinkEstimate { rtt_us, loss, ..Default::default() }
+    }
+
+    fn good() -> LinkEstimate {
+        link(20_000, 0.0)
+    }
+
+    #[test]
+    fn congestion_halves_the_rate() {
+        let mut rc = RateController::new(1.0, 80.0, 1.0);
+        assert_eq!(rc.update(&link(20_000, 0.2), 0), Some(40.0), "heavy loss");
+        assert_eq!(rc.update(&good(), QUEUE_CONGESTED_US + 1), Some(20.0), "backed-up send queue");
+        assert_eq!(rc.update(&LinkEstimate { poor: true, ..good() }, 0), Some(10.0), "poor quality");
+        assert_eq!(rc.update(&link(20_000 + RTT_INFLATION_US + 1, 0.0), 0), Some(5.0), "inflated RTT");
+    }
+
+    #[test]
+    fn rtt_inflation_is_measured_from_the_recent_floor() {
+        let mut rc = RateController::new(1.0, 80.0, 1.0);
+        // Above the floor by less than RTT_INFLATION_US: not congestion
+        rc.update(&link(20_000, 0.0), 0);
+        assert_eq!(rc.update(&link(20_000 + RTT_INFLATION_US, 0.0), 0), None);
+        assert_eq!(rc.rate_hz(), 80.0);
+        // A high floor tolerates the floor again on top of it
+        let mut rc = RateController::new(1.0, 80.0, 1.0);
+        rc.update(&link(200_000, 0.0), 0);
+        assert_eq!(rc.update(&link(390_000, 0.0), 0), None);
+        assert_eq!(rc.update(&link(400_001, 0.0), 0), Some(40.0));
+    }
+
+    #[test]
+    fn holds_after_a_decrease_then_climbs_additively() {
+        let mut rc = RateController::new(1.0, 80.0, 1.0);
+        assert_eq!(rc.update(&link(20_000, 0.2), 0), Some(40.0));
+        for _ in 0..HOLD_SAMPLES {
+            assert_eq!(rc.update(&good(), 0), None);
+            assert_eq!(rc.rate_hz(), 40.0);
+        }
+        assert_eq!(rc.update(&good(), 0), Some(50.0), "climbs by max / 8");
+        // Elevated but not congested loss neither climbs nor halves
+        assert_eq!(rc.update(&link(20_000, 0.05), 0), None);
+        assert_eq!(rc.rate_hz(), 50.0);
+        assert_eq!(rc.update(&good(), 0), Some(60.0));
+        assert_eq!(rc.update(&good(), 0), Some(70.0));
+        assert_eq!(rc.update(&good(), 0), Some(80.0));
+        assert_eq!(rc.update(&good(), 0), None, "already at max");
+    }
+
+    #[test]
+    fn bandwidth_share_caps_the_rate() {
+        let mut rc = RateController::new(1.0, 80.0, 0.5);
+        // Without a known message size the estimate does not cap
+        assert_eq!(rc.update(&LinkEstimate { available_bps: 8_000.0, ..good() }, 0), None);
+        rc.record_send(1_000 - MESSAGE_OVERHEAD as usize);
+        // Half of 400 kbit/s is 25,000 bytes/s: 25 messages of 1000 bytes with overhead
+        let capped = LinkEstimate { available_bps: 400_000.0, ..good() };
+        assert_eq!(rc.update(&capped, 0), Some(25.0));
+        assert_eq!(rc.update(&capped, 0), None);
+        assert_eq!(rc.rate_hz(), 25.0);
+    }
+
+    #[test]
+    fn reports_large_moves_and_reaching_a_bound() {
+        let mut rc = RateController::new(10.0, 80.0, 1.0);
+        rc.record_send(1_000 - MESSAGE_OVERHEAD as usize);
+        let cap = |hz: f64| LinkEstimate { available_bps: hz * 8_000.0, ..good() };
+        assert_eq!(rc.update(&cap(40.0), 0), Some(40.0));
+        // Within REPORT_CHANGE of the last report: moved, but not reported
+        assert_eq!(rc.update(&cap(37.0), 0), None);
+        assert_eq!(rc.rate_hz(), 37.0);
+        assert_eq!(rc.update(&cap(35.0), 0), Some(35.0), "drifted past the threshold");
+        assert_eq!(rc.update(&cap(11.0), 0), Some(11.0));
+        // Halving clamps to min_hz; a small move onto the bound is still reported
+        assert_eq!(rc.update(&LinkEstimate { poor: true, ..cap(11.0) }, 0), Some(10.0));
+        assert_eq!(rc.update(&cap(1.0), 0), None, "clamped to min_hz and already reported");
+    }
+}
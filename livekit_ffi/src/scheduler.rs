@@ -0,0 +1,455 @@
+//! Send scheduling for queued data traffic: per-label classes with token-bucket rate limits,
+//! strict or weighted (deficit round robin) priority between classes, and message deadlines.
+//!
+//! Pure bookkeeping; the backend's send worker owns the transport and drives `next`.
+
+use std::collections::{HashMap, VecDeque};
+use std::time::{Duration, Instant};
+
+/// Message bytes: copied at send time, or a caller-owned buffer released when dropped.
+pub enum Payload {
+    Copied(Vec<u8>),
+    Owned(Box<dyn AsRef<[u8]> + Send>),
+}
+
+impl Payload {
+    pub fn as_slice(&self) -> &[u8] {
+        match self {
+            Payload::Copied(v) => v,
+            Payload::Owned(b) => (**b).as_ref(),
+        }
+    }
+
+    pub fn len(&self) -> usize {
+        self.as_slice().len()
+    }
+
+    /// Transports that need an owned `Vec` copy owned buffers here, releasing them.
+    pub fn into_vec(self) -> Vec<u8> {
+        match self {
+            Payload::Copied(v) => v,
+            Payload::Owned(b) => (*b).as_ref().to_vec(),
+        }
+    }
+}
+
+/// A message waiting to be sent.
+pub struct QueuedSend {
+    pub topic: String,
+    pub payload: Payload,
+    pub reliable: bool,
+    /// Participant identities to deliver to; empty = the whole room.
+    pub destinations: Vec<String>,
+    pub enqueued: Instant,
+    pub deadline: Option<Instant>,
+}
+
+#[derive(Copy, Clone, Debug, PartialEq, Eq)]
+pub enum Mode {
+    /// Always serve the lowest `priority` value that has a sendable message.
+    Strict,
+    /// Share bandwidth in proportion to `weight` (deficit round robin).
+    Weighted,
+}
+
+#[derive(Copy, Clone, Debug)]
+pub struct ClassConfig {
+    pub priority: i32,
+    pub weight: u32,
+    /// Bytes per second; 0 = unlimited.
+    pub rate: u32,
+    /// Bucket size in bytes; 0 = one second of `rate`.
+    pub burst: u32,
+}
+
+impl Default for ClassConfig {
+    fn default() -> Self {
+        Self { priority: 100, weight: 1, rate: 0, burst: 0 }
+    }
+}
+
+/// Bytes a class may send per round-robin visit, per unit of weight.
+const QUANTUM: i64 = crate::framing::LOSSY_MTU as i64;
+/// Wait-time samples kept per class for percentiles.
+const WAIT_SAMPLES: usize = 512;
+
+struct TokenBucket {
+    rate: f64,
+    burst: f64,
+    tokens: f64,
+    refilled: Instant,
+}
+
+impl TokenBucket {
+    fn new(cfg: &ClassConfig, now: Instant) -> Option<Self> {
+        if cfg.rate == 0 {
+            return None;
+        }
+        let burst = if cfg.burst == 0 { cfg.rate } else { cfg.burst } as f64;
+        Some(Self { rate: cfg.rate as f64, burst, tokens: burst, refilled: now })
+    }
+
+    fn refill(&mut self, now: Instant) {
+        let dt = now.saturating_duration_since(self.refilled).as_secs_f64();
+        self.tokens = (self.tokens + dt * self.rate).min(self.burst);
+        self.refilled = now;
+    }
+
+    /// Messages larger than the bucket go out once it is full, then leave it in debt.
+    fn need(&self, len: usize) -> f64 {
+        (len as f64).min(self.burst)
+    }
+
+    fn ready_at(&self, len: usize, now: Instant) -> Option<Instant> {
+        let missing = self.need(len) - self.tokens;
+        (missing > 0.0).then(|| now + Duration::from_secs_f64(missing / self.rate))
+    }
+}
+
+/// Ring of recent queue wait times in microseconds.
+struct WaitSamples {
+    samples: Vec<u32>,
+    next: usize,
+}
+
+impl WaitSamples {
+    fn record(&mut self, wait: Duration) {
+        let us = wait.as_micros().min(u32::MAX as u128) as u32;
+        if self.samples.len() < WAIT_SAMPLES {
+            self.samples.push(us);
+        } else {
+            self.samples[self.next] = us;
+        }
+        self.next = (self.next + 1) % WAIT_SAMPLES;
+    }
+
+    /// (p50, p95, p99) over the retained samples.
+    fn percentiles(&self) -> (u32, u32, u32) {
+        if self.samples.is_empty() {
+            return (0, 0, 0);
+        }
+        let mut sorted = self.samples.clone();
+        sorted.sort_unstable();
+        let at = |p: usize| sorted[(sorted.len() - 1) * p / 100];
+        (at(50), at(95), at(99))
+    }
+}
+
+pub struct Class {
+    config: ClassConfig,
+    queue: VecDeque<QueuedSend>,
+    queued_bytes: usize,
+    bucket: Option<TokenBucket>,
+    deficit: i64,
+    waits: WaitSamples,
+    pub sent_messages: i64,
+    pub sent_bytes: i64,
+    pub expired: i64,
+}
+
+impl Class {
+    fn new(config: ClassConfig, now: Instant) -> Self {
+        Self {
+            config,
+            queue: VecDeque::new(),
+            queued_bytes: 0,
+            bucket: TokenBucket::new(&config, now),
+            deficit: 0,
+            waits: WaitSamples { samples: Vec::new(), next: 0 },
+            sent_messages: 0,
+            sent_bytes: 0,
+            expired: 0,
+        }
+    }
+
+    /// Move expired messages at the head into `out`.
+    fn drop_expired(&mut self, now: Instant, out: &mut Vec<QueuedSend>) {
+        while self.queue.front().is_some_and(|m| m.deadline.is_some_and(|d| now > d)) {
+            if let Some(m) = self.queue.pop_front() {
+                self.queued_bytes -= m.payload.len();
+                self.expired += 1;
+                out.push(m);
+            }
+        }
+    }
+
+    /// When the head message may be sent: None = now (or the class is empty).
+    fn blocked_until(&self, now: Instant) -> Option<Instant> {
+        let head = self.queue.front()?;
+        self.bucket.as_ref()?.ready_at(head.payload.len(), now)
+    }
+
+    fn take(&mut self, now: Instant) -> Option<QueuedSend> {
+        let msg = self.queue.pop_front()?;
+        let len = msg.payload.len();
+        self.queued_bytes -= len;
+        if let Some(bucket) = self.bucket.as_mut() {
+            bucket.tokens -= len as f64;
+        }
+        self.waits.record(now.saturating_duration_since(msg.enqueued));
+        self.sent_messages += 1;
+        self.sent_bytes += len as i64;
+        Some(msg)
+    }
+
+    pub fn depth(&self) -> usize {
+        self.queue.len()
+    }
+
+    pub fn queued_bytes(&self) -> usize {
+        self.queued_bytes
+    }
+
+    pub fn wait_percentiles_us(&self) -> (u32, u32, u32) {
+        self.waits.percentiles()
+    }
+}
+
+pub enum Next {
+    Send(QueuedSend),
+    /// Messages are queued but rate limited until then.
+    WaitUntil(Instant),
+    Idle,
+}
+
+/// Classes keyed by label; labels without a class share the default class (label "").
+pub struct Scheduler {
+    mode: Mode,
+    classes: Vec<(String, Class)>,
+    cursor: usize,
+}
+
+impl Scheduler {
+    pub fn new(mode: Mode, configs: &HashMap<String, ClassConfig>) -> Self {
+        let now = Instant::now();
+        let mut s = Self { mode, classes: vec![(String::new(), Class::new(ClassConfig::default(), now))], cursor: 0 };
+        for (label, cfg) in configs {
+            s.configure(label, Some(*cfg));
+        }
+        s
+    }
+
+    pub fn set_mode(&mut self, mode: Mode) {
+        self.mode = mode;
+    }
+
+    fn index(&self, label: &str) -> Option<usize> {
+        self.classes.iter().position(|(l, _)| l == label)
+    }
+
+    /// Add, update or (with None) remove a label's class. Messages queued on a removed class
+    /// move to the default class.
+    pub fn configure(&mut self, label: &str, config: Option<ClassConfig>) {
+        let now = Instant::now();
+        match (self.index(label), config) {
+            (Some(i), Some(cfg)) => {
+                let class = &mut self.classes[i].1;
+                class.config = cfg;
+                class.bucket = TokenBucket::new(&cfg, now);
+            }
+            (None, Some(cfg)) => self.classes.push((label.to_string(), Class::new(cfg, now))),
+            (Some(i), None) if !label.is_empty() => {
+                let (_, removed) = self.classes.remove(i);
+                let Some(d) = self.index("") else { return; };
+                let default = &mut self.classes[d].1;
+                default.queued_bytes += removed.queued_bytes;
+                default.queue.extend(removed.queue);
+            }
+            _ => return,
+        }
+        // Strict mode scans in priority order
+        self.classes.sort_by_key(|(_, c)| c.config.priority);
+        self.cursor = 0;
+    }
+
+    pub fn push(&mut self, label: &str, msg: QueuedSend) {
+        let i = self.index(label).or_else(|| self.index("")).unwrap_or(0);
+        let class = &mut self.classes[i].1;
+        class.queued_bytes += msg.payload.len();
+        class.queue.push_back(msg);
+    }
+
+    pub fn class(&self, label: &str) -> Option<&Class> {
+        self.index(label).map(|i| &self.classes[i].1)
+    }
+
+    /// Pick the next message to send. Expired messages are taken out on the way and returned
+    /// alongside, so the caller can drop them (and release owned buffers) outside its lock.
+    pub fn next(&mut self, now: Instant) -> (Next, Vec<QueuedSend>) {
+        let mut expired = Vec::new();
+        let mut wake: Option<Instant> = None;
+        for (_, class) in self.classes.iter_mut() {
+            class.drop_expired(now, &mut expired);
+            if let Some(bucket) = class.bucket.as_mut() {
+                bucket.refill(now);
+            }
+        }
+        let next = match self.mode {
+            Mode::Strict => {
+                let mut chosen = None;
+                for (i, (_, class)) in self.classes.iter().enumerate() {
+                    if class.queue.is_empty() {
+                        continue;
+                    }
+                    match class.blocked_until(now) {
+                        None => {
+                            chosen = Some(i);
+                            break;
+                        }
+                        Some(t) => wake = Some(wake.map_or(t, |w| w.min(t))),
+                    }
+                }
+                chosen.and_then(|i| self.classes[i].1.take(now))
+            }
+            Mode::Weighted => self.next_weighted(now, &mut wake),
+        };
+        match (next, wake) {
+            (Some(msg), _) => (Next::Send(msg), expired),
+            (None, Some(t)) => (Next::WaitUntil(t), expired),
+            (None, None) => (Next::Idle, expired),
+        }
+    }
+
+    /// Deficit round robin: each visit credits `weight * QUANTUM` bytes; a class sends while
+    /// its credit covers the head message. Rate-limited classes are skipped, not credited.
+    fn next_weighted(&mut self, now: Instant, wake: &mut Option<Instant>) -> Option<QueuedSend> {
+        let n = self.classes.len();
+        // Enough visits for any class to accumulate credit for a maximum-size message
+        let max_visits = n * (crate::framing::RELIABLE_MAX / QUANTUM as usize + 2);
+        for _ in 0..max_visits {
+            let class = &mut self.classes[self.cursor].1;
+            let Some(head) = class.queue.front() else {
+                class.deficit = 0;
+                self.cursor = (self.cursor + 1) % n;
+                continue;
+            };
+            let len = head.payload.len() as i64;
+            if let Some(t) = class.blocked_until(now) {
+                *wake = Some(wake.map_or(t, |w| w.min(t)));
+                self.cursor = (self.cursor + 1) % n;
+                continue;
+            }
+            if class.deficit >= len {
+                class.deficit -= len;
+                return class.take(now);
+            }
+            class.deficit += QUANTUM * class.config.weight.max(1) as i64;
+            self.cursor = (self.cursor + 1) % n;
+        }
+        None
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn msg(topic: &str, len: usize, now: Instant, deadline: Option<Instant>) -> QueuedSend {
+        QueuedSend {
+            topic: topic.to_string(),
+            payload: Payload::Copied(vec![0; len]),
+            reliable: true,
+            destinations: Vec::new(),
+            enqueued: now,
+            deadline,
+        }
+    }
+
+    fn class(priority: i32, weight: u32, rate: u32, burst: u32) -> ClassConfig {
+        ClassConfig { priority, weight, rate, burst }
+    }
+
+    fn sent_topic(next: (Next, Vec<QueuedSend>)) -> String {
+        match next.0 {
+            Next::Send(m) => m.topic,
+            Next::WaitUntil(_) => "wait".to_string(),
+            Next::Idle => "idle".to_string(),
+        }
+    }
+
+    #[test]
+    fn strict_mode_serves_priority_then_fifo() {
+        let mut configs = HashMap::new();
+        configs.insert("pose".to_string(), class(0, 1, 0, 0));
+        configs.insert("scene".to_string(), class(10, 1, 0, 0));
+        let mut s = Scheduler::new(Mode::Strict, &configs);
+        let now = Instant::now();
+        s.push("scene", msg("scene1", 10, now, None));
+        s.push("other", msg("other1", 10, now, None));
+        s.push("pose", msg("pose1", 10, now, None));
+        s.push("scene", msg("scene2", 10, now, None));
+        s.push("pose", msg("pose2", 10, now, None));
+
+        let order: Vec<_> = (0..6).map(|_| sent_topic(s.next(now))).collect();
+        // Unclassed labels share the default class, priority 100
+        assert_eq!(order, ["pose1", "pose2", "scene1", "scene2", "other1", "idle"]);
+        assert_eq!(s.class("pose").unwrap().sent_messages, 2);
+    }
+
+    #[test]
+    fn expired_messages_are_dropped_unsent() {
+        let mut s = Scheduler::new(Mode::Strict, &HashMap::new());
+        let now = Instant::now();
+        s.push("a", msg("late", 10, now, Some(now + Duration::from_millis(5))));
+        s.push("a", msg("fresh", 10, now, None));
+        let (next, expired) = s.next(now + Duration::from_millis(10));
+        assert!(matches!(next, Next::Send(m) if m.topic == "fresh"));
+        assert_eq!(expired.len(), 1);
+        assert_eq!(expired[0].topic, "late");
+        assert_eq!(s.class("").unwrap().expired, 1);
+        assert_eq!(s.class("").unwrap().queued_bytes(), 0);
+    }
+
+    #[test]
+    fn rate_limited_class_waits_without_blocking_others() {
+        let mut configs = HashMap::new();
+        configs.insert("bulk".to_string(), class(0, 1, 1000, 1000));
+        let mut s = Scheduler::new(Mode::Strict, &configs);
+        let now = Instant::now();
+        s.push("bulk", msg("bulk1", 1000, now, None));
+        s.push("bulk", msg("bulk2", 500, now, None));
+        s.push("pose", msg("pose1", 10, now, None));
+
+        assert_eq!(sent_topic(s.next(now)), "bulk1");
+        // The bucket is empty: the lower-priority default class goes first
+        assert_eq!(sent_topic(s.next(now)), "pose1");
+        match s.next(now).0 {
+            Next::WaitUntil(t) => {
+                let wait = t - now;
+                assert!(wait > Duration::from_millis(450) && wait <= Duration::from_millis(500), "{:?}", wait);
+            }
+            _ => panic!("bulk2 should be rate limited"),
+        }
+        assert_eq!(sent_topic(s.next(now + Duration::from_millis(500))), "bulk2");
+    }
+
+    #[test]
+    fn weighted_mode_shares_by_weight() {
+        let mut configs = HashMap::new();
+        configs.insert("a".to_string(), class(0, 3, 0, 0));
+        configs.insert("b".to_string(), class(0, 1, 0, 0));
+        let mut s = Scheduler::new(Mode::Weighted, &configs);
+        let now = Instant::now();
+        for _ in 0..400 {
+            s.push("a", msg("a", QUANTUM as usize, now, None));
+            s.push("b", msg("b", QUANTUM as usize, now, None));
+        }
+        let sent: Vec<_> = (0..200).map(|_| sent_topic(s.next(now))).collect();
+        let a = sent.iter().filter(|t| *t == "a").count();
+        assert!((145..=155).contains(&a), "a sent {} of 200", a);
+    }
+
+    #[test]
+    fn removing_a_class_moves_its_queue_to_default() {
+        let mut configs = HashMap::new();
+        configs.insert("pose".to_string(), class(0, 1, 0, 0));
+        let mut s = Scheduler::new(Mode::Strict, &configs);
+        let now = Instant::now();
+        s.push("pose", msg("pose1", 10, now, None));
+        s.configure("pose", None);
+        assert!(s.class("pose").is_none());
+        assert_eq!(s.class("").unwrap().depth(), 1);
+        assert_eq!(s.class("").unwrap().queued_bytes(), 10);
+        assert_eq!(sent_topic(s.next(now)), "pose1");
+    }
+}
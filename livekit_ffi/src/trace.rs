@@ -0,0 +1,191 @@
+//! Hot-path tracing spans exported as Chrome trace JSON (`lk_trace_enable`, `lk_trace_dump`).
+//!
+//! Compiled in only with the `trace_spans` feature; without it `trace_span!` expands to nothing.
+//! When compiled in, a span costs one relaxed load while recording is off. While it is on, each
+//! span takes two clock reads and a write into its thread's ring of recent spans. That ring is
+//! locked only by its own thread and by a dump, so threads never contend with each other. A
+//! dump writes every thread's spans as complete ("X") events, which chrome://tracing and
+//! ui.perfetto.dev open directly, and then clears the rings and forgets threads that exited.
+//!
+//! Spans that cross an `.await` are recorded by the thread that finishes them.
+
+use std::cell::OnceCell;
+use std::fs::File;
+use std::io::{BufWriter, Write};
+use std::path::Path;
+use std::sync::atomic::{AtomicBool, AtomicU64, Ordering};
+use std::sync::{Arc, Mutex};
+use std::time::Instant;
+
+use once_cell::sync::Lazy;
+
+/// Spans kept per thread; the oldest are overwritten.
+const THREAD_SPANS: usize = 65_536;
+
+static ENABLED: AtomicBool = AtomicBool::new(false);
+static EPOCH: Lazy<Instant> = Lazy::new(Instant::now);
+static THREADS: Mutex<Vec<Arc<ThreadSpans>>> = Mutex::new(Vec::new());
+static NEXT_TID: AtomicU64 = AtomicU64::new(1);
+
+#[derive(Copy, Clone)]
+struct Record {
+    name: &'static str,
+    start_ns: u64,
+    dur_ns: u64,
+}
+
+#[derive(Default)]
+struct Ring {
+    records: Vec<Record>,
+    /// Next slot to overwrite once `records` is full.
+    next: usize,
+}
+
+struct ThreadSpans {
+    tid: u64,
+    name: String,
+    ring: Mutex<Ring>,
+}
+
+thread_local! {
+    static LOCAL: OnceCell<Arc<ThreadSpans>> = const { OnceCell::new() };
+}
+
+fn record(name: &'static str, start: Instant, end: Instant) {
+    let rec = Record {
+        name,
+        start_ns: start.saturating_duration_since(*EPOCH).as_nanos() as u64,
+        dur_ns: end.saturating_duration_since(start).as_nanos() as u64,
+    };
+    LOCAL.with(|local| {
+        let spans = local.get_or_init(|| {
+            let thread = std::thread::current();
+            let spans = Arc::new(ThreadSpans {
+                tid: NEXT_TID.fetch_add(1, Ordering::Relaxed),
+                name: thread.name().map(str::to_string).unwrap_or_else(|| format!("{:?}", thread.id())),
+                ring: Mutex::new(Ring::default()),
+            });
+            THREADS.lock().unwrap().push(spans.clone());
+            spans
+        });
+        let mut ring = spans.ring.lock().unwrap();
+        if ring.records.len() < THREAD_SPANS {
+            ring.records.push(rec);
+        } else {
+            let next = ring.next;
+            ring.records[next] = rec;
+            ring.next = (next + 1) % THREAD_SPANS;
+        }
+    });
+}
+
+/// Records the time from `enter` to drop; a no-op unless recording was on at `enter`.
+pub struct Span {
+    name: &'static str,
+    start: Option<Instant>,
+}
+
+impl Span {
+    #[inline]
+    pub fn enter(name: &'static str) -> Self {
+        let start = ENABLED.load(Ordering::Relaxed).then(Instant::now);
+        Self { name, start }
+    }
+}
+
+impl Drop for Span {
+    #[inline]
+    fn drop(&mut self) {
+        if let Some(start) = self.start {
+            record(self.name, start, Instant::now());
+        }
+    }
+}
+
+pub fn set_enabled(enabled: bool) {
+    Lazy::force(&EPOCH);
+    ENABLED.store(enabled, Ordering::Relaxed);
+}
+
+fn escape(s: &str) -> String {
+    s.chars()
+        .flat_map(|c| match c {
+            '"' | '\\' => vec!['\\', c],
+            c if c.is_control() => vec![' '],
+            c => vec![c],
+        })
+        .collect()
+}
+
+/// Write every recorded span to `path` as Chrome trace JSON and clear the rings. Returns the
+/// number of spans written.
+pub fn dump(path: &Path) -> std::io::Result<usize> {
+    let threads = {
+        let mut all = THREADS.lock().unwrap();
+        let threads = std::mem::take(&mut *all);
+        // A thread that exited dropped its reference; write its last spans, then let it go
+        all.extend(threads.iter().filter(|t| Arc::strong_count(t) > 1).cloned());
+        threads
+    };
+    let mut out = BufWriter::new(File::create(path)?);
+    let pid = std::process::id();
+    let mut written = 0usize;
+    out.write_all(b"{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n")?;
+    let mut first = true;
+    for thread in &threads {
+        // Take the records out so the thread only waits for the swap, not the file write
+        let ring = std::mem::take(&mut *thread.ring.lock().unwrap());
+        if !first {
+            out.write_all(b",\n")?;
+        }
+        first = false;
+        write!(out, "{{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":{pid},\"tid\":{},\"args\":{{\"name\":\"{}\"}}}}", thread.tid, escape(&thread.name))?;
+        let (newer, older) = ring.records.split_at(ring.next);
+        for rec in older.iter().chain(newer) {
+            write!(
+                out,
+                ",\n{{\"ph\":\"X\",\"name\":\"{}\",\"pid\":{pid},\"tid\":{},\"ts\":{:.3},\"dur\":{:.3}}}",
+                rec.name,
+                thread.tid,
+                rec.start_ns as f64 / 1_000.0,
+                rec.dur_ns as f64 / 1_000.0
+            )?;
+            written += 1;
+        }
+    }
+    out.write_all(b"\n]}\n")?;
+    out.flush()?;
+    Ok(written)
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn registered(tid: u64) -> bool {
+        THREADS.lock().unwrap().iter().any(|t| t.tid == tid)
+    }
+
+    #[test]
+    fn dump_writes_and_then_forgets_exited_threads() {
+        set_enabled(true);
+        let tid = std::thread::spawn(|| {
+            drop(Span::enter("test.exited"));
+            LOCAL.with(|local| local.get().map(|t| t.tid))
+        })
+        .join()
+        .unwrap()
+        .expect("span recorded");
+        drop(Span::enter("test.alive"));
+        let alive = LOCAL.with(|local| local.get().map(|t| t.tid)).expect("span recorded");
+        assert!(registered(tid));
+
+        let path = std::env::temp_dir().join(format!("lk_trace_test_{}.json", std::process::id()));
+        assert!(dump(&path).unwrap() >= 2);
+        let json = std::fs::read_to_string(&path).unwrap();
+        let _ = std::fs::remove_file(&path);
+        assert!(json.contains("test.exited") && json.contains("test.alive"));
+        assert!(!registered(tid), "exited thread still registered");
+        assert!(registered(alive));
+    }
+}
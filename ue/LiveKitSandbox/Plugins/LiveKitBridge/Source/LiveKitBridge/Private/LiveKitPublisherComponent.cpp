@@ -3,9 +3,42 @@
 #include "Engine/World.h"
 #include "TimerManager.h"
 #include "Async/Async.h"
+#include "Stats/Stats.h"
+#include "Trace/Trace.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
 #include <cmath>
 DEFINE_LOG_CATEGORY_STATIC(LogLiveKitBridge, Log, All);
 
+// `stat LiveKit` in the console. Insights captures get the same scopes with -trace=default,LiveKit
+DECLARE_STATS_GROUP(TEXT("LiveKit"), STATGROUP_LiveKit, STATCAT_Advanced);
+DECLARE_CYCLE_STAT(TEXT("Publish Audio"), STAT_LiveKit_PublishAudio, STATGROUP_LiveKit);
+DECLARE_CYCLE_STAT(TEXT("Send Data"), STAT_LiveKit_SendData, STATGROUP_LiveKit);
+DECLARE_CYCLE_STAT(TEXT("Data Callback (FFI thread)"), STAT_LiveKit_DataCallback, STATGROUP_LiveKit);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Audio Blocks Published"), STAT_LiveKit_AudioBlocks, STATGROUP_LiveKit);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Messages Sent"), STAT_LiveKit_MessagesSent, STATGROUP_LiveKit);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Bytes Sent"), STAT_LiveKit_BytesSent, STATGROUP_LiveKit);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Send Failures"), STAT_LiveKit_SendFailures, STATGROUP_LiveKit);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Data Callbacks"), STAT_LiveKit_DataCallbacks, STATGROUP_LiveKit);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Audio Callbacks"), STAT_LiveKit_AudioCallbacks, STATGROUP_LiveKit);
+
+UE_TRACE_CHANNEL_DEFINE(LiveKitChannel);
+
+// A stat cycle counter plus an Insights CPU scope on the LiveKit channel
+#define LIVEKIT_SCOPE(Stat, Name) SCOPE_CYCLE_COUNTER(Stat); TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL_STR(Name, LiveKitChannel)
+
+static void CountSend(bool bOk, int32 Bytes)
+{
+    if (bOk)
+    {
+        INC_DWORD_STAT(STAT_LiveKit_MessagesSent);
+        INC_DWORD_STAT_BY(STAT_LiveKit_BytesSent, Bytes);
+    }
+    else
+    {
+        INC_DWORD_STAT(STAT_LiveKit_SendFailures);
+    }
+}
+
 void ULiveKitPublisherComponent::BeginPlay()
 {
     Super::BeginPlay();
@@ -31,6 +64,9 @@ void ULiveKitPublisherComponent::BeginPlay()
     }
     // Always bind connection state callback for async lifecycle
     Client->SetConnectionCallback(&ULiveKitPublisherComponent::ConnectionThunk, this);
+    // Lines carry no component state, so the thunk needs no user pointer
+    Client->SetLogCallback(&ULiveKitPublisherComponent::LogThunk, nullptr);
+    Client->SetLogLevel((LkLogLevel)FfiLogLevel);
 
     if (bConnectAsync)
     {
@@ -113,6 +149,7 @@ void ULiveKitPublisherComponent::PushAudioPCM(const TArray<int16>& InterleavedFr
 {
     if (Client && InterleavedFrames.Num() > 0)
     {
+        LIVEKIT_SCOPE(STAT_LiveKit_PublishAudio, TEXT("LiveKit.PublishAudio"));
         const bool bOk = Client->PublishPCM(InterleavedFrames.GetData(), (size_t)FramesPerChannel, Channels, SampleRate);
         if (!bOk)
         {
@@ -126,6 +163,7 @@ void ULiveKitPublisherComponent::PushAudioPCM(const TArray<int16>& InterleavedFr
                 UE_LOG(LogLiveKitBridge, Verbose, TEXT("PublishPCM failed (%d frames/ch)"), FramesPerChannel);
             }
         } else {
+            INC_DWORD_STAT(STAT_LiveKit_AudioBlocks);
             if (!bLoggedAudioInit)
             {
                 bLoggedAudioInit = true;
@@ -194,7 +232,12 @@ void ULiveKitPublisherComponent::PushAudioPCMOnTrack(FName TrackName, const TArr
         UE_LOG(LogLiveKitBridge, Verbose, TEXT("PushAudioPCMOnTrack: track '%s' not available"), *TrackName.ToString());
         return;
     }
-    if (!(*TrackPtr)->PublishPCM(InterleavedFrames.GetData(), (size_t)FramesPerChannel))
+    LIVEKIT_SCOPE(STAT_LiveKit_PublishAudio, TEXT("LiveKit.PublishAudio"));
+    if ((*TrackPtr)->PublishPCM(InterleavedFrames.GetData(), (size_t)FramesPerChannel))
+    {
+        INC_DWORD_STAT(STAT_LiveKit_AudioBlocks);
+    }
+    else
     {
         const FString Reason = Client ? Client->GetLastErrorMessage() : FString();
         UE_LOG(LogLiveKitBridge, Verbose, TEXT("PushAudioPCMOnTrack '%s' failed (%s)"), *TrackName.ToString(), Reason.IsEmpty()?TEXT("no reason"): *Reason);
@@ -205,7 +248,9 @@ void ULiveKitPublisherComponent::SendMocap(const TArray<uint8>& Payload, bool bR
 {
     if (Client && Payload.Num() > 0)
     {
+        LIVEKIT_SCOPE(STAT_LiveKit_SendData, TEXT("LiveKit.SendData"));
         const bool bOk = Client->SendData(Payload.GetData(), (size_t)Payload.Num(), bReliable);
+        CountSend(bOk, Payload.Num());
         if (!bOk)
         {
             const FString Reason = Client ? Client->GetLastErrorMessage() : FString();
@@ -227,7 +272,7 @@ void ULiveKitPublisherComponent::SendMocap(const TArray<uint8>& Payload, bool bR
                 });
             }
         } else {
-            UE_LOG(LogLiveKitBridge, Log, TEXT("SendMocap succeeded (%d bytes, reliable=%s)"), Payload.Num(), bReliable ? TEXT("true") : TEXT("false"));
+            UE_LOG(LogLiveKitBridge, VeryVerbose, TEXT("SendMocap succeeded (%d bytes, reliable=%s)"), Payload.Num(), bReliable ? TEXT("true") : TEXT("false"));
             AsyncTask(ENamedThreads::GameThread, [this, n=Payload.Num(), b=bReliable]()
             {
                 if (IsValid(this)) { OnMocapSent(n, b); }
@@ -288,8 +333,10 @@ bool ULiveKitPublisherComponent::SendMocapOnChannel(FName ChannelName, const TAr
         UE_LOG(LogLiveKitBridge, Warning, TEXT("SendMocapOnChannel: channel '%s' unavailable"), *ChannelName.ToString());
         return false;
     }
+    LIVEKIT_SCOPE(STAT_LiveKit_SendData, TEXT("LiveKit.SendData"));
     const bool bReliable = (*ChannelPtr)->IsReliable();
     const bool bOk = (*ChannelPtr)->Send(Payload);
+    CountSend(bOk, Payload.Num());
     if (!bOk)
     {
         const FString Reason = Client ? Client->GetLastErrorMessage() : FString();
@@ -312,7 +359,7 @@ bool ULiveKitPublisherComponent::SendMocapOnChannel(FName ChannelName, const TAr
     }
     else
     {
-        UE_LOG(LogLiveKitBridge, Log, TEXT("SendMocapOnChannel '%s' succeeded (%d bytes, reliable=%s)"), *ChannelName.ToString(), Payload.Num(), bReliable?TEXT("true"):TEXT("false"));
+        UE_LOG(LogLiveKitBridge, VeryVerbose, TEXT("SendMocapOnChannel '%s' succeeded (%d bytes, reliable=%s)"), *ChannelName.ToString(), Payload.Num(), bReliable?TEXT("true"):TEXT("false"));
         AsyncTask(ENamedThreads::GameThread, [this, n = Payload.Num(), b = bReliable]()
         {
             if (IsValid(this)) { OnMocapSent(n, b); }
@@ -326,6 +373,8 @@ bool ULiveKitPublisherComponent::SendMocapOnChannel(FName ChannelName, const TAr
     if (!User || !bytes || len == 0) return;
     ULiveKitPublisherComponent* Self = reinterpret_cast<ULiveKitPublisherComponent*>(User);
     if (!IsValid(Self)) return;
+    LIVEKIT_SCOPE(STAT_LiveKit_DataCallback, TEXT("LiveKit.DataCallback"));
+    INC_DWORD_STAT(STAT_LiveKit_DataCallbacks);
     // Optional debug decode: [u64 time_us][u64 seq]
     if (len >= 16)
     {
@@ -355,6 +404,7 @@ bool ULiveKitPublisherComponent::SendMocapOnChannel(FName ChannelName, const TAr
     if (!User || !pcm || frames_per_channel == 0 || channels <= 0 || sample_rate <= 0) return;
     ULiveKitPublisherComponent* Self = reinterpret_cast<ULiveKitPublisherComponent*>(User);
     if (!IsValid(Self)) return;
+    INC_DWORD_STAT(STAT_LiveKit_AudioCallbacks);
 
     // Log first frame and then every ~100 frames to avoid spam
     Self->AudioFrameCount++;
@@ -454,7 +504,7 @@ void ULiveKitPublisherComponent::StartTestData()
             for (int32 i = 0; i < N; ++i) { Payload[i] = (uint8)(i ^ 0x5A); }
         }
         ++DataSeq;
-        UE_LOG(LogLiveKitBridge, Log, TEXT("SendMocap tick: seq=%llu size=%d reliable=%s"), (unsigned long long)(DataSeq-1), N, bTestDataReliable?TEXT("true"):TEXT("false"));
+        UE_LOG(LogLiveKitBridge, VeryVerbose, TEXT("SendMocap tick: seq=%llu size=%d reliable=%s"), (unsigned long long)(DataSeq-1), N, bTestDataReliable?TEXT("true"):TEXT("false"));
         SendMocap(Payload, bTestDataReliable);
     }, Period, true, 0.5f);
 }
@@ -508,3 +558,17 @@ void ULiveKitPublisherComponent::StopTestData()
         }
     });
 }
+
+/* static */ void ULiveKitPublisherComponent::LogThunk(void* User, LkLogLevel level, const char* target, const char* message, int64_t timestamp_us)
+{
+    // Runs on the FFI log thread; UE_LOG is thread-safe and stamps its own time
+    if (!message) return;
+    switch (level)
+    {
+        case LkLogError: UE_LOG(LogLiveKitBridge, Error, TEXT("[ffi] %s"), UTF8_TO_TCHAR(message)); break;
+        case LkLogWarn:  UE_LOG(LogLiveKitBridge, Warning, TEXT("[ffi] %s"), UTF8_TO_TCHAR(message)); break;
+        case LkLogInfo:  UE_LOG(LogLiveKitBridge, Log, TEXT("[ffi] %s"), UTF8_TO_TCHAR(message)); break;
+        case LkLogDebug: UE_LOG(LogLiveKitBridge, Verbose, TEXT("[ffi] %s"), UTF8_TO_TCHAR(message)); break;
+        default:         UE_LOG(LogLiveKitBridge, VeryVerbose, TEXT("[ffi] %s"), UTF8_TO_TCHAR(message)); break;
+    }
+}
@@ -239,6 +239,23 @@ public:
         return ok;
     }
 
+    bool SetLogLevel(LkLogLevel Level)
+    {
+        LkResult r = lk_set_log_level(Handle, Level);
+        const bool ok = (r.code == 0);
+        if (r.message) { lk_free_str((char*)r.message); }
+        return ok;
+    }
+
+    bool SetLogCallback(LkLogCallback Cb, void* User)
+    {
+        LkResult r = lk_set_log_callback(Handle, Cb, User);
+        const bool ok = (r.code == 0);
+        if (!ok) { CaptureError(r); if (r.message) { UE_LOG(LogTemp, Warning, TEXT("LiveKit set log callback: %s"), UTF8_TO_TCHAR(r.message)); lk_free_str((char*)r.message); } }
+        else if (r.message) { lk_free_str((char*)r.message); ClearError(); }
+        return ok;
+    }
+
     bool IsReady() const
     {
         return Handle && lk_client_is_ready(Handle) != 0;
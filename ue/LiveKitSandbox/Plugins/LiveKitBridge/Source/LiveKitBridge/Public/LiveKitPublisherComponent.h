@@ -14,6 +14,17 @@ enum class ELiveKitClientRole : uint8
     Subscriber UMETA(DisplayName="Subscriber"),
     Both       UMETA(DisplayName="Both")
 };
+
+// Verbosity of the FFI library's own log lines, which go to LogLiveKitBridge (mirrors LkLogLevel)
+UENUM(BlueprintType)
+enum class ELiveKitLogLevel : uint8
+{
+    Error,
+    Warn,
+    Info,
+    Debug,
+    Trace
+};
 #include "LiveKitPublisherComponent.generated.h"
 
 UCLASS(ClassGroup=(Networking), meta=(BlueprintSpawnableComponent))
@@ -28,6 +39,7 @@ public:
     UPROPERTY(EditAnywhere, Category="LiveKit") bool bReceiveAudio = false; // not exposed to BP (audio frames are native only)
     UPROPERTY(EditAnywhere, Category="LiveKit|Audio") int32 SampleRate = 48000;
     UPROPERTY(EditAnywhere, Category="LiveKit|Audio") int32 Channels = 1;
+    UPROPERTY(EditAnywhere, Category="LiveKit") ELiveKitLogLevel FfiLogLevel = ELiveKitLogLevel::Error;
 
     // Connection behavior
     UPROPERTY(EditAnywhere, Category="LiveKit|Connection") bool bConnectAsync = true;
@@ -101,6 +113,7 @@ private:
     static void DataThunk(void* User, const uint8_t* bytes, size_t len);
     static void AudioThunk(void* User, const int16_t* pcm, size_t frames_per_channel, int32_t channels, int32_t sample_rate);
     static void ConnectionThunk(void* User, LkConnectionState state, int32_t reason_code, const char* message);
+    static void LogThunk(void* User, LkLogLevel level, const char* target, const char* message, int64_t timestamp_us);
 
     // Test state
     FTimerHandle ToneTimerHandle;
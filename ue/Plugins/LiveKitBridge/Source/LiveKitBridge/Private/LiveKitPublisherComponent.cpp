@@ -3,13 +3,75 @@
 #include "Engine/World.h"
 #include "TimerManager.h"
 #include "Async/Async.h"
+#include "HAL/FileManager.h"
+#include "Misc/Paths.h"
+#include "Stats/Stats.h"
+#include "Trace/Trace.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "ProfilingDebugging/CountersTrace.h"
 #include <cmath>
 DEFINE_LOG_CATEGORY_STATIC(LogLiveKitBridge, Log, All);
 
+// `stat LiveKit` in the console. Insights captures get the same scopes with -trace=default,LiveKit
+// and the queue depths on the counters channel.
+DECLARE_STATS_GROUP(TEXT("LiveKit"), STATGROUP_LiveKit, STATCAT_Advanced);
+DECLARE_CYCLE_STAT(TEXT("Publish Audio"), STAT_LiveKit_PublishAudio, STATGROUP_LiveKit);
+DECLARE_CYCLE_STAT(TEXT("Send Data"), STAT_LiveKit_SendData, STATGROUP_LiveKit);
+DECLARE_CYCLE_STAT(TEXT("Stats Poll"), STAT_LiveKit_StatsPoll, STATGROUP_LiveKit);
+DECLARE_CYCLE_STAT(TEXT("Enqueue Inbound (FFI thread)"), STAT_LiveKit_EnqueueInbound, STATGROUP_LiveKit);
+DECLARE_CYCLE_STAT(TEXT("Dispatch Inbound (game thread)"), STAT_LiveKit_DispatchInbound, STATGROUP_LiveKit);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Audio Blocks Published"), STAT_LiveKit_AudioBlocks, STATGROUP_LiveKit);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Messages Sent"), STAT_LiveKit_MessagesSent, STATGROUP_LiveKit);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Bytes Sent"), STAT_LiveKit_BytesSent, STATGROUP_LiveKit);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Send Failures"), STAT_LiveKit_SendFailures, STATGROUP_LiveKit);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Data Callbacks"), STAT_LiveKit_DataCallbacks, STATGROUP_LiveKit);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Audio Callbacks"), STAT_LiveKit_AudioCallbacks, STATGROUP_LiveKit);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Packets Dispatched"), STAT_LiveKit_PacketsDispatched, STATGROUP_LiveKit);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Inbound Queue Depth"), STAT_LiveKit_InboundQueue, STATGROUP_LiveKit);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Send Queue Depth"), STAT_LiveKit_SendQueue, STATGROUP_LiveKit);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Send Queue Bytes"), STAT_LiveKit_SendQueueBytes, STATGROUP_LiveKit);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Audio Queued (ms)"), STAT_LiveKit_AudioQueuedMs, STATGROUP_LiveKit);
+
+UE_TRACE_CHANNEL_DEFINE(LiveKitChannel);
+TRACE_DECLARE_INT_COUNTER(LiveKitInboundQueue, TEXT("LiveKit/InboundQueueDepth"));
+TRACE_DECLARE_INT_COUNTER(LiveKitSendQueue, TEXT("LiveKit/SendQueueDepth"));
+TRACE_DECLARE_INT_COUNTER(LiveKitAudioQueuedMs, TEXT("LiveKit/AudioQueuedMs"));
+
+// A stat cycle counter plus an Insights CPU scope on the LiveKit channel
+#define LIVEKIT_SCOPE(Stat, Name) SCOPE_CYCLE_COUNTER(Stat); TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL_STR(Name, LiveKitChannel)
+
+// FFI queue depths cost a lock round trip per channel, so they are sampled at this interval
+static constexpr double LiveKitStatsPollSeconds = 0.25;
+// Labels the catch-all data callbacks remember as FNames
+static constexpr int32 LiveKitMaxCachedLabels = 32;
+
+static void CountSend(bool bOk, int32 Bytes)
+{
+    if (bOk)
+    {
+        INC_DWORD_STAT(STAT_LiveKit_MessagesSent);
+        INC_DWORD_STAT_BY(STAT_LiveKit_BytesSent, Bytes);
+    }
+    else
+    {
+        INC_DWORD_STAT(STAT_LiveKit_SendFailures);
+    }
+}
+
+ULiveKitPublisherComponent::ULiveKitPublisherComponent()
+{
+    // Ticking drains the inbound data queue on the game thread
+    PrimaryComponentTick.bCanEverTick = true;
+    PrimaryComponentTick.bStartWithTickEnabled = true;
+}
+
 void ULiveKitPublisherComponent::BeginPlay()
 {
     Super::BeginPlay();
     Client = new LiveKitClient();
+    const uint32 QueueCapacity = (uint32)FMath::Max(16, InboundQueueCapacity);
+    InboundQueue = MakeUnique<TCircularQueue<FLiveKitInboundMessage>>(QueueCapacity);
+    InboundBufferPool = MakeUnique<TCircularQueue<TArray<uint8>>>(QueueCapacity);
     // Map role
     LkRole LkRoleVal = LkRoleBoth;
     switch (Role)
@@ -21,13 +83,37 @@ void ULiveKitPublisherComponent::BeginPlay()
         default:                               LkRoleVal = LkRoleBoth; break;
     }
 
+    Client->SetRegistryCallback(&ULiveKitPublisherComponent::RegistryThunk, this);
+    Client->SetRateCallback(&ULiveKitPublisherComponent::RateThunk, this);
+    // Lines carry no component state, so the thunk needs no user pointer
+    Client->SetLogCallback(&ULiveKitPublisherComponent::LogThunk, nullptr);
+    Client->SetLogLevel((LkLogLevel)FfiLogLevel);
     if (bReceiveMocap)
     {
-        Client->SetDataCallback(&ULiveKitPublisherComponent::DataThunk, this);
+        if (bDeferInboundCopy)
+        {
+            Client->SetDataCallbackBuffered(&ULiveKitPublisherComponent::DataThunkBuffered, this);
+        }
+        else
+        {
+            Client->SetDataCallbackFrom(&ULiveKitPublisherComponent::DataThunkFrom, this);
+        }
     }
     if (bReceiveAudio)
     {
-        Client->SetAudioCallback(&ULiveKitPublisherComponent::AudioThunk, this);
+        Client->SetAudioCallbackIds(&ULiveKitPublisherComponent::AudioThunkIds, this);
+    }
+    if (bBatchSmallSends)
+    {
+        Client->SetDataBatching(true, BatchFlushWindowMs);
+    }
+    if (bWeightedSendScheduling)
+    {
+        Client->SetSendScheduler(LkSchedulerWeighted);
+    }
+    if (ClockSyncIntervalMs > 0)
+    {
+        Client->SetClockSync(ClockSyncIntervalMs);
     }
 
     const bool bOk = Client->ConnectWithRole(TCHAR_TO_UTF8(*RoomUrl), TCHAR_TO_UTF8(*Token), LkRoleVal);
@@ -72,8 +158,20 @@ void ULiveKitPublisherComponent::BeginPlay()
 void ULiveKitPublisherComponent::EndPlay(const EEndPlayReason::Type Reason)
 {
     DataChannels.Empty();
+    ClassedChannels.Empty();
+    StateChannels.Empty();
     AudioTracks.Empty();
     if (Client) { Client->Disconnect(); delete Client; Client = nullptr; }
+    LargeTransfers.Empty(); // Disconnect waits for in-flight transfers to stop reading these
+    PosePlayouts.Empty();
+    InboundChannels.Empty(); // handler contexts are safe to free once the client is gone
+    InboundStateChannels.Empty();
+    // No callbacks fire after the client is destroyed; release queued buffers
+    InboundBatch.Empty();
+    ReleaseInboundQueue();
+    InboundQueue.Reset();
+    InboundBufferPool.Reset();
+    DeferredCopyPool.Empty();
     StopDebugTone();
     StopTestData();
     AsyncTask(ENamedThreads::GameThread, [this]()
@@ -83,10 +181,355 @@ void ULiveKitPublisherComponent::EndPlay(const EEndPlayReason::Type Reason)
     Super::EndPlay(Reason);
 }
 
+void ULiveKitPublisherComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+    Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+    PollProfilingStats();
+    DispatchInbound();
+}
+
+void ULiveKitPublisherComponent::PollProfilingStats()
+{
+    // Nothing to sample unless `stat LiveKit` or an Insights capture is listening
+    bool bListening = UE_TRACE_CHANNELEXPR_IS_ENABLED(LiveKitChannel);
+#if STATS
+    bListening = bListening || FThreadStats::IsCollectingData();
+#endif
+    if (!bListening)
+    {
+        return;
+    }
+
+    // Sampled before TickComponent drains it, so this is what piled up since the last tick
+    const int32 InboundDepth = InboundQueue.IsValid() ? (int32)InboundQueue->Count() : 0;
+    SET_DWORD_STAT(STAT_LiveKit_InboundQueue, InboundDepth);
+    TRACE_COUNTER_SET(LiveKitInboundQueue, InboundDepth);
+
+    const double Now = FPlatformTime::Seconds();
+    if (!Client || Now < NextStatsPollTime)
+    {
+        return;
+    }
+    NextStatsPollTime = Now + LiveKitStatsPollSeconds;
+    LIVEKIT_SCOPE(STAT_LiveKit_StatsPoll, TEXT("LiveKit.StatsPoll"));
+
+    // The default class holds everything queued on labels without a class of their own;
+    // labels without a class would only come back as errors
+    int64 SendDepth = 0;
+    int64 SendBytes = 0;
+    LkDataClassStats ClassStats{};
+    if (Client->GetDataClassStats(FString(), ClassStats))
+    {
+        SendDepth += ClassStats.queue_depth;
+        SendBytes += ClassStats.queued_bytes;
+    }
+    for (const FName& ChannelName : ClassedChannels)
+    {
+        const TUniquePtr<LiveKitDataChannel>* ChannelPtr = DataChannels.Find(ChannelName);
+        ClassStats = LkDataClassStats{};
+        if (ChannelPtr && Client->GetDataClassStats((*ChannelPtr)->GetLabel(), ClassStats))
+        {
+            SendDepth += ClassStats.queue_depth;
+            SendBytes += ClassStats.queued_bytes;
+        }
+    }
+    // The fullest published ring is the one closest to overrunning
+    int32 AudioQueuedMs = 0;
+    TArray<LkAudioTrackStats> Tracks;
+    if (Client->GetAudioTrackStats(Tracks))
+    {
+        for (const LkAudioTrackStats& Track : Tracks)
+        {
+            if (!Track.remote) { AudioQueuedMs = FMath::Max(AudioQueuedMs, (int32)Track.queued_ms); }
+        }
+    }
+    SET_DWORD_STAT(STAT_LiveKit_SendQueue, (uint32)SendDepth);
+    SET_DWORD_STAT(STAT_LiveKit_SendQueueBytes, (uint32)SendBytes);
+    SET_DWORD_STAT(STAT_LiveKit_AudioQueuedMs, AudioQueuedMs);
+    TRACE_COUNTER_SET(LiveKitSendQueue, SendDepth);
+    TRACE_COUNTER_SET(LiveKitAudioQueuedMs, AudioQueuedMs);
+}
+
+void ULiveKitPublisherComponent::DispatchInbound()
+{
+    // Includes the Blueprint events, which is where a slow consumer shows up
+    LIVEKIT_SCOPE(STAT_LiveKit_DispatchInbound, TEXT("LiveKit.DispatchInbound"));
+    if (!InboundQueue.IsValid())
+    {
+        return;
+    }
+
+    FLiveKitInboundMessage Message;
+    while (InboundQueue->Dequeue(Message))
+    {
+        // Every frame feeds the playout buffer, including those collapsing discards below
+        if (PosePlayouts.Num() > 0)
+        {
+            PushPosePlayout(Message);
+        }
+        // Measured at receipt; only sender times from synced clocks are known
+        const float LatencyMs = Message.SenderTimeUs > 0 ? (float)(Message.ArrivalUs - Message.SenderTimeUs) / 1000.f : -1.f;
+        if (bCollapseInboundToLatest)
+        {
+            const int32 Existing = InboundBatch.IndexOfByPredicate([&Message](const FLiveKitMocapPacket& P)
+            {
+                return P.Channel == Message.Channel && P.SenderId == (int32)Message.SenderId && P.StateKey == Message.StateKey;
+            });
+            if (Existing != INDEX_NONE)
+            {
+                // A superseded deferred packet is released without ever being copied
+                InboundBatchDeferred[Existing].Release();
+                InboundBatchDeferred[Existing] = Message.Deferred;
+                InboundBatch[Existing].LatencyMs = LatencyMs;
+                Swap(InboundBatch[Existing].Payload, Message.Payload);
+                RecycleInboundBuffer(MoveTemp(Message.Payload));
+                ++InboundPacketsCollapsed;
+                continue;
+            }
+        }
+        FLiveKitMocapPacket& Packet = InboundBatch.AddDefaulted_GetRef();
+        Packet.Channel = Message.Channel;
+        Packet.SenderId = (int32)Message.SenderId;
+        Packet.StateKey = Message.StateKey;
+        Packet.LatencyMs = LatencyMs;
+        Packet.Payload = MoveTemp(Message.Payload);
+        InboundBatchDeferred.Add(Message.Deferred);
+    }
+
+    // Copy the surviving deferred packets out of their FFI buffers
+    for (int32 i = 0; i < InboundBatch.Num(); ++i)
+    {
+        FLiveKitDeferredPayload& Deferred = InboundBatchDeferred[i];
+        if (Deferred.Buffer)
+        {
+            TArray<uint8>& Payload = InboundBatch[i].Payload;
+            // Not from InboundBufferPool: the FFI thread is that queue's only consumer
+            if (Payload.Max() == 0 && DeferredCopyPool.Num() > 0) { Payload = DeferredCopyPool.Pop(EAllowShrinking::No); }
+            Payload.Reset();
+            Payload.Append(Deferred.Bytes, Deferred.Len);
+            Deferred.Release();
+        }
+    }
+    InboundBatchDeferred.Reset();
+
+    if (InboundBatch.Num() == 0)
+    {
+        return;
+    }
+
+    ++InboundBatchesDispatched;
+    INC_DWORD_STAT_BY(STAT_LiveKit_PacketsDispatched, InboundBatch.Num());
+    OnMocapBatchReceived(InboundBatch);
+    if (bDispatchPerPacketEvents)
+    {
+        for (const FLiveKitMocapPacket& Packet : InboundBatch)
+        {
+            OnMocapReceived(Packet.Payload);
+        }
+    }
+
+    for (FLiveKitMocapPacket& Packet : InboundBatch)
+    {
+        RecycleInboundBuffer(MoveTemp(Packet.Payload));
+    }
+    InboundBatch.Reset();
+}
+
+void ULiveKitPublisherComponent::ReleaseInboundQueue()
+{
+    if (!InboundQueue.IsValid()) return;
+    FLiveKitInboundMessage Message;
+    while (InboundQueue->Dequeue(Message))
+    {
+        Message.Deferred.Release();
+    }
+}
+
+void ULiveKitPublisherComponent::RecycleInboundBuffer(TArray<uint8>&& Buffer)
+{
+    if (Buffer.Max() == 0) return;
+    // Deferred copies run on the game thread and keep their own pool
+    if (bDeferInboundCopy && DeferredCopyPool.Num() < InboundQueueCapacity)
+    {
+        DeferredCopyPool.Add(MoveTemp(Buffer));
+        return;
+    }
+    // Pool full: let the buffer free normally
+    if (InboundBufferPool.IsValid())
+    {
+        InboundBufferPool->Enqueue(MoveTemp(Buffer));
+    }
+}
+
+FLiveKitInboundStats ULiveKitPublisherComponent::GetInboundStats() const
+{
+    FLiveKitInboundStats Stats;
+    Stats.PacketsReceived = InboundPacketsReceived.load(std::memory_order_relaxed);
+    Stats.BytesReceived = InboundBytesReceived.load(std::memory_order_relaxed);
+    Stats.PacketsDropped = InboundPacketsDropped.load(std::memory_order_relaxed);
+    Stats.PacketsCollapsed = InboundPacketsCollapsed;
+    Stats.BatchesDispatched = InboundBatchesDispatched;
+    return Stats;
+}
+
+FLiveKitTransportStats ULiveKitPublisherComponent::GetTransportStats(bool bSubscriber) const
+{
+    FLiveKitTransportStats Out;
+    LkTransportStats Stats{};
+    if (Client && Client->GetTransportStats(bSubscriber ? nullptr : &Stats, bSubscriber ? &Stats : nullptr))
+    {
+        Out.bConnected = Stats.connected != 0;
+        Out.RttMs = Stats.rtt_us / 1000.f;
+        Out.AvailableOutgoingKbps = (float)(Stats.available_outgoing_bps / 1000.0);
+        Out.AvailableIncomingKbps = (float)(Stats.available_incoming_bps / 1000.0);
+        Out.BytesSent = Stats.bytes_sent;
+        Out.BytesReceived = Stats.bytes_received;
+        Out.SendKbps = (float)(Stats.send_bps / 1000.0);
+        Out.ReceiveKbps = (float)(Stats.receive_bps / 1000.0);
+        Out.LocalCandidate = (ELiveKitCandidateType)Stats.local_candidate;
+        Out.RemoteCandidate = (ELiveKitCandidateType)Stats.remote_candidate;
+        Out.bTcp = Stats.tcp != 0;
+    }
+    return Out;
+}
+
+TArray<FLiveKitTrackStats> ULiveKitPublisherComponent::GetTrackStats() const
+{
+    TArray<FLiveKitTrackStats> Out;
+    TArray<LkTrackStats> Tracks;
+    if (!Client || !Client->GetTrackStats(Tracks))
+    {
+        return Out;
+    }
+    Out.Reserve(Tracks.Num());
+    for (const LkTrackStats& T : Tracks)
+    {
+        FLiveKitTrackStats& S = Out.AddDefaulted_GetRef();
+        S.Name = UTF8_TO_TCHAR(T.name);
+        S.bOutbound = T.outbound != 0;
+        S.bVideo = T.video != 0;
+        S.ParticipantId = (int32)T.participant_id;
+        S.TrackId = (int32)T.track_id;
+        S.Packets = T.packets;
+        S.Bytes = T.bytes;
+        S.Kbps = (float)(T.bitrate_bps / 1000.0);
+        S.PacketsLost = T.packets_lost;
+        S.Loss = (float)T.loss;
+        S.JitterMs = T.jitter_us / 1000.f;
+        S.RttMs = T.rtt_us / 1000.f;
+        S.NackCount = T.nack_count;
+        S.PliCount = T.pli_count;
+        S.RetransmittedPackets = T.retransmitted_packets;
+        S.TargetKbps = (float)(T.target_bitrate_bps / 1000.0);
+    }
+    return Out;
+}
+
+static FLiveKitAudioTrackStats ToAudioTrackStats(const LkAudioTrackStats& T)
+{
+    FLiveKitAudioTrackStats S;
+    S.Name = UTF8_TO_TCHAR(T.name);
+    S.bRemote = T.remote != 0;
+    S.SampleRate = T.sample_rate;
+    S.Channels = T.channels;
+    S.QueuedMs = T.queued_ms;
+    S.HighWaterMs = T.high_water_ms;
+    S.CapacityMs = T.capacity_ms;
+    S.Underruns = T.underruns;
+    S.Overruns = T.overruns;
+    S.MsSinceLastFrame = T.last_frame_us > 0 ? (lk_now_local_us() - T.last_frame_us) / 1000.f : -1.f;
+    S.ParticipantId = (int32)T.participant_id;
+    S.TrackId = (int32)T.track_id;
+    S.FramesReceived = T.frames_received;
+    S.ConcealedRatio = T.samples_received > 0 ? (float)((double)T.concealed_samples / (double)T.samples_received) : 0.f;
+    S.JitterBufferMs = T.jitter_buffer_ms;
+    return S;
+}
+
+bool ULiveKitPublisherComponent::GetAudioTrackStats(FName TrackName, FLiveKitAudioTrackStats& OutStats) const
+{
+    const TUniquePtr<LiveKitAudioTrack>* TrackPtr = AudioTracks.Find(TrackName);
+    LkAudioTrackStats Stats{};
+    if (!TrackPtr || !(*TrackPtr)->GetStats(Stats))
+    {
+        return false;
+    }
+    OutStats = ToAudioTrackStats(Stats);
+    return true;
+}
+
+TArray<FLiveKitAudioTrackStats> ULiveKitPublisherComponent::GetAllAudioTrackStats() const
+{
+    TArray<FLiveKitAudioTrackStats> Out;
+    TArray<LkAudioTrackStats> Tracks;
+    if (Client && Client->GetAudioTrackStats(Tracks))
+    {
+        Out.Reserve(Tracks.Num());
+        for (const LkAudioTrackStats& T : Tracks)
+        {
+            Out.Add(ToAudioTrackStats(T));
+        }
+    }
+    return Out;
+}
+
+static FLiveKitLatencySummary ToLatencySummary(const LkLatencySummary& L)
+{
+    FLiveKitLatencySummary S;
+    S.Count = L.count;
+    S.MinUs = (float)L.min_us;
+    S.MeanUs = (float)L.mean_us;
+    S.P50Us = (float)L.p50_us;
+    S.P90Us = (float)L.p90_us;
+    S.P99Us = (float)L.p99_us;
+    S.P999Us = (float)L.p999_us;
+    S.MaxUs = (float)L.max_us;
+    return S;
+}
+
+FLiveKitLatencyStats ULiveKitPublisherComponent::GetLatencyStats(bool bReset) const
+{
+    FLiveKitLatencyStats Out;
+    LkLatencyStats Stats{};
+    if (Client && Client->GetLatencyStats(Stats, bReset))
+    {
+        Out.AudioRing = ToLatencySummary(Stats.audio_ring);
+        Out.Send = ToLatencySummary(Stats.send);
+        Out.Dispatch = ToLatencySummary(Stats.dispatch);
+        Out.Callback = ToLatencySummary(Stats.callback);
+    }
+    return Out;
+}
+
+bool ULiveKitPublisherComponent::SetTraceRecording(bool bEnabled)
+{
+    return LiveKitClient::EnableTrace(bEnabled);
+}
+
+bool ULiveKitPublisherComponent::DumpTrace(const FString& FileName)
+{
+    const FString Path = FPaths::IsRelative(FileName) ? FPaths::Combine(FPaths::ProfilingDir(), FileName) : FileName;
+    IFileManager::Get().MakeDirectory(*FPaths::GetPath(Path), true);
+    int32 Spans = 0;
+    const bool bOk = LiveKitClient::DumpTrace(FPaths::ConvertRelativePathToFull(Path), &Spans);
+    if (bOk)
+    {
+        UE_LOG(LogLiveKitBridge, Log, TEXT("LiveKit trace: %d spans written to %s"), Spans, *Path);
+    }
+    return bOk;
+}
+
+FString ULiveKitPublisherComponent::GetParticipantIdentity(int32 ParticipantId) const
+{
+    const FString* Identity = ParticipantIdentities.Find(ParticipantId);
+    return Identity ? *Identity : FString();
+}
+
 void ULiveKitPublisherComponent::PushAudioPCM(const TArray<int16>& InterleavedFrames, int32 FramesPerChannel)
 {
     if (Client && InterleavedFrames.Num() > 0)
     {
+        LIVEKIT_SCOPE(STAT_LiveKit_PublishAudio, TEXT("LiveKit.PublishAudio"));
         const bool bOk = Client->PublishPCM(InterleavedFrames.GetData(), (size_t)FramesPerChannel, Channels, SampleRate);
         if (!bOk)
         {
@@ -100,6 +543,7 @@ void ULiveKitPublisherComponent::PushAudioPCM(const TArray<int16>& InterleavedFr
                 UE_LOG(LogLiveKitBridge, Verbose, TEXT("PublishPCM failed (%d frames/ch)"), FramesPerChannel);
             }
         } else {
+            INC_DWORD_STAT(STAT_LiveKit_AudioBlocks);
             if (!bLoggedAudioInit)
             {
                 bLoggedAudioInit = true;
@@ -168,7 +612,12 @@ void ULiveKitPublisherComponent::PushAudioPCMOnTrack(FName TrackName, const TArr
         UE_LOG(LogLiveKitBridge, Verbose, TEXT("PushAudioPCMOnTrack: track '%s' not available"), *TrackName.ToString());
         return;
     }
-    if (!(*TrackPtr)->PublishPCM(InterleavedFrames.GetData(), (size_t)FramesPerChannel))
+    LIVEKIT_SCOPE(STAT_LiveKit_PublishAudio, TEXT("LiveKit.PublishAudio"));
+    if ((*TrackPtr)->PublishPCM(InterleavedFrames.GetData(), (size_t)FramesPerChannel))
+    {
+        INC_DWORD_STAT(STAT_LiveKit_AudioBlocks);
+    }
+    else
     {
         const FString Reason = Client ? Client->GetLastErrorMessage() : FString();
         UE_LOG(LogLiveKitBridge, Verbose, TEXT("PushAudioPCMOnTrack '%s' failed (%s)"), *TrackName.ToString(), Reason.IsEmpty()?TEXT("no reason"): *Reason);
@@ -179,7 +628,9 @@ void ULiveKitPublisherComponent::SendMocap(const TArray<uint8>& Payload, bool bR
 {
     if (Client && Payload.Num() > 0)
     {
+        LIVEKIT_SCOPE(STAT_LiveKit_SendData, TEXT("LiveKit.SendData"));
         const bool bOk = Client->SendData(Payload.GetData(), (size_t)Payload.Num(), bReliable);
+        CountSend(bOk, Payload.Num());
         if (!bOk)
         {
             const FString Reason = Client ? Client->GetLastErrorMessage() : FString();
@@ -201,7 +652,7 @@ void ULiveKitPublisherComponent::SendMocap(const TArray<uint8>& Payload, bool bR
                 });
             }
         } else {
-            UE_LOG(LogLiveKitBridge, Log, TEXT("SendMocap succeeded (%d bytes, reliable=%s)"), Payload.Num(), bReliable ? TEXT("true") : TEXT("false"));
+            UE_LOG(LogLiveKitBridge, VeryVerbose, TEXT("SendMocap succeeded (%d bytes, reliable=%s)"), Payload.Num(), bReliable ? TEXT("true") : TEXT("false"));
             AsyncTask(ENamedThreads::GameThread, [this, n=Payload.Num(), b=bReliable]()
             {
                 if (IsValid(this)) { OnMocapSent(n, b); }
@@ -227,6 +678,16 @@ bool ULiveKitPublisherComponent::RegisterMocapChannel(FName ChannelName, const F
         UE_LOG(LogLiveKitBridge, Warning, TEXT("RegisterMocapChannel skipped: '%s' already exists"), *ChannelName.ToString());
         return false;
     }
+    // The FFI keeps one handler per label, so a second channel would steal the first's inbound
+    // data and unregistering either would silence both
+    for (const TPair<FName, TUniquePtr<LiveKitDataChannel>>& Pair : DataChannels)
+    {
+        if (Pair.Value->GetLabel() == Label)
+        {
+            UE_LOG(LogLiveKitBridge, Warning, TEXT("RegisterMocapChannel skipped: label '%s' already used by '%s'"), *Label, *Pair.Key.ToString());
+            return false;
+        }
+    }
     TUniquePtr<LiveKitDataChannel> Channel = Client->CreateDataChannel(Label, bReliable, bOrdered);
     if (!Channel.IsValid() || !Channel->IsValid())
     {
@@ -234,6 +695,19 @@ bool ULiveKitPublisherComponent::RegisterMocapChannel(FName ChannelName, const F
         return false;
     }
     DataChannels.Add(ChannelName, MoveTemp(Channel));
+
+    // Let the FFI route this label straight to the channel; no per-packet label conversion
+    if (bReceiveMocap)
+    {
+        TUniquePtr<FLiveKitInboundChannel> Inbound = MakeUnique<FLiveKitInboundChannel>();
+        Inbound->Owner = this;
+        Inbound->Channel = ChannelName;
+        Inbound->Label = Label;
+        if (Client->RegisterDataHandler(Label, &ULiveKitPublisherComponent::DataHandlerThunk, Inbound.Get()))
+        {
+            InboundChannels.Add(ChannelName, MoveTemp(Inbound));
+        }
+    }
     UE_LOG(LogLiveKitBridge, Log, TEXT("Registered mocap channel '%s' (label='%s', reliable=%s, ordered=%s)"),
         *ChannelName.ToString(), *Label, bReliable?TEXT("true"):TEXT("false"), bOrdered?TEXT("true"):TEXT("false"));
     return true;
@@ -241,6 +715,13 @@ bool ULiveKitPublisherComponent::RegisterMocapChannel(FName ChannelName, const F
 
 bool ULiveKitPublisherComponent::UnregisterMocapChannel(FName ChannelName)
 {
+    if (TUniquePtr<FLiveKitInboundChannel>* Inbound = InboundChannels.Find(ChannelName))
+    {
+        // The FFI stops dispatching to the handler before this returns, so the context can go
+        if (Client) { Client->UnregisterDataHandler((*Inbound)->Label); }
+        InboundChannels.Remove(ChannelName);
+    }
+    ClassedChannels.Remove(ChannelName);
     if (DataChannels.Remove(ChannelName) > 0)
     {
         UE_LOG(LogLiveKitBridge, Log, TEXT("Unregistered mocap channel '%s'"), *ChannelName.ToString());
@@ -262,8 +743,10 @@ bool ULiveKitPublisherComponent::SendMocapOnChannel(FName ChannelName, const TAr
         UE_LOG(LogLiveKitBridge, Warning, TEXT("SendMocapOnChannel: channel '%s' unavailable"), *ChannelName.ToString());
         return false;
     }
+    LIVEKIT_SCOPE(STAT_LiveKit_SendData, TEXT("LiveKit.SendData"));
     const bool bReliable = (*ChannelPtr)->IsReliable();
     const bool bOk = (*ChannelPtr)->Send(Payload);
+    CountSend(bOk, Payload.Num());
     if (!bOk)
     {
         const FString Reason = Client ? Client->GetLastErrorMessage() : FString();
@@ -286,7 +769,7 @@ bool ULiveKitPublisherComponent::SendMocapOnChannel(FName ChannelName, const TAr
     }
     else
     {
-        UE_LOG(LogLiveKitBridge, Log, TEXT("SendMocapOnChannel '%s' succeeded (%d bytes, reliable=%s)"), *ChannelName.ToString(), Payload.Num(), bReliable?TEXT("true"):TEXT("false"));
+        UE_LOG(LogLiveKitBridge, VeryVerbose, TEXT("SendMocapOnChannel '%s' succeeded (%d bytes, reliable=%s)"), *ChannelName.ToString(), Payload.Num(), bReliable?TEXT("true"):TEXT("false"));
         AsyncTask(ENamedThreads::GameThread, [this, n = Payload.Num(), b = bReliable]()
         {
             if (IsValid(this)) { OnMocapSent(n, b); }
@@ -295,47 +778,677 @@ bool ULiveKitPublisherComponent::SendMocapOnChannel(FName ChannelName, const TAr
     return bOk;
 }
 
-/* static */ void ULiveKitPublisherComponent::DataThunk(void* User, const uint8_t* bytes, size_t len)
+bool ULiveKitPublisherComponent::SendMocapOnChannelOwned(FName ChannelName, TArray<uint8>&& Payload)
 {
-    if (!User || !bytes || len == 0) return;
-    ULiveKitPublisherComponent* Self = reinterpret_cast<ULiveKitPublisherComponent*>(User);
-    if (!IsValid(Self)) return;
-    // Optional debug decode: [u64 time_us][u64 seq]
-    if (len >= 16)
+    if (!Client || Payload.Num() == 0)
     {
-        uint64 TimeUs = 0; uint64 Seq = 0;
-        FMemory::Memcpy(&TimeUs, bytes + 0, sizeof(uint64));
-        FMemory::Memcpy(&Seq, bytes + 8, sizeof(uint64));
-        const double NowUs = FPlatformTime::Seconds() * 1e6;
-        const double LatencyMs = (NowUs - (double)TimeUs) / 1000.0;
-        UE_LOG(LogLiveKitBridge, Log, TEXT("Mocap recv: seq=%llu size=%d latency=%.2fms"), (unsigned long long)Seq, (int)len, LatencyMs);
+        return false;
+    }
+    TUniquePtr<LiveKitDataChannel>* ChannelPtr = DataChannels.Find(ChannelName);
+    if (!ChannelPtr || !ChannelPtr->IsValid() || !(*ChannelPtr)->IsValid())
+    {
+        UE_LOG(LogLiveKitBridge, Warning, TEXT("SendMocapOnChannelOwned: channel '%s' unavailable"), *ChannelName.ToString());
+        return false;
+    }
+    LIVEKIT_SCOPE(STAT_LiveKit_SendData, TEXT("LiveKit.SendData"));
+    const int32 N = Payload.Num();
+    const bool bReliable = (*ChannelPtr)->IsReliable();
+    const bool bOk = (*ChannelPtr)->SendOwned(MoveTemp(Payload));
+    CountSend(bOk, N);
+    if (!bOk)
+    {
+        const FString Reason = Client->GetLastErrorMessage();
+        UE_LOG(LogLiveKitBridge, Verbose, TEXT("SendMocapOnChannelOwned '%s' failed (%d bytes, reliable=%s): %s"), *ChannelName.ToString(), N, bReliable?TEXT("true"):TEXT("false"), *Reason);
+        AsyncTask(ENamedThreads::GameThread, [this, N, b = bReliable, Reason]()
+        {
+            if (IsValid(this)) { OnMocapSendFailed(N, b, Reason); }
+        });
     }
     else
     {
-        UE_LOG(LogLiveKitBridge, Log, TEXT("Mocap recv: size=%d"), (int)len);
+        AsyncTask(ENamedThreads::GameThread, [this, N, b = bReliable]()
+        {
+            if (IsValid(this)) { OnMocapSent(N, b); }
+        });
     }
+    return bOk;
+}
+
+bool ULiveKitPublisherComponent::SendMocapToParticipants(FName ChannelName, const TArray<uint8>& Payload, const TArray<int32>& ParticipantIds)
+{
+    if (!Client || Payload.Num() == 0 || ParticipantIds.Num() == 0)
+    {
+        return false;
+    }
+    TUniquePtr<LiveKitDataChannel>* ChannelPtr = DataChannels.Find(ChannelName);
+    if (!ChannelPtr || !ChannelPtr->IsValid() || !(*ChannelPtr)->IsValid())
+    {
+        UE_LOG(LogLiveKitBridge, Warning, TEXT("SendMocapToParticipants: channel '%s' unavailable"), *ChannelName.ToString());
+        return false;
+    }
+    TArray<uint32> Ids;
+    Ids.Reserve(ParticipantIds.Num());
+    for (int32 Id : ParticipantIds)
+    {
+        if (Id > 0) { Ids.Add((uint32)Id); }
+    }
+    LIVEKIT_SCOPE(STAT_LiveKit_SendData, TEXT("LiveKit.SendData"));
+    const bool bReliable = (*ChannelPtr)->IsReliable();
+    const bool bOk = (*ChannelPtr)->SendTo(Payload, Ids);
+    CountSend(bOk, Payload.Num());
+    if (!bOk)
+    {
+        const FString Reason = Client->GetLastErrorMessage();
+        UE_LOG(LogLiveKitBridge, Verbose, TEXT("SendMocapToParticipants '%s' failed (%d bytes, %d recipients): %s"), *ChannelName.ToString(), Payload.Num(), Ids.Num(), *Reason);
+        AsyncTask(ENamedThreads::GameThread, [this, n = Payload.Num(), b = bReliable, Reason]()
+        {
+            if (IsValid(this)) { OnMocapSendFailed(n, b, Reason); }
+        });
+    }
+    else
+    {
+        AsyncTask(ENamedThreads::GameThread, [this, n = Payload.Num(), b = bReliable]()
+        {
+            if (IsValid(this)) { OnMocapSent(n, b); }
+        });
+    }
+    return bOk;
+}
+
+bool ULiveKitPublisherComponent::EncodePose(const TArray<FTransform>& Bones, const FLiveKitPoseCodecSettings& Settings, TArray<uint8>& OutPayload)
+{
+    OutPayload.Reset();
+    if (Bones.Num() == 0)
+    {
+        return false;
+    }
+    LkPoseCodecConfig Config{};
+    Config.bone_count = (uint32)Bones.Num();
+    Config.rotation_bits = Settings.RotationBits;
+    Config.encode_positions = Settings.bEncodePositions ? 1 : 0;
+    Config.position_bits = Settings.PositionBits;
+    Config.position_range = Settings.PositionRange;
+    Config.scale_bits = Settings.bEncodeScales ? Settings.ScaleBits : 0;
+    Config.scale_min = Settings.ScaleMin;
+    Config.scale_max = Settings.ScaleMax;
+    const size_t Size = lk_pose_encoded_size(&Config);
+    if (Size == 0)
+    {
+        UE_LOG(LogLiveKitBridge, Warning, TEXT("EncodePose: invalid codec settings for %d bones"), Bones.Num());
+        return false;
+    }
+
+    TArray<LkBoneTransform> Raw;
+    Raw.SetNumUninitialized(Bones.Num());
+    for (int32 i = 0; i < Bones.Num(); ++i)
+    {
+        const FQuat Q = Bones[i].GetRotation();
+        const FVector P = Bones[i].GetTranslation();
+        const FVector S = Bones[i].GetScale3D();
+        Raw[i] = LkBoneTransform{ { (float)Q.X, (float)Q.Y, (float)Q.Z, (float)Q.W }, { (float)P.X, (float)P.Y, (float)P.Z }, { (float)S.X, (float)S.Y, (float)S.Z } };
+    }
+    OutPayload.SetNumUninitialized((int32)Size);
+    size_t Len = 0;
+    LkResult r = lk_pose_encode(&Config, Raw.GetData(), OutPayload.GetData(), Size, &Len);
+    if (r.code != 0)
+    {
+        UE_LOG(LogLiveKitBridge, Warning, TEXT("EncodePose failed: %s"), r.message ? UTF8_TO_TCHAR(r.message) : TEXT("unknown"));
+        if (r.message) { lk_free_str((char*)r.message); }
+        OutPayload.Reset();
+        return false;
+    }
+    return true; // Len == Size: the encoded size is fixed per config
+}
+
+bool ULiveKitPublisherComponent::DecodePose(const TArray<uint8>& Payload, TArray<FTransform>& OutBones)
+{
+    OutBones.Reset();
+    size_t Count = 0;
+    // First call reports the bone count
+    LkResult r = lk_pose_decode(Payload.GetData(), (size_t)Payload.Num(), nullptr, 0, &Count);
+    if (r.message) { lk_free_str((char*)r.message); }
+    if (r.code != 601 || Count == 0)
+    {
+        return false;
+    }
+    TArray<LkBoneTransform> Raw;
+    Raw.SetNumUninitialized((int32)Count);
+    r = lk_pose_decode(Payload.GetData(), (size_t)Payload.Num(), Raw.GetData(), Count, &Count);
+    if (r.message) { lk_free_str((char*)r.message); }
+    if (r.code != 0)
+    {
+        return false;
+    }
+    OutBones.Reserve(Raw.Num());
+    for (const LkBoneTransform& B : Raw)
+    {
+        OutBones.Emplace(FQuat(B.rotation[0], B.rotation[1], B.rotation[2], B.rotation[3]), FVector(B.position[0], B.position[1], B.position[2]), FVector(B.scale[0], B.scale[1], B.scale[2]));
+    }
+    return true;
+}
+
+bool ULiveKitPublisherComponent::SendPoseOnChannel(FName ChannelName, const TArray<FTransform>& Bones)
+{
     TArray<uint8> Payload;
-    Payload.Append(bytes, (int32)len);
-    AsyncTask(ENamedThreads::GameThread, [Self, Payload = MoveTemp(Payload)]() mutable {
-        if (IsValid(Self))
+    if (!EncodePose(Bones, PoseCodecSettings, Payload))
+    {
+        return false;
+    }
+    return SendMocapOnChannelOwned(ChannelName, MoveTemp(Payload));
+}
+
+bool ULiveKitPublisherComponent::SetChannelPosePlayout(FName ChannelName, bool bEnable, int32 BoneCount, int32 MinDelayMs, int32 MaxDelayMs)
+{
+    if (!bEnable)
+    {
+        return PosePlayouts.Remove(ChannelName) > 0;
+    }
+    if (BoneCount <= 0)
+    {
+        UE_LOG(LogLiveKitBridge, Warning, TEXT("SetChannelPosePlayout: BoneCount must be positive"));
+        return false;
+    }
+    TUniquePtr<FLiveKitPosePlayout> Playout = MakeUnique<FLiveKitPosePlayout>();
+    Playout->Config.bone_count = (uint32_t)BoneCount;
+    Playout->Config.min_delay_ms = FMath::Max(0, MinDelayMs);
+    Playout->Config.max_delay_ms = FMath::Max(0, MaxDelayMs);
+    Playout->Scratch.SetNumUninitialized(BoneCount);
+    PosePlayouts.Add(ChannelName, MoveTemp(Playout)); // replaces (and destroys) existing buffers
+    return true;
+}
+
+void ULiveKitPublisherComponent::PushPosePlayout(const FLiveKitInboundMessage& Message)
+{
+    TUniquePtr<FLiveKitPosePlayout>* PlayoutPtr = PosePlayouts.Find(Message.Channel);
+    if (!PlayoutPtr)
+    {
+        return;
+    }
+    FLiveKitPosePlayout& Playout = **PlayoutPtr;
+    // Deferred packets are decoded straight from the FFI buffer
+    const uint8* Bytes = Message.Deferred.Buffer ? Message.Deferred.Bytes : Message.Payload.GetData();
+    const size_t Len = Message.Deferred.Buffer ? (size_t)Message.Deferred.Len : (size_t)Message.Payload.Num();
+    size_t Count = 0;
+    LkResult r = lk_pose_decode(Bytes, Len, Playout.Scratch.GetData(), (size_t)Playout.Scratch.Num(), &Count);
+    if (r.message) { lk_free_str((char*)r.message); }
+    if (r.code != 0 || Count != (size_t)Playout.Scratch.Num())
+    {
+        return; // not a pose packet, or a different skeleton
+    }
+    LkPlayoutBuffer*& Buffer = Playout.Senders.FindOrAdd(Message.SenderId);
+    if (!Buffer)
+    {
+        Buffer = lk_playout_create(&Playout.Config);
+        if (!Buffer) return;
+    }
+    // Without a sender time, arrival order and spacing are all the buffer has to go on
+    const int64 SampleTimeUs = Message.SenderTimeUs > 0 ? Message.SenderTimeUs : Message.ArrivalUs;
+    r = lk_playout_push(Buffer, SampleTimeUs, Message.ArrivalUs, Playout.Scratch.GetData(), Count);
+    if (r.message) { lk_free_str((char*)r.message); }
+}
+
+bool ULiveKitPublisherComponent::SamplePose(FName ChannelName, int32 SenderId, TArray<FTransform>& OutBones)
+{
+    OutBones.Reset();
+    TUniquePtr<FLiveKitPosePlayout>* PlayoutPtr = PosePlayouts.Find(ChannelName);
+    LkPlayoutBuffer* const* Buffer = PlayoutPtr ? (*PlayoutPtr)->Senders.Find((uint32)SenderId) : nullptr;
+    if (!Buffer)
+    {
+        return false;
+    }
+    TArray<LkBoneTransform>& Raw = (*PlayoutPtr)->Scratch;
+    LkPlayoutMode Mode = LkPlayoutEmpty;
+    LkResult r = lk_playout_sample(*Buffer, lk_now_local_us(), Raw.GetData(), (size_t)Raw.Num(), &Mode);
+    if (r.message) { lk_free_str((char*)r.message); }
+    if (r.code != 0 || Mode == LkPlayoutEmpty)
+    {
+        return false;
+    }
+    OutBones.Reserve(Raw.Num());
+    for (const LkBoneTransform& B : Raw)
+    {
+        OutBones.Emplace(FQuat(B.rotation[0], B.rotation[1], B.rotation[2], B.rotation[3]), FVector(B.position[0], B.position[1], B.position[2]), FVector(B.scale[0], B.scale[1], B.scale[2]));
+    }
+    return true;
+}
+
+FLiveKitPosePlayoutStats ULiveKitPublisherComponent::GetPosePlayoutStats(FName ChannelName, int32 SenderId) const
+{
+    FLiveKitPosePlayoutStats Out;
+    const TUniquePtr<FLiveKitPosePlayout>* PlayoutPtr = PosePlayouts.Find(ChannelName);
+    LkPlayoutBuffer* const* Buffer = PlayoutPtr ? (*PlayoutPtr)->Senders.Find((uint32)SenderId) : nullptr;
+    LkPlayoutStats Stats{};
+    if (!Buffer)
+    {
+        return Out;
+    }
+    LkResult r = lk_playout_get_stats(*Buffer, &Stats);
+    if (r.message) { lk_free_str((char*)r.message); }
+    if (r.code == 0)
+    {
+        Out.Depth = Stats.depth;
+        Out.TargetDelayMs = Stats.target_delay_us / 1000.f;
+        Out.JitterMs = Stats.jitter_us / 1000.f;
+        Out.FramesPushed = Stats.frames_pushed;
+        Out.LateDropped = Stats.late_dropped;
+        Out.Interpolated = Stats.interpolated;
+        Out.Extrapolated = Stats.extrapolated;
+        Out.Held = Stats.held;
+    }
+    return Out;
+}
+
+void ULiveKitPublisherComponent::EnqueueInbound(FName Channel, uint32 SenderId, int32 StateKey, const uint8_t* Bytes, size_t Len)
+{
+    if (!InboundQueue.IsValid()) return;
+
+    // Runs on an FFI thread: no logging or task posts per packet, only counters
+    LIVEKIT_SCOPE(STAT_LiveKit_EnqueueInbound, TEXT("LiveKit.EnqueueInbound"));
+    INC_DWORD_STAT(STAT_LiveKit_DataCallbacks);
+    InboundPacketsReceived.fetch_add(1, std::memory_order_relaxed);
+    InboundBytesReceived.fetch_add((int64)Len, std::memory_order_relaxed);
+
+    FLiveKitInboundMessage Message;
+    Message.Channel = Channel;
+    Message.SenderId = SenderId;
+    Message.StateKey = StateKey;
+    // The sender time is only readable inside the FFI callback delivering the message
+    Message.SenderTimeUs = lk_data_sender_time_us();
+    Message.ArrivalUs = lk_now_local_us();
+    InboundBufferPool->Dequeue(Message.Payload); // reuse a recycled buffer when one is available
+    Message.Payload.Reset();
+    Message.Payload.Append(Bytes, (int32)Len);
+    if (!InboundQueue->Enqueue(MoveTemp(Message)))
+    {
+        InboundPacketsDropped.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void ULiveKitPublisherComponent::EnqueueInboundDeferred(FName Channel, uint32 SenderId, const uint8_t* Bytes, size_t Len, LkDataBuffer* Buffer)
+{
+    if (!InboundQueue.IsValid()) { lk_data_release(Buffer); return; }
+
+    LIVEKIT_SCOPE(STAT_LiveKit_EnqueueInbound, TEXT("LiveKit.EnqueueInbound"));
+    INC_DWORD_STAT(STAT_LiveKit_DataCallbacks);
+    InboundPacketsReceived.fetch_add(1, std::memory_order_relaxed);
+    InboundBytesReceived.fetch_add((int64)Len, std::memory_order_relaxed);
+
+    FLiveKitInboundMessage Message;
+    Message.Channel = Channel;
+    Message.SenderId = SenderId;
+    Message.SenderTimeUs = lk_data_sender_time_us();
+    Message.ArrivalUs = lk_now_local_us();
+    Message.Deferred.Buffer = Buffer;
+    Message.Deferred.Bytes = Bytes;
+    Message.Deferred.Len = (int32)Len;
+    if (!InboundQueue->Enqueue(MoveTemp(Message)))
+    {
+        lk_data_release(Buffer);
+        InboundPacketsDropped.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+bool ULiveKitPublisherComponent::SetChannelSequenced(FName ChannelName, bool bSequenced)
+{
+    const TUniquePtr<LiveKitDataChannel>* ChannelPtr = DataChannels.Find(ChannelName);
+    if (!Client || !ChannelPtr)
+    {
+        return false;
+    }
+    return Client->SetReceiveFilter((*ChannelPtr)->GetLabel(), bSequenced ? LkReceiveSequenced : LkReceiveDedup);
+}
+
+bool ULiveKitPublisherComponent::SetChannelPriority(FName ChannelName, int32 Priority, int32 Weight, int32 RateLimitBytesPerSec, int32 BurstBytes)
+{
+    const TUniquePtr<LiveKitDataChannel>* ChannelPtr = DataChannels.Find(ChannelName);
+    if (!Client || !ChannelPtr)
+    {
+        return false;
+    }
+    const LkDataClassConfig Config{ Priority, FMath::Max(1, Weight), FMath::Max(0, RateLimitBytesPerSec), FMath::Max(0, BurstBytes) };
+    if (!Client->SetDataClass((*ChannelPtr)->GetLabel(), &Config))
+    {
+        return false;
+    }
+    ClassedChannels.Add(ChannelName);
+    return true;
+}
+
+FLiveKitChannelSendStats ULiveKitPublisherComponent::GetChannelSendStats(FName ChannelName) const
+{
+    FLiveKitChannelSendStats Out;
+    const TUniquePtr<LiveKitDataChannel>* ChannelPtr = DataChannels.Find(ChannelName);
+    LkDataClassStats Stats{};
+    if (Client && ChannelPtr && Client->GetDataClassStats((*ChannelPtr)->GetLabel(), Stats))
+    {
+        Out.QueueDepth = Stats.queue_depth;
+        Out.SentMessages = Stats.sent_messages;
+        Out.SentBytes = Stats.sent_bytes;
+        Out.ExpiredDropped = Stats.expired_dropped;
+        Out.WaitP50Ms = Stats.wait_p50_us / 1000.f;
+        Out.WaitP95Ms = Stats.wait_p95_us / 1000.f;
+        Out.WaitP99Ms = Stats.wait_p99_us / 1000.f;
+    }
+    return Out;
+}
+
+bool ULiveKitPublisherComponent::SetChannelDeltaCoding(FName ChannelName, bool bEnable, int32 KeyframeInterval, bool bLz4)
+{
+    const TUniquePtr<LiveKitDataChannel>* ChannelPtr = DataChannels.Find(ChannelName);
+    if (!Client || !ChannelPtr)
+    {
+        return false;
+    }
+    return Client->SetDeltaChannel((*ChannelPtr)->GetLabel(), bEnable ? FMath::Max(1, KeyframeInterval) : 0, bLz4);
+}
+
+FLiveKitDeltaStats ULiveKitPublisherComponent::GetChannelDeltaStats(FName ChannelName) const
+{
+    FLiveKitDeltaStats Out;
+    const TUniquePtr<LiveKitDataChannel>* ChannelPtr = DataChannels.Find(ChannelName);
+    LkDeltaStats Stats{};
+    if (Client && ChannelPtr && Client->GetDeltaStats((*ChannelPtr)->GetLabel(), Stats))
+    {
+        Out.FramesSent = Stats.frames_sent;
+        Out.KeyframesSent = Stats.keyframes_sent;
+        Out.CompressionRatio = (float)Stats.compression_ratio;
+        Out.EncodeMicrosPerFrame = Stats.encode_ns_per_frame / 1000.f;
+        Out.FramesReceived = Stats.frames_received;
+        Out.DecodeMicrosPerFrame = Stats.decode_ns_per_frame / 1000.f;
+        Out.UndecodableDropped = Stats.undecodable_dropped;
+    }
+    return Out;
+}
+
+bool ULiveKitPublisherComponent::SetChannelCompression(FName ChannelName, ELiveKitCompression Codec, int32 Level, const TArray<uint8>& Dictionary)
+{
+    const TUniquePtr<LiveKitDataChannel>* ChannelPtr = DataChannels.Find(ChannelName);
+    if (!Client || !ChannelPtr)
+    {
+        return false;
+    }
+    const LkCompression LkCodec = Codec == ELiveKitCompression::Lz4 ? LkCompressionLz4
+        : Codec == ELiveKitCompression::Zstd ? LkCompressionZstd : LkCompressionNone;
+    return Client->SetDataCompression((*ChannelPtr)->GetLabel(), LkCodec, Level, Dictionary);
+}
+
+FLiveKitCompressionStats ULiveKitPublisherComponent::GetCompressionStats() const
+{
+    FLiveKitCompressionStats Out;
+    LkDataStats Stats{};
+    if (Client && Client->GetDataStats(Stats))
+    {
+        Out.CompressedMessages = Stats.compressed_messages;
+        Out.RawBytes = Stats.compressed_raw_bytes;
+        Out.WireBytes = Stats.compressed_wire_bytes;
+        Out.CompressionRatio = (float)Stats.compression_ratio;
+        Out.DecompressFailed = Stats.decompress_failed;
+    }
+    return Out;
+}
+
+bool ULiveKitPublisherComponent::SetChannelFec(FName ChannelName, int32 GroupSize)
+{
+    const TUniquePtr<LiveKitDataChannel>* ChannelPtr = DataChannels.Find(ChannelName);
+    if (!Client || !ChannelPtr)
+    {
+        return false;
+    }
+    return Client->SetDataFec((*ChannelPtr)->GetLabel(), GroupSize);
+}
+
+FLiveKitFecStats ULiveKitPublisherComponent::GetFecStats() const
+{
+    FLiveKitFecStats Out;
+    LkDataStats Stats{};
+    if (Client && Client->GetDataStats(Stats))
+    {
+        Out.ProtectedMessages = Stats.fec_messages;
+        Out.ParityPackets = Stats.fec_parity_packets;
+        Out.OverheadRatio = (float)Stats.fec_overhead_ratio;
+        Out.Recovered = Stats.fec_recovered;
+        Out.Unrecovered = Stats.fec_unrecovered;
+    }
+    return Out;
+}
+
+bool ULiveKitPublisherComponent::SetChannelRateControl(FName ChannelName, float MinHz, float MaxHz)
+{
+    const TUniquePtr<LiveKitDataChannel>* ChannelPtr = DataChannels.Find(ChannelName);
+    if (!Client || !ChannelPtr)
+    {
+        return false;
+    }
+    return Client->SetRateControl((*ChannelPtr)->GetLabel(), MinHz, MaxHz);
+}
+
+float ULiveKitPublisherComponent::GetRecommendedRate(FName ChannelName) const
+{
+    const TUniquePtr<LiveKitDataChannel>* ChannelPtr = DataChannels.Find(ChannelName);
+    float Hz = 0.f;
+    if (!Client || !ChannelPtr || !Client->GetRecommendedRate((*ChannelPtr)->GetLabel(), Hz))
+    {
+        return 0.f;
+    }
+    return Hz;
+}
+
+FLiveKitLinkStats ULiveKitPublisherComponent::GetLinkStats() const
+{
+    FLiveKitLinkStats Out;
+    LkLinkStats Stats{};
+    if (Client && Client->GetLinkStats(Stats))
+    {
+        Out.RttMs = Stats.rtt_us / 1000.f;
+        Out.Loss = (float)Stats.loss;
+        Out.AvailableOutgoingKbps = (float)(Stats.available_outgoing_bps / 1000.0);
+        Out.Quality = (ELiveKitConnectionQuality)Stats.quality;
+    }
+    return Out;
+}
+
+bool ULiveKitPublisherComponent::SetChannelTimestamps(FName ChannelName, bool bEnable)
+{
+    const TUniquePtr<LiveKitDataChannel>* ChannelPtr = DataChannels.Find(ChannelName);
+    if (!Client || !ChannelPtr)
+    {
+        return false;
+    }
+    return Client->SetDataTimestamps((*ChannelPtr)->GetLabel(), bEnable);
+}
+
+FLiveKitClockSyncStats ULiveKitPublisherComponent::GetClockSyncStats() const
+{
+    FLiveKitClockSyncStats Out;
+    LkClockSyncStats Stats{};
+    if (Client && Client->GetClockSyncStats(Stats))
+    {
+        Out.bSynced = Stats.synced != 0;
+        Out.ReferenceParticipantId = (int32)Stats.reference_participant_id;
+        Out.OffsetMs = Stats.offset_us / 1000.f;
+        Out.RttMs = Stats.rtt_us / 1000.f;
+        Out.Samples = Stats.samples;
+        Out.Outliers = Stats.outliers;
+    }
+    return Out;
+}
+
+int64 ULiveKitPublisherComponent::GetSyncedTimeMicros() const
+{
+    return Client ? Client->NowSyncedUs() : lk_now_local_us();
+}
+
+bool ULiveKitPublisherComponent::SetChannelMaxAge(FName ChannelName, int32 MaxAgeMs)
+{
+    TUniquePtr<LiveKitDataChannel>* ChannelPtr = DataChannels.Find(ChannelName);
+    if (!ChannelPtr)
+    {
+        return false;
+    }
+    (*ChannelPtr)->SetMaxAgeMs(MaxAgeMs);
+    return true;
+}
+
+bool ULiveKitPublisherComponent::CreateStateChannel(FName ChannelName, const FString& Label, bool bReliable, int32 TickHz)
+{
+    if (!Client)
+    {
+        UE_LOG(LogLiveKitBridge, Warning, TEXT("CreateStateChannel called before LiveKit client is ready"));
+        return false;
+    }
+    if (ChannelName.IsNone() || Label.IsEmpty() || StateChannels.Contains(ChannelName))
+    {
+        UE_LOG(LogLiveKitBridge, Warning, TEXT("CreateStateChannel invalid or duplicate channel '%s'"), *ChannelName.ToString());
+        return false;
+    }
+    // One state handler per label, as with data channels
+    for (const TPair<FName, TUniquePtr<LiveKitStateChannel>>& Pair : StateChannels)
+    {
+        if (Pair.Value->GetLabel() == Label)
         {
-            Self->OnMocapReceived(Payload);
+            UE_LOG(LogLiveKitBridge, Warning, TEXT("CreateStateChannel skipped: label '%s' already used by '%s'"), *Label, *Pair.Key.ToString());
+            return false;
         }
-    });
+    }
+    TUniquePtr<LiveKitStateChannel> Channel = Client->CreateStateChannel(Label, bReliable, TickHz);
+    if (!Channel.IsValid())
+    {
+        UE_LOG(LogLiveKitBridge, Warning, TEXT("CreateStateChannel failed to create '%s'"), *ChannelName.ToString());
+        return false;
+    }
+    StateChannels.Add(ChannelName, MoveTemp(Channel));
+
+    if (bReceiveMocap)
+    {
+        TUniquePtr<FLiveKitInboundChannel> Inbound = MakeUnique<FLiveKitInboundChannel>();
+        Inbound->Owner = this;
+        Inbound->Channel = ChannelName;
+        Inbound->Label = Label;
+        if (Client->RegisterStateHandler(Label, &ULiveKitPublisherComponent::StateHandlerThunk, Inbound.Get()))
+        {
+            InboundStateChannels.Add(ChannelName, MoveTemp(Inbound));
+        }
+    }
+    UE_LOG(LogLiveKitBridge, Log, TEXT("Created state channel '%s' (label='%s', reliable=%s, %d Hz)"),
+        *ChannelName.ToString(), *Label, bReliable?TEXT("true"):TEXT("false"), TickHz);
+    return true;
+}
+
+bool ULiveKitPublisherComponent::DestroyStateChannel(FName ChannelName)
+{
+    if (TUniquePtr<FLiveKitInboundChannel>* Inbound = InboundStateChannels.Find(ChannelName))
+    {
+        if (Client) { Client->RegisterStateHandler((*Inbound)->Label, nullptr, nullptr); }
+        InboundStateChannels.Remove(ChannelName);
+    }
+    return StateChannels.Remove(ChannelName) > 0;
+}
+
+bool ULiveKitPublisherComponent::WriteState(FName ChannelName, int32 Key, const TArray<uint8>& Value)
+{
+    TUniquePtr<LiveKitStateChannel>* ChannelPtr = StateChannels.Find(ChannelName);
+    if (!ChannelPtr || Key < 0)
+    {
+        return false;
+    }
+    // Cheap: copies into the key's slot; superseded values never hit the network
+    return (*ChannelPtr)->Write((uint32)Key, Value);
+}
+
+int64 ULiveKitPublisherComponent::SendLargePayload(const FString& Label, const TArray<uint8>& Payload)
+{
+    // Blueprint arrays arrive by const reference; native callers use the Owned variant
+    return SendLargePayloadOwned(Label, TArray<uint8>(Payload));
+}
+
+int64 ULiveKitPublisherComponent::SendLargePayloadOwned(const FString& Label, TArray<uint8>&& Payload)
+{
+    if (!Client || Payload.Num() == 0)
+    {
+        return 0;
+    }
+    // The FFI streams straight from this buffer, so it must outlive the transfer
+    const int32 N = Payload.Num();
+    TUniquePtr<TArray<uint8>> Buffer = MakeUnique<TArray<uint8>>(MoveTemp(Payload));
+    uint64 TransferId = 0;
+    LIVEKIT_SCOPE(STAT_LiveKit_SendData, TEXT("LiveKit.SendData"));
+    const bool bOk = Client->SendLarge(Buffer->GetData(), (size_t)Buffer->Num(), Label, &ULiveKitPublisherComponent::TransferThunk, this, &TransferId);
+    CountSend(bOk, N);
+    if (!bOk)
+    {
+        OnMocapSendFailed(N, true, Client->GetLastErrorMessage());
+        return 0;
+    }
+    LargeTransfers.Add((int64)TransferId, MoveTemp(Buffer));
+    return (int64)TransferId;
+}
+
+bool ULiveKitPublisherComponent::CancelLargeTransfer(int64 TransferId)
+{
+    return Client && LargeTransfers.Contains(TransferId) && Client->CancelTransfer((uint64)TransferId);
+}
+
+/* static */ void ULiveKitPublisherComponent::DataHandlerThunk(void* User, const LkDataMessageInfo* Info, const uint8_t* bytes, size_t len)
+{
+    if (!User || !Info || !bytes || len == 0) return;
+    const FLiveKitInboundChannel* Inbound = reinterpret_cast<const FLiveKitInboundChannel*>(User);
+    Inbound->Owner->EnqueueInbound(Inbound->Channel, Info->participant_id, -1, bytes, len);
+}
+
+/* static */ void ULiveKitPublisherComponent::StateHandlerThunk(void* User, const LkDataMessageInfo* Info, uint32_t key, const uint8_t* bytes, size_t len)
+{
+    if (!User || !Info || !bytes || len == 0) return;
+    const FLiveKitInboundChannel* Inbound = reinterpret_cast<const FLiveKitInboundChannel*>(User);
+    Inbound->Owner->EnqueueInbound(Inbound->Channel, Info->participant_id, (int32)key, bytes, len);
 }
 
-/* static */ void ULiveKitPublisherComponent::AudioThunk(void* User, const int16_t* pcm, size_t frames_per_channel, int32_t channels, int32_t sample_rate)
+/* static */ void ULiveKitPublisherComponent::DataThunkFrom(void* User, uint32_t participant_id, const char* label, LkReliability reliability, const uint8_t* bytes, size_t len)
+{
+    if (!User || !bytes || len == 0) return;
+    ULiveKitPublisherComponent* Self = reinterpret_cast<ULiveKitPublisherComponent*>(User);
+    // Catch-all for labels without a registered channel
+    Self->EnqueueInbound(Self->CallbackLabelName(label), participant_id, -1, bytes, len);
+}
+
+/* static */ void ULiveKitPublisherComponent::DataThunkBuffered(void* User, uint32_t participant_id, const char* label, LkReliability reliability, const uint8_t* bytes, size_t len, LkDataBuffer* buffer)
+{
+    if (!User || !bytes || len == 0) { lk_data_release(buffer); return; }
+    ULiveKitPublisherComponent* Self = reinterpret_cast<ULiveKitPublisherComponent*>(User);
+    Self->EnqueueInboundDeferred(Self->CallbackLabelName(label), participant_id, bytes, len, buffer);
+}
+
+FName ULiveKitPublisherComponent::CallbackLabelName(const char* Label)
+{
+    if (!Label) return NAME_None;
+    // A handful of labels in practice: a byte compare beats converting and hashing per packet
+    for (const TPair<TArray<ANSICHAR>, FName>& Entry : CallbackLabelNames)
+    {
+        if (FCStringAnsi::Strcmp(Entry.Key.GetData(), Label) == 0) return Entry.Value;
+    }
+    const FName Name(UTF8_TO_TCHAR(Label));
+    // Bounded so a peer cycling through labels cannot grow it
+    if (CallbackLabelNames.Num() < LiveKitMaxCachedLabels)
+    {
+        TArray<ANSICHAR> Key;
+        Key.Append(Label, FCStringAnsi::Strlen(Label) + 1);
+        CallbackLabelNames.Emplace(MoveTemp(Key), Name);
+    }
+    return Name;
+}
+
+/* static */ void ULiveKitPublisherComponent::AudioThunkIds(void* User, const int16_t* pcm, size_t frames_per_channel, int32_t channels, int32_t sample_rate, uint32_t participant_id, uint32_t track_id)
 {
     if (!User || !pcm || frames_per_channel == 0 || channels <= 0 || sample_rate <= 0) return;
     ULiveKitPublisherComponent* Self = reinterpret_cast<ULiveKitPublisherComponent*>(User);
     if (!IsValid(Self)) return;
+    INC_DWORD_STAT(STAT_LiveKit_AudioCallbacks);
 
-    // Log first frame and then every ~100 frames to avoid spam
+    // Log first frame and then every ~100 frames to avoid spam; IDs resolve via the registry
     Self->AudioFrameCount++;
     if (!Self->bLoggedFirstAudioFrame)
     {
         Self->bLoggedFirstAudioFrame = true;
-        UE_LOG(LogLiveKitBridge, Log, TEXT("Remote audio frame: sr=%d ch=%d fpc=%d"), sample_rate, channels, (int32)frames_per_channel);
+        UE_LOG(LogLiveKitBridge, Log, TEXT("Remote audio frame: participant=%u track=%u sr=%d ch=%d fpc=%d"), participant_id, track_id, sample_rate, channels, (int32)frames_per_channel);
         AsyncTask(ENamedThreads::GameThread, [Self, sample_rate, channels, frames_per_channel]()
         {
             if (IsValid(Self)) { Self->OnFirstAudioReceived(sample_rate, channels, (int32)frames_per_channel); }
@@ -343,32 +1456,98 @@ bool ULiveKitPublisherComponent::SendMocapOnChannel(FName ChannelName, const TAr
     }
     else if ((Self->AudioFrameCount % 100) == 0)
     {
-        UE_LOG(LogLiveKitBridge, VeryVerbose, TEXT("Remote audio frame #%lld: sr=%d ch=%d fpc=%d"), (long long)Self->AudioFrameCount, sample_rate, channels, (int32)frames_per_channel);
+        UE_LOG(LogLiveKitBridge, VeryVerbose, TEXT("Remote audio frame #%lld: participant=%u track=%u sr=%d ch=%d fpc=%d"), (long long)Self->AudioFrameCount, participant_id, track_id, sample_rate, channels, (int32)frames_per_channel);
     }
 }
 
-/* static */ void ULiveKitPublisherComponent::AudioThunkEx(void* User, const int16_t* pcm, size_t frames_per_channel, int32_t channels, int32_t sample_rate, const char* participant_name, const char* track_name)
+/* static */ void ULiveKitPublisherComponent::TransferThunk(void* User, uint64_t transfer_id, LkTransferState state, uint64_t bytes_done, uint64_t bytes_total)
 {
-    if (!User || !pcm || frames_per_channel == 0 || channels <= 0 || sample_rate <= 0 || !participant_name || !track_name) return;
     ULiveKitPublisherComponent* Self = reinterpret_cast<ULiveKitPublisherComponent*>(User);
-    if (!IsValid(Self)) return;
+    if (!Self) return;
+    AsyncTask(ENamedThreads::GameThread, [Self, transfer_id, state, bytes_done, bytes_total]()
+    {
+        if (!IsValid(Self)) return;
+        if (state == LkTransferInProgress)
+        {
+            Self->OnLargeTransferProgress((int64)transfer_id, (int64)bytes_done, (int64)bytes_total);
+            return;
+        }
+        // Terminal: the FFI no longer reads the buffer
+        Self->LargeTransfers.Remove((int64)transfer_id);
+        const bool bSuccess = (state == LkTransferCompleted);
+        UE_LOG(LogLiveKitBridge, Log, TEXT("LiveKit large transfer %llu %s (%llu/%llu bytes)"), transfer_id, bSuccess ? TEXT("completed") : (state == LkTransferCancelled ? TEXT("cancelled") : TEXT("failed")), bytes_done, bytes_total);
+        Self->OnLargeTransferFinished((int64)transfer_id, bSuccess);
+    });
+}
 
-    // Log first frame and then every ~100 frames to avoid spam (with per-subject identification)
-    Self->AudioFrameCount++;
-    const FString ParticipantName = UTF8_TO_TCHAR(participant_name);
-    const FString TrackName = UTF8_TO_TCHAR(track_name);
-    if (!Self->bLoggedFirstAudioFrame)
+/* static */ void ULiveKitPublisherComponent::RegistryThunk(void* User, LkRegistryEvent event, uint32_t participant_id, uint32_t track_id, const char* participant_identity, const char* track_name)
+{
+    ULiveKitPublisherComponent* Self = reinterpret_cast<ULiveKitPublisherComponent*>(User);
+    if (!Self || !IsValid(Self)) return;
+    // One-time events: converting strings here is fine, hot callbacks only carry the IDs
+    const FString Identity = participant_identity ? FString(UTF8_TO_TCHAR(participant_identity)) : FString();
+    const FString TrackName = track_name ? FString(UTF8_TO_TCHAR(track_name)) : FString();
+    AsyncTask(ENamedThreads::GameThread, [Self, event, participant_id, track_id, Identity, TrackName]()
     {
-        Self->bLoggedFirstAudioFrame = true;
-        UE_LOG(LogLiveKitBridge, Log, TEXT("Remote audio frame: participant='%s' track='%s' sr=%d ch=%d fpc=%d"), *ParticipantName, *TrackName, sample_rate, channels, (int32)frames_per_channel);
-        AsyncTask(ENamedThreads::GameThread, [Self, sample_rate, channels, frames_per_channel]()
+        if (!IsValid(Self)) return;
+        switch (event)
         {
-            if (IsValid(Self)) { Self->OnFirstAudioReceived(sample_rate, channels, (int32)frames_per_channel); }
-        });
-    }
-    else if ((Self->AudioFrameCount % 100) == 0)
+            case LkParticipantJoined:
+                Self->ParticipantIdentities.Add((int32)participant_id, Identity);
+                UE_LOG(LogLiveKitBridge, Log, TEXT("LiveKit participant joined: id=%u identity='%s'"), participant_id, *Identity);
+                Self->OnParticipantJoined((int32)participant_id, Identity);
+                break;
+            case LkParticipantLeft:
+                UE_LOG(LogLiveKitBridge, Log, TEXT("LiveKit participant left: id=%u identity='%s'"), participant_id, *Identity);
+                // Its playout buffers would otherwise live until the channel is reconfigured
+                for (TPair<FName, TUniquePtr<FLiveKitPosePlayout>>& Playout : Self->PosePlayouts)
+                {
+                    Playout.Value->RemoveSender(participant_id);
+                }
+                Self->OnParticipantLeft((int32)participant_id, Identity);
+                break;
+            case LkTrackSubscribed:
+                Self->ParticipantIdentities.Add((int32)participant_id, Identity);
+                UE_LOG(LogLiveKitBridge, Log, TEXT("LiveKit track subscribed: id=%u name='%s' participant=%u"), track_id, *TrackName, participant_id);
+                Self->OnRemoteTrackSubscribed((int32)participant_id, (int32)track_id, TrackName);
+                break;
+            case LkTrackUnsubscribed:
+                UE_LOG(LogLiveKitBridge, Verbose, TEXT("LiveKit track unsubscribed: id=%u name='%s'"), track_id, *TrackName);
+                break;
+        }
+    });
+}
+
+/* static */ void ULiveKitPublisherComponent::RateThunk(void* User, const char* label, float hz)
+{
+    ULiveKitPublisherComponent* Self = reinterpret_cast<ULiveKitPublisherComponent*>(User);
+    if (!Self || !label) return;
+    const FString Label = UTF8_TO_TCHAR(label);
+    AsyncTask(ENamedThreads::GameThread, [Self, Label, hz]()
+    {
+        if (!IsValid(Self)) return;
+        for (const TPair<FName, TUniquePtr<LiveKitDataChannel>>& Pair : Self->DataChannels)
+        {
+            if (Pair.Value->GetLabel() == Label)
+            {
+                UE_LOG(LogLiveKitBridge, Verbose, TEXT("LiveKit recommended rate for '%s': %.1f Hz"), *Pair.Key.ToString(), hz);
+                Self->OnRecommendedRateChanged(Pair.Key, hz);
+            }
+        }
+    });
+}
+
+/* static */ void ULiveKitPublisherComponent::LogThunk(void* User, LkLogLevel level, const char* target, const char* message, int64_t timestamp_us)
+{
+    // Runs on the FFI log thread; UE_LOG is thread-safe and stamps its own time
+    if (!message) return;
+    switch (level)
     {
-        UE_LOG(LogLiveKitBridge, VeryVerbose, TEXT("Remote audio frame #%lld: participant='%s' track='%s' sr=%d ch=%d fpc=%d"), (long long)Self->AudioFrameCount, *ParticipantName, *TrackName, sample_rate, channels, (int32)frames_per_channel);
+        case LkLogError: UE_LOG(LogLiveKitBridge, Error, TEXT("[ffi] %s"), UTF8_TO_TCHAR(message)); break;
+        case LkLogWarn:  UE_LOG(LogLiveKitBridge, Warning, TEXT("[ffi] %s"), UTF8_TO_TCHAR(message)); break;
+        case LkLogInfo:  UE_LOG(LogLiveKitBridge, Log, TEXT("[ffi] %s"), UTF8_TO_TCHAR(message)); break;
+        case LkLogDebug: UE_LOG(LogLiveKitBridge, Verbose, TEXT("[ffi] %s"), UTF8_TO_TCHAR(message)); break;
+        default:         UE_LOG(LogLiveKitBridge, VeryVerbose, TEXT("[ffi] %s"), UTF8_TO_TCHAR(message)); break;
     }
 }
 
@@ -440,8 +1619,8 @@ void ULiveKitPublisherComponent::StartTestData()
         TArray<uint8> Payload;
         Payload.SetNumUninitialized(N);
 
-        // Simple structure: [u64 time_us][u64 seq][padding pattern]
-        const uint64 NowUs = (uint64)(FPlatformTime::Seconds() * 1e6);
+        // Simple structure: [u64 time_us][u64 seq][padding pattern]; room clock, comparable across hosts once synced
+        const uint64 NowUs = (uint64)Client->NowSyncedUs();
         if (N >= 16)
         {
             FMemory::Memcpy(Payload.GetData() + 0, &NowUs, sizeof(uint64));
@@ -453,7 +1632,7 @@ void ULiveKitPublisherComponent::StartTestData()
             for (int32 i = 0; i < N; ++i) { Payload[i] = (uint8)(i ^ 0x5A); }
         }
         ++DataSeq;
-        UE_LOG(LogLiveKitBridge, Log, TEXT("SendMocap tick: seq=%llu size=%d reliable=%s"), (unsigned long long)(DataSeq-1), N, bTestDataReliable?TEXT("true"):TEXT("false"));
+        UE_LOG(LogLiveKitBridge, VeryVerbose, TEXT("SendMocap tick: seq=%llu size=%d reliable=%s"), (unsigned long long)(DataSeq-1), N, bTestDataReliable?TEXT("true"):TEXT("false"));
         SendMocap(Payload, bTestDataReliable);
     }, Period, true, 0.5f);
 }
@@ -15,16 +15,23 @@ public:
 
     bool IsValid() const { return Client != nullptr && !Label.IsEmpty(); }
     bool IsReliable() const { return Reliability == LkReliable; }
-    const FString& GetLabel() const { return Label; }
+    // Deadline for queued sends on this channel, targeted and owned ones included (0 = none)
+    // Deadline for queued sends on this channel (0 = none)
+    void SetMaxAgeMs(int32 InMaxAgeMs) { MaxAgeMs = FMath::Max(0, InMaxAgeMs); }
 
     bool Send(const void* Bytes, size_t Len) const;
     bool Send(const TArray<uint8>& Payload) const;
+    // Deliver only to the given interned participant IDs
+    bool SendTo(const TArray<uint8>& Payload, const TArray<uint32>& ParticipantIds) const;
+    // Hand the payload to the FFI without a copy; it is freed once sent
+    bool SendOwned(TArray<uint8>&& Payload) const;
 
 private:
     LiveKitClient* Client = nullptr;
     FString Label;
     LkReliability Reliability = LkReliable;
     bool bOrdered = true;
+    int32 MaxAgeMs = 0;
 };
 
 class LiveKitAudioTrack
@@ -50,6 +57,7 @@ public:
 
     bool PublishPCM(const int16_t* Interleaved, size_t FramesPerChannel) const;
     bool PublishPCM(const TArray<int16>& Frames, int32 FramesPerChannel) const;
+    bool GetStats(LkAudioTrackStats& OutStats) const;
 
     bool IsValid() const { return Handle != nullptr; }
     const FString& GetName() const { return Name; }
@@ -72,6 +80,30 @@ private:
     friend class LiveKitClient;
 };
 
+class LiveKitStateChannel
+{
+public:
+    LiveKitStateChannel(LkStateChannelHandle* InHandle, const FString& InLabel) : Handle(InHandle), Label(InLabel) {}
+    ~LiveKitStateChannel() { Reset(); }
+
+    LiveKitStateChannel(const LiveKitStateChannel&) = delete;
+    LiveKitStateChannel& operator=(const LiveKitStateChannel&) = delete;
+
+    // Stores the newest value for Key; it goes out on the channel's next tick unless overwritten first
+    bool Write(uint32 Key, const void* Bytes, size_t Len) const;
+    bool Write(uint32 Key, const TArray<uint8>& Value) const { return Write(Key, Value.GetData(), static_cast<size_t>(Value.Num())); }
+    bool GetStats(LkStateChannelStats& OutStats) const;
+
+    bool IsValid() const { return Handle != nullptr; }
+    const FString& GetLabel() const { return Label; }
+
+private:
+    void Reset();
+
+    LkStateChannelHandle* Handle = nullptr;
+    FString Label;
+};
+
 class LiveKitClient
 {
 public:
@@ -164,7 +196,8 @@ public:
         return ok;
     }
 
-    bool SendDataOnChannel(const void* Bytes, size_t Len, LkReliability Reliability, bool bOrdered, const FString& Label)
+    // MaxAgeMs > 0: queued, and discarded unsent if still queued after that long
+    bool SendDataOnChannel(const void* Bytes, size_t Len, LkReliability Reliability, bool bOrdered, const FString& Label, int32 MaxAgeMs = 0)
     {
         if (!Handle || Bytes == nullptr || Len == 0)
         {
@@ -172,7 +205,16 @@ public:
         }
         FTCHARToUTF8 Utf8Label(*Label);
         const char* LabelPtr = Utf8Label.Length() > 0 ? Utf8Label.Get() : nullptr;
-        LkResult r = lk_send_data_ex(Handle, static_cast<const uint8_t*>(Bytes), Len, Reliability, bOrdered ? 1 : 0, LabelPtr);
+        LkResult r;
+        if (MaxAgeMs > 0)
+        {
+            const LkSendOptions Opts{ Reliability, bOrdered ? 1 : 0, LabelPtr, MaxAgeMs };
+            r = lk_send_data_opts(Handle, static_cast<const uint8_t*>(Bytes), Len, &Opts);
+        }
+        else
+        {
+            r = lk_send_data_ex(Handle, static_cast<const uint8_t*>(Bytes), Len, Reliability, bOrdered ? 1 : 0, LabelPtr);
+        }
         const bool ok = (r.code == 0);
         if (!ok)
         {
@@ -191,6 +233,40 @@ public:
         return ok;
     }
 
+    bool SendDataToIds(const void* Bytes, size_t Len, LkReliability Reliability, bool bOrdered, const FString& Label, const TArray<uint32>& ParticipantIds, int32 MaxAgeMs = 0)
+    {
+        if (!Handle || Bytes == nullptr || Len == 0 || ParticipantIds.Num() == 0)
+        {
+            return false;
+        }
+        FTCHARToUTF8 Utf8Label(*Label);
+        const char* LabelPtr = Utf8Label.Length() > 0 ? Utf8Label.Get() : nullptr;
+        LkResult r = lk_send_data_to_ids(Handle, static_cast<const uint8_t*>(Bytes), Len, Reliability, bOrdered ? 1 : 0, LabelPtr, MaxAgeMs, ParticipantIds.GetData(), static_cast<size_t>(ParticipantIds.Num()));
+        const bool ok = (r.code == 0);
+        if (!ok) { CaptureError(r); if (r.message) { UE_LOG(LogTemp, Warning, TEXT("LiveKit send data to %d participants (channel '%s'): %s"), ParticipantIds.Num(), *Label, UTF8_TO_TCHAR(r.message)); lk_free_str((char*)r.message); } }
+        else if (r.message) { lk_free_str((char*)r.message); ClearError(); }
+        return ok;
+    }
+
+    // Moves Payload to the heap and lets the FFI send it in place; it is deleted from the
+    // release callback, which may run on an FFI worker thread
+    bool SendDataOwned(TArray<uint8>&& Payload, LkReliability Reliability, bool bOrdered, const FString& Label, int32 MaxAgeMs = 0)
+    {
+        if (!Handle || Payload.Num() == 0)
+        {
+            return false;
+        }
+        TArray<uint8>* Owned = new TArray<uint8>(MoveTemp(Payload));
+        FTCHARToUTF8 Utf8Label(*Label);
+        const char* LabelPtr = Utf8Label.Length() > 0 ? Utf8Label.Get() : nullptr;
+        // The release callback always runs, also on failure, so Owned is never leaked
+        LkResult r = lk_send_data_owned(Handle, Owned->GetData(), static_cast<size_t>(Owned->Num()), Reliability, bOrdered ? 1 : 0, LabelPtr, MaxAgeMs, &LiveKitClient::ReleaseOwnedThunk, Owned);
+        const bool ok = (r.code == 0);
+        if (!ok) { CaptureError(r); if (r.message) { UE_LOG(LogTemp, Warning, TEXT("LiveKit send owned data (channel '%s'): %s"), *Label, UTF8_TO_TCHAR(r.message)); lk_free_str((char*)r.message); } }
+        else if (r.message) { lk_free_str((char*)r.message); ClearError(); }
+        return ok;
+    }
+
     bool SendDataOnChannel(const TArray<uint8>& Payload, LkReliability Reliability, bool bOrdered, const FString& Label)
     {
         return SendDataOnChannel(Payload.GetData(), static_cast<size_t>(Payload.Num()), Reliability, bOrdered, Label);
@@ -214,6 +290,34 @@ public:
         return ok;
     }
 
+    bool SetDataCallbackEx(LkDataCallbackEx Cb, void* User)
+    {
+        LkResult r = lk_client_set_data_callback_ex(Handle, Cb, User);
+        const bool ok = (r.code == 0);
+        if (!ok) { CaptureError(r); if (r.message) { UE_LOG(LogTemp, Warning, TEXT("LiveKit set data callback (ex): %s"), UTF8_TO_TCHAR(r.message)); lk_free_str((char*)r.message); } }
+        else if (r.message) { lk_free_str((char*)r.message); ClearError(); }
+        return ok;
+    }
+
+    bool SetDataCallbackFrom(LkDataCallbackFrom Cb, void* User)
+    {
+        LkResult r = lk_client_set_data_callback_from(Handle, Cb, User);
+        const bool ok = (r.code == 0);
+        if (!ok) { CaptureError(r); if (r.message) { UE_LOG(LogTemp, Warning, TEXT("LiveKit set data callback (from): %s"), UTF8_TO_TCHAR(r.message)); lk_free_str((char*)r.message); } }
+        else if (r.message) { lk_free_str((char*)r.message); ClearError(); }
+        return ok;
+    }
+
+    // The callee owns each buffer and must pass it to lk_data_release
+    bool SetDataCallbackBuffered(LkDataCallbackBuffered Cb, void* User)
+    {
+        LkResult r = lk_client_set_data_callback_buffered(Handle, Cb, User);
+        const bool ok = (r.code == 0);
+        if (!ok) { CaptureError(r); if (r.message) { UE_LOG(LogTemp, Warning, TEXT("LiveKit set data callback (buffered): %s"), UTF8_TO_TCHAR(r.message)); lk_free_str((char*)r.message); } }
+        else if (r.message) { lk_free_str((char*)r.message); ClearError(); }
+        return ok;
+    }
+
     bool SetAudioCallback(LkAudioCallback Cb, void* User)
     {
         LkResult r = lk_client_set_audio_callback(Handle, Cb, User);
@@ -232,6 +336,392 @@ public:
         return ok;
     }
 
+    bool SetDataBatching(bool bEnabled, int32 FlushWindowMs = 0, int32 MaxPacketBytes = 0)
+    {
+        LkResult r = lk_set_data_batching(Handle, bEnabled ? 1 : 0, FlushWindowMs, MaxPacketBytes);
+        const bool ok = (r.code == 0);
+        if (!ok) { CaptureError(r); if (r.message) { UE_LOG(LogTemp, Warning, TEXT("LiveKit set data batching: %s"), UTF8_TO_TCHAR(r.message)); lk_free_str((char*)r.message); } }
+        else if (r.message) { lk_free_str((char*)r.message); ClearError(); }
+        return ok;
+    }
+
+    // Payload must stay alive until Cb reports a terminal state (or until Disconnect returns).
+    bool SendLarge(const uint8* Bytes, size_t Len, const FString& Label, LkTransferCallback Cb, void* User, uint64* OutTransferId)
+    {
+        FTCHARToUTF8 Utf8Label(*Label);
+        LkResult r = lk_send_large(Handle, Bytes, Len, Utf8Label.Get(), Cb, User, OutTransferId);
+        const bool ok = (r.code == 0);
+        if (!ok) { CaptureError(r); if (r.message) { UE_LOG(LogTemp, Warning, TEXT("LiveKit send large '%s': %s"), *Label, UTF8_TO_TCHAR(r.message)); lk_free_str((char*)r.message); } }
+        else if (r.message) { lk_free_str((char*)r.message); ClearError(); }
+        return ok;
+    }
+
+    bool CancelTransfer(uint64 TransferId)
+    {
+        LkResult r = lk_cancel_transfer(Handle, TransferId);
+        const bool ok = (r.code == 0);
+        if (!ok) { CaptureError(r); if (r.message) { UE_LOG(LogTemp, Verbose, TEXT("LiveKit cancel transfer %llu: %s"), TransferId, UTF8_TO_TCHAR(r.message)); lk_free_str((char*)r.message); } }
+        else if (r.message) { lk_free_str((char*)r.message); ClearError(); }
+        return ok;
+    }
+
+    bool SetAudioCallbackIds(LkAudioCallbackIds Cb, void* User)
+    {
+        LkResult r = lk_client_set_audio_callback_ids(Handle, Cb, User);
+        const bool ok = (r.code == 0);
+        if (!ok) { CaptureError(r); if (r.message) { UE_LOG(LogTemp, Warning, TEXT("LiveKit set audio callback (ids): %s"), UTF8_TO_TCHAR(r.message)); lk_free_str((char*)r.message); } }
+        else if (r.message) { lk_free_str((char*)r.message); ClearError(); }
+        return ok;
+    }
+
+    bool SetRegistryCallback(LkRegistryCallback Cb, void* User)
+    {
+        LkResult r = lk_set_registry_callback(Handle, Cb, User);
+        const bool ok = (r.code == 0);
+        if (!ok) { CaptureError(r); if (r.message) { UE_LOG(LogTemp, Warning, TEXT("LiveKit set registry callback: %s"), UTF8_TO_TCHAR(r.message)); lk_free_str((char*)r.message); } }
+        else if (r.message) { lk_free_str((char*)r.message); ClearError(); }
+        return ok;
+    }
+
+    bool RegisterDataHandler(const FString& Label, LkDataHandler Cb, void* User)
+    {
+        FTCHARToUTF8 Utf8Label(*Label);
+        LkResult r = lk_register_data_handler(Handle, Utf8Label.Get(), Cb, User);
+        const bool ok = (r.code == 0);
+        if (!ok) { CaptureError(r); if (r.message) { UE_LOG(LogTemp, Warning, TEXT("LiveKit register data handler '%s': %s"), *Label, UTF8_TO_TCHAR(r.message)); lk_free_str((char*)r.message); } }
+        else if (r.message) { lk_free_str((char*)r.message); ClearError(); }
+        return ok;
+    }
+
+    bool UnregisterDataHandler(const FString& Label)
+    {
+        return RegisterDataHandler(Label, nullptr, nullptr);
+    }
+
+    bool SetDataClass(const FString& Label, const LkDataClassConfig* Config)
+    {
+        FTCHARToUTF8 Utf8Label(*Label);
+        LkResult r = lk_set_data_class(Handle, Utf8Label.Get(), Config);
+        const bool ok = (r.code == 0);
+        if (!ok) { CaptureError(r); if (r.message) { UE_LOG(LogTemp, Warning, TEXT("LiveKit set data class '%s': %s"), *Label, UTF8_TO_TCHAR(r.message)); lk_free_str((char*)r.message); } }
+        else if (r.message) { lk_free_str((char*)r.message); ClearError(); }
+        return ok;
+    }
+
+    bool SetSendScheduler(LkSchedulerMode Mode)
+    {
+        LkResult r = lk_set_send_scheduler(Handle, Mode);
+        const bool ok = (r.code == 0);
+        if (!ok) { CaptureError(r); if (r.message) { UE_LOG(LogTemp, Warning, TEXT("LiveKit set send scheduler: %s"), UTF8_TO_TCHAR(r.message)); lk_free_str((char*)r.message); } }
+        else if (r.message) { lk_free_str((char*)r.message); ClearError(); }
+        return ok;
+    }
+
+    // 0 stops synchronizing; pings from peers are answered regardless
+    bool SetClockSync(int32 IntervalMs)
+    {
+        LkResult r = lk_set_clock_sync(Handle, IntervalMs);
+        const bool ok = (r.code == 0);
+        if (!ok) { CaptureError(r); if (r.message) { UE_LOG(LogTemp, Warning, TEXT("LiveKit set clock sync: %s"), UTF8_TO_TCHAR(r.message)); lk_free_str((char*)r.message); } }
+        else if (r.message) { lk_free_str((char*)r.message); ClearError(); }
+        return ok;
+    }
+
+    bool GetClockSyncStats(LkClockSyncStats& OutStats)
+    {
+        LkResult r = lk_get_clock_sync_stats(Handle, &OutStats);
+        const bool ok = (r.code == 0);
+        if (r.message) { lk_free_str((char*)r.message); }
+        return ok;
+    }
+
+    int64 NowSyncedUs() const
+    {
+        return lk_now_synced_us(Handle);
+    }
+
+    bool SetDataTimestamps(const FString& Label, bool bEnable)
+    {
+        FTCHARToUTF8 Utf8Label(*Label);
+        LkResult r = lk_set_data_timestamps(Handle, Utf8Label.Get(), bEnable ? 1 : 0);
+        const bool ok = (r.code == 0);
+        if (!ok) { CaptureError(r); if (r.message) { UE_LOG(LogTemp, Warning, TEXT("LiveKit set data timestamps '%s': %s"), *Label, UTF8_TO_TCHAR(r.message)); lk_free_str((char*)r.message); } }
+        else if (r.message) { lk_free_str((char*)r.message); ClearError(); }
+        return ok;
+    }
+
+    // GroupSize 2-32 messages per parity packet; 0 turns FEC off for the label
+    bool SetDataFec(const FString& Label, int32 GroupSize)
+    {
+        FTCHARToUTF8 Utf8Label(*Label);
+        LkResult r = lk_set_data_fec(Handle, Utf8Label.Get(), GroupSize);
+        const bool ok = (r.code == 0);
+        if (!ok) { CaptureError(r); if (r.message) { UE_LOG(LogTemp, Warning, TEXT("LiveKit set data FEC '%s': %s"), *Label, UTF8_TO_TCHAR(r.message)); lk_free_str((char*)r.message); } }
+        else if (r.message) { lk_free_str((char*)r.message); ClearError(); }
+        return ok;
+    }
+
+    bool GetLinkStats(LkLinkStats& OutStats)
+    {
+        LkResult r = lk_get_link_stats(Handle, &OutStats);
+        const bool ok = (r.code == 0);
+        if (r.message) { lk_free_str((char*)r.message); }
+        return ok;
+    }
+
+    // Cached from the once-a-second poll the first call starts; either output may be null
+    bool GetTransportStats(LkTransportStats* OutPublisher, LkTransportStats* OutSubscriber)
+    {
+        LkResult r = lk_get_transport_stats(Handle, OutPublisher, OutSubscriber);
+        const bool ok = (r.code == 0);
+        if (r.message) { lk_free_str((char*)r.message); }
+        return ok;
+    }
+
+    // Published tracks first, then subscribed ones
+    bool GetAudioTrackStats(TArray<LkAudioTrackStats>& OutTracks)
+    {
+        size_t Count = 0;
+        LkResult r = lk_get_audio_track_stats(Handle, nullptr, 0, &Count);
+        if (r.message) { lk_free_str((char*)r.message); }
+        if (r.code != 0) { OutTracks.Reset(); return false; }
+        OutTracks.SetNumZeroed((int32)Count);
+        r = lk_get_audio_track_stats(Handle, OutTracks.GetData(), Count, &Count);
+        const bool ok = (r.code == 0);
+        if (r.message) { lk_free_str((char*)r.message); }
+        OutTracks.SetNum(ok ? FMath::Min((int32)Count, OutTracks.Num()) : 0);
+        return ok;
+    }
+
+    bool GetTrackStats(TArray<LkTrackStats>& OutTracks)
+    {
+        size_t Count = 0;
+        LkResult r = lk_get_track_stats(Handle, nullptr, 0, &Count);
+        if (r.message) { lk_free_str((char*)r.message); }
+        if (r.code != 0) { OutTracks.Reset(); return false; }
+        // The list can grow between the two calls; the second call reports the final count
+        OutTracks.SetNumZeroed((int32)Count);
+        r = lk_get_track_stats(Handle, OutTracks.GetData(), Count, &Count);
+        const bool ok = (r.code == 0);
+        if (r.message) { lk_free_str((char*)r.message); }
+        OutTracks.SetNum(ok ? FMath::Min((int32)Count, OutTracks.Num()) : 0);
+        return ok;
+    }
+
+    // MaxHz <= 0 turns rate control off for the label
+    bool SetRateControl(const FString& Label, float MinHz, float MaxHz, float BandwidthShare = 0.f)
+    {
+        FTCHARToUTF8 Utf8Label(*Label);
+        LkRateControlConfig Cfg{ MinHz, MaxHz, BandwidthShare };
+        LkResult r = lk_set_rate_control(Handle, Utf8Label.Get(), MaxHz > 0.f ? &Cfg : nullptr);
+        const bool ok = (r.code == 0);
+        if (!ok) { CaptureError(r); if (r.message) { UE_LOG(LogTemp, Warning, TEXT("LiveKit set rate control '%s': %s"), *Label, UTF8_TO_TCHAR(r.message)); lk_free_str((char*)r.message); } }
+        else if (r.message) { lk_free_str((char*)r.message); ClearError(); }
+        return ok;
+    }
+
+    bool GetRecommendedRate(const FString& Label, float& OutHz)
+    {
+        FTCHARToUTF8 Utf8Label(*Label);
+        LkResult r = lk_get_recommended_rate(Handle, Utf8Label.Get(), &OutHz);
+        const bool ok = (r.code == 0);
+        if (r.message) { lk_free_str((char*)r.message); }
+        return ok;
+    }
+
+    bool SetLogLevel(LkLogLevel Level)
+    {
+        LkResult r = lk_set_log_level(Handle, Level);
+        const bool ok = (r.code == 0);
+        if (r.message) { lk_free_str((char*)r.message); }
+        return ok;
+    }
+
+    bool SetLogCallback(LkLogCallback Cb, void* User)
+    {
+        LkResult r = lk_set_log_callback(Handle, Cb, User);
+        const bool ok = (r.code == 0);
+        if (!ok) { CaptureError(r); if (r.message) { UE_LOG(LogTemp, Warning, TEXT("LiveKit set log callback: %s"), UTF8_TO_TCHAR(r.message)); lk_free_str((char*)r.message); } }
+        else if (r.message) { lk_free_str((char*)r.message); ClearError(); }
+        return ok;
+    }
+
+    bool SetRateCallback(LkRateCallback Cb, void* User)
+    {
+        LkResult r = lk_set_rate_callback(Handle, Cb, User);
+        const bool ok = (r.code == 0);
+        if (!ok) { CaptureError(r); if (r.message) { UE_LOG(LogTemp, Warning, TEXT("LiveKit set rate callback: %s"), UTF8_TO_TCHAR(r.message)); lk_free_str((char*)r.message); } }
+        else if (r.message) { lk_free_str((char*)r.message); ClearError(); }
+        return ok;
+    }
+
+    bool GetDataClassStats(const FString& Label, LkDataClassStats& OutStats)
+    {
+        FTCHARToUTF8 Utf8Label(*Label);
+        LkResult r = lk_get_data_class_stats(Handle, Utf8Label.Get(), &OutStats);
+        const bool ok = (r.code == 0);
+        if (r.message) { lk_free_str((char*)r.message); }
+        return ok;
+    }
+
+    // KeyframeInterval <= 0 turns delta coding off for the label
+    bool SetDeltaChannel(const FString& Label, int32 KeyframeInterval, bool bLz4)
+    {
+        FTCHARToUTF8 Utf8Label(*Label);
+        const LkDeltaConfig Config{ KeyframeInterval, bLz4 ? 1 : 0 };
+        LkResult r = lk_set_delta_channel(Handle, Utf8Label.Get(), KeyframeInterval > 0 ? &Config : nullptr);
+        const bool ok = (r.code == 0);
+        if (!ok) { CaptureError(r); if (r.message) { UE_LOG(LogTemp, Warning, TEXT("LiveKit set delta channel '%s': %s"), *Label, UTF8_TO_TCHAR(r.message)); lk_free_str((char*)r.message); } }
+        else if (r.message) { lk_free_str((char*)r.message); ClearError(); }
+        return ok;
+    }
+
+    bool GetDeltaStats(const FString& Label, LkDeltaStats& OutStats)
+    {
+        FTCHARToUTF8 Utf8Label(*Label);
+        LkResult r = lk_get_delta_stats(Handle, Utf8Label.Get(), &OutStats);
+        const bool ok = (r.code == 0);
+        if (r.message) { lk_free_str((char*)r.message); }
+        return ok;
+    }
+
+    // Codec None with a dictionary only decodes; None without one turns compression off
+    bool SetDataCompression(const FString& Label, LkCompression Codec, int32 Level, const TArray<uint8>& Dictionary)
+    {
+        FTCHARToUTF8 Utf8Label(*Label);
+        const LkCompressionConfig Config{ Codec, Level, Dictionary.GetData(), (size_t)Dictionary.Num() };
+        const bool bOff = Codec == LkCompressionNone && Dictionary.Num() == 0;
+        LkResult r = lk_set_data_compression(Handle, Utf8Label.Get(), bOff ? nullptr : &Config);
+        const bool ok = (r.code == 0);
+        if (!ok) { CaptureError(r); if (r.message) { UE_LOG(LogTemp, Warning, TEXT("LiveKit set compression '%s': %s"), *Label, UTF8_TO_TCHAR(r.message)); lk_free_str((char*)r.message); } }
+        else if (r.message) { lk_free_str((char*)r.message); ClearError(); }
+        return ok;
+    }
+
+    // Samples should be a few hundred representative messages
+    static bool TrainCompressionDictionary(const TArray<TArray<uint8>>& Samples, int32 MaxBytes, TArray<uint8>& OutDictionary)
+    {
+        TArray<uint8> Flat;
+        TArray<size_t> Sizes;
+        Sizes.Reserve(Samples.Num());
+        for (const TArray<uint8>& Sample : Samples)
+        {
+            Flat.Append(Sample);
+            Sizes.Add((size_t)Sample.Num());
+        }
+        OutDictionary.SetNumUninitialized(FMath::Max(1, MaxBytes));
+        size_t Written = 0;
+        LkResult r = lk_train_compression_dictionary(Flat.GetData(), Sizes.GetData(), (size_t)Sizes.Num(),
+            OutDictionary.GetData(), (size_t)OutDictionary.Num(), &Written);
+        const bool ok = (r.code == 0);
+        if (r.message) { if (!ok) { UE_LOG(LogTemp, Warning, TEXT("LiveKit train dictionary: %s"), UTF8_TO_TCHAR(r.message)); } lk_free_str((char*)r.message); }
+        OutDictionary.SetNum(ok ? (int32)Written : 0);
+        return ok;
+    }
+
+    bool GetDataStats(LkDataStats& OutStats)
+    {
+        LkResult r = lk_get_data_stats(Handle, &OutStats);
+        const bool ok = (r.code == 0);
+        if (r.message) { lk_free_str((char*)r.message); }
+        return ok;
+    }
+
+    bool GetLatencyStats(LkLatencyStats& OutStats, bool bReset)
+    {
+        LkResult r = lk_get_latency_stats(Handle, &OutStats, bReset ? 1 : 0);
+        const bool ok = (r.code == 0);
+        if (r.message) { lk_free_str((char*)r.message); }
+        return ok;
+    }
+
+    // Process-wide; fails unless the library was built with the trace_spans feature
+    static bool EnableTrace(bool bEnabled)
+    {
+        LkResult r = lk_trace_enable(bEnabled ? 1 : 0);
+        const bool ok = (r.code == 0);
+        if (r.message) { if (!ok) { UE_LOG(LogTemp, Warning, TEXT("LiveKit trace enable: %s"), UTF8_TO_TCHAR(r.message)); } lk_free_str((char*)r.message); }
+        return ok;
+    }
+
+    static bool DumpTrace(const FString& Path, int32* OutSpans = nullptr)
+    {
+        FTCHARToUTF8 Utf8Path(*Path);
+        size_t Spans = 0;
+        LkResult r = lk_trace_dump(Utf8Path.Get(), &Spans);
+        const bool ok = (r.code == 0);
+        if (r.message) { if (!ok) { UE_LOG(LogTemp, Warning, TEXT("LiveKit trace dump: %s"), UTF8_TO_TCHAR(r.message)); } lk_free_str((char*)r.message); }
+        if (OutSpans) { *OutSpans = ok ? (int32)Spans : 0; }
+        return ok;
+    }
+
+    bool SetReceiveFilter(const FString& Label, LkReceiveFilter Filter)
+    {
+        FTCHARToUTF8 Utf8Label(*Label);
+        LkResult r = lk_set_receive_filter(Handle, Utf8Label.Get(), Filter);
+        const bool ok = (r.code == 0);
+        if (!ok) { CaptureError(r); if (r.message) { UE_LOG(LogTemp, Warning, TEXT("LiveKit set receive filter '%s': %s"), *Label, UTF8_TO_TCHAR(r.message)); lk_free_str((char*)r.message); } }
+        else if (r.message) { lk_free_str((char*)r.message); ClearError(); }
+        return ok;
+    }
+
+    bool RegisterStreamHandler(const FString& Label, LkStreamChunkCallback Cb, void* User)
+    {
+        FTCHARToUTF8 Utf8Label(*Label);
+        LkResult r = lk_register_stream_handler(Handle, Utf8Label.Get(), Cb, User);
+        const bool ok = (r.code == 0);
+        if (!ok) { CaptureError(r); if (r.message) { UE_LOG(LogTemp, Warning, TEXT("LiveKit register stream handler '%s': %s"), *Label, UTF8_TO_TCHAR(r.message)); lk_free_str((char*)r.message); } }
+        else if (r.message) { lk_free_str((char*)r.message); ClearError(); }
+        return ok;
+    }
+
+    bool RegisterStateHandler(const FString& Label, LkStateHandler Cb, void* User)
+    {
+        FTCHARToUTF8 Utf8Label(*Label);
+        LkResult r = lk_register_state_handler(Handle, Utf8Label.Get(), Cb, User);
+        const bool ok = (r.code == 0);
+        if (!ok) { CaptureError(r); if (r.message) { UE_LOG(LogTemp, Warning, TEXT("LiveKit register state handler '%s': %s"), *Label, UTF8_TO_TCHAR(r.message)); lk_free_str((char*)r.message); } }
+        else if (r.message) { lk_free_str((char*)r.message); ClearError(); }
+        return ok;
+    }
+
+    TUniquePtr<LiveKitStateChannel> CreateStateChannel(const FString& Label, bool bReliable, int32 TickHz = 60, int32 MaxPacketBytes = 0)
+    {
+        if (!Handle || Label.IsEmpty())
+        {
+            return nullptr;
+        }
+        FTCHARToUTF8 Utf8Label(*Label);
+        LkStateChannelConfig Config;
+        Config.label = Utf8Label.Get();
+        Config.reliability = bReliable ? LkReliable : LkLossy;
+        Config.tick_hz = TickHz;
+        Config.max_packet_bytes = MaxPacketBytes;
+        LkStateChannelHandle* ChannelHandle = nullptr;
+        LkResult r = lk_state_channel_create(Handle, &Config, &ChannelHandle);
+        const bool ok = (r.code == 0) && ChannelHandle != nullptr;
+        if (!ok)
+        {
+            CaptureError(r);
+            if (r.message) { UE_LOG(LogTemp, Warning, TEXT("LiveKit create state channel '%s' failed: %s"), *Label, UTF8_TO_TCHAR(r.message)); lk_free_str((char*)r.message); }
+            return nullptr;
+        }
+        if (r.message)
+        {
+            lk_free_str((char*)r.message);
+            ClearError();
+        }
+        return MakeUnique<LiveKitStateChannel>(ChannelHandle, Label);
+    }
+
+    FString GetParticipantIdentity(uint32 ParticipantId) const
+    {
+        char Buffer[256] = {0};
+        LkResult r = lk_get_participant_identity(Handle, ParticipantId, Buffer, sizeof(Buffer));
+        if (r.message) { lk_free_str((char*)r.message); }
+        return (r.code == 0) ? FString(UTF8_TO_TCHAR(Buffer)) : FString();
+    }
+
     bool IsReady() const
     {
         return Handle && lk_client_is_ready(Handle) != 0;
@@ -311,6 +801,10 @@ private:
         LastCode = 0;
         LastMessage.Reset();
     }
+    static void ReleaseOwnedThunk(void* User, const uint8_t*, size_t)
+    {
+        delete static_cast<TArray<uint8>*>(User);
+    }
 };
 
 inline LiveKitDataChannel::LiveKitDataChannel(LiveKitClient* InClient, const FString& InLabel, LkReliability InReliability, bool bInOrdered)
@@ -323,7 +817,7 @@ inline LiveKitDataChannel::LiveKitDataChannel(LiveKitClient* InClient, const FSt
 
 inline bool LiveKitDataChannel::Send(const void* Bytes, size_t Len) const
 {
-    return Client && Client->SendDataOnChannel(Bytes, Len, Reliability, bOrdered, Label);
+    return Client && Client->SendDataOnChannel(Bytes, Len, Reliability, bOrdered, Label, MaxAgeMs);
 }
 
 inline bool LiveKitDataChannel::Send(const TArray<uint8>& Payload) const
@@ -331,6 +825,16 @@ inline bool LiveKitDataChannel::Send(const TArray<uint8>& Payload) const
     return Send(Payload.GetData(), static_cast<size_t>(Payload.Num()));
 }
 
+inline bool LiveKitDataChannel::SendOwned(TArray<uint8>&& Payload) const
+{
+    return Client && Client->SendDataOwned(MoveTemp(Payload), Reliability, bOrdered, Label, MaxAgeMs);
+}
+
+inline bool LiveKitDataChannel::SendTo(const TArray<uint8>& Payload, const TArray<uint32>& ParticipantIds) const
+{
+    return Client && Client->SendDataToIds(Payload.GetData(), static_cast<size_t>(Payload.Num()), Reliability, bOrdered, Label, ParticipantIds, MaxAgeMs);
+}
+
 inline LiveKitAudioTrack::LiveKitAudioTrack(LiveKitClient* InClient, LkAudioTrackHandle* InHandle, const FString& InName, int32 InSampleRate, int32 InChannels, int32 InBufferMs)
     : Client(InClient)
     , Handle(InHandle)
@@ -351,6 +855,17 @@ inline bool LiveKitAudioTrack::PublishPCM(const TArray<int16>& Frames, int32 Fra
     return PublishPCM(Frames.GetData(), static_cast<size_t>(FramesPerChannel));
 }
 
+inline bool LiveKitAudioTrack::GetStats(LkAudioTrackStats& OutStats) const
+{
+    if (!Handle)
+    {
+        return false;
+    }
+    LkResult r = lk_audio_track_get_stats(Handle, &OutStats);
+    if (r.message) { lk_free_str((char*)r.message); }
+    return r.code == 0;
+}
+
 inline void LiveKitAudioTrack::Reset()
 {
     if (Handle)
@@ -389,3 +904,40 @@ inline void LiveKitAudioTrack::MoveFrom(LiveKitAudioTrack&& Other)
     Other.Channels = 0;
     Other.BufferMs = 0;
 }
+
+inline bool LiveKitStateChannel::Write(uint32 Key, const void* Bytes, size_t Len) const
+{
+    if (!Handle || (Bytes == nullptr && Len > 0))
+    {
+        return false;
+    }
+    LkResult r = lk_state_channel_write(Handle, Key, static_cast<const uint8_t*>(Bytes), Len);
+    if (r.message)
+    {
+        if (r.code != 0) { UE_LOG(LogTemp, Verbose, TEXT("LiveKit state write on '%s' failed: %s"), *Label, UTF8_TO_TCHAR(r.message)); }
+        lk_free_str((char*)r.message);
+    }
+    return r.code == 0;
+}
+
+inline bool LiveKitStateChannel::GetStats(LkStateChannelStats& OutStats) const
+{
+    if (!Handle)
+    {
+        return false;
+    }
+    LkResult r = lk_state_channel_get_stats(Handle, &OutStats);
+    if (r.message) { lk_free_str((char*)r.message); }
+    return r.code == 0;
+}
+
+inline void LiveKitStateChannel::Reset()
+{
+    if (Handle)
+    {
+        LkStateChannelHandle* ToDestroy = Handle;
+        Handle = nullptr;
+        LkResult r = lk_state_channel_destroy(ToDestroy);
+        if (r.message) { lk_free_str((char*)r.message); }
+    }
+}
@@ -3,8 +3,10 @@
 #include "UObject/ObjectMacros.h"
 #include "UObject/ScriptMacros.h"
 #include "Components/ActorComponent.h"
+#include "Containers/CircularQueue.h"
 #include "livekit_ffi.h"
 #include "LiveKitClient.hpp"
+#include <atomic>
 
 UENUM(BlueprintType)
 enum class ELiveKitClientRole : uint8
@@ -14,13 +16,379 @@ enum class ELiveKitClientRole : uint8
     Subscriber UMETA(DisplayName="Subscriber"),
     Both       UMETA(DisplayName="Both")
 };
+
+// Verbosity of the FFI library's own log lines, which go to LogLiveKitBridge (mirrors LkLogLevel)
+UENUM(BlueprintType)
+enum class ELiveKitLogLevel : uint8
+{
+    Error,
+    Warn,
+    Info,
+    Debug,
+    Trace
+};
+
+UENUM(BlueprintType)
+enum class ELiveKitCompression : uint8
+{
+    None UMETA(DisplayName="None"),
+    Lz4  UMETA(DisplayName="LZ4"),
+    Zstd UMETA(DisplayName="zstd")
+};
+
+// Server rating of this participant's connection (mirrors LkConnectionQuality)
+UENUM(BlueprintType)
+enum class ELiveKitConnectionQuality : uint8
+{
+    Unknown   UMETA(DisplayName="Unknown"),
+    Excellent UMETA(DisplayName="Excellent"),
+    Good      UMETA(DisplayName="Good"),
+    Poor      UMETA(DisplayName="Poor"),
+    Lost      UMETA(DisplayName="Lost")
+};
+
+// ICE candidate type of a transport's selected path (mirrors LkCandidateType)
+UENUM(BlueprintType)
+enum class ELiveKitCandidateType : uint8
+{
+    Unknown UMETA(DisplayName="Unknown"),
+    Host    UMETA(DisplayName="Host"),
+    Srflx   UMETA(DisplayName="Server Reflexive"),
+    Prflx   UMETA(DisplayName="Peer Reflexive"),
+    Relay   UMETA(DisplayName="Relay (TURN)")
+};
 #include "LiveKitPublisherComponent.generated.h"
 
+USTRUCT(BlueprintType)
+struct FLiveKitMocapPacket
+{
+    GENERATED_BODY()
+
+    // Data label (topic) the packet arrived on
+    UPROPERTY(BlueprintReadOnly, Category="LiveKit|Data") FName Channel;
+    // Interned participant ID of the sender (0 if unknown); see GetParticipantIdentity
+    UPROPERTY(BlueprintReadOnly, Category="LiveKit|Data") int32 SenderId = 0;
+    // Key for packets from a state channel (see CreateStateChannel), -1 for plain data
+    UPROPERTY(BlueprintReadOnly, Category="LiveKit|Data") int32 StateKey = -1;
+    UPROPERTY(BlueprintReadOnly, Category="LiveKit|Data") TArray<uint8> Payload;
+    // One-way latency measured on receipt; -1 unless the channel is timestamped (SetChannelTimestamps) and both ends are clock-synced
+    UPROPERTY(BlueprintReadOnly, Category="LiveKit|Data") float LatencyMs = -1.f;
+};
+
+USTRUCT(BlueprintType)
+struct FLiveKitInboundStats
+{
+    GENERATED_BODY()
+
+    UPROPERTY(BlueprintReadOnly, Category="LiveKit|Data") int64 PacketsReceived = 0;
+    UPROPERTY(BlueprintReadOnly, Category="LiveKit|Data") int64 BytesReceived = 0;
+    // Packets dropped because the inbound queue was full
+    UPROPERTY(BlueprintReadOnly, Category="LiveKit|Data") int64 PacketsDropped = 0;
+    // Packets superseded by a newer one on the same channel (bCollapseInboundToLatest)
+    UPROPERTY(BlueprintReadOnly, Category="LiveKit|Data") int64 PacketsCollapsed = 0;
+    UPROPERTY(BlueprintReadOnly, Category="LiveKit|Data") int64 BatchesDispatched = 0;
+};
+
+USTRUCT(BlueprintType)
+struct FLiveKitChannelSendStats
+{
+    GENERATED_BODY()
+
+    // Messages waiting in the channel's send queue
+    UPROPERTY(BlueprintReadOnly, Category="LiveKit|Data") int64 QueueDepth = 0;
+    UPROPERTY(BlueprintReadOnly, Category="LiveKit|Data") int64 SentMessages = 0;
+    UPROPERTY(BlueprintReadOnly, Category="LiveKit|Data") int64 SentBytes = 0;
+    UPROPERTY(BlueprintReadOnly, Category="LiveKit|Data") int64 ExpiredDropped = 0;
+    // Queue wait percentiles over recent messages, in milliseconds
+    UPROPERTY(BlueprintReadOnly, Category="LiveKit|Data") float WaitP50Ms = 0.f;
+    UPROPERTY(BlueprintReadOnly, Category="LiveKit|Data") float WaitP95Ms = 0.f;
+    UPROPERTY(BlueprintReadOnly, Category="LiveKit|Data") float WaitP99Ms = 0.f;
+};
+
+USTRUCT(BlueprintType)
+struct FLiveKitDeltaStats
+{
+    GENERATED_BODY()
+
+    UPROPERTY(BlueprintReadOnly, Category="LiveKit|Data") int64 FramesSent = 0;
+    UPROPERTY(BlueprintReadOnly, Category="LiveKit|Data") int64 KeyframesSent = 0;
+    // Uncoded bytes / bytes on the wire
+    UPROPERTY(BlueprintReadOnly, Category="LiveKit|Data") float CompressionRatio = 0.f;
+    UPROPERTY(BlueprintReadOnly, Category="LiveKit|Data") float EncodeMicrosPerFrame = 0.f;
+    UPROPERTY(BlueprintReadOnly, Category="LiveKit|Data") int64 FramesReceived = 0;
+    UPROPERTY(BlueprintReadOnly, Category="LiveKit|Data") float DecodeMicrosPerFrame = 0.f;
+    // Received deltas whose keyframe was lost
+    UPROPERTY(BlueprintReadOnly, Category="LiveKit|Data") int64 UndecodableDropped = 0;
+};
+
+USTRUCT(BlueprintType)
+struct FLiveKitClockSyncStats
+{
+    GENERATED_BODY()
+
+    UPROPERTY(BlueprintReadOnly, Category="LiveKit|Data") bool bSynced = false;
+    // Participant whose clock is the room clock; 0 = this one
+    UPROPERTY(BlueprintReadOnly, Category="LiveKit|Data") int32 ReferenceParticipantId = 0;
+    // Room clock minus local clock
+    UPROPERTY(BlueprintReadOnly, Category="LiveKit|Data") float OffsetMs = 0.f;
+    UPROPERTY(BlueprintReadOnly, Category="LiveKit|Data") float RttMs = 0.f;
+    UPROPERTY(BlueprintReadOnly, Category="LiveKit|Data") int64 Samples = 0;
+    UPROPERTY(BlueprintReadOnly, Category="LiveKit|Data") int64 Outliers = 0;
+};
+
+// Room-wide compression counters (see SetChannelCompression)
+USTRUCT(BlueprintType)
+struct FLiveKitCompressionStats
+{
+    GENERATED_BODY()
+
+    UPROPERTY(BlueprintReadOnly, Category="LiveKit|Data") int64 CompressedMessages = 0;
+    UPROPERTY(BlueprintReadOnly, Category="LiveKit|Data") int64 RawBytes = 0;
+    UPROPERTY(BlueprintReadOnly, Category="LiveKit|Data") int64 WireBytes = 0;
+    // Raw bytes / bytes on the wire
+    UPROPERTY(BlueprintReadOnly, Category="LiveKit|Data") float CompressionRatio = 0.f;
+    // Received messages that could not be decompressed (e.g. missing dictionary)
+    UPROPERTY(BlueprintReadOnly, Category="LiveKit|Data") int64 DecompressFailed = 0;
+};
+
+// Room-wide forward error correction counters (see SetChannelFec)
+USTRUCT(BlueprintType)
+struct FLiveKitFecStats
+{
+    GENERATED_BODY()
+
+    UPROPERTY(BlueprintReadOnly, Category="LiveKit|Data") int64 ProtectedMessages = 0;
+    UPROPERTY(BlueprintReadOnly, Category="LiveKit|Data") int64 ParityPackets = 0;
+    // Bytes FEC added / message bytes protected
+    UPROPERTY(BlueprintReadOnly, Category="LiveKit|Data") float OverheadRatio = 0.f;
+    // Received messages rebuilt from parity instead of being lost
+    UPROPERTY(BlueprintReadOnly, Category="LiveKit|Data") int64 Recovered = 0;
+    // Received messages lost in groups missing more than one
+    UPROPERTY(BlueprintReadOnly, Category="LiveKit|Data") int64 Unrecovered = 0;
+};
+
+// Publisher transport estimate, polled while any channel has rate control (see SetChannelRateControl)
+USTRUCT(BlueprintType)
+struct FLiveKitLinkStats
+{
+    GENERATED_BODY()
+
+    // Zero fields are unknown; loss and bandwidth may stay unknown on data-only connections
+    UPROPERTY(BlueprintReadOnly, Category="LiveKit|Data") float RttMs = 0.f;
+    // Fraction of published packets lost, 0..1
+    UPROPERTY(BlueprintReadOnly, Category="LiveKit|Data") float Loss = 0.f;
+    UPROPERTY(BlueprintReadOnly, Category="LiveKit|Data") float AvailableOutgoingKbps = 0.f;
+    UPROPERTY(BlueprintReadOnly, Category="LiveKit|Data") ELiveKitConnectionQuality Quality = ELiveKitConnectionQuality::Unknown;
+};
+
+// One WebRTC peer connection's transport (see GetTransportStats)
+USTRUCT(BlueprintType)
+struct FLiveKitTransportStats
+{
+    GENERATED_BODY()
+
+    // False until ICE has selected a path; the other fields are zero until then
+    UPROPERTY(BlueprintReadOnly, Category="LiveKit|Stats") bool bConnected = false;
+    UPROPERTY(BlueprintReadOnly, Category="LiveKit|Stats") float RttMs = 0.f;
+    UPROPERTY(BlueprintReadOnly, Category="LiveKit|Stats") float AvailableOutgoingKbps = 0.f;
+    UPROPERTY(BlueprintReadOnly, Category="LiveKit|Stats") float AvailableIncomingKbps = 0.f;
+    UPROPERTY(BlueprintReadOnly, Category="LiveKit|Stats") int64 BytesSent = 0;
+    UPROPERTY(BlueprintReadOnly, Category="LiveKit|Stats") int64 BytesReceived = 0;
+    UPROPERTY(BlueprintReadOnly, Category="LiveKit|Stats") float SendKbps = 0.f;
+    UPROPERTY(BlueprintReadOnly, Category="LiveKit|Stats") float ReceiveKbps = 0.f;
+    UPROPERTY(BlueprintReadOnly, Category="LiveKit|Stats") ELiveKitCandidateType LocalCandidate = ELiveKitCandidateType::Unknown;
+    UPROPERTY(BlueprintReadOnly, Category="LiveKit|Stats") ELiveKitCandidateType RemoteCandidate = ELiveKitCandidateType::Unknown;
+    UPROPERTY(BlueprintReadOnly, Category="LiveKit|Stats") bool bTcp = false;
+};
+
+// RTP stats of one published or subscribed media track (see GetTrackStats)
+USTRUCT(BlueprintType)
+struct FLiveKitTrackStats
+{
+    GENERATED_BODY()
+
+    UPROPERTY(BlueprintReadOnly, Category="LiveKit|Stats") FString Name;
+    UPROPERTY(BlueprintReadOnly, Category="LiveKit|Stats") bool bOutbound = false;
+    UPROPERTY(BlueprintReadOnly, Category="LiveKit|Stats") bool bVideo = false;
+    // Registry IDs of a subscribed track; 0 for published ones
+    UPROPERTY(BlueprintReadOnly, Category="LiveKit|Stats") int32 ParticipantId = 0;
+    UPROPERTY(BlueprintReadOnly, Category="LiveKit|Stats") int32 TrackId = 0;
+    UPROPERTY(BlueprintReadOnly, Category="LiveKit|Stats") int64 Packets = 0;
+    UPROPERTY(BlueprintReadOnly, Category="LiveKit|Stats") int64 Bytes = 0;
+    UPROPERTY(BlueprintReadOnly, Category="LiveKit|Stats") float Kbps = 0.f;
+    UPROPERTY(BlueprintReadOnly, Category="LiveKit|Stats") int64 PacketsLost = 0;
+    // Fraction lost, 0..1
+    UPROPERTY(BlueprintReadOnly, Category="LiveKit|Stats") float Loss = 0.f;
+    UPROPERTY(BlueprintReadOnly, Category="LiveKit|Stats") float JitterMs = 0.f;
+    // Outbound only
+    UPROPERTY(BlueprintReadOnly, Category="LiveKit|Stats") float RttMs = 0.f;
+    UPROPERTY(BlueprintReadOnly, Category="LiveKit|Stats") int64 NackCount = 0;
+    UPROPERTY(BlueprintReadOnly, Category="LiveKit|Stats") int64 PliCount = 0;
+    // Outbound only
+    UPROPERTY(BlueprintReadOnly, Category="LiveKit|Stats") int64 RetransmittedPackets = 0;
+    // Outbound only: the encoder's target
+    UPROPERTY(BlueprintReadOnly, Category="LiveKit|Stats") float TargetKbps = 0.f;
+};
+
+// One published or subscribed audio track (see GetAudioTrackStats)
+USTRUCT(BlueprintType)
+struct FLiveKitAudioTrackStats
+{
+    GENERATED_BODY()
+
+    UPROPERTY(BlueprintReadOnly, Category="LiveKit|Stats") FString Name;
+    UPROPERTY(BlueprintReadOnly, Category="LiveKit|Stats") bool bRemote = false;
+    UPROPERTY(BlueprintReadOnly, Category="LiveKit|Stats") int32 SampleRate = 0;
+    UPROPERTY(BlueprintReadOnly, Category="LiveKit|Stats") int32 Channels = 0;
+    // Published: audio waiting to be sent, its peak and the ring size
+    UPROPERTY(BlueprintReadOnly, Category="LiveKit|Stats") int32 QueuedMs = 0;
+    UPROPERTY(BlueprintReadOnly, Category="LiveKit|Stats") int32 HighWaterMs = 0;
+    UPROPERTY(BlueprintReadOnly, Category="LiveKit|Stats") int32 CapacityMs = 0;
+    UPROPERTY(BlueprintReadOnly, Category="LiveKit|Stats") int32 Underruns = 0;
+    UPROPERTY(BlueprintReadOnly, Category="LiveKit|Stats") int32 Overruns = 0;
+    // Since the last push (published) or received frame (subscribed); -1 if none yet
+    UPROPERTY(BlueprintReadOnly, Category="LiveKit|Stats") float MsSinceLastFrame = -1.f;
+    // Subscribed only
+    UPROPERTY(BlueprintReadOnly, Category="LiveKit|Stats") int32 ParticipantId = 0;
+    UPROPERTY(BlueprintReadOnly, Category="LiveKit|Stats") int32 TrackId = 0;
+    UPROPERTY(BlueprintReadOnly, Category="LiveKit|Stats") int64 FramesReceived = 0;
+    // Fraction of played samples WebRTC synthesized to conceal loss
+    UPROPERTY(BlueprintReadOnly, Category="LiveKit|Stats") float ConcealedRatio = 0.f;
+    UPROPERTY(BlueprintReadOnly, Category="LiveKit|Stats") float JitterBufferMs = 0.f;
+};
+
+// One hot path's latency distribution over the recording window, in microseconds
+USTRUCT(BlueprintType)
+struct FLiveKitLatencySummary
+{
+    GENERATED_BODY()
+
+    UPROPERTY(BlueprintReadOnly, Category="LiveKit|Stats") int64 Count = 0;
+    UPROPERTY(BlueprintReadOnly, Category="LiveKit|Stats") float MinUs = 0.f;
+    UPROPERTY(BlueprintReadOnly, Category="LiveKit|Stats") float MeanUs = 0.f;
+    UPROPERTY(BlueprintReadOnly, Category="LiveKit|Stats") float P50Us = 0.f;
+    UPROPERTY(BlueprintReadOnly, Category="LiveKit|Stats") float P90Us = 0.f;
+    UPROPERTY(BlueprintReadOnly, Category="LiveKit|Stats") float P99Us = 0.f;
+    UPROPERTY(BlueprintReadOnly, Category="LiveKit|Stats") float P999Us = 0.f;
+    UPROPERTY(BlueprintReadOnly, Category="LiveKit|Stats") float MaxUs = 0.f;
+};
+
+// Latency of the audio, send and receive hot paths (see GetLatencyStats)
+USTRUCT(BlueprintType)
+struct FLiveKitLatencyStats
+{
+    GENERATED_BODY()
+
+    // Published PCM waiting in the ring until it is handed to WebRTC
+    UPROPERTY(BlueprintReadOnly, Category="LiveKit|Stats") FLiveKitLatencySummary AudioRing;
+    // Data sends from the call (or enqueue) until the publish completes
+    UPROPERTY(BlueprintReadOnly, Category="LiveKit|Stats") FLiveKitLatencySummary Send;
+    // Received data and audio from arrival until the callback starts
+    UPROPERTY(BlueprintReadOnly, Category="LiveKit|Stats") FLiveKitLatencySummary Dispatch;
+    // Time spent inside the component's data and audio callbacks
+    UPROPERTY(BlueprintReadOnly, Category="LiveKit|Stats") FLiveKitLatencySummary Callback;
+};
+
+// Precision for the FFI pose codec (see lk_pose_encode); the receiver needs no settings to decode
+USTRUCT(BlueprintType)
+struct FLiveKitPoseCodecSettings
+{
+    GENERATED_BODY()
+
+    // Bits per smallest-three quaternion component (11 = about 0.1 degree)
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="LiveKit|Pose", meta=(ClampMin="4", ClampMax="16")) int32 RotationBits = 11;
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="LiveKit|Pose") bool bEncodePositions = true;
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="LiveKit|Pose", meta=(ClampMin="4", ClampMax="24")) int32 PositionBits = 16;
+    // Bone offsets from the root (bone 0) are clamped to +/- this many cm
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="LiveKit|Pose", meta=(ClampMin="1")) float PositionRange = 300.f;
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="LiveKit|Pose") bool bEncodeScales = false;
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="LiveKit|Pose", meta=(ClampMin="4", ClampMax="16")) int32 ScaleBits = 8;
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="LiveKit|Pose") float ScaleMin = 0.5f;
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="LiveKit|Pose") float ScaleMax = 2.f;
+};
+
+// One remote sender's pose playout buffer (see SetChannelPosePlayout)
+USTRUCT(BlueprintType)
+struct FLiveKitPosePlayoutStats
+{
+    GENERATED_BODY()
+
+    // Frames buffered ahead of the last SamplePose
+    UPROPERTY(BlueprintReadOnly, Category="LiveKit|Pose") int32 Depth = 0;
+    // Adaptive delay added to the fastest recent transit
+    UPROPERTY(BlueprintReadOnly, Category="LiveKit|Pose") float TargetDelayMs = 0.f;
+    UPROPERTY(BlueprintReadOnly, Category="LiveKit|Pose") float JitterMs = 0.f;
+    UPROPERTY(BlueprintReadOnly, Category="LiveKit|Pose") int64 FramesPushed = 0;
+    // Frames that arrived after their play time
+    UPROPERTY(BlueprintReadOnly, Category="LiveKit|Pose") int64 LateDropped = 0;
+    UPROPERTY(BlueprintReadOnly, Category="LiveKit|Pose") int64 Interpolated = 0;
+    UPROPERTY(BlueprintReadOnly, Category="LiveKit|Pose") int64 Extrapolated = 0;
+    UPROPERTY(BlueprintReadOnly, Category="LiveKit|Pose") int64 Held = 0;
+};
+
+// Per-channel context handed to the FFI topic handler; owned by the component
+struct FLiveKitInboundChannel
+{
+    class ULiveKitPublisherComponent* Owner = nullptr;
+    FName Channel;
+    FString Label;
+};
+
+// FFI-owned bytes from the buffered data callback, copied out on the game thread
+struct FLiveKitDeferredPayload
+{
+    LkDataBuffer* Buffer = nullptr;
+    const uint8* Bytes = nullptr;
+    int32 Len = 0;
+
+    void Release()
+    {
+        if (Buffer) { lk_data_release(Buffer); }
+        *this = FLiveKitDeferredPayload();
+    }
+};
+
+// Native-only queue element for inbound data (not exposed to Blueprint)
+struct FLiveKitInboundMessage
+{
+    FName Channel;
+    uint32 SenderId = 0;
+    int32 StateKey = -1;
+    int64 SenderTimeUs = 0; // lk_data_sender_time_us at receipt (0 = unknown)
+    int64 ArrivalUs = 0;    // lk_now_local_us at receipt
+    TArray<uint8> Payload;
+    FLiveKitDeferredPayload Deferred; // set instead of Payload by the buffered callback
+};
+
+// Playout buffers for one channel, one per remote sender, created on first packet
+struct FLiveKitPosePlayout
+{
+    LkPlayoutConfig Config{};
+    TMap<uint32, LkPlayoutBuffer*> Senders;
+    TArray<LkBoneTransform> Scratch;
+
+    FLiveKitPosePlayout() = default;
+    FLiveKitPosePlayout(const FLiveKitPosePlayout&) = delete;
+    FLiveKitPosePlayout& operator=(const FLiveKitPosePlayout&) = delete;
+    ~FLiveKitPosePlayout()
+    {
+        for (const TPair<uint32, LkPlayoutBuffer*>& Sender : Senders) { lk_playout_destroy(Sender.Value); }
+    }
+
+    void RemoveSender(uint32 SenderId)
+    {
+        LkPlayoutBuffer* Buffer = nullptr;
+        if (Senders.RemoveAndCopyValue(SenderId, Buffer)) { lk_playout_destroy(Buffer); }
+    }
+};
+
 UCLASS(ClassGroup=(Networking), meta=(BlueprintSpawnableComponent))
 class ULiveKitPublisherComponent : public UActorComponent
 {
     GENERATED_BODY()
 public:
+    ULiveKitPublisherComponent();
+
     UPROPERTY(EditAnywhere, Category="LiveKit") FString RoomUrl;
     UPROPERTY(EditAnywhere, Category="LiveKit") FString Token;
     UPROPERTY(EditAnywhere, Category="LiveKit") ELiveKitClientRole Role = ELiveKitClientRole::Both;
@@ -28,6 +396,24 @@ public:
     UPROPERTY(EditAnywhere, Category="LiveKit") bool bReceiveAudio = false; // not exposed to BP (audio frames are native only)
     UPROPERTY(EditAnywhere, Category="LiveKit|Audio") int32 SampleRate = 48000;
     UPROPERTY(EditAnywhere, Category="LiveKit|Audio") int32 Channels = 1;
+    UPROPERTY(EditAnywhere, Category="LiveKit") ELiveKitLogLevel FfiLogLevel = ELiveKitLogLevel::Error;
+
+    // Inbound data is queued on the FFI thread and delivered once per tick
+    UPROPERTY(EditAnywhere, Category="LiveKit|Data", meta=(ClampMin="16")) int32 InboundQueueCapacity = 1024;
+    UPROPERTY(EditAnywhere, Category="LiveKit|Data") bool bCollapseInboundToLatest = false; // keep only the newest packet per channel, sender and state key each tick
+    UPROPERTY(EditAnywhere, Category="LiveKit|Data") bool bDispatchPerPacketEvents = true; // also fire OnMocapReceived for each packet in the batch
+    // Queue FFI-owned buffers and copy on the game thread; packets superseded by collapsing are never copied
+    UPROPERTY(EditAnywhere, Category="LiveKit|Data") bool bDeferInboundCopy = false;
+
+    // Outbound: coalesce small sends on the same channel into MTU-sized packets
+    UPROPERTY(EditAnywhere, Category="LiveKit|Data") bool bBatchSmallSends = false;
+    UPROPERTY(EditAnywhere, Category="LiveKit|Data", meta=(ClampMin="1", EditCondition="bBatchSmallSends")) int32 BatchFlushWindowMs = 5;
+    // Channels with a priority (SetChannelPriority) share bandwidth by weight instead of strict priority
+    UPROPERTY(EditAnywhere, Category="LiveKit|Data") bool bWeightedSendScheduling = false;
+    // Ping the room clock reference this often for synced timestamps (0 = off; peers are answered regardless)
+    UPROPERTY(EditAnywhere, Category="LiveKit|Data", meta=(ClampMin="0")) int32 ClockSyncIntervalMs = 2000;
+    // Used by SendPoseOnChannel
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="LiveKit|Pose") FLiveKitPoseCodecSettings PoseCodecSettings;
 
     // Test utilities
     UPROPERTY(EditAnywhere, Category="LiveKit|Test") bool bStartDebugTone = false;
@@ -41,18 +427,116 @@ public:
 
     virtual void BeginPlay() override;
     virtual void EndPlay(const EEndPlayReason::Type Reason) override;
+    virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
 
     // Native-only entry (int16 is not a Blueprint-supported element type)
     void PushAudioPCM(const TArray<int16>& InterleavedFrames, int32 FramesPerChannel);
 
     UFUNCTION(BlueprintCallable, Category="LiveKit")
     void SendMocap(const TArray<uint8>& Payload, bool bReliable);
+    // bOrdered=false: each packet is delivered on arrival, so one loss never stalls later packets.
+    // Fails if another registered channel already uses Label.
     UFUNCTION(BlueprintCallable, Category="LiveKit|Data")
     bool RegisterMocapChannel(FName ChannelName, const FString& Label, bool bReliable, bool bOrdered = true);
     UFUNCTION(BlueprintCallable, Category="LiveKit|Data")
     bool UnregisterMocapChannel(FName ChannelName);
     UFUNCTION(BlueprintCallable, Category="LiveKit|Data")
     bool SendMocapOnChannel(FName ChannelName, const TArray<uint8>& Payload);
+    // Native-only: hands Payload to the FFI without a copy (Payload is left empty)
+    bool SendMocapOnChannelOwned(FName ChannelName, TArray<uint8>&& Payload);
+    // Deliver only to the given participants (IDs from OnParticipantJoined); others never download it
+    UFUNCTION(BlueprintCallable, Category="LiveKit|Data")
+    bool SendMocapToParticipants(FName ChannelName, const TArray<uint8>& Payload, const TArray<int32>& ParticipantIds);
+    // Drop unordered packets older than the newest one already received from the same sender
+    UFUNCTION(BlueprintCallable, Category="LiveKit|Data")
+    bool SetChannelSequenced(FName ChannelName, bool bSequenced);
+    // Queue the channel's sends under a priority class (lower = more urgent) with an optional rate limit
+    UFUNCTION(BlueprintCallable, Category="LiveKit|Data")
+    bool SetChannelPriority(FName ChannelName, int32 Priority, int32 Weight = 1, int32 RateLimitBytesPerSec = 0, int32 BurstBytes = 0);
+    UFUNCTION(BlueprintCallable, Category="LiveKit|Data")
+    FLiveKitChannelSendStats GetChannelSendStats(FName ChannelName) const;
+    // Send frames as deltas against a periodic keyframe; suits same-sized, slowly changing payloads such as poses
+    UFUNCTION(BlueprintCallable, Category="LiveKit|Data")
+    bool SetChannelDeltaCoding(FName ChannelName, bool bEnable, int32 KeyframeInterval = 30, bool bLz4 = false);
+    UFUNCTION(BlueprintCallable, Category="LiveKit|Data")
+    FLiveKitDeltaStats GetChannelDeltaStats(FName ChannelName) const;
+    // Compress the channel's sends; receivers decompress without setup unless a dictionary is used,
+    // in which case they need the same dictionary (Codec None + Dictionary = decode only)
+    UFUNCTION(BlueprintCallable, Category="LiveKit|Data")
+    bool SetChannelCompression(FName ChannelName, ELiveKitCompression Codec, int32 Level, const TArray<uint8>& Dictionary);
+    UFUNCTION(BlueprintCallable, Category="LiveKit|Data")
+    FLiveKitCompressionStats GetCompressionStats() const;
+    // Send a parity packet after every GroupSize lossy sends (2-32, 0 = off); receivers rebuild
+    // any single lost packet of a group without a retransmission
+    UFUNCTION(BlueprintCallable, Category="LiveKit|Data")
+    bool SetChannelFec(FName ChannelName, int32 GroupSize);
+    UFUNCTION(BlueprintCallable, Category="LiveKit|Data")
+    FLiveKitFecStats GetFecStats() const;
+    // Recommend a send rate between MinHz and MaxHz from the link estimate and the channel's
+    // send queue; nothing is throttled, read GetRecommendedRate or handle OnRecommendedRateChanged.
+    // MaxHz 0 turns it off.
+    UFUNCTION(BlueprintCallable, Category="LiveKit|Data")
+    bool SetChannelRateControl(FName ChannelName, float MinHz, float MaxHz);
+    // 0 if the channel has no rate control
+    UFUNCTION(BlueprintCallable, Category="LiveKit|Data")
+    float GetRecommendedRate(FName ChannelName) const;
+    UFUNCTION(BlueprintCallable, Category="LiveKit|Data")
+    FLiveKitLinkStats GetLinkStats() const;
+    // Fired when a channel's recommended rate moves by more than 10% or reaches a bound
+    UFUNCTION(BlueprintImplementableEvent, Category="LiveKit|Data")
+    void OnRecommendedRateChanged(FName ChannelName, float Hz);
+    // Stamp the channel's sends with the room clock; receivers get FLiveKitMocapPacket::LatencyMs
+    UFUNCTION(BlueprintCallable, Category="LiveKit|Data")
+    bool SetChannelTimestamps(FName ChannelName, bool bEnable);
+    UFUNCTION(BlueprintCallable, Category="LiveKit|Data")
+    FLiveKitClockSyncStats GetClockSyncStats() const;
+    // Room clock in microseconds, shared by all clock-synced participants (local clock until synced)
+    UFUNCTION(BlueprintPure, Category="LiveKit|Data")
+    int64 GetSyncedTimeMicros() const;
+    // Discard sends still queued after MaxAgeMs instead of delivering them late (0 = never)
+    UFUNCTION(BlueprintCallable, Category="LiveKit|Data")
+    bool SetChannelMaxAge(FName ChannelName, int32 MaxAgeMs);
+
+    // Quantized pose codec: bone 0 is the root; other positions are encoded relative to it
+    UFUNCTION(BlueprintCallable, Category="LiveKit|Pose")
+    static bool EncodePose(const TArray<FTransform>& Bones, const FLiveKitPoseCodecSettings& Settings, TArray<uint8>& OutPayload);
+    UFUNCTION(BlueprintCallable, Category="LiveKit|Pose")
+    static bool DecodePose(const TArray<uint8>& Payload, TArray<FTransform>& OutBones);
+    // Encode with PoseCodecSettings and send without a further copy
+    UFUNCTION(BlueprintCallable, Category="LiveKit|Pose")
+    bool SendPoseOnChannel(FName ChannelName, const TArray<FTransform>& Bones);
+    // Buffer received poses on the channel per sender and play them out smoothly via SamplePose.
+    // The delay adapts to network jitter between the bounds; it needs timestamps on the sender
+    // (SetChannelTimestamps), otherwise arrival times are used and only frame spacing is smoothed.
+    UFUNCTION(BlueprintCallable, Category="LiveKit|Pose")
+    bool SetChannelPosePlayout(FName ChannelName, bool bEnable, int32 BoneCount, int32 MinDelayMs = 0, int32 MaxDelayMs = 200);
+    // Interpolated pose of SenderId for the current time; false until its first frame arrives
+    UFUNCTION(BlueprintCallable, Category="LiveKit|Pose")
+    bool SamplePose(FName ChannelName, int32 SenderId, TArray<FTransform>& OutBones);
+    UFUNCTION(BlueprintCallable, Category="LiveKit|Pose")
+    FLiveKitPosePlayoutStats GetPosePlayoutStats(FName ChannelName, int32 SenderId) const;
+
+    // Keyed latest-value channels: only the newest value per key is sent each tick
+    UFUNCTION(BlueprintCallable, Category="LiveKit|State")
+    bool CreateStateChannel(FName ChannelName, const FString& Label, bool bReliable = false, int32 TickHz = 60);
+    UFUNCTION(BlueprintCallable, Category="LiveKit|State")
+    bool DestroyStateChannel(FName ChannelName);
+    UFUNCTION(BlueprintCallable, Category="LiveKit|State")
+    bool WriteState(FName ChannelName, int32 Key, const TArray<uint8>& Value);
+
+    // Large reliable payloads of any size, streamed in chunks. Returns the transfer ID (0 on failure).
+    UFUNCTION(BlueprintCallable, Category="LiveKit|Data")
+    int64 SendLargePayload(const FString& Label, const TArray<uint8>& Payload);
+    // Native-only: keeps Payload alive for the transfer without a copy (Payload is left empty)
+    int64 SendLargePayloadOwned(const FString& Label, TArray<uint8>&& Payload);
+    UFUNCTION(BlueprintCallable, Category="LiveKit|Data")
+    bool CancelLargeTransfer(int64 TransferId);
+
+    UFUNCTION(BlueprintImplementableEvent, Category="LiveKit|Data")
+    void OnLargeTransferProgress(int64 TransferId, int64 BytesDone, int64 BytesTotal);
+
+    UFUNCTION(BlueprintImplementableEvent, Category="LiveKit|Data")
+    void OnLargeTransferFinished(int64 TransferId, bool bSuccess);
 
     // Test controls
     UFUNCTION(BlueprintCallable, Category="LiveKit|Test") void StartDebugTone();
@@ -63,6 +547,47 @@ public:
     UFUNCTION(BlueprintImplementableEvent, Category="LiveKit")
     void OnMocapReceived(const TArray<uint8>& Payload);
 
+    // Fired once per tick with every packet received since the previous tick
+    UFUNCTION(BlueprintImplementableEvent, Category="LiveKit|Data")
+    void OnMocapBatchReceived(const TArray<FLiveKitMocapPacket>& Packets);
+
+    UFUNCTION(BlueprintCallable, Category="LiveKit|Data")
+    FLiveKitInboundStats GetInboundStats() const;
+
+    // WebRTC stats, refreshed once a second after the first call (zero until then); cheap to poll
+    UFUNCTION(BlueprintCallable, Category="LiveKit|Stats")
+    FLiveKitTransportStats GetTransportStats(bool bSubscriber = false) const;
+    UFUNCTION(BlueprintCallable, Category="LiveKit|Stats")
+    TArray<FLiveKitTrackStats> GetTrackStats() const;
+    // A track made with CreateAudioTrack; false if there is no such track
+    UFUNCTION(BlueprintCallable, Category="LiveKit|Stats")
+    bool GetAudioTrackStats(FName TrackName, FLiveKitAudioTrackStats& OutStats) const;
+    // Every published (including the default track) and subscribed audio track
+    UFUNCTION(BlueprintCallable, Category="LiveKit|Stats")
+    TArray<FLiveKitAudioTrackStats> GetAllAudioTrackStats() const;
+    // Since the connection started or the last call with bReset, which starts a new window
+    UFUNCTION(BlueprintCallable, Category="LiveKit|Stats")
+    FLiveKitLatencyStats GetLatencyStats(bool bReset = false) const;
+    // Hot-path tracing, process-wide; false unless the FFI library was built with trace_spans
+    UFUNCTION(BlueprintCallable, Category="LiveKit|Stats")
+    static bool SetTraceRecording(bool bEnabled);
+    // Writes Chrome trace JSON (chrome://tracing, ui.perfetto.dev); a relative path is under Saved/Profiling
+    UFUNCTION(BlueprintCallable, Category="LiveKit|Stats")
+    static bool DumpTrace(const FString& FileName);
+
+    // Participant/track registry (IDs are stable for the component's connection lifetime)
+    UFUNCTION(BlueprintPure, Category="LiveKit|Participants")
+    FString GetParticipantIdentity(int32 ParticipantId) const;
+
+    UFUNCTION(BlueprintImplementableEvent, Category="LiveKit|Participants")
+    void OnParticipantJoined(int32 ParticipantId, const FString& Identity);
+
+    UFUNCTION(BlueprintImplementableEvent, Category="LiveKit|Participants")
+    void OnParticipantLeft(int32 ParticipantId, const FString& Identity);
+
+    UFUNCTION(BlueprintImplementableEvent, Category="LiveKit|Participants")
+    void OnRemoteTrackSubscribed(int32 ParticipantId, int32 TrackId, const FString& TrackName);
+
     // Blueprint-friendly feedback events
     UFUNCTION(BlueprintImplementableEvent, Category="LiveKit")
     void OnConnected(const FString& InUrl, ELiveKitClientRole InRole, bool bRecvMocapFlag, bool bRecvAudioFlag);
@@ -92,12 +617,60 @@ public:
 private:
     class LiveKitClient* Client = nullptr;
     TMap<FName, TUniquePtr<LiveKitDataChannel>> DataChannels;
+    // Channels given a send class via SetChannelPriority; polled for STAT LiveKit
+    TSet<FName> ClassedChannels;
+    // Inbound topic handlers registered with the FFI, keyed like DataChannels
+    TMap<FName, TUniquePtr<FLiveKitInboundChannel>> InboundChannels;
+    TMap<FName, TUniquePtr<LiveKitStateChannel>> StateChannels;
+    TMap<FName, TUniquePtr<FLiveKitInboundChannel>> InboundStateChannels;
     TMap<FName, TUniquePtr<LiveKitAudioTrack>> AudioTracks;
+    // Payload copies owned until the FFI reports a terminal transfer state
+    TMap<int64, TUniquePtr<TArray<uint8>>> LargeTransfers;
+    TMap<FName, TUniquePtr<FLiveKitPosePlayout>> PosePlayouts;
+
+    // Inbound data: FFI thread enqueues, game thread drains in TickComponent.
+    // Payload buffers cycle back through InboundBufferPool to avoid per-packet allocations.
+    // The pool is single-consumer: only the FFI thread dequeues from it.
+    TUniquePtr<TCircularQueue<FLiveKitInboundMessage>> InboundQueue;
+    TUniquePtr<TCircularQueue<TArray<uint8>>> InboundBufferPool;
+    // Game-thread-only buffers for deferred copies (bDeferInboundCopy)
+    TArray<TArray<uint8>> DeferredCopyPool;
+    TArray<FLiveKitMocapPacket> InboundBatch;
+    TArray<FLiveKitDeferredPayload> InboundBatchDeferred; // parallel to InboundBatch
+    void DispatchInbound();
+    void PushPosePlayout(const FLiveKitInboundMessage& Message);
+    void EnqueueInbound(FName Channel, uint32 SenderId, int32 StateKey, const uint8_t* Bytes, size_t Len);
+    void EnqueueInboundDeferred(FName Channel, uint32 SenderId, const uint8_t* Bytes, size_t Len, LkDataBuffer* Buffer);
+    void ReleaseInboundQueue();
+    void RecycleInboundBuffer(TArray<uint8>&& Buffer);
+    // Label -> FName for the catch-all data callbacks. Only those callbacks touch it, and the
+    // FFI serializes them under its client lock, so it needs no lock of its own.
+    TArray<TPair<TArray<ANSICHAR>, FName>> CallbackLabelNames;
+    FName CallbackLabelName(const char* Label);
+
+    std::atomic<int64> InboundPacketsReceived{0};
+    std::atomic<int64> InboundBytesReceived{0};
+    std::atomic<int64> InboundPacketsDropped{0};
+    int64 InboundPacketsCollapsed = 0;
+    int64 InboundBatchesDispatched = 0;
+
+    // Feeds the STAT LiveKit queue depths and their Insights counters while either is recording
+    void PollProfilingStats();
+    double NextStatsPollTime = 0.0;
+
+    // Game-thread copy of the FFI registry (ID -> identity)
+    TMap<int32, FString> ParticipantIdentities;
 
     // C callback thunks
-    static void DataThunk(void* User, const uint8_t* bytes, size_t len);
-    static void AudioThunk(void* User, const int16_t* pcm, size_t frames_per_channel, int32_t channels, int32_t sample_rate);
-    static void AudioThunkEx(void* User, const int16_t* pcm, size_t frames_per_channel, int32_t channels, int32_t sample_rate, const char* participant_name, const char* track_name);
+    static void DataHandlerThunk(void* User, const LkDataMessageInfo* Info, const uint8_t* bytes, size_t len);
+    static void StateHandlerThunk(void* User, const LkDataMessageInfo* Info, uint32_t key, const uint8_t* bytes, size_t len);
+    static void DataThunkFrom(void* User, uint32_t participant_id, const char* label, LkReliability reliability, const uint8_t* bytes, size_t len);
+    static void DataThunkBuffered(void* User, uint32_t participant_id, const char* label, LkReliability reliability, const uint8_t* bytes, size_t len, LkDataBuffer* buffer);
+    static void AudioThunkIds(void* User, const int16_t* pcm, size_t frames_per_channel, int32_t channels, int32_t sample_rate, uint32_t participant_id, uint32_t track_id);
+    static void TransferThunk(void* User, uint64_t transfer_id, LkTransferState state, uint64_t bytes_done, uint64_t bytes_total);
+    static void RegistryThunk(void* User, LkRegistryEvent event, uint32_t participant_id, uint32_t track_id, const char* participant_identity, const char* track_name);
+    static void RateThunk(void* User, const char* label, float hz);
+    static void LogThunk(void* User, LkLogLevel level, const char* target, const char* message, int64_t timestamp_us);
 
     // Test state
     FTimerHandle ToneTimerHandle;
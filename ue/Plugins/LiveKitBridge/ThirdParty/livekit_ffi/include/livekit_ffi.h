@@ -40,6 +40,11 @@ typedef struct LkClientHandle LkClientHandle;
  */
 typedef struct LkAudioTrackHandle LkAudioTrackHandle;
 
+/**
+ * Opaque keyed state channel handle (see lk_state_channel_create).
+ */
+typedef struct LkStateChannelHandle LkStateChannelHandle;
+
 /**
  * Data channel reliability mode.
  */
@@ -77,6 +82,35 @@ typedef enum {
   LkLogTrace = 4
 } LkLogLevel;
 
+/**
+ * Registry event kinds (see LkRegistryCallback).
+ */
+typedef enum {
+  LkParticipantJoined = 0,
+  LkParticipantLeft = 1,
+  LkTrackSubscribed = 2,
+  LkTrackUnsubscribed = 3
+} LkRegistryEvent;
+
+/**
+ * Receive-side filtering for unordered (ordered = 0) messages (see lk_set_receive_filter).
+ */
+typedef enum {
+  LkReceiveDedup = 0,     // drop duplicate deliveries (default)
+  LkReceiveSequenced = 1  // also drop messages older than the newest already delivered
+} LkReceiveFilter;
+
+/**
+ * Large transfer states (see lk_send_large, lk_register_stream_handler).
+ * Every transfer reports exactly one terminal state (anything but InProgress).
+ */
+typedef enum {
+  LkTransferInProgress = 0,
+  LkTransferCompleted = 1,
+  LkTransferFailed = 2,
+  LkTransferCancelled = 3
+} LkTransferState;
+
 // ═══════════════════════════════════════════════════════════════════════════
 // Callbacks
 // ═══════════════════════════════════════════════════════════════════════════
@@ -108,6 +142,105 @@ typedef void (*LkAudioCallback)(void* user, const int16_t* pcm_interleaved, size
  */
 typedef void (*LkAudioCallbackEx)(void* user, const int16_t* pcm_interleaved, size_t frames_per_channel, int32_t channels, int32_t sample_rate, const char* participant_name, const char* track_name);
 
+/**
+ * Audio callback with interned participant/track IDs (see LkRegistryCallback).
+ * Carries no strings, so per-frame routing is an integer lookup.
+ * NOTE: Callbacks may be invoked on background threads. Never block internally.
+ */
+typedef void (*LkAudioCallbackIds)(void* user, const int16_t* pcm_interleaved, size_t frames_per_channel, int32_t channels, int32_t sample_rate, uint32_t participant_id, uint32_t track_id);
+
+/**
+ * Data callback with sender identity.
+ * - participant_id: interned ID of the sending participant (0 if unknown)
+ * NOTE: Callbacks may be invoked on background threads. Never block internally.
+ */
+typedef void (*LkDataCallbackFrom)(void* user, uint32_t participant_id, const char* label, LkReliability reliability, const uint8_t* bytes, size_t len);
+
+/**
+ * Opaque reference to a received message's bytes (see LkDataCallbackBuffered).
+ */
+typedef struct LkDataBuffer LkDataBuffer;
+
+/**
+ * Data callback that takes ownership of the message. Unlike the other data callbacks,
+ * bytes stays valid after the callback returns, until buffer is passed to lk_data_release,
+ * so the message can be queued for another thread without copying it.
+ * Every invocation must be matched by exactly one lk_data_release(buffer).
+ * NOTE: Callbacks may be invoked on background threads. Never block internally.
+ */
+typedef void (*LkDataCallbackBuffered)(void* user, uint32_t participant_id, const char* label, LkReliability reliability, const uint8_t* bytes, size_t len, LkDataBuffer* buffer);
+
+/**
+ * Registry callback, invoked when a participant joins (including those already in the room at
+ * connect and every rejoin) or a track is first assigned an ID, and again when it leaves / is
+ * unsubscribed.
+ * IDs are small integers starting at 1, stable for the client's lifetime and never reused
+ * (a participant that rejoins keeps its ID).
+ * - track_id: 0 for participant events
+ * - participant_identity: never NULL
+ * - track_name: NULL for participant events
+ * NOTE: Callbacks may be invoked on background threads. Never block internally.
+ */
+typedef void (*LkRegistryCallback)(void* user, LkRegistryEvent event, uint32_t participant_id, uint32_t track_id, const char* participant_identity, const char* track_name);
+
+/**
+ * Per-message metadata passed to topic handlers (see lk_register_data_handler).
+ * Valid only for the duration of the callback.
+ * - label: the topic the handler was registered for (never NULL)
+ * - participant_id: interned ID of the sender (0 if unknown)
+ * - sender_time_us: send time in the local clock, as lk_data_sender_time_us (0 if unknown)
+ */
+typedef struct {
+  const char* label;
+  uint32_t participant_id;
+  LkReliability reliability;
+  int64_t sender_time_us;
+} LkDataMessageInfo;
+
+/**
+ * Topic handler callback; receives only messages for the topic it was registered on.
+ * NOTE: Callbacks may be invoked on background threads. Never block internally.
+ */
+typedef void (*LkDataHandler)(void* user, const LkDataMessageInfo* info, const uint8_t* bytes, size_t len);
+
+/**
+ * State handler callback; receives one keyed value from a state channel
+ * (see lk_register_state_handler). Values older than the last one delivered
+ * for the same (sender, key) are never passed on.
+ * NOTE: Callbacks may be invoked on background threads. Never block internally.
+ */
+typedef void (*LkStateHandler)(void* user, const LkDataMessageInfo* info, uint32_t key, const uint8_t* bytes, size_t len);
+
+/**
+ * Progress callback for lk_send_large; called after each chunk and once with a terminal state.
+ * The payload buffer may be released once a terminal state is reported.
+ * NOTE: Callbacks may be invoked on background threads. Never block internally.
+ */
+typedef void (*LkTransferCallback)(void* user, uint64_t transfer_id, LkTransferState state, uint64_t bytes_done, uint64_t bytes_total);
+
+/**
+ * Per-chunk metadata passed to stream handlers (see lk_register_stream_handler).
+ * Valid only for the duration of the callback.
+ * - transfer_id: identifies the stream; pass to lk_cancel_transfer to stop reading it
+ * - offset: byte offset of this chunk within the stream
+ * - total_length: announced stream size (0 if the sender did not announce one)
+ * - state: InProgress for data chunks; the final call carries the terminal state and no data
+ */
+typedef struct {
+  const char* label;
+  uint32_t participant_id;
+  uint64_t transfer_id;
+  uint64_t offset;
+  uint64_t total_length;
+  LkTransferState state;
+} LkStreamChunkInfo;
+
+/**
+ * Stream handler callback; receives chunks of large reliable payloads as they arrive.
+ * NOTE: Callbacks may be invoked on background threads. Never block internally.
+ */
+typedef void (*LkStreamChunkCallback)(void* user, const LkStreamChunkInfo* info, const uint8_t* bytes, size_t len);
+
 /**
  * Audio format change notification callback.
  * Called when the incoming audio format changes.
@@ -124,6 +257,14 @@ typedef void (*LkAudioFormatChangeCallback)(void* user, int32_t sample_rate, int
  */
 typedef void (*LkConnectionCallback)(void* user, LkConnectionState state, int32_t reason_code, const char* message);
 
+/**
+ * Log line callback (see lk_set_log_callback).
+ * - target: the emitting module, e.g. "livekit_ffi::backend_livekit"
+ * - timestamp_us: local wall clock when the line was logged, microseconds since the Unix epoch
+ * Both strings are valid only during the call.
+ */
+typedef void (*LkLogCallback)(void* user, LkLogLevel level, const char* target, const char* message, int64_t timestamp_us);
+
 // ═══════════════════════════════════════════════════════════════════════════
 // Diagnostic Structures
 // ═══════════════════════════════════════════════════════════════════════════
@@ -140,16 +281,162 @@ typedef struct {
   int32_t overruns;
 } LkAudioStats;
 
+/**
+ * Statistics of one audio track, published (remote = 0) or subscribed (remote = 1).
+ * - name: track name, NUL-terminated and truncated to fit
+ * - queued_ms / high_water_ms / capacity_ms: published; audio waiting in the ring, its peak
+ *   since the track was created, and the ring size
+ * - underruns: published; 10 ms frames padded with silence because the ring ran dry
+ * - overruns: published; pushes cut short by a full ring
+ * - last_frame_us: lk_now_local_us of the last push (published) or of the last frame
+ *   delivered to the audio callback (subscribed); 0 if none yet
+ * - participant_id / track_id: subscribed; the IDs passed to LkAudioCallbackIds
+ * - frames_received: subscribed; frames delivered to the audio callback
+ * - samples_received / concealed_samples: subscribed; samples played out by WebRTC and those
+ *   it synthesized to conceal loss (their ratio is the concealed fraction)
+ * - jitter_buffer_ms: subscribed; average jitter buffer delay over the last poll interval
+ * The subscribed-track WebRTC figures come from the stats poll lk_get_audio_track_stats
+ * starts (see lk_get_transport_stats) and are 0 until it has run.
+ */
+typedef struct {
+  char name[64];
+  int32_t remote;
+  int32_t sample_rate;
+  int32_t channels;
+  int32_t queued_ms;
+  int32_t high_water_ms;
+  int32_t capacity_ms;
+  int32_t underruns;
+  int32_t overruns;
+  int64_t last_frame_us;
+  uint32_t participant_id;
+  uint32_t track_id;
+  int64_t frames_received;
+  int64_t samples_received;
+  int64_t concealed_samples;
+  float jitter_buffer_ms;
+} LkAudioTrackStats;
+
 /**
  * Data channel statistics for diagnostics.
+ * - batched_messages / batch_packets: messages and packets sent through send batching
+ *   (see lk_set_data_batching); their ratio is the average messages per packet
+ * - unordered_retransmits: reliable-unordered packets sent again for a missing ack
+ * - duplicates_dropped / stale_dropped: unordered messages removed by the receive filter
+ * - expired_dropped: messages discarded unsent because they outlived max_age_ms
+ * - compressed_raw_bytes / compressed_wire_bytes: messages sent compressed (see
+ *   lk_set_data_compression), before and after; compression_ratio is their quotient
+ *   (0 before any compressed send)
+ * - decompress_failed: compressed messages dropped on receive (missing dictionary, corrupt)
+ * - fec_messages / fec_parity_packets: lossy messages sent in FEC groups (see
+ *   lk_set_data_fec) and the parity packets added; fec_overhead_ratio is the bytes FEC
+ *   added over the message bytes it protected
+ * - fec_recovered / fec_unrecovered: received messages rebuilt from parity, and those
+ *   lost in groups missing more than one
  */
 typedef struct {
   int64_t reliable_sent_bytes;
   int64_t reliable_dropped;
   int64_t lossy_sent_bytes;
   int64_t lossy_dropped;
+  int64_t batched_messages;
+  int64_t batch_packets;
+  int64_t unordered_retransmits;
+  int64_t duplicates_dropped;
+  int64_t stale_dropped;
+  int64_t expired_dropped;
+  int64_t compressed_messages;
+  int64_t compressed_raw_bytes;
+  int64_t compressed_wire_bytes;
+  double compression_ratio;
+  int64_t decompress_failed;
+  int64_t fec_messages;
+  int64_t fec_parity_packets;
+  double fec_overhead_ratio;
+  int64_t fec_recovered;
+  int64_t fec_unrecovered;
 } LkDataStats;
 
+typedef enum {
+  LkCandidateUnknown = 0,
+  LkCandidateHost = 1,
+  LkCandidateSrflx = 2,   /* address seen by a STUN server (NAT) */
+  LkCandidatePrflx = 3,
+  LkCandidateRelay = 4,   /* through a TURN server */
+} LkCandidateType;
+
+/**
+ * One peer connection's transport, from its nominated ICE candidate pair.
+ * - connected: 1 once a pair is nominated; the other fields are 0 until then
+ * - send_bps / receive_bps: over the last poll interval (about 1 s)
+ * - tcp: 1 if the local candidate is TCP (ICE-TCP or TURN over TCP)
+ * - updated_us: lk_now_local_us at the poll; 0 before the first
+ */
+typedef struct {
+  int32_t connected;
+  int64_t rtt_us;
+  double available_outgoing_bps;
+  double available_incoming_bps;
+  int64_t bytes_sent;
+  int64_t bytes_received;
+  double send_bps;
+  double receive_bps;
+  LkCandidateType local_candidate;
+  LkCandidateType remote_candidate;
+  int32_t tcp;
+  int64_t updated_us;
+} LkTransportStats;
+
+/**
+ * RTP stats of one published or subscribed media track.
+ * - name: track name, NUL-terminated and truncated to fit
+ * - participant_id / track_id: registry IDs of a subscribed track; 0 for published ones
+ * - packets / bytes / bitrate_bps: sent or received; bitrate over the last poll interval
+ * - packets_lost / loss: inbound, as counted here over the track's lifetime; outbound, as
+ *   the receiving end last reported over RTCP
+ * - rtt_us, retransmitted_packets, target_bitrate_bps: outbound only
+ */
+typedef struct {
+  char name[64];
+  int32_t outbound;
+  int32_t video;
+  uint32_t participant_id;
+  uint32_t track_id;
+  int64_t packets;
+  int64_t bytes;
+  double bitrate_bps;
+  int64_t packets_lost;
+  double loss;
+  int64_t jitter_us;
+  int64_t rtt_us;
+  int64_t nack_count;
+  int64_t pli_count;
+  int64_t retransmitted_packets;
+  double target_bitrate_bps;
+} LkTrackStats;
+
+/**
+ * Latency distribution of one hot path over the recording window, in microseconds.
+ * Percentiles are accurate to about 6%. All zero when nothing was recorded.
+ */
+typedef struct {
+  int64_t count;
+  double min_us;
+  double max_us;
+  double mean_us;
+  double p50_us;
+  double p90_us;
+  double p99_us;
+  double p999_us;
+} LkLatencySummary;
+
+typedef struct {
+  LkLatencySummary audio_ring;  // published PCM from lk_publish_audio_pcm_i16* until its frame is captured
+  LkLatencySummary send;        // data sends from the call (or enqueue) until the publish completes
+  LkLatencySummary dispatch;    // received data / audio from arrival until its callback starts
+  LkLatencySummary callback;    // time spent inside data and audio callbacks
+} LkLatencyStats;
+
 // ═══════════════════════════════════════════════════════════════════════════
 // Client Lifecycle
 // ═══════════════════════════════════════════════════════════════════════════
@@ -187,6 +474,58 @@ LkResult lk_client_set_audio_callback(LkClientHandle*, LkAudioCallback cb, void*
  */
 LkResult lk_client_set_audio_callback_ex(LkClientHandle*, LkAudioCallbackEx cb, void* user);
 
+/**
+ * Set audio callback carrying interned participant/track IDs.
+ * Overrides any previously set standard or extended audio callback.
+ */
+LkResult lk_client_set_audio_callback_ids(LkClientHandle*, LkAudioCallbackIds cb, void* user);
+
+/**
+ * Set data callback carrying the sender's interned participant ID.
+ * Takes precedence over the original and extended data callbacks.
+ */
+LkResult lk_client_set_data_callback_from(LkClientHandle*, LkDataCallbackFrom cb, void* user);
+
+/**
+ * Set a data callback that takes ownership of each message (see LkDataCallbackBuffered).
+ * Takes precedence over all other data callbacks; topic handlers still come first.
+ * Messages are shared with the received packet, not copied.
+ */
+LkResult lk_client_set_data_callback_buffered(LkClientHandle*, LkDataCallbackBuffered cb, void* user);
+
+/**
+ * Release a buffer handed out by LkDataCallbackBuffered. Safe to call from any thread,
+ * and after the client is destroyed. NULL is ignored.
+ */
+void lk_data_release(LkDataBuffer* buffer);
+
+/**
+ * Set participant/track registry callback.
+ * Participants already in the room are announced on connect.
+ */
+LkResult lk_set_registry_callback(LkClientHandle*, LkRegistryCallback cb, void* user);
+
+/**
+ * Look up the identity for an interned participant ID.
+ * Copies a NUL-terminated string into buf (truncated to buf_len - 1 bytes).
+ * Returns error 5 if the ID is unknown.
+ */
+LkResult lk_get_participant_identity(LkClientHandle*, uint32_t participant_id, char* buf, size_t buf_len);
+
+/**
+ * Look up the owning participant and name for an interned track ID.
+ * out_participant_id may be NULL. Returns error 5 if the ID is unknown.
+ */
+LkResult lk_get_track_info(LkClientHandle*, uint32_t track_id, uint32_t* out_participant_id, char* buf, size_t buf_len);
+
+/**
+ * Register a handler for one data topic (label). Topic matching happens inside the FFI,
+ * so each handler sees only its own channel. Pass cb = NULL to remove the handler.
+ * Topics with a handler bypass the catch-all data callbacks; topics with neither a
+ * handler nor a catch-all callback are dropped before any copy.
+ */
+LkResult lk_register_data_handler(LkClientHandle*, const char* label, LkDataHandler cb, void* user);
+
 /**
  * Set audio format change callback.
  * Called when incoming audio format changes.
@@ -312,6 +651,9 @@ LkResult lk_audio_track_publish_pcm_i16(
   const int16_t* pcm_interleaved,
   size_t frames_per_channel);
 
+/** Ring statistics of a dedicated audio track. */
+LkResult lk_audio_track_get_stats(LkAudioTrackHandle*, LkAudioTrackStats* out_stats);
+
 // ═══════════════════════════════════════════════════════════════════════════
 // Data Channel
 // ═══════════════════════════════════════════════════════════════════════════
@@ -332,6 +674,11 @@ LkResult lk_send_data(
  * - ordered: 1 to preserve order, 0 for unordered (default 1)
  * - label: optional label for the data channel (NULL uses default)
  *
+ * Unordered messages are delivered as soon as they arrive, so a lost packet never
+ * holds back later ones. Reliable + unordered messages are retransmitted to each peer
+ * until acknowledged (given up after ~5 s); lossy + unordered ones are sent once.
+ * Unordered messages must fit one packet (~1290 bytes); larger ones are sent ordered.
+ *
  * Size guidance: lossy ≤ ~1300 bytes, reliable ≤ ~15 KiB.
  */
 LkResult lk_send_data_ex(
@@ -342,12 +689,609 @@ LkResult lk_send_data_ex(
   int32_t ordered,
   const char* label);
 
+/**
+ * Send data to specific participants only, instead of the whole room.
+ * Fan-out bandwidth then scales with the number of recipients, not the room size.
+ * - max_age_ms: deadline as in LkSendOptions; 0 = none
+ * - identities: participant identities (count entries)
+ * Other parameters behave as in lk_send_data_ex. Targeted sends are never batched.
+ */
+LkResult lk_send_data_to(
+  LkClientHandle*,
+  const uint8_t* bytes,
+  size_t len,
+  LkReliability reliability,
+  int32_t ordered,
+  const char* label,
+  int32_t max_age_ms,
+  const char* const* identities,
+  size_t count);
+
+/**
+ * lk_send_data_to addressed by interned participant IDs (see LkRegistryCallback).
+ * Returns error 5 if any ID is unknown.
+ */
+LkResult lk_send_data_to_ids(
+  LkClientHandle*,
+  const uint8_t* bytes,
+  size_t len,
+  LkReliability reliability,
+  int32_t ordered,
+  const char* label,
+  int32_t max_age_ms,
+  const uint32_t* participant_ids,
+  size_t count);
+
+/**
+ * Per-message send options (see lk_send_data_opts).
+ * - reliability, ordered, label: as for lk_send_data_ex
+ * - max_age_ms: deadline; 0 = none. A message still queued when it is older than this is
+ *   discarded instead of sent (counted in LkDataStats.expired_dropped). Suits lossy
+ *   pose/mocap streams, where a late sample is worthless.
+ */
+typedef struct {
+  LkReliability reliability;
+  int32_t ordered;
+  const char* label;
+  int32_t max_age_ms;
+} LkSendOptions;
+
+/**
+ * Send data with per-message options. Messages with a deadline go through the send
+ * queue and return immediately; others behave exactly like lk_send_data_ex.
+ */
+LkResult lk_send_data_opts(LkClientHandle*, const uint8_t* bytes, size_t len, const LkSendOptions* opts);
+
+/**
+ * Release callback for lk_send_data_owned; receives the buffer that was passed in.
+ */
+typedef void (*LkReleaseCallback)(void* user, const uint8_t* bytes, size_t len);
+
+/**
+ * Send a caller-allocated buffer without copying it. The FFI takes ownership of bytes and
+ * calls release exactly once when it no longer needs them: after transmission, or on
+ * failure (possibly before this function returns). The buffer must stay valid and
+ * unmodified until then.
+ * Sends go through the send queue and return immediately. Reliable sends are written from
+ * the caller's memory; lossy packets are still copied into the outgoing packet.
+ * release is never called with an FFI lock held, so it may call lk_send_data_owned again,
+ * e.g. to resend a recycled buffer. It can run on an FFI thread.
+ * max_age_ms is a deadline as in LkSendOptions; 0 = none.
+ * Returns error 4 if release is NULL (nothing is released in that case).
+ */
+LkResult lk_send_data_owned(
+  LkClientHandle*,
+  const uint8_t* bytes,
+  size_t len,
+  LkReliability reliability,
+  int32_t ordered,
+  const char* label,
+  int32_t max_age_ms,
+  LkReleaseCallback release,
+  void* user);
+
+/**
+ * Send scheduler arbitration between data classes (see lk_set_send_scheduler).
+ */
+typedef enum {
+  LkSchedulerStrict = 0,   // lowest priority value with a sendable message goes first
+  LkSchedulerWeighted = 1  // bandwidth shared in proportion to weight
+} LkSchedulerMode;
+
+/**
+ * Send class for one data label (see lk_set_data_class).
+ * - priority: lower is more urgent (strict mode); unclassed labels use 100
+ * - weight: bandwidth share in weighted mode (0 = 1)
+ * - rate_bytes_per_sec: token-bucket rate limit (0 = unlimited)
+ * - burst_bytes: bucket size (0 = one second of rate)
+ */
+typedef struct {
+  int32_t priority;
+  int32_t weight;
+  int32_t rate_bytes_per_sec;
+  int32_t burst_bytes;
+} LkDataClassConfig;
+
+/**
+ * Per-class send queue statistics.
+ * - queue_depth / queued_bytes: messages currently waiting
+ * - wait_p50_us / wait_p95_us / wait_p99_us: time from send call to transmission,
+ *   over the most recent 512 messages
+ */
+typedef struct {
+  int64_t queue_depth;
+  int64_t queued_bytes;
+  int64_t sent_messages;
+  int64_t sent_bytes;
+  int64_t expired_dropped;
+  int64_t wait_p50_us;
+  int64_t wait_p95_us;
+  int64_t wait_p99_us;
+} LkDataClassStats;
+
+/**
+ * Give a data label its own send class. Ordered sends on the label then go through the
+ * send scheduler (returning immediately), which enforces the rate limit and arbitrates
+ * between classes so bulk traffic cannot delay latency-critical labels.
+ * Classed labels bypass send batching. Pass config = NULL to remove the class.
+ * May be called before connecting.
+ */
+LkResult lk_set_data_class(LkClientHandle*, const char* label, const LkDataClassConfig* config);
+
+/**
+ * Choose strict (default) or weighted arbitration between send classes.
+ */
+LkResult lk_set_send_scheduler(LkClientHandle*, LkSchedulerMode mode);
+
+/**
+ * Read send queue statistics for a class; label NULL or "" selects the default class
+ * (deadline sends on unclassed labels). Returns error 5 if the label has no class.
+ */
+LkResult lk_get_data_class_stats(LkClientHandle*, const char* label, LkDataClassStats* out_stats);
+
+/**
+ * Delta coding for a label (see lk_set_delta_channel).
+ * - keyframe_interval: frames between keyframes (0 = 30). Lossy receivers that miss a
+ *   keyframe drop frames until the next one, so this bounds recovery time.
+ * - use_lz4: also LZ4-compress each coded frame when that makes it smaller
+ */
+typedef struct {
+  int32_t keyframe_interval;
+  int32_t use_lz4;
+} LkDeltaConfig;
+
+/**
+ * Delta coding statistics for one label, both directions.
+ * - raw_bytes_sent / encoded_bytes_sent: before and after coding; compression_ratio is
+ *   their quotient (0 before any sends)
+ * - encode_ns_per_frame / decode_ns_per_frame: mean CPU time per frame
+ * - undecodable_dropped: deltas received without their keyframe
+ */
+typedef struct {
+  int64_t frames_sent;
+  int64_t keyframes_sent;
+  int64_t raw_bytes_sent;
+  int64_t encoded_bytes_sent;
+  int64_t encode_ns_per_frame;
+  int64_t frames_received;
+  int64_t undecodable_dropped;
+  int64_t decode_ns_per_frame;
+  double compression_ratio;
+} LkDeltaStats;
+
+/**
+ * Delta-code sends on a label: every keyframe_interval frames (and whenever the payload
+ * size changes, or a participant joins) a full keyframe is sent; frames in between are
+ * XORed against the last keyframe and packed as zero runs. Suits streams of same-sized,
+ * slowly changing frames such as poses. Receivers decode before any callback sees the data.
+ * Coded sends go through the send queue and return immediately. Targeted sends
+ * (lk_send_data_to) on the label are sent uncoded. Calling it again on a coded label
+ * changes the settings without restarting the stream. NULL config turns coding off.
+ */
+LkResult lk_set_delta_channel(LkClientHandle*, const char* label, const LkDeltaConfig* config);
+
+LkResult lk_get_delta_stats(LkClientHandle*, const char* label, LkDeltaStats* out_stats);
+
+/**
+ * Clock synchronization state (see lk_set_clock_sync).
+ * - synced: 1 once the room clock is known (at once when this participant is the reference)
+ * - reference_participant_id: participant whose clock is the room clock; 0 = this one
+ * - offset_us: room clock minus local clock
+ * - rtt_us: round trip of the sample the offset was taken from
+ * - outliers: samples delayed far beyond the best recent round trip (queueing); they do
+ *   not affect the offset
+ */
+typedef struct {
+  int32_t synced;
+  uint32_t reference_participant_id;
+  int64_t offset_us;
+  int64_t rtt_us;
+  int64_t samples;
+  int64_t outliers;
+} LkClockSyncStats;
+
+/**
+ * Synchronize to the room clock with ping/pong exchanges every interval_ms (0 stops). The
+ * room clock is the local clock of the participant with the lowest identity. The offset
+ * follows the lowest-RTT sample of the last 8, which filters out queueing delay. Every
+ * client answers pings, so only the participants that need synced time enable this.
+ * Typical interval: 2000 ms; the first 8 pings go out every 125 ms.
+ */
+LkResult lk_set_clock_sync(LkClientHandle*, int32_t interval_ms);
+LkResult lk_get_clock_sync_stats(LkClientHandle*, LkClockSyncStats* out_stats);
+
+/**
+ * Room clock in microseconds (close to Unix time) as estimated by this client; equal to
+ * lk_now_local_us while it is not synchronized (including after lk_disconnect) or for NULL.
+ */
+int64_t lk_now_synced_us(LkClientHandle*);
+
+/** Local clock in microseconds: Unix time at first use, advanced by a monotonic clock. */
+int64_t lk_now_local_us(void);
+
+/**
+ * Stamp sends on a label with the sender's room time. Receivers get it mapped into their
+ * local clock, so `lk_now_local_us() - lk_data_sender_time_us()` is the one-way latency.
+ * Timestamped messages go through the send queue; they are not batched or sent unordered.
+ */
+LkResult lk_set_data_timestamps(LkClientHandle*, const char* label, int32_t enabled);
+
+/**
+ * Send time of the message being delivered, in the local clock. Call it from inside a
+ * data callback; returns 0 if the label is not timestamped or either end is not yet
+ * synchronized. Audio frames carry no sender time.
+ */
+int64_t lk_data_sender_time_us(void);
+
+typedef enum {
+  LkCompressionNone = 0,  /* send raw; still decode with the configured dictionary */
+  LkCompressionLz4 = 1,   /* fast, modest ratio */
+  LkCompressionZstd = 2,  /* slower, better ratio; much better with a dictionary */
+} LkCompression;
+
+/**
+ * Compression for a label (see lk_set_data_compression).
+ * - level: zstd level (1-22, negative for faster modes; 0 = default); ignored for LZ4
+ * - dictionary / dictionary_len: optional zstd dictionary, copied. Receivers must
+ *   configure the same dictionary on the label to decode.
+ */
+typedef struct {
+  LkCompression codec;
+  int32_t level;
+  const uint8_t* dictionary;
+  size_t dictionary_len;
+} LkCompressionConfig;
+
+/**
+ * Compress sends on a label. Each compressed message carries a one-byte codec id, so
+ * receivers decompress before any callback sees the data without further setup (except a
+ * shared dictionary). The size limits apply to the compressed message: a 40 KiB JSON
+ * document that compresses below 15 KiB can be sent reliable. Messages that would not
+ * shrink are sent raw. Compressed sends go through the send queue and return immediately.
+ * Delta-coded labels are not compressed. NULL config turns compression off.
+ */
+LkResult lk_set_data_compression(LkClientHandle*, const char* label, const LkCompressionConfig* config);
+
+/**
+ * Train a zstd dictionary from `count` sample messages stored back to back in `samples`,
+ * with their sizes in `sample_sizes`. Writes at most `capacity` bytes (100 KiB is typical)
+ * to `out` and the size to `out_len`. Use a few hundred representative messages; fails
+ * with error 5 when there are too few. Not supported by the stub backend (error 501).
+ */
+LkResult lk_train_compression_dictionary(const uint8_t* samples, const size_t* sample_sizes, size_t count,
+                                         uint8_t* out, size_t capacity, size_t* out_len);
+
+/**
+ * Protect lossy sends on a label with XOR parity: after every group_size messages (2-32)
+ * one parity packet goes out, from which receivers rebuild any single lost message of the
+ * group before the callback sees it, with no retransmission. Recovered messages arrive
+ * with the group's parity, so after later messages. Overhead is 1/group_size packets.
+ * Messages over 1287 bytes and targeted sends go out unprotected; protected messages go
+ * through the send queue and are not batched or sent unordered. 0 turns it off.
+ * Receivers need no setup.
+ */
+LkResult lk_set_data_fec(LkClientHandle*, const char* label, int32_t group_size);
+
+typedef enum {
+  LkConnectionQualityUnknown = 0,
+  LkConnectionQualityExcellent = 1,
+  LkConnectionQualityGood = 2,
+  LkConnectionQualityPoor = 3,
+  LkConnectionQualityLost = 4,
+} LkConnectionQuality;
+
+/**
+ * Link estimate of the publisher transport, polled once a second while any label has
+ * rate control (see lk_set_rate_control) or transport stats are in use. Zero fields are
+ * unknown.
+ * - rtt_us: candidate pair round trip, falling back to clock sync
+ * - loss: fraction of published media packets lost (0..1), from RTCP; 0 without media
+ * - available_outgoing_bps: the transport's bandwidth estimate; may be 0 without media
+ * - quality: the server's rating of this participant's connection
+ * - updated_us: lk_now_local_us at the last poll; 0 before the first
+ */
+typedef struct {
+  int64_t rtt_us;
+  double loss;
+  double available_outgoing_bps;
+  LkConnectionQuality quality;
+  int64_t updated_us;
+} LkLinkStats;
+
+LkResult lk_get_link_stats(LkClientHandle*, LkLinkStats* out_stats);
+
+/**
+ * Rate control for a label (see lk_set_rate_control).
+ * - min_hz / max_hz: bounds of the recommended rate; it starts at max_hz
+ * - bandwidth_share: fraction of the available outgoing bandwidth the label may use
+ *   (0 = 0.5), with the label's average message size
+ */
+typedef struct {
+  float min_hz;
+  float max_hz;
+  float bandwidth_share;
+} LkRateControlConfig;
+
+/**
+ * Recommend a send rate for a label from the link estimate. Once a second the rate halves
+ * when the link shows congestion (loss over 10%, round trip well above its recent floor,
+ * the label's send queue p95 wait over 100 ms, or a poor quality rating) and otherwise
+ * climbs by max_hz/8 while loss stays under 2%. Advisory only: nothing is throttled, the
+ * sender reads the rate or gets callbacks. NULL config turns it off.
+ */
+LkResult lk_set_rate_control(LkClientHandle*, const char* label, const LkRateControlConfig* config);
+
+/** Current recommended rate; error 5 if the label has no rate control. */
+LkResult lk_get_recommended_rate(LkClientHandle*, const char* label, float* out_hz);
+
+/**
+ * Called when a label's recommended rate moves by more than 10% or reaches a bound, from
+ * a background thread without the client lock held. NULL removes the callback.
+ */
+typedef void (*LkRateCallback)(void* user, const char* label, float hz);
+LkResult lk_set_rate_callback(LkClientHandle*, LkRateCallback cb, void* user);
+
+/**
+ * Choose how unordered messages received on `label` are filtered.
+ * Duplicates are always dropped; LkReceiveSequenced additionally drops messages older
+ * than the newest one already delivered from the same sender (latest-wins streams).
+ * Has no effect on ordered traffic.
+ */
+LkResult lk_set_receive_filter(LkClientHandle*, const char* label, LkReceiveFilter filter);
+
 /**
  * Set default labels for reliable and lossy data channels.
  * If NULL, uses built-in defaults.
  */
 LkResult lk_set_default_data_labels(LkClientHandle*, const char* reliable_label, const char* lossy_label);
 
+/**
+ * Opt-in send batching for lk_send_data / lk_send_data_ex.
+ * Messages on the same label and reliability are length-prefixed into one packet,
+ * sent when the next message would not fit max_packet_bytes or flush_window_ms after
+ * the first message was queued. Receivers split packets back into the original messages
+ * before any data callback, so batching is transparent to them.
+ * - flush_window_ms: 0 = 5 ms
+ * - max_packet_bytes: 0 = 1300 (lossy packets never exceed 1300)
+ * Messages too large to share a packet, and targeted sends, go out unbatched but still
+ * behind their label's pending packets, so the label's order is kept; like batched ones,
+ * they are sent asynchronously. Disabling or reconfiguring flushes pending data first.
+ */
+LkResult lk_set_data_batching(LkClientHandle*, int32_t enabled, int32_t flush_window_ms, int32_t max_packet_bytes);
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Large Payload Transfers
+// ═══════════════════════════════════════════════════════════════════════════
+
+/**
+ * Send a reliable payload of any size on topic `label`, streamed in 64 KiB chunks
+ * from the caller's buffer without copying it. Returns immediately.
+ * - cb: required; reports progress and exactly one terminal state
+ * - out_transfer_id: optional; ID for lk_cancel_transfer
+ * The buffer must stay valid until the terminal callback (or until lk_disconnect /
+ * lk_client_destroy returns, which cancel in-flight transfers and wait for them, terminal
+ * callbacks included, so neither the buffer nor `user` is touched after they return).
+ * Receivers get the payload through their usual data callback or topic handler,
+ * or chunk by chunk through lk_register_stream_handler.
+ * Returns error 4 if bytes or cb is null, error 5 if len is 0 or label is empty.
+ */
+LkResult lk_send_large(
+  LkClientHandle*,
+  const uint8_t* bytes,
+  size_t len,
+  const char* label,
+  LkTransferCallback cb,
+  void* user,
+  uint64_t* out_transfer_id);
+
+/**
+ * Cancel an in-flight large transfer, sent or received. A pending send write is
+ * abandoned at once; receives stop at the next chunk boundary.
+ * Returns error 5 if the transfer is unknown or already finished.
+ */
+LkResult lk_cancel_transfer(LkClientHandle*, uint64_t transfer_id);
+
+/**
+ * Register a progressive handler for large payloads on topic `label`: chunks are
+ * delivered as they arrive instead of after the whole payload is buffered.
+ * Takes precedence over lk_register_data_handler for streamed payloads on the same
+ * topic. Pass cb = NULL to remove the handler.
+ */
+LkResult lk_register_stream_handler(LkClientHandle*, const char* label, LkStreamChunkCallback cb, void* user);
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Keyed State Channels
+// ═══════════════════════════════════════════════════════════════════════════
+
+/**
+ * Keyed latest-value channel configuration.
+ * - label: channel label (required); receivers register with lk_register_state_handler
+ * - reliability: lossy suits pose/transform streams; reliable suits slow-changing state
+ * - tick_hz: scheduler rate; dirty keys are sent once per tick (0 = 60 Hz, max 1000)
+ * - max_packet_bytes: packet size cap (0 = 1300; lossy is capped at 1300, reliable at 15 KiB)
+ */
+typedef struct {
+  const char* label;
+  LkReliability reliability;
+  int32_t tick_hz;
+  int32_t max_packet_bytes;
+} LkStateChannelConfig;
+
+/**
+ * State channel counters.
+ * - updates_superseded: writes replaced by a newer write before they were sent
+ * - packets_dropped: packets the transport refused to send
+ */
+typedef struct {
+  int64_t updates_written;
+  int64_t updates_superseded;
+  int64_t updates_sent;
+  int64_t packets_sent;
+  int64_t bytes_sent;
+  int64_t packets_dropped;
+} LkStateChannelStats;
+
+/**
+ * Create a keyed state channel. Requires a connected client.
+ * A background scheduler sends the newest value of every key written since the
+ * previous tick, packed into as few packets as fit max_packet_bytes.
+ * The channel stops when destroyed or when the client disconnects.
+ */
+LkResult lk_state_channel_create(
+  LkClientHandle*,
+  const LkStateChannelConfig* config,
+  LkStateChannelHandle** out_channel);
+
+/**
+ * Destroy a state channel handle; unsent values are discarded.
+ */
+LkResult lk_state_channel_destroy(LkStateChannelHandle*);
+
+/**
+ * Store the newest value for key. Copies the bytes and returns immediately;
+ * never waits on the network. Error 5 if the value cannot fit one packet,
+ * error 6 after the client disconnected.
+ */
+LkResult lk_state_channel_write(LkStateChannelHandle*, uint32_t key, const uint8_t* bytes, size_t len);
+
+LkResult lk_state_channel_get_stats(LkStateChannelHandle*, LkStateChannelStats* out_stats);
+
+/**
+ * Register a handler for values arriving on state channel label. Pass cb = NULL to remove.
+ */
+LkResult lk_register_state_handler(LkClientHandle*, const char* label, LkStateHandler cb, void* user);
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Pose Codec
+// ═══════════════════════════════════════════════════════════════════════════
+//
+// Quantizes a skeletal pose into a compact bit-packed packet, so a full-body pose fits
+// the 1300-byte lossy limit (60 bones with positions and scales: about 830 bytes;
+// rotations only: about 270). Pure functions: they need no client and work in every build.
+// Packets are self-describing, so the receiver needs no config to decode them.
+
+/**
+ * One bone. rotation is a quaternion (x, y, z, w); it need not be normalized.
+ * Bone 0 is the root: other positions are encoded relative to it.
+ */
+typedef struct {
+  float rotation[4];
+  float position[3];
+  float scale[3];
+} LkBoneTransform;
+
+/**
+ * Encoding precision.
+ * - bone_count: 1..65535
+ * - rotation_bits: bits per smallest-three component, 4..16 (0 = 11, about 0.1 degree)
+ * - encode_positions: 0 = rotations only (positions decode as 0)
+ * - position_bits: bits per axis, 4..24 (0 = 16)
+ * - position_range: offsets from the root are clamped to +/- this (in your units)
+ * - scale_bits: bits per axis, 4..16, or 0 to omit scales (they decode as 1)
+ * - scale_min / scale_max: scale range when scale_bits > 0
+ */
+typedef struct {
+  uint32_t bone_count;
+  int32_t rotation_bits;
+  int32_t encode_positions;
+  int32_t position_bits;
+  float position_range;
+  int32_t scale_bits;
+  float scale_min;
+  float scale_max;
+} LkPoseCodecConfig;
+
+/**
+ * Size in bytes of one pose encoded with config (constant per config); 0 if the config
+ * is invalid.
+ */
+size_t lk_pose_encoded_size(const LkPoseCodecConfig* config);
+
+/**
+ * Encode config->bone_count bones into out.
+ * Errors: 5 invalid config, 601 out_capacity below lk_pose_encoded_size.
+ */
+LkResult lk_pose_encode(const LkPoseCodecConfig* config, const LkBoneTransform* bones, uint8_t* out, size_t out_capacity, size_t* out_len);
+
+/**
+ * Decode a pose packet. out_count receives the packet's bone count, also on error 601
+ * (capacity too small or out_bones NULL), so callers can size their buffer.
+ * Errors: 601 buffer too small, 602 malformed or truncated packet.
+ */
+LkResult lk_pose_decode(const uint8_t* bytes, size_t len, LkBoneTransform* out_bones, size_t capacity, size_t* out_count);
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Pose Playout Buffer
+// ═══════════════════════════════════════════════════════════════════════════
+//
+// Smooths a received pose stream: push frames as they arrive, sample at render time. The
+// buffer delays playback just enough to absorb the stream's recent jitter (95th percentile
+// plus one frame interval), interpolates between frames, and briefly extrapolates across
+// gaps. Sender clocks need not be synchronized with the receiver, only consistent per
+// sender. Pure functions: one buffer per remote stream, usable from any thread.
+
+typedef struct LkPlayoutBuffer LkPlayoutBuffer;
+
+/**
+ * - bone_count: bones per frame (required)
+ * - min_delay_ms: floor for the adaptive delay
+ * - max_delay_ms: cap for the adaptive delay (0 = 200)
+ * - max_extrapolate_ms: extrapolation past the newest frame before holding it
+ *   (0 = 50, negative = never extrapolate)
+ * - capacity: frames buffered at most (0 = 64)
+ */
+typedef struct {
+  uint32_t bone_count;
+  int32_t min_delay_ms;
+  int32_t max_delay_ms;
+  int32_t max_extrapolate_ms;
+  int32_t capacity;
+} LkPlayoutConfig;
+
+typedef enum {
+  LkPlayoutEmpty = 0,        // nothing pushed yet; output untouched
+  LkPlayoutInterpolated = 1,
+  LkPlayoutExtrapolated = 2,
+  LkPlayoutHeld = 3,         // a buffered frame as is (before the first, or extrapolation ran out)
+} LkPlayoutMode;
+
+typedef struct {
+  int32_t depth;             // frames buffered ahead of the last render time
+  int64_t target_delay_us;   // current playout delay beyond the fastest recent transit
+  int64_t jitter_us;         // 95th percentile transit minus the fastest
+  int64_t frames_pushed;
+  int64_t late_dropped;      // arrived after their play time
+  int64_t duplicates_dropped;
+  int64_t overflow_dropped;
+  int64_t interpolated;      // samples by mode
+  int64_t extrapolated;
+  int64_t held;
+} LkPlayoutStats;
+
+/** Create a buffer; NULL if config is NULL or bone_count is 0. */
+LkPlayoutBuffer* lk_playout_create(const LkPlayoutConfig* config);
+void lk_playout_destroy(LkPlayoutBuffer* buffer);
+
+/**
+ * Add a frame of bone_count bones. sample_time_us is the sender's capture time on any
+ * clock consistent per sender (e.g. lk_data_sender_time_us); arrival_us is the local
+ * receive time on the clock later passed to lk_playout_sample (e.g. lk_now_local_us).
+ * Late and duplicate frames are counted and dropped. A frame more than max_delay_ms behind
+ * the last sampled time means the sender restarted: the buffered frames are discarded and
+ * playout starts over from it.
+ * Errors: 4 null pointer, 5 count differs from bone_count.
+ */
+LkResult lk_playout_push(LkPlayoutBuffer* buffer, int64_t sample_time_us, int64_t arrival_us, const LkBoneTransform* bones, size_t count);
+
+/**
+ * Write the pose for local time render_time_us to out_bones and how it was produced to
+ * out_mode (may be NULL). Render times should not go backwards.
+ * Errors: 4 null pointer, 601 capacity below bone_count.
+ */
+LkResult lk_playout_sample(LkPlayoutBuffer* buffer, int64_t render_time_us, LkBoneTransform* out_bones, size_t capacity, LkPlayoutMode* out_mode);
+
+LkResult lk_playout_get_stats(LkPlayoutBuffer* buffer, LkPlayoutStats* out_stats);
+
 // ═══════════════════════════════════════════════════════════════════════════
 // Reconnection and Token Management
 // ═══════════════════════════════════════════════════════════════════════════
@@ -386,18 +1330,75 @@ LkResult lk_set_role(LkClientHandle*, LkRole role, int32_t auto_subscribe);
  */
 LkResult lk_set_log_level(LkClientHandle*, LkLogLevel level);
 
+/**
+ * Route log lines to `cb` instead of stdout; NULL restores stdout. Checking the level costs one
+ * atomic load, so disabled levels are free. Enabled lines are queued without blocking and
+ * delivered in order on a dedicated log thread, never inside another API call. If the queue
+ * (1024 lines) is full, lines are dropped and a warning reports how many. Each call site logs
+ * at most 20 lines per second; its first line in the next second carries the number suppressed.
+ * Once this returns (or lk_client_destroy does) the previous callback is not called again.
+ * Do not call lk_set_log_callback from inside the callback.
+ */
+LkResult lk_set_log_callback(LkClientHandle*, LkLogCallback cb, void* user);
+
 /**
  * Get audio statistics.
  * Returns current audio ring buffer state and error counters.
  */
 LkResult lk_get_audio_stats(LkClientHandle*, LkAudioStats* out_stats);
 
+/**
+ * Statistics of every audio track: published ones (including the default track) first,
+ * then subscribed ones. Writes at most `capacity` entries to `out_tracks`; `out_count`
+ * gets the number available, so a call with capacity 0 sizes the array.
+ */
+LkResult lk_get_audio_track_stats(LkClientHandle*, LkAudioTrackStats* out_tracks, size_t capacity, size_t* out_count);
+
 /**
  * Get data channel statistics.
  * Returns cumulative send/drop counters.
  */
 LkResult lk_get_data_stats(LkClientHandle*, LkDataStats* out_stats);
 
+/**
+ * WebRTC transport stats of the publisher and subscriber peer connections (either output may
+ * be NULL). The first stats call starts a once-a-second poll of the SDK's stats; calls return
+ * the cached figures of the last poll, so reading them at any rate is cheap. Until the first
+ * poll completes everything is 0.
+ */
+LkResult lk_get_transport_stats(LkClientHandle*, LkTransportStats* out_publisher, LkTransportStats* out_subscriber);
+
+/**
+ * Per-track RTP stats from the same poll: published tracks first, then subscribed ones.
+ * Writes at most `capacity` entries to `out_tracks`; `out_count` gets the number available,
+ * so a call with capacity 0 sizes the array.
+ */
+LkResult lk_get_track_stats(LkClientHandle*, LkTrackStats* out_tracks, size_t capacity, size_t* out_count);
+
+/**
+ * Latency histograms of the audio, send and receive hot paths. Recording is always on and
+ * lock-free; this call summarizes everything since the client was created or the last call
+ * with `reset` non-zero, which also starts a new window. Batched sends are timed from the
+ * batch's first message; sends on the send queue from when they were enqueued.
+ */
+LkResult lk_get_latency_stats(LkClientHandle*, LkLatencyStats* out_stats, int32_t reset);
+
+/**
+ * Hot-path tracing (process-wide). Only in libraries built with the `trace_spans` feature;
+ * otherwise both calls return 501 and the spans are compiled out entirely. While enabled, the
+ * audio push, ring pop and capture_frame, room event handling, data receive and dispatch,
+ * audio callbacks, and data send and publish are timed into a per-thread ring of the most
+ * recent 65536 spans. Recording off costs one atomic load per span.
+ */
+LkResult lk_trace_enable(int32_t enabled);
+
+/**
+ * Write the recorded spans to `path` as Chrome trace JSON (open in chrome://tracing or
+ * ui.perfetto.dev) and clear them. `out_spans` (may be NULL) gets the number written.
+ * Returns 500 if the file cannot be written.
+ */
+LkResult lk_trace_dump(const char* path, size_t* out_spans);
+
 // ═══════════════════════════════════════════════════════════════════════════
 // Threading and Safety Guarantees
 // ═══════════════════════════════════════════════════════════════════════════